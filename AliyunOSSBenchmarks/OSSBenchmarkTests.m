@@ -0,0 +1,259 @@
+//
+//  OSSBenchmarkTests.m
+//  AliyunOSSBenchmarks
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <AliyunOSSiOS/AliyunOSSiOS.h>
+#import <AliyunOSSiOS/OSSXMLResponseParser.h>
+
+/* Scripts/mock_oss_server.py, run with --latency and --bandwidth to benchmark slow networks */
+#define OSS_BENCHMARK_DEFAULT_ENDPOINT  @"http://127.0.0.1:8800"
+#define OSS_BENCHMARK_BUCKET            @"benchmark"
+
+static const NSUInteger oss_benchmark_file_size = 16 * 1024 * 1024;
+
+@interface OSSBenchmarkTests : XCTestCase
+{
+    OSSClient *_client;
+    NSURL *_fileURL;
+}
+
+@end
+
+@implementation OSSBenchmarkTests
+
+- (void)setUp {
+    [super setUp];
+    self.continueAfterFailure = NO;
+
+    NSString *endpoint = [NSProcessInfo processInfo].environment[@"OSS_BENCHMARK_ENDPOINT"] ?: OSS_BENCHMARK_DEFAULT_ENDPOINT;
+    OSSStsTokenCredentialProvider *provider = [[OSSStsTokenCredentialProvider alloc] initWithAccessKeyId:@"ak"
+                                                                                              secretKeyId:@"sk"
+                                                                                            securityToken:@"token"];
+    OSSClientConfiguration *configuration = [OSSClientConfiguration new];
+    configuration.maxRetryCount = 0;
+    configuration.crc64Verifiable = NO;
+    _client = [[OSSClient alloc] initWithEndpoint:endpoint credentialProvider:provider clientConfiguration:configuration];
+
+    _fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"oss_benchmark_16m"]];
+    if (![[NSFileManager defaultManager] fileExistsAtPath:_fileURL.path]) {
+        NSMutableData *data = [NSMutableData dataWithLength:oss_benchmark_file_size];
+        arc4random_buf(data.mutableBytes, data.length);
+        [data writeToURL:_fileURL atomically:YES];
+    }
+
+    // a 404 from the mock server means it's up, anything else means it isn't running
+    OSSHeadObjectRequest *head = [OSSHeadObjectRequest new];
+    head.bucketName = OSS_BENCHMARK_BUCKET;
+    head.objectKey = @"not-exist";
+    OSSTask *task = [_client headObject:head];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(OSSServerErrorDomain, task.error.domain, @"start Scripts/mock_oss_server.py or set OSS_BENCHMARK_ENDPOINT first");
+}
+
+- (void)tearDown {
+    _client = nil;
+    [super tearDown];
+}
+
+#pragma mark - utils
+
+/* wall clock, and peak memory where XCTMetric is available */
+- (void)measureWithMemory:(void (^)(void))block {
+    if (@available(iOS 13.0, macOS 10.15, *)) {
+        [self measureWithMetrics:@[[XCTClockMetric new], [XCTMemoryMetric new]] block:block];
+    } else {
+        [self measureBlock:block];
+    }
+}
+
+- (void)logBytes:(double)bytes startTime:(CFAbsoluteTime)startTime name:(NSString *)name {
+    NSTimeInterval cost = CFAbsoluteTimeGetCurrent() - startTime;
+    NSLog(@"%@: %.1f MB/s", name, bytes / cost / (1024 * 1024));
+}
+
+- (void)waitForAllTasks:(NSArray<OSSTask *> *)tasks {
+    [[OSSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+    for (OSSTask *task in tasks) {
+        XCTAssertNil(task.error);
+    }
+}
+
+- (void)putObjectWithKey:(NSString *)objectKey length:(NSUInteger)length {
+    OSSPutObjectRequest *put = [OSSPutObjectRequest new];
+    put.bucketName = OSS_BENCHMARK_BUCKET;
+    put.objectKey = objectKey;
+    put.uploadingData = [[NSData dataWithContentsOfURL:_fileURL] subdataWithRange:NSMakeRange(0, length)];
+    [self waitForAllTasks:@[[_client putObject:put]]];
+}
+
+#pragma mark - putObject & getObject
+
+- (void)testPutObjectThroughput {
+    // 16 puts of 1MB at once
+    NSData *data = [[NSData dataWithContentsOfURL:_fileURL] subdataWithRange:NSMakeRange(0, 1024 * 1024)];
+    [self measureWithMemory:^{
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        NSMutableArray<OSSTask *> *tasks = [NSMutableArray array];
+        for (int i = 0; i < 16; i++) {
+            OSSPutObjectRequest *put = [OSSPutObjectRequest new];
+            put.bucketName = OSS_BENCHMARK_BUCKET;
+            put.objectKey = [NSString stringWithFormat:@"put/%d", i];
+            put.uploadingData = data;
+            [tasks addObject:[_client putObject:put]];
+        }
+        [self waitForAllTasks:tasks];
+        [self logBytes:16.0 * data.length startTime:startTime name:@"putObject"];
+    }];
+}
+
+- (void)testGetObjectThroughput {
+    // 16 gets of 4MB at once, in memory
+    [self putObjectWithKey:@"get/4m" length:4 * 1024 * 1024];
+    [self measureWithMemory:^{
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        NSMutableArray<OSSTask *> *tasks = [NSMutableArray array];
+        for (int i = 0; i < 16; i++) {
+            OSSGetObjectRequest *get = [OSSGetObjectRequest new];
+            get.bucketName = OSS_BENCHMARK_BUCKET;
+            get.objectKey = @"get/4m";
+            [tasks addObject:[_client getObject:get]];
+        }
+        [self waitForAllTasks:tasks];
+        [self logBytes:16.0 * 4 * 1024 * 1024 startTime:startTime name:@"getObject"];
+    }];
+}
+
+- (void)testGetObjectToFilePeakMemory {
+    // the memory metric shows what a download to file keeps in memory, which shouldn't grow with the object
+    [self putObjectWithKey:@"get/16m" length:oss_benchmark_file_size];
+    NSURL *downloadURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"oss_benchmark_download"]];
+    [self measureWithMemory:^{
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        OSSGetObjectRequest *get = [OSSGetObjectRequest new];
+        get.bucketName = OSS_BENCHMARK_BUCKET;
+        get.objectKey = @"get/16m";
+        get.downloadToFileURL = downloadURL;
+        [self waitForAllTasks:@[[_client getObject:get]]];
+        [self logBytes:oss_benchmark_file_size startTime:startTime name:@"getObject to file"];
+        [[NSFileManager defaultManager] removeItemAtURL:downloadURL error:nil];
+    }];
+}
+
+#pragma mark - multipart
+
+- (void)measureMultipartUploadWithPartSize:(NSUInteger)partSize concurrentPartCount:(NSUInteger)concurrentPartCount {
+    [self measureWithMemory:^{
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        OSSMultipartUploadRequest *request = [OSSMultipartUploadRequest new];
+        request.bucketName = OSS_BENCHMARK_BUCKET;
+        request.objectKey = @"multipart/16m";
+        request.uploadingFileURL = _fileURL;
+        request.partSize = partSize;
+        request.concurrentPartCount = concurrentPartCount;
+        request.crcFlag = OSSRequestCRCClosed;
+        [self waitForAllTasks:@[[_client multipartUpload:request]]];
+        NSString *name = [NSString stringWithFormat:@"multipartUpload, %luKB parts, %lu at once",
+                          (unsigned long)(partSize / 1024), (unsigned long)concurrentPartCount];
+        [self logBytes:oss_benchmark_file_size startTime:startTime name:name];
+    }];
+}
+
+- (void)testMultipartUploadWith256KBPartsOneByOne {
+    [self measureMultipartUploadWithPartSize:256 * 1024 concurrentPartCount:1];
+}
+
+- (void)testMultipartUploadWith256KBParts {
+    [self measureMultipartUploadWithPartSize:256 * 1024 concurrentPartCount:6];
+}
+
+- (void)testMultipartUploadWith1MBPartsOneByOne {
+    [self measureMultipartUploadWithPartSize:1024 * 1024 concurrentPartCount:1];
+}
+
+- (void)testMultipartUploadWith1MBParts {
+    [self measureMultipartUploadWithPartSize:1024 * 1024 concurrentPartCount:3];
+}
+
+- (void)testMultipartUploadWith1MBPartsSixAtOnce {
+    [self measureMultipartUploadWithPartSize:1024 * 1024 concurrentPartCount:6];
+}
+
+- (void)testMultipartUploadWith4MBParts {
+    [self measureMultipartUploadWithPartSize:4 * 1024 * 1024 concurrentPartCount:3];
+}
+
+#pragma mark - checksums, signing, xml
+
+- (void)testCrc64Speed {
+    NSData *data = [NSData dataWithContentsOfURL:_fileURL];
+    [self measureBlock:^{
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < 4; i++) {
+            [OSSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length];
+        }
+        NSLog(@"crc64ecma: %.2f GB/s", 4.0 * data.length / (CFAbsoluteTimeGetCurrent() - startTime) / (1 << 30));
+    }];
+}
+
+- (void)testMD5Speed {
+    NSData *data = [NSData dataWithContentsOfURL:_fileURL];
+    [self measureBlock:^{
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < 4; i++) {
+            [OSSUtil base64Md5ForData:data];
+        }
+        NSLog(@"md5: %.2f GB/s", 4.0 * data.length / (CFAbsoluteTimeGetCurrent() - startTime) / (1 << 30));
+    }];
+}
+
+- (void)testSigningSpeed {
+    OSSStsTokenCredentialProvider *provider = [[OSSStsTokenCredentialProvider alloc] initWithAccessKeyId:@"ak"
+                                                                                              secretKeyId:@"OtxrzxIsfpFjA7SwPzILwy8Bw21TLhquhboDYROV"
+                                                                                            securityToken:@"token"];
+    OSSSignerInterceptor *signer = [[OSSSignerInterceptor alloc] initWithCredentialProvider:provider];
+    const int count = 10000;
+    [self measureBlock:^{
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < count; i++) {
+            @autoreleasepool {
+                OSSAllRequestNeededMessage *message = [[OSSAllRequestNeededMessage alloc] initWithEndpoint:@"https://oss-cn-hangzhou.aliyuncs.com"
+                                                                                                httpMethod:@"PUT"
+                                                                                                bucketName:OSS_BENCHMARK_BUCKET
+                                                                                                 objectKey:@"dir/object"
+                                                                                                      type:@"application/octet-stream"
+                                                                                                       md5:nil
+                                                                                                     range:nil
+                                                                                                      date:[[NSDate oss_clockSkewFixedDate] oss_asStringValue]
+                                                                                              headerParams:[@{@"x-oss-meta-name": @"value"} mutableCopy]
+                                                                                                    querys:[@{@"partNumber": @"1", @"uploadId": @"abc"} mutableCopy]
+                                                                                                      sha1:nil];
+                [signer interceptRequestMessage:message];
+            }
+        }
+        NSLog(@"signing: %.0f ops/s", count / (CFAbsoluteTimeGetCurrent() - startTime));
+    }];
+}
+
+- (void)testListBucketXMLParseSpeed {
+    NSMutableString *xml = [NSMutableString stringWithString:@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<ListBucketResult><Name>benchmark</Name><MaxKeys>1000</MaxKeys><IsTruncated>false</IsTruncated>"];
+    for (int i = 0; i < 1000; i++) {
+        [xml appendFormat:@"<Contents><Key>dir/file_%d.jpg</Key><LastModified>2018-01-01T00:00:00.000Z</LastModified><ETag>\"5B3C1A2E053D763E1B002CC607C5A0FE\"</ETag><Type>Normal</Type><Size>%d</Size><StorageClass>Standard</StorageClass><Owner><ID>1</ID><DisplayName>1</DisplayName></Owner></Contents>", i, i * 1024];
+    }
+    [xml appendString:@"</ListBucketResult>"];
+    NSData *body = [xml dataUsingEncoding:NSUTF8StringEncoding];
+    [self measureBlock:^{
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < 10; i++) {
+            OSSXMLResponseParser *parser = [OSSXMLResponseParser parserForOperationType:OSSOperationTypeGetBucket];
+            [parser feedData:body];
+            [parser finish];
+        }
+        NSLog(@"list bucket xml: %.1f MB/s", 10.0 * body.length / (CFAbsoluteTimeGetCurrent() - startTime) / (1024 * 1024));
+    }];
+}
+
+@end
@@ -0,0 +1,59 @@
+//
+//  OSSBucketListIterator.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class OSSClient;
+@class OSSGetBucketRequest;
+@class OSSTask;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A lazy listing of a bucket, following NextMarker page after page.
+
+ The next pages are requested while the current one is being consumed, up to
+ maxPrefetchPages pages ahead. With a delimiter and expandCommonPrefixes, every
+ common prefix returned is listed too, up to maxConcurrentRequests listings at once,
+ so a deep bucket is listed at the throughput of several listings instead of the
+ round trip of one.
+ */
+@interface OSSBucketListIterator : NSObject
+
+/**
+ The max pages received and not consumed yet, plus the pages being requested. 2 by default.
+ */
+@property (nonatomic, assign) NSUInteger maxPrefetchPages;
+
+/**
+ The max getBucket requests running at once. It only matters with expandCommonPrefixes,
+ since the pages of one prefix are requested in order. 4 by default.
+ */
+@property (nonatomic, assign) NSUInteger maxConcurrentRequests;
+
+/**
+ Lists the common prefixes of every page as well, recursively. NO by default.
+ The pages of different prefixes are then returned in the order they are received.
+ */
+@property (nonatomic, assign) BOOL expandCommonPrefixes;
+
+- (instancetype)initWithClient:(OSSClient *)client request:(OSSGetBucketRequest *)request;
+
+/**
+ The next page as an OSSGetBucketResult, or a nil result once the listing is over.
+ After an error, every call returns the error.
+ */
+- (OSSTask *)nextPage;
+
+/**
+ Cancels the running requests, and the pages not consumed yet are dropped.
+ */
+- (void)cancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
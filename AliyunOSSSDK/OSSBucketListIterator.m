@@ -0,0 +1,179 @@
+//
+//  OSSBucketListIterator.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSBucketListIterator.h"
+#import "OSSClient.h"
+#import "OSSDefine.h"
+#import "OSSModel.h"
+#import "OSSBolts.h"
+#import "OSSLog.h"
+
+@implementation OSSBucketListIterator {
+    OSSClient * _client;
+    OSSGetBucketRequest * _request;
+
+    /* the next request of every listing not over yet */
+    NSMutableArray<OSSGetBucketRequest *> * _cursors;
+    NSMutableSet<OSSGetBucketRequest *> * _runningRequests;
+    NSMutableArray<OSSGetBucketResult *> * _pages;
+    NSMutableArray<OSSTaskCompletionSource *> * _waiters;
+    NSError * _error;
+}
+
+- (instancetype)initWithClient:(OSSClient *)client request:(OSSGetBucketRequest *)request {
+    if (self = [super init]) {
+        _client = client;
+        _request = request;
+        _maxPrefetchPages = 2;
+        _maxConcurrentRequests = 4;
+        _cursors = [NSMutableArray arrayWithObject:[self requestWithPrefix:request.prefix marker:request.marker]];
+        _runningRequests = [NSMutableSet new];
+        _pages = [NSMutableArray new];
+        _waiters = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (OSSTask *)nextPage {
+    OSSTask * task = nil;
+    @synchronized(self) {
+        if (_pages.count) {
+            task = [OSSTask taskWithResult:_pages.firstObject];
+            [_pages removeObjectAtIndex:0];
+        } else if (_error) {
+            task = [OSSTask taskWithError:_error];
+        } else if ([self isOver]) {
+            task = [OSSTask taskWithResult:nil];
+        } else {
+            OSSTaskCompletionSource * waiter = [OSSTaskCompletionSource taskCompletionSource];
+            [_waiters addObject:waiter];
+            task = waiter.task;
+        }
+    }
+    [self sendRequests];
+    return task;
+}
+
+- (void)cancel {
+    NSArray<OSSTaskCompletionSource *> * waiters;
+    NSArray<OSSGetBucketRequest *> * runningRequests;
+    @synchronized(self) {
+        if (!_error) {
+            _error = [NSError errorWithDomain:OSSClientErrorDomain
+                                         code:OSSClientErrorCodeTaskCancelled
+                                     userInfo:@{OSSErrorMessageTOKEN: @"This task is cancelled!"}];
+        }
+        [_pages removeAllObjects];
+        [_cursors removeAllObjects];
+        runningRequests = _runningRequests.allObjects;
+        waiters = [_waiters copy];
+        [_waiters removeAllObjects];
+    }
+    [runningRequests makeObjectsPerformSelector:@selector(cancel)];
+    for (OSSTaskCompletionSource * waiter in waiters) {
+        [waiter trySetError:_error];
+    }
+}
+
+# pragma mark - Private Methods
+
+- (OSSGetBucketRequest *)requestWithPrefix:(NSString *)prefix marker:(NSString *)marker {
+    OSSGetBucketRequest * request = [OSSGetBucketRequest new];
+    request.bucketName = _request.bucketName;
+    request.delimiter = _request.delimiter;
+    request.maxKeys = _request.maxKeys;
+    request.prefix = prefix;
+    request.marker = marker;
+    return request;
+}
+
+/* must be called with the lock held */
+- (BOOL)isOver {
+    return _cursors.count == 0 && _runningRequests.count == 0 && _pages.count == 0;
+}
+
+- (void)sendRequests {
+    NSMutableArray<OSSGetBucketRequest *> * requests = [NSMutableArray new];
+    @synchronized(self) {
+        NSUInteger maxPrefetchPages = MAX(self.maxPrefetchPages, 1);
+        NSUInteger maxConcurrentRequests = MAX(self.maxConcurrentRequests, 1);
+        while (!_error && _cursors.count
+               && _runningRequests.count < maxConcurrentRequests
+               && _pages.count + _runningRequests.count < maxPrefetchPages) {
+            OSSGetBucketRequest * request = _cursors.firstObject;
+            [_cursors removeObjectAtIndex:0];
+            [_runningRequests addObject:request];
+            [requests addObject:request];
+        }
+    }
+
+    for (OSSGetBucketRequest * request in requests) {
+        [[_client getBucket:request] continueWithBlock:^id(OSSTask * task) {
+            [self request:request didCompleteWithTask:task];
+            return nil;
+        }];
+    }
+}
+
+- (void)request:(OSSGetBucketRequest *)request didCompleteWithTask:(OSSTask *)task {
+    OSSTaskCompletionSource * waiter = nil;
+    NSArray<OSSTaskCompletionSource *> * finishedWaiters = nil;
+    @synchronized(self) {
+        [_runningRequests removeObject:request];
+        if (_error) {
+            return;
+        }
+
+        if (task.error) {
+            OSSLogError(@"list bucket %@ with prefix %@ failed: %@", request.bucketName, request.prefix, task.error);
+            _error = task.error;
+            [_cursors removeAllObjects];
+            finishedWaiters = [_waiters copy];
+            [_waiters removeAllObjects];
+        } else {
+            OSSGetBucketResult * result = task.result;
+            if (result.isTruncated) {
+                NSString * nextMarker = result.nextMarker;
+                if (!nextMarker.length) {
+                    nextMarker = [[result.contents lastObject] objectForKey:OSSKeyXMLTOKEN];
+                }
+                if (nextMarker.length) {
+                    /* keep on with the same listing first, the prefixes come after it */
+                    [_cursors insertObject:[self requestWithPrefix:request.prefix marker:nextMarker] atIndex:0];
+                }
+            }
+            if (self.expandCommonPrefixes && _request.delimiter.length) {
+                for (NSString * prefix in result.commentPrefixes) {
+                    [_cursors addObject:[self requestWithPrefix:prefix marker:nil]];
+                }
+            }
+
+            if (_waiters.count) {
+                waiter = _waiters.firstObject;
+                [_waiters removeObjectAtIndex:0];
+            } else {
+                [_pages addObject:result];
+            }
+            if ([self isOver]) {
+                finishedWaiters = [_waiters copy];
+                [_waiters removeAllObjects];
+            }
+        }
+    }
+
+    [waiter trySetResult:task.result];
+    for (OSSTaskCompletionSource * finishedWaiter in finishedWaiters) {
+        if (task.error) {
+            [finishedWaiter trySetError:task.error];
+        } else {
+            [finishedWaiter trySetResult:nil];
+        }
+    }
+    [self sendRequests];
+}
+
+@end
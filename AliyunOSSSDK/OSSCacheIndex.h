@@ -0,0 +1,65 @@
+//
+//  OSSCacheIndex.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The keys of a cache in their least recently used order, each with a property list item, and the file
+ they're kept in so that they outlive the process.
+
+ A change is written a second later at the latest, together with the ones made meanwhile. A new use of a
+ key isn't written by itself, only with the next change. A cache writing its content files on the queue
+ of the index has them on disk before the index naming them. It's thread safe.
+ */
+@interface OSSCacheIndex : NSObject
+
+/**
+ Where the index is read from and written to, nil for an index in memory only.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString * filePath;
+
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+/**
+ The key to evict first, nil when the index is empty.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString * leastRecentlyUsedKey;
+
+/**
+ Reads the items kept in the file, if any.
+ @param queue where the file is written, nil for a queue of its own
+ */
+- (instancetype)initWithFilePath:(nullable NSString *)filePath queue:(nullable dispatch_queue_t)queue NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ The keys, the least recently used one first.
+ */
+- (NSArray<NSString *> *)keys;
+
+- (nullable NSDictionary *)itemForKey:(NSString *)key;
+
+/**
+ Adds the key as the most recently used one, or replaces its item where it is.
+ */
+- (void)setItem:(NSDictionary *)item forKey:(NSString *)key;
+
+/**
+ Makes the key the most recently used one.
+ */
+- (void)touchKey:(NSString *)key;
+
+- (void)removeItemForKey:(NSString *)key;
+
+- (void)removeAllItems;
+
+@end
+
+NS_ASSUME_NONNULL_END
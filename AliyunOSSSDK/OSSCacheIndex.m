@@ -0,0 +1,138 @@
+//
+//  OSSCacheIndex.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSCacheIndex.h"
+#import "OSSLog.h"
+
+static NSString * const oss_cache_index_key_key = @"key";
+static NSString * const oss_cache_index_item_key = @"item";
+
+@implementation OSSCacheIndex {
+    NSMutableDictionary<NSString *, NSDictionary *> * _items;
+    /* the least recently used key first */
+    NSMutableOrderedSet<NSString *> * _keys;
+
+    dispatch_queue_t _queue;
+    BOOL _isWriteScheduled;
+}
+
+- (instancetype)initWithFilePath:(NSString *)filePath queue:(dispatch_queue_t)queue {
+    if (self = [super init]) {
+        _filePath = [filePath copy];
+        _items = [NSMutableDictionary new];
+        _keys = [NSMutableOrderedSet new];
+        _queue = queue ?: dispatch_queue_create("com.aliyun.oss.cache-index", DISPATCH_QUEUE_SERIAL);
+
+        if (_filePath) {
+            [self load];
+        }
+    }
+    return self;
+}
+
+- (NSUInteger)count {
+    @synchronized(self) {
+        return _keys.count;
+    }
+}
+
+- (NSString *)leastRecentlyUsedKey {
+    @synchronized(self) {
+        return _keys.firstObject;
+    }
+}
+
+- (NSArray<NSString *> *)keys {
+    @synchronized(self) {
+        return [_keys array];
+    }
+}
+
+- (NSDictionary *)itemForKey:(NSString *)key {
+    @synchronized(self) {
+        return _items[key];
+    }
+}
+
+- (void)setItem:(NSDictionary *)item forKey:(NSString *)key {
+    NSDictionary * storedItem = [item copy];
+    @synchronized(self) {
+        _items[key] = storedItem;
+        [_keys addObject:key];
+        [self scheduleWriteLocked];
+    }
+}
+
+- (void)touchKey:(NSString *)key {
+    @synchronized(self) {
+        if (_items[key] && ![_keys.lastObject isEqualToString:key]) {
+            [_keys removeObject:key];
+            [_keys addObject:key];
+        }
+    }
+}
+
+- (void)removeItemForKey:(NSString *)key {
+    @synchronized(self) {
+        if (_items[key]) {
+            [_items removeObjectForKey:key];
+            [_keys removeObject:key];
+            [self scheduleWriteLocked];
+        }
+    }
+}
+
+- (void)removeAllItems {
+    @synchronized(self) {
+        [_items removeAllObjects];
+        [_keys removeAllObjects];
+        [self scheduleWriteLocked];
+    }
+}
+
+# pragma mark - Private Methods
+
+- (void)scheduleWriteLocked {
+    if (!self.filePath || _isWriteScheduled) {
+        return;
+    }
+    _isWriteScheduled = YES;
+    __weak OSSCacheIndex * weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)NSEC_PER_SEC), _queue, ^{
+        [weakSelf write];
+    });
+}
+
+- (void)write {
+    NSMutableArray<NSDictionary *> * records = [NSMutableArray array];
+    @synchronized(self) {
+        _isWriteScheduled = NO;
+        for (NSString * key in _keys) {
+            [records addObject:@{oss_cache_index_key_key: key, oss_cache_index_item_key: _items[key]}];
+        }
+    }
+    if (![records writeToFile:self.filePath atomically:YES]) {
+        OSSLogError(@"can't write the cache index %@", self.filePath);
+    }
+}
+
+- (void)load {
+    NSArray * records = [NSArray arrayWithContentsOfFile:self.filePath];
+    for (NSDictionary * record in records) {
+        if (![record isKindOfClass:[NSDictionary class]]) {
+            continue;
+        }
+        NSString * key = record[oss_cache_index_key_key];
+        NSDictionary * item = record[oss_cache_index_item_key];
+        if ([key isKindOfClass:[NSString class]] && [item isKindOfClass:[NSDictionary class]]) {
+            _items[key] = item;
+            [_keys addObject:key];
+        }
+    }
+}
+
+@end
@@ -29,8 +29,21 @@
 @class OSSTask;
 @class OSSExecutor;
 @class OSSCallBackRequest;
+@class OSSBucketListIterator;
+@class OSSObjectAppender;
+@class OSSObjectReader;
+@class OSSImagePipeline;
+@class OSSDeleteMultipleObjectsRequest;
+@class OSSHeadMultipleObjectsRequest;
+@class OSSStreamingMultipartUploadRequest;
+@class OSSParallelDownloadRequest;
+@class OSSResumableDownloadRequest;
+@class OSSUploadPartCopyRequest;
+@class OSSMultipartCopyRequest;
+@class OSSBulkUploadRequest;
 
 @class OSSNetworking;
+@class OSSEndpointSelector;
 @class OSSClientConfiguration;
 @protocol OSSCredentialProvider;
 
@@ -62,6 +75,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, strong) OSSClientConfiguration * clientConfiguration;
 
+/**
+ Picks the endpoint of each request, nil unless the configuration has alternativeEndpoints.
+ */
+@property (nonatomic, strong, readonly, nullable) OSSEndpointSelector * endpointSelector;
+
 /**
  oss operation task queue
  */
@@ -120,6 +138,12 @@ The corresponding RESTFul API: GetBucket
  */
 - (OSSTask *)getBucket:(OSSGetBucketRequest *)request;
 
+/**
+ Lists a bucket lazily, page after page from the request's marker, prefetching the next pages.
+ See OSSBucketListIterator for the lookahead and the listing of the common prefixes.
+ */
+- (OSSBucketListIterator *)bucketListIteratorWithRequest:(OSSGetBucketRequest *)request;
+
 /**
 The corresponding RESTFul API: GetBucketACL
  Gets the bucket ACL.
@@ -132,12 +156,36 @@ The corresponding RESTFul API: HeadObject
  */
 - (OSSTask *)headObject:(OSSHeadObjectRequest *)request;
 
+/**
+The corresponding RESTFul API: HeadObject
+ Gets the metadata of the objects of a bucket in batch, by Head Object requests sent concurrently.
+ The result has the metadata of the existing objects, the keys that don't exist and the keys whose request failed; the task only fails when all requests failed.
+ */
+- (OSSTask *)headMultipleObjects:(OSSHeadMultipleObjectsRequest *)request;
+
 /**
 The corresponding RESTFul API: GetObject
  Gets the whole object (includes content). It requires caller have read permission on the object.
  */
 - (OSSTask *)getObject:(OSSGetObjectRequest *)request;
 
+/**
+ Returns a reader with random access to the object, through ranged getObject: requests of cached blocks.
+ directory keeps the blocks on disk too, nil for a cache in memory only.
+ See OSSObjectReader for the block cache and the read-ahead.
+ */
+- (OSSObjectReader *)objectReaderWithBucketName:(NSString *)bucketName
+                                      objectKey:(NSString *)objectKey
+                                      directory:(nullable NSString *)directory;
+
+/**
+ Returns a pipeline loading the images of the bucket, original or processed by x-oss-process, through getObject:.
+ directory keeps the encoded images on disk too, nil for a cache in memory only.
+ See OSSImagePipeline for the caches, the background decoding and the prefetches.
+ */
+- (OSSImagePipeline *)imagePipelineWithBucketName:(NSString *)bucketName
+                                        directory:(nullable NSString *)directory;
+
 /**
 The corresponding RESTFul API: PutObject
  Uploads a file.
@@ -166,20 +214,45 @@ The corresponding RESTFul API: AppendObject
  */
 - (OSSTask *)appendObject:(OSSAppendObjectRequest *)request withCrc64ecma:(nullable NSString *)crc64ecma;
 
+/**
+ Returns an appender which buffers writes and sends them as ordered appends to the object.
+ position and crc64ecma are the current length and x-oss-hash-crc64ecma of the object, 0 and nil for a new one.
+ See OSSObjectAppender for the flush thresholds and the backpressure.
+ */
+- (OSSObjectAppender *)objectAppenderWithBucketName:(NSString *)bucketName
+                                          objectKey:(NSString *)objectKey
+                                           position:(int64_t)position
+                                          crc64ecma:(nullable NSString *)crc64ecma;
+
 /**
 The corresponding RESTFul API: copyObject
  Copies an existing object to another one.The operation sends a PUT request with x-oss-copy-source header to specify the source object.
  OSS server side will detect and copy the object. If it succeeds, the new object's metadata information will be returned.
- The operation applies for files less than 1GB. For big files, use UploadPartCopy RESTFul API.
+ The operation applies for files less than 1GB. For big files, use multipartCopy:.
  */
 - (OSSTask *)copyObject:(OSSCopyObjectRequest *)request;
 
+/**
+ Copies an object of any size by a multipart upload whose parts are copied by UploadPartCopy requests sent concurrently.
+ The bytes are copied by OSS, they don't go through the client. Every part is only copied if the source object
+ still has the ETag it had when the copy started, and the crc64 of the new object is checked against the source's.
+ With recordDirectoryPath, an interrupted copy resumes from the parts already copied.
+ */
+- (OSSTask *)multipartCopy:(OSSMultipartCopyRequest *)request;
+
 /**
 The corresponding RESTFul API: DeleteObject
 Deletes an object
  */
 - (OSSTask *)deleteObject:(OSSDeleteObjectRequest *)request;
 
+/**
+The corresponding RESTFul API: DeleteMultipleObjects
+Deletes the objects of a bucket in batch. The keys are split into requests of at most 1000 keys, which are sent concurrently.
+The result has the keys deleted (unless in quiet mode) and the keys of the requests that failed; the task only fails when all requests failed.
+ */
+- (OSSTask *)deleteMultipleObjects:(OSSDeleteMultipleObjectsRequest *)request;
+
 /**
 The corresponding RESTFul API: InitiateMultipartUpload
  Initiates a multipart upload to get a upload Id. It's needed before starting uploading parts data. 
@@ -198,6 +271,13 @@ The corresponding RESTFul API: UploadPart
  */
 - (OSSTask *)uploadPart:(OSSUploadPartRequest *)request;
 
+/**
+The corresponding RESTFul API: UploadPartCopy
+ Copies a range of an existing object into a part of a multipart upload, the bytes are copied by OSS.
+ Except the last part, all other part's minimal size is 100KB, and no part is larger than 5GB.
+ */
+- (OSSTask *)uploadPartCopy:(OSSUploadPartCopyRequest *)request;
+
 /**
 The corresponding RESTFul API: CompleteMultipartUpload
  This API is to complete the multipart upload after all parts data have been uploaded.
@@ -248,6 +328,20 @@ Aborts the multipart upload by the specified upload Id.
                         withExpirationInterval:(NSTimeInterval)interval
                                 withParameters:(NSDictionary *)parameters;
 
+/**
+ Generates signed URLs for many objects at once, e.g. the images of a screen. The credential is got once
+ and the signatures share the same expiration time and HMAC key, which is much faster than one call per object.
+ @bucketName objects' bucket name
+ @objectKeys Object names
+ @interval Expiration time in seconds.
+ @parameter the parameters of every URL, e.g. @{@"x-oss-process": @"image/resize,w_50"}
+ The task's result is an NSArray of the URL strings, in the order of objectKeys.
+ */
+- (OSSTask *)presignConstrainURLsWithBucketName:(NSString *)bucketName
+                                 withObjectKeys:(NSArray<NSString *> *)objectKeys
+                         withExpirationInterval:(NSTimeInterval)interval
+                                 withParameters:(nullable NSDictionary *)parameters;
+
 /** TODOTODO
  If the object's ACL is public read or public read-write, use this API to generate a signed url for sharing.
  @bucketName Object's bucket name
@@ -301,6 +395,48 @@ Aborts the multipart upload by the specified upload Id.
  */
 - (OSSTask *)sequentialMultipartUpload:(OSSResumableUploadRequest *)request;
 
+/**
+ Uploads the files of a directory or a list of files, several at the same time.
+ Each file is uploaded by putObject:, or by parts if it's larger than multipartThreshold. With recordDirectoryPath
+ the uploaded files are recorded, and an interrupted bulk upload skips them when it's started again.
+ The result has the keys uploaded, skipped and failed; the task only fails when all files failed.
+ */
+- (OSSTask *)bulkUpload:(OSSBulkUploadRequest *)request;
+
+/**
+ Multipart upload from a stream or a producer block, the parts are cut and sent as the bytes arrive
+ while at most concurrentPartCount parts are held in memory.
+ The crc64 of the whole body is computed as it's read and checked against the object's, if enabled.
+ */
+- (OSSTask *)streamingMultipartUpload:(OSSStreamingMultipartUploadRequest *)request;
+
+/**
+ Hands over the handler of application:handleEventsForBackgroundURLSession:completionHandler:.
+ It's called once the events of the background session are delivered. Multipart uploads with
+ backgroundPartTransfer still running go on with their next parts; an upload of a relaunched app
+ is continued by sending the resumable request again with the same recordDirectoryPath, the parts
+ uploaded in the background are then found by listing the parts.
+ Returns NO if the identifier isn't the background session of this client.
+ */
+- (BOOL)handleEventsForBackgroundURLSession:(NSString *)identifier completionHandler:(void (^)(void))completionHandler;
+
+/**
+ Downloads an object to a local file with several concurrent range requests.
+ The object is planned with a HEAD request, every range is written in place
+ into the preallocated file, and the range crc64s are combined to check the
+ whole object when crc64 verification is enabled.
+ */
+- (OSSTask *)parallelDownload:(OSSParallelDownloadRequest *)request;
+
+/**
+ Downloads an object like parallelDownload:, and persists the finished ranges,
+ the ETag and the range crc64s to a checkpoint file under recordDirectoryPath.
+ An interrupted download resumes with the missing ranges only, a download whose
+ object has a different ETag or Last-Modified since the checkpoint is refused
+ with OSSClientErrorCodeObjectModified and starts over on the next call.
+ */
+- (OSSTask *)resumableDownload:(OSSResumableDownloadRequest *)request;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -14,13 +14,35 @@
 #import "OSSBolts.h"
 #import "OSSNetworking.h"
 #import "OSSXMLDictionary.h"
+#import "OSSBucketListIterator.h"
+#import "OSSObjectAppender.h"
+#import "OSSObjectReader.h"
+#import "OSSImagePipeline.h"
 #import "OSSReachabilityManager.h"
 #import "NSMutableData+OSS_CRC.h"
+#import "OSSInputStreamHelper.h"
+#import "OSSProgressReporter.h"
+#import "OSSPartScheduler.h"
+#import "OSSTransferScheduler.h"
+#import "OSSRequestCoalescer.h"
+#import "OSSStreamingBody.h"
+#import "OSSContentCompressor.h"
+#import "OSSEndpointSelector.h"
+#import "OSSPartInfoJournal.h"
+#import "OSSHttpdns.h"
+#import "OSSObjectCache.h"
+#import "OSSFileDigestCache.h"
+#import "OSSMemoryGovernor.h"
+
+#include <fcntl.h>
+#include <unistd.h>
 
 static NSString * const oss_partInfos_storage_name = @"oss_partInfos_storage_name";
+static NSString * const oss_partInfos_journal_suffix = @".journal";
 static NSString * const oss_record_info_suffix_with_crc = @"-crc64";
 static NSString * const oss_record_info_suffix_with_sequential = @"-sequential";
 static NSUInteger const oss_multipart_max_part_number = 5000;   //max part number
+static NSString * const oss_download_temp_file_suffix = @".osstmp";
 
 /**
  * extend OSSRequest to include the ref to networking request object
@@ -29,11 +51,144 @@ static NSUInteger const oss_multipart_max_part_number = 5000;   //max part numbe
 @property (nonatomic, strong) OSSNetworkingRequestDelegate * requestDelegate;
 @end
 
+/**
+ * extend OSSParallelDownloadRequest to include the range requests,they are cancelled with it
+ */
+@interface OSSParallelDownloadRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
 
+/**
+ * extend OSSDeleteMultipleObjectsRequest to include the batch requests,they are cancelled with it
+ */
+@interface OSSDeleteMultipleObjectsRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
 
-@implementation OSSClient
+/**
+ * extend OSSMultipartCopyRequest to include the part copy requests,they are cancelled with it
+ */
+@interface OSSMultipartCopyRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
+
+/**
+ * extend OSSBulkUploadRequest to include the file requests,they are cancelled with it
+ */
+@interface OSSBulkUploadRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
+
+/**
+ * extend OSSHeadMultipleObjectsRequest to include the head requests,they are cancelled with it
+ */
+@interface OSSHeadMultipleObjectsRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
+
+
+/**
+ * the retry policy is kept by the client, since the networking may be shared with other clients
+ */
+@interface OSSClient ()
+@property (nonatomic, strong) id<OSSRetryPolicy> retryPolicy;
+/* every request of the client waits for its turn in it, whichever networking sends it */
+@property (nonatomic, strong) OSSTransferScheduler * transferScheduler;
+/* the identical reads in flight, when the configuration coalesces them */
+@property (nonatomic, strong) OSSRequestCoalescer * requestCoalescer;
+/* the digests of the uploads skipping unchanged objects, when the configuration has no cache */
+@property (nonatomic, strong) OSSFileDigestCache * fileDigestCache;
+@end
+
+/**
+ * the parts of a multipart upload in progress. A part is started whenever the scheduler has
+ * a free slot and each part sent starts the next ones, so no thread waits for the parts
+ */
+@interface OSSMultipartPartsUpload : NSObject
+
+@property (nonatomic, strong) OSSMultipartUploadRequest * request;
+@property (nonatomic, strong) OSSPartScheduler * scheduler;
+@property (nonatomic, strong) OSSProgressReporter * progressReporter;
+@property (nonatomic, strong) OSSPartInfoJournal * partInfoJournal;
+@property (nonatomic, strong) OSSTaskCompletionSource * completionSource;
+
+/* the parts are read from the mapped file or its handle, or from a streaming body */
+@property (nonatomic, strong) NSData * mappedFileData;
+@property (nonatomic, strong) NSFileHandle * fileHandle;
+@property (nonatomic, assign) unsigned long long fileSize;
+@property (nonatomic, assign) NSUInteger maxPartCount;
+@property (nonatomic, strong) NSSet<NSNumber *> * alreadyUploadedPartNumbers;
+@property (nonatomic, strong) OSSStreamingBody * body;
+
+/* each part is sent once the one read before it is finished, when the parts go in order */
+@property (nonatomic, assign) BOOL sendsPartsInOrder;
+
+/* only used by the thread starting the parts */
+@property (nonatomic, assign) int nextPartNumber;
+@property (nonatomic, assign) unsigned long long partOffset;
+@property (nonatomic, strong) OSSTask * lastPartTask;
+
+/* guarded by @synchronized on the upload */
+@property (nonatomic, strong) NSMutableArray<OSSPartInfo *> * partInfos;
+@property (nonatomic, assign) int64_t uploadedLength;
+@property (nonatomic, assign) NSUInteger runningCount;
+@property (nonatomic, strong) NSError * error;
+@property (nonatomic, assign) BOOL isCancelled;
+@property (nonatomic, assign) BOOL isExhausted;
+@property (nonatomic, assign) BOOL isStartingParts;
+@property (nonatomic, assign) BOOL needsStartParts;
+@property (nonatomic, assign) BOOL isFinished;
+
+@end
+
+@implementation OSSMultipartPartsUpload
+@end
+
+/**
+ * a file of a bulk upload, its version is recorded in the manifest once it's uploaded
+ */
+@interface OSSBulkUploadFile : NSObject
+
+@property (nonatomic, strong) NSURL * fileURL;
+@property (nonatomic, copy) NSString * objectKey;
+@property (nonatomic, assign) unsigned long long size;
+@property (nonatomic, copy) NSString * version;
+
+@end
+
+@implementation OSSBulkUploadFile
+@end
+
+/**
+ * the files of a bulk upload in progress. A file is started whenever one of the concurrent files
+ * is finished, so no thread waits for the uploads
+ */
+@interface OSSBulkFilesUpload : NSObject
+
+@property (nonatomic, strong) OSSBulkUploadRequest * request;
+@property (nonatomic, strong) NSArray<OSSBulkUploadFile *> * pendingFiles;
+@property (nonatomic, strong) NSArray<NSString *> * skippedObjects;
+@property (nonatomic, copy) NSString * manifestPath;
+@property (nonatomic, strong) NSFileHandle * manifest;
+@property (nonatomic, strong) OSSProgressReporter * progressReporter;
+@property (nonatomic, assign) int64_t totalBytesExpected;
+@property (nonatomic, strong) OSSTaskCompletionSource * completionSource;
+
+/* guarded by @synchronized on the upload */
+@property (nonatomic, assign) NSUInteger nextFileIndex;
+@property (nonatomic, assign) NSUInteger runningCount;
+@property (nonatomic, assign) int64_t totalBytesSent;
+@property (nonatomic, strong) NSMutableArray<NSString *> * uploadedObjects;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSError *> * failedObjects;
+@property (nonatomic, strong) NSError * firstError;
+@property (nonatomic, assign) BOOL isFinished;
+
+@end
+
+@implementation OSSBulkFilesUpload
+@end
 
-static NSObject * lock;
+@implementation OSSClient
 
 - (instancetype)initWithEndpoint:(NSString *)endpoint credentialProvider:(id<OSSCredentialProvider>)credentialProvider {
     return [self initWithEndpoint:endpoint credentialProvider:credentialProvider clientConfiguration:[OSSClientConfiguration new]];
@@ -43,20 +198,27 @@ static NSObject * lock;
               credentialProvider:(id<OSSCredentialProvider>)credentialProvider
              clientConfiguration:(OSSClientConfiguration *)conf {
     if (self = [super init]) {
-        lock = [NSObject new];
         // Monitor the network. If the network type is changed, recheck the IPv6 status.
         [OSSReachabilityManager shareInstance];
 
-        NSOperationQueue * queue = [NSOperationQueue new];
         // using for resumable upload and compat old interface
-        queue.maxConcurrentOperationCount = 3;
-        _ossOperationExecutor = [OSSExecutor executorWithOperationQueue:queue];
+        _ossOperationExecutor = [OSSExecutor executorWithWidth:3 qualityOfService:QOS_CLASS_DEFAULT];
         if ([endpoint rangeOfString:@"://"].location == NSNotFound) {
             endpoint = [@"https://" stringByAppendingString:endpoint];
         }
         self.endpoint = [endpoint oss_trim];
         self.credentialProvider = credentialProvider;
         self.clientConfiguration = conf;
+        self.transferScheduler = [OSSTransferScheduler new];
+        self.transferScheduler.maxRequestCount = conf.maxConcurrentRequestCount;
+        self.transferScheduler.maxInFlightBytes = conf.maxInFlightBytes;
+        self.transferScheduler.maxBandwidth = conf.maxBandwidth;
+        self.requestCoalescer = [OSSRequestCoalescer new];
+        self.fileDigestCache = [OSSFileDigestCache new];
+        __weak OSSClient * weakSelf = self;
+        [[OSSMemoryGovernor sharedGovernor] addPressureObserver:self handler:^{
+            [weakSelf.clientConfiguration.objectCache removeAllContentsFromMemory];
+        }];
 
         OSSNetworkingConfiguration * netConf = [OSSNetworkingConfiguration new];
         if (conf) {
@@ -68,8 +230,35 @@ static NSObject * lock;
             netConf.proxyHost = conf.proxyHost;
             netConf.proxyPort = conf.proxyPort;
             netConf.maxConcurrentRequestCount = conf.maxConcurrentRequestCount;
+            netConf.maxConnectionsPerHost = conf.maxConnectionsPerHost;
+            netConf.HTTPShouldUsePipelining = conf.HTTPShouldUsePipelining;
+            netConf.networkServiceType = conf.networkServiceType;
+            netConf.multipathServiceType = conf.multipathServiceType;
+            self.retryPolicy = conf.retryPolicy ?: [OSSJitteredRetryPolicy policyWithMaxRetryCount:conf.maxRetryCount];
+            netConf.retryPolicy = self.retryPolicy;
+        }
+        if (conf.enableSessionSharing) {
+            self.networking = [OSSNetworking sharedNetworkingForEndpoint:self.endpoint configuration:netConf];
+        } else {
+            self.networking = [[OSSNetworking alloc] initWithConfiguration:netConf];
+        }
+
+        if (conf.alternativeEndpoints.count) {
+            NSMutableArray<NSString *> * endpoints = [NSMutableArray arrayWithObject:self.endpoint];
+            for (NSString * alternativeEndpoint in conf.alternativeEndpoints) {
+                NSString * normalizedEndpoint = alternativeEndpoint;
+                if ([normalizedEndpoint rangeOfString:@"://"].location == NSNotFound) {
+                    normalizedEndpoint = [@"https://" stringByAppendingString:normalizedEndpoint];
+                }
+                [endpoints addObject:[normalizedEndpoint oss_trim]];
+            }
+            _endpointSelector = [[OSSEndpointSelector alloc] initWithEndpoints:endpoints];
+            [_endpointSelector raceEndpoints];
+        }
+
+        if (conf.isHttpdnsEnable && conf.httpdnsPreResolveHosts.count) {
+            [[OSSHttpdns sharedInstance] preResolveHosts:conf.httpdnsPreResolveHosts];
         }
-        self.networking = [[OSSNetworking alloc] initWithConfiguration:netConf];
     }
     return self;
 }
@@ -100,8 +289,47 @@ static NSObject * lock;
     }
 
     request.isHttpdnsEnable = self.clientConfiguration.isHttpdnsEnable;
+    request.retryHandler = self.retryPolicy;
+    request.endpointSelector = self.endpointSelector;
+
+    OSSRequestMetrics * metrics = [OSSRequestMetrics new];
+    metrics.operationType = request.operType;
+    metrics.httpMethod = request.allNeededMessage.httpMethod;
+    metrics.bucketName = request.allNeededMessage.bucketName;
+    metrics.objectKey = request.allNeededMessage.objectKey;
+    metrics.startDate = [NSDate date];
+    request.metrics = metrics;
+
+    OSSTask * task = [self.transferScheduler scheduleRequest:request send:^OSSTask *{
+        metrics.queueDuration = -[metrics.startDate timeIntervalSinceNow];
+        // the request is signed when it's sent, it may have waited a while for its turn
+        if ([request.allNeededMessage.date oss_isNotEmpty]) {
+            request.allNeededMessage.date = [[NSDate oss_clockSkewFixedDate] oss_asStringValue];
+        }
+        return [self.networking sendRequest:request];
+    }];
 
-    return [_networking sendRequest:request];
+    OSSRequestMetricsBlock metricsHandler = self.clientConfiguration.requestMetricsHandler;
+    /* whatever its outcome, the object may have changed */
+    OSSObjectCache * objectCache = self.clientConfiguration.objectCache;
+    BOOL mayChangeObject = objectCache && [metrics.objectKey oss_isNotEmpty]
+                           && ![metrics.httpMethod isEqualToString:@"GET"] && ![metrics.httpMethod isEqualToString:@"HEAD"];
+    return [task continueWithBlock:^id(OSSTask *sentTask) {
+        if (mayChangeObject) {
+            [objectCache removeEntryForKey:[self objectCacheKeyForBucketName:metrics.bucketName objectKey:metrics.objectKey]];
+        }
+        metrics.totalDuration = -[metrics.startDate timeIntervalSinceNow];
+        metrics.error = sentTask.error;
+        if ([sentTask.result isKindOfClass:[OSSResult class]]) {
+            OSSResult * result = sentTask.result;
+            metrics.requestId = result.requestId;
+            result.metrics = metrics;
+        }
+        if (metricsHandler) {
+            metricsHandler(metrics);
+        }
+        return sentTask;
+    }];
 }
 
 #pragma implement restful apis
@@ -189,6 +417,10 @@ static NSObject * lock;
     return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
 }
 
+- (OSSBucketListIterator *)bucketListIteratorWithRequest:(OSSGetBucketRequest *)request {
+    return [[OSSBucketListIterator alloc] initWithClient:self request:request];
+}
+
 - (OSSTask *)getBucketACL:(OSSGetBucketACLRequest *)request {
     OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
 
@@ -210,7 +442,31 @@ static NSObject * lock;
 }
 
 - (OSSTask *)headObject:(OSSHeadObjectRequest *)request {
-    OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
+    id<NSCopying> coalescingKey = [self coalescingKeyOfRequest:request
+                                                    httpMethod:@"HEAD"
+                                                    bucketName:request.bucketName
+                                                     objectKey:request.objectKey
+                                                         range:nil
+                                                   xOssProcess:nil];
+    if (!coalescingKey) {
+        return [self headObject:request requestDelegate:request.requestDelegate];
+    }
+    return [self.requestCoalescer taskForKey:coalescingKey caller:request.requestDelegate downloadProgress:nil startFlight:^OSSTask *(OSSNetworkingRequestDelegate *flightDelegate) {
+        return [self headObject:request requestDelegate:flightDelegate];
+    }];
+}
+
+- (OSSTask *)headObject:(OSSHeadObjectRequest *)request requestDelegate:(OSSNetworkingRequestDelegate *)requestDelegate {
+    OSSObjectCache * objectCache = self.clientConfiguration.objectCache;
+    NSString * cacheKey = [self objectCacheKeyForBucketName:request.bucketName objectKey:request.objectKey];
+    OSSObjectCacheEntry * cachedEntry = [objectCache entryForKey:cacheKey];
+    if (cachedEntry && [objectCache isEntryFresh:cachedEntry]) {
+        OSSHeadObjectResult * result = [OSSHeadObjectResult new];
+        result.httpResponseCode = 200;
+        result.httpResponseHeaderFields = cachedEntry.httpResponseHeaderFields;
+        result.objectMeta = cachedEntry.objectMeta;
+        return [OSSTask taskWithResult:result];
+    }
 
     requestDelegate.responseParser = [[OSSHttpResponseParser alloc] initForOperationType:OSSOperationTypeHeadObject];
     requestDelegate.allNeededMessage = [[OSSAllRequestNeededMessage alloc] initWithEndpoint:self.endpoint
@@ -225,18 +481,156 @@ static NSObject * lock;
                                                     querys:nil sha1:nil];
     requestDelegate.operType = OSSOperationTypeHeadObject;
 
-    return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
+    OSSTask * task = [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
+    if (!objectCache) {
+        return task;
+    }
+    return [task continueWithBlock:^id(OSSTask *headTask) {
+        if (headTask.result) {
+            OSSHeadObjectResult * result = headTask.result;
+            [objectCache storeHttpResponseHeaderFields:result.httpResponseHeaderFields
+                                            objectMeta:result.objectMeta
+                                                  data:nil
+                                                forKey:cacheKey];
+        } else if ([self isServerError:headTask.error withStatusCode:404]) {
+            [objectCache removeEntryForKey:cacheKey];
+        }
+        return headTask;
+    }];
+}
+
+- (OSSTask *)headMultipleObjects:(OSSHeadMultipleObjectsRequest *)request {
+    if (![request.bucketName oss_isNotEmpty] || request.keys.count == 0) {
+        NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                             code:OSSClientErrorCodeInvalidArgument
+                                         userInfo:@{OSSErrorMessageTOKEN: @"bucketName and keys should not be empty!"}];
+        return [OSSTask taskWithError:error];
+    }
+
+    return [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
+        /* a key asked twice is sent once */
+        NSArray<NSString *> *keys = [[NSOrderedSet orderedSetWithArray:request.keys] array];
+        NSUInteger concurrentCount = MAX(request.concurrentRequestCount, 1);
+        dispatch_semaphore_t windowSemaphore = dispatch_semaphore_create(concurrentCount);
+        dispatch_group_t group = dispatch_group_create();
+        NSHashTable<OSSRequest *> *runningChildrenRequests = request.runningChildrenRequests;
+        NSObject *resultLock = [NSObject new];
+
+        NSMutableDictionary<NSString *, OSSHeadObjectResult *> *headObjectResults = [NSMutableDictionary dictionary];
+        NSMutableArray<NSString *> *missingObjects = [NSMutableArray array];
+        NSMutableDictionary<NSString *, NSError *> *failedObjects = [NSMutableDictionary dictionary];
+        __block NSError *firstError = nil;
+
+        for (NSString *key in keys) {
+            dispatch_semaphore_wait(windowSemaphore, DISPATCH_TIME_FOREVER);
+            if (request.isCancelled) {
+                dispatch_semaphore_signal(windowSemaphore);
+                break;
+            }
+
+            OSSHeadObjectRequest *headRequest = [OSSHeadObjectRequest new];
+            headRequest.bucketName = request.bucketName;
+            headRequest.objectKey = key;
+            headRequest.isAuthenticationRequired = request.isAuthenticationRequired;
+
+            @synchronized(runningChildrenRequests) {
+                [runningChildrenRequests addObject:headRequest];
+            }
+            dispatch_group_enter(group);
+            [[self headObject:headRequest] continueWithBlock:^id(OSSTask *headTask) {
+                @synchronized(runningChildrenRequests) {
+                    [runningChildrenRequests removeObject:headRequest];
+                }
+                @synchronized(resultLock) {
+                    if (headTask.result) {
+                        headObjectResults[key] = headTask.result;
+                    } else if ([self isServerError:headTask.error withStatusCode:404]) {
+                        [missingObjects addObject:key];
+                    } else {
+                        OSSLogError(@"head object %@ of bucket %@ failed: %@", key, headRequest.bucketName, headTask.error);
+                        firstError = firstError ?: headTask.error;
+                        failedObjects[key] = headTask.error;
+                    }
+                }
+                dispatch_semaphore_signal(windowSemaphore);
+                dispatch_group_leave(group);
+                return nil;
+            }];
+        }
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+        if (request.isCancelled) {
+            NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                                 code:OSSClientErrorCodeTaskCancelled
+                                             userInfo:@{OSSErrorMessageTOKEN: @"This task is cancelled!"}];
+            return [OSSTask taskWithError:error];
+        }
+        if (failedObjects.count == keys.count) {
+            return [OSSTask taskWithError:firstError];
+        }
+
+        OSSHeadMultipleObjectsResult *result = [OSSHeadMultipleObjectsResult new];
+        result.httpResponseCode = 200;
+        result.headObjectResults = [headObjectResults copy];
+        result.missingObjects = [missingObjects copy];
+        result.failedObjects = [failedObjects copy];
+        return [OSSTask taskWithResult:result];
+    }];
 }
 
 - (OSSTask *)getObject:(OSSGetObjectRequest *)request {
-    OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
+    id<NSCopying> coalescingKey = nil;
+    // a read into a caller's buffer, file or data block can't be shared
+    if (!request.downloadToFileURL && !request.onRecieveData && !request.downloadBuffer && request.maxDownloadedDataLength == 0) {
+        coalescingKey = [self coalescingKeyOfRequest:request
+                                          httpMethod:@"GET"
+                                          bucketName:request.bucketName
+                                           objectKey:request.objectKey
+                                               range:[request.range toHeaderString]
+                                         xOssProcess:request.xOssProcess];
+    }
+    if (!coalescingKey) {
+        return [self getObject:request requestDelegate:request.requestDelegate];
+    }
+    OSSNetworkingDownloadProgressBlock downloadProgress = nil;
+    if (request.downloadProgress) {
+        downloadProgress = [self progressBlockForRequest:request progress:request.downloadProgress];
+    }
+    return [self.requestCoalescer taskForKey:coalescingKey caller:request.requestDelegate downloadProgress:downloadProgress startFlight:^OSSTask *(OSSNetworkingRequestDelegate *flightDelegate) {
+        return [self getObject:request requestDelegate:flightDelegate];
+    }];
+}
+
+- (OSSTask *)getObject:(OSSGetObjectRequest *)request requestDelegate:(OSSNetworkingRequestDelegate *)requestDelegate {
+    /* only whole objects received in memory are cached */
+    OSSObjectCache * objectCache = self.clientConfiguration.objectCache;
+    if (request.range || request.xOssProcess || request.onRecieveData || request.downloadToFileURL) {
+        objectCache = nil;
+    }
+    NSString * cacheKey = [self objectCacheKeyForBucketName:request.bucketName objectKey:request.objectKey];
+    OSSObjectCacheEntry * cachedEntry = [objectCache entryForKey:cacheKey];
+    NSData * cachedData = cachedEntry.hasData ? [objectCache dataForKey:cacheKey] : nil;
+    if (cachedData && [objectCache isEntryFresh:cachedEntry]) {
+        return [OSSTask taskWithResult:[self getObjectResultOfCacheEntry:cachedEntry data:cachedData request:request httpResponseCode:200]];
+    }
+    NSMutableDictionary * headerParams = nil;
+    if (cachedData) {
+        headerParams = [NSMutableDictionary dictionary];
+        if (cachedEntry.eTag) {
+            [headerParams setObject:cachedEntry.eTag forKey:@"If-None-Match"];
+        }
+        if (cachedEntry.lastModified) {
+            [headerParams setObject:cachedEntry.lastModified forKey:@"If-Modified-Since"];
+        }
+    }
 
     NSString * rangeString = nil;
     if (request.range) {
         rangeString = [request.range toHeaderString];
     }
-    if (request.downloadProgress) {
-        requestDelegate.downloadProgress = request.downloadProgress;
+    // the progress of a coalesced read is set by the coalescer, for every caller
+    if (request.downloadProgress && requestDelegate == request.requestDelegate) {
+        requestDelegate.downloadProgress = [self progressBlockForRequest:request progress:request.downloadProgress];
     }
     if (request.onRecieveData) {
         requestDelegate.onRecieveData = request.onRecieveData;
@@ -252,6 +646,8 @@ static NSObject * lock;
     
     requestDelegate.responseParser = responseParser;
     requestDelegate.responseParser.downloadingFileURL = request.downloadToFileURL;
+    requestDelegate.responseParser.collectingBuffer = request.downloadBuffer;
+    requestDelegate.responseParser.maxCollectingDataLength = request.maxDownloadedDataLength;
     requestDelegate.allNeededMessage = [[OSSAllRequestNeededMessage alloc] initWithEndpoint:self.endpoint
                                                 httpMethod:@"GET"
                                                 bucketName:request.bucketName
@@ -260,14 +656,77 @@ static NSObject * lock;
                                                        md5:nil
                                                      range:rangeString
                                                       date:[[NSDate oss_clockSkewFixedDate] oss_asStringValue]
-                                              headerParams:nil
+                                              headerParams:headerParams
                                                     querys:querys sha1:nil];
     requestDelegate.operType = OSSOperationTypeGetObject;
 
-    return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
+    OSSTask * task = [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
+    if (!objectCache) {
+        return task;
+    }
+    return [task continueWithBlock:^id(OSSTask *getTask) {
+        if (cachedData && [self isServerError:getTask.error withStatusCode:304]) {
+            // revalidated, the cached content is still the object's
+            [objectCache storeHttpResponseHeaderFields:cachedEntry.httpResponseHeaderFields
+                                            objectMeta:cachedEntry.objectMeta
+                                                  data:nil
+                                                forKey:cacheKey];
+            return [OSSTask taskWithResult:[self getObjectResultOfCacheEntry:cachedEntry data:cachedData request:request httpResponseCode:304]];
+        }
+        if (getTask.result) {
+            OSSGetObjectResult * result = getTask.result;
+            [objectCache storeHttpResponseHeaderFields:result.httpResponseHeaderFields
+                                            objectMeta:result.objectMeta
+                                                  data:result.downloadedData
+                                                forKey:cacheKey];
+        } else if ([self isServerError:getTask.error withStatusCode:404]) {
+            [objectCache removeEntryForKey:cacheKey];
+        }
+        return getTask;
+    }];
+}
+
+- (OSSObjectReader *)objectReaderWithBucketName:(NSString *)bucketName
+                                      objectKey:(NSString *)objectKey
+                                      directory:(NSString *)directory {
+    return [[OSSObjectReader alloc] initWithClient:self bucketName:bucketName objectKey:objectKey directory:directory];
+}
+
+- (OSSImagePipeline *)imagePipelineWithBucketName:(NSString *)bucketName
+                                        directory:(NSString *)directory {
+    return [[OSSImagePipeline alloc] initWithClient:self bucketName:bucketName directory:directory];
 }
 
 - (OSSTask *)putObject:(OSSPutObjectRequest *)request
+{
+    if (!request.skipsUnchangedObject || request.contentCompression != OSSContentCompressionNone
+        || (!request.uploadingData && !request.uploadingFileURL)) {
+        return [self sendPutObject:request];
+    }
+    return [[self headObjectUnchangedByRequest:request
+                                    bucketName:request.bucketName
+                                     objectKey:request.objectKey
+                              uploadingFileURL:request.uploadingFileURL
+                                 uploadingData:request.uploadingData] continueWithBlock:^id(OSSTask *headTask) {
+        if (headTask.error) {
+            return headTask;
+        }
+        OSSHeadObjectResult * headResult = headTask.result;
+        if (!headResult) {
+            return [self sendPutObject:request];
+        }
+        OSSPutObjectResult * result = [OSSPutObjectResult new];
+        result.requestId = headResult.requestId;
+        result.httpResponseCode = headResult.httpResponseCode;
+        result.httpResponseHeaderFields = headResult.httpResponseHeaderFields;
+        result.remoteCRC64ecma = headResult.remoteCRC64ecma;
+        result.eTag = headResult.objectMeta[@"Etag"];
+        result.isSkipped = YES;
+        return [OSSTask taskWithResult:result];
+    }];
+}
+
+- (OSSTask *)sendPutObject:(OSSPutObjectRequest *)request
 {
     OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
     NSMutableDictionary * headerParams = [NSMutableDictionary dictionaryWithDictionary:request.objectMeta];
@@ -277,13 +736,38 @@ static NSObject * lock;
         requestDelegate.uploadingData = request.uploadingData;
         if (requestDelegate.crc64Verifiable)
         {
-            NSMutableData *mutableData = [NSMutableData dataWithData:request.uploadingData];
-            requestDelegate.contentCRC = [NSString stringWithFormat:@"%llu",[mutableData oss_crc64]];
+            // computed on the body in place, copying it would double the memory it takes
+            uint64_t crc64 = [OSSUtil crc64ecma:0 buffer:(void *)request.uploadingData.bytes length:request.uploadingData.length];
+            requestDelegate.contentCRC = [NSString stringWithFormat:@"%llu", crc64];
         }
     }
     if (request.uploadingFileURL) {
         requestDelegate.uploadingFileURL = request.uploadingFileURL;
     }
+    if (request.uploadingInputStream || request.uploadingDataProducer) {
+        OSSStreamingBody *body = nil;
+        if (request.contentCompression != OSSContentCompressionNone) {
+            // compressed on the thread filling the body stream, the crc64 is the one of the bytes sent
+            OSSUploadDataProducerBlock producer = request.uploadingInputStream
+                ? [OSSContentCompressor producerCompressingInputStream:request.uploadingInputStream compression:request.contentCompression]
+                : [OSSContentCompressor producerCompressingProducer:request.uploadingDataProducer compression:request.contentCompression];
+            body = [[OSSStreamingBody alloc] initWithProducer:producer];
+        } else {
+            body = request.uploadingInputStream ? [[OSSStreamingBody alloc] initWithInputStream:request.uploadingInputStream]
+                                                : [[OSSStreamingBody alloc] initWithProducer:request.uploadingDataProducer];
+        }
+        if (requestDelegate.crc64Verifiable) {
+            // the body is over before the response comes, which is when the crc is checked
+            __weak OSSStreamingBody *weakBody = body;
+            __weak OSSNetworkingRequestDelegate *weakDelegate = requestDelegate;
+            body.completion = ^(NSError *error) {
+                if (!error) {
+                    weakDelegate.contentCRC = [NSString stringWithFormat:@"%llu", weakBody.crc64];
+                }
+            };
+        }
+        requestDelegate.uploadingBody = body;
+    }
     if (request.callbackParam) {
         [headerParams setObject:[request.callbackParam base64JsonString] forKey:OSSHttpHeaderXOSSCallback];
     }
@@ -291,7 +775,7 @@ static NSObject * lock;
         [headerParams setObject:[request.callbackVar base64JsonString] forKey:OSSHttpHeaderXOSSCallbackVar];
     }
     if (request.uploadProgress) {
-        requestDelegate.uploadProgress = request.uploadProgress;
+        requestDelegate.uploadProgress = [self progressBlockForRequest:request progress:request.uploadProgress];
     }
     if (request.uploadRetryCallback) {
         requestDelegate.retryCallback = request.uploadRetryCallback;
@@ -302,6 +786,10 @@ static NSObject * lock;
     if (request.contentEncoding) {
         [headerParams setObject:request.contentEncoding forKey:OSSHttpHeaderContentEncoding];
     }
+    if (request.contentCompression != OSSContentCompressionNone) {
+        [headerParams setObject:request.contentCompression == OSSContentCompressionGzip ? @"gzip" : @"deflate"
+                         forKey:OSSHttpHeaderContentEncoding];
+    }
     if (request.expires) {
         [headerParams setObject:request.expires forKey:OSSHttpHeaderExpires];
     }
@@ -321,6 +809,9 @@ static NSObject * lock;
                                                                                headerParams:headerParams querys:nil sha1:request.contentSHA1];
     requestDelegate.operType = OSSOperationTypePutObject;
     
+    if (request.contentCompression != OSSContentCompressionNone) {
+        return [self invokeRequest:requestDelegate compressingBodyWith:request.contentCompression requireAuthentication:request.isAuthenticationRequired];
+    }
     return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
 }
 
@@ -371,15 +862,16 @@ static NSObject * lock;
         requestDelegate.uploadingData = request.uploadingData;
         if (requestDelegate.crc64Verifiable)
         {
-            NSMutableData *mutableData = [NSMutableData dataWithData:request.uploadingData];
-            requestDelegate.contentCRC = [NSString stringWithFormat:@"%llu",[mutableData oss_crc64]];
+            // computed on the body in place, copying it would double the memory it takes
+            uint64_t crc64 = [OSSUtil crc64ecma:0 buffer:(void *)request.uploadingData.bytes length:request.uploadingData.length];
+            requestDelegate.contentCRC = [NSString stringWithFormat:@"%llu", crc64];
         }
     }
     if (request.uploadingFileURL) {
         requestDelegate.uploadingFileURL = request.uploadingFileURL;
     }
     if (request.uploadProgress) {
-        requestDelegate.uploadProgress = request.uploadProgress;
+        requestDelegate.uploadProgress = [self progressBlockForRequest:request progress:request.uploadProgress];
     }
     if (request.contentDisposition) {
         [headerParams setObject:request.contentDisposition forKey:OSSHttpHeaderContentDisposition];
@@ -415,6 +907,13 @@ static NSObject * lock;
     return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
 }
 
+- (OSSObjectAppender *)objectAppenderWithBucketName:(NSString *)bucketName
+                                          objectKey:(NSString *)objectKey
+                                           position:(int64_t)position
+                                          crc64ecma:(NSString *)crc64ecma {
+    return [[OSSObjectAppender alloc] initWithClient:self bucketName:bucketName objectKey:objectKey position:position crc64ecma:crc64ecma];
+}
+
 - (OSSTask *)deleteObject:(OSSDeleteObjectRequest *)request {
     OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
 
@@ -434,12 +933,99 @@ static NSObject * lock;
     return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
 }
 
+- (OSSTask *)deleteMultipleObjects:(OSSDeleteMultipleObjectsRequest *)request {
+    if (![request.bucketName oss_isNotEmpty] || request.keys.count == 0) {
+        NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                             code:OSSClientErrorCodeInvalidArgument
+                                         userInfo:@{OSSErrorMessageTOKEN: @"bucketName and keys should not be empty!"}];
+        return [OSSTask taskWithError:error];
+    }
+
+    return [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
+        NSUInteger batchCount = (request.keys.count + OSSDeleteMultipleObjectsMaxKeys - 1) / OSSDeleteMultipleObjectsMaxKeys;
+        NSUInteger concurrentCount = MAX(request.concurrentRequestCount, 1);
+        dispatch_semaphore_t windowSemaphore = dispatch_semaphore_create(concurrentCount);
+        dispatch_group_t group = dispatch_group_create();
+        NSHashTable<OSSRequest *> *runningChildrenRequests = request.runningChildrenRequests;
+        NSObject *resultLock = [NSObject new];
+
+        NSMutableArray<NSString *> *deletedObjects = [NSMutableArray array];
+        NSMutableDictionary<NSString *, NSError *> *failedObjects = [NSMutableDictionary dictionary];
+        __block OSSDeleteMultipleObjectsResult *firstResult = nil;
+        __block NSError *firstError = nil;
+
+        for (NSUInteger batch = 0; batch < batchCount; batch++) {
+            dispatch_semaphore_wait(windowSemaphore, DISPATCH_TIME_FOREVER);
+            if (request.isCancelled) {
+                dispatch_semaphore_signal(windowSemaphore);
+                break;
+            }
+
+            NSRange range = NSMakeRange(batch * OSSDeleteMultipleObjectsMaxKeys, MIN(OSSDeleteMultipleObjectsMaxKeys, request.keys.count - batch * OSSDeleteMultipleObjectsMaxKeys));
+            NSArray<NSString *> *keys = [request.keys subarrayWithRange:range];
+            OSSDeleteMultipleObjectsRequest *batchRequest = [OSSDeleteMultipleObjectsRequest new];
+            batchRequest.bucketName = request.bucketName;
+            batchRequest.keys = keys;
+            batchRequest.quiet = request.quiet;
+            batchRequest.isAuthenticationRequired = request.isAuthenticationRequired;
+
+            @synchronized(runningChildrenRequests) {
+                [runningChildrenRequests addObject:batchRequest];
+            }
+            dispatch_group_enter(group);
+            [[self deleteObjectsInBatch:batchRequest] continueWithBlock:^id(OSSTask *batchTask) {
+                @synchronized(runningChildrenRequests) {
+                    [runningChildrenRequests removeObject:batchRequest];
+                }
+                for (NSString *key in keys) {
+                    [self.clientConfiguration.objectCache removeEntryForKey:[self objectCacheKeyForBucketName:batchRequest.bucketName objectKey:key]];
+                }
+                @synchronized(resultLock) {
+                    if (batchTask.error) {
+                        OSSLogError(@"delete %lu objects of bucket %@ failed: %@", (unsigned long)keys.count, batchRequest.bucketName, batchTask.error);
+                        firstError = firstError ?: batchTask.error;
+                        for (NSString *key in keys) {
+                            failedObjects[key] = batchTask.error;
+                        }
+                    } else {
+                        OSSDeleteMultipleObjectsResult *batchResult = batchTask.result;
+                        firstResult = firstResult ?: batchResult;
+                        [deletedObjects addObjectsFromArray:batchResult.deletedObjects];
+                    }
+                }
+                dispatch_semaphore_signal(windowSemaphore);
+                dispatch_group_leave(group);
+                return nil;
+            }];
+        }
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+        if (request.isCancelled) {
+            NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                                 code:OSSClientErrorCodeTaskCancelled
+                                             userInfo:@{OSSErrorMessageTOKEN: @"This task is cancelled!"}];
+            return [OSSTask taskWithError:error];
+        }
+        if (!firstResult) {
+            return [OSSTask taskWithError:firstError];
+        }
+
+        OSSDeleteMultipleObjectsResult *result = [OSSDeleteMultipleObjectsResult new];
+        result.httpResponseCode = firstResult.httpResponseCode;
+        result.httpResponseHeaderFields = firstResult.httpResponseHeaderFields;
+        result.requestId = firstResult.requestId;
+        result.deletedObjects = [deletedObjects copy];
+        result.failedObjects = [failedObjects copy];
+        return [OSSTask taskWithResult:result];
+    }];
+}
+
 - (OSSTask *)copyObject:(OSSCopyObjectRequest *)request {
     OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
     NSMutableDictionary * headerParams = [NSMutableDictionary dictionaryWithDictionary:request.objectMeta];
 
     if (request.sourceCopyFrom) {
-        [headerParams setObject:request.sourceCopyFrom forKey:@"x-oss-copy-source"];
+        [headerParams setObject:request.sourceCopyFrom forKey:OSSHttpHeaderCopySource];
     }
     requestDelegate.responseParser = [[OSSHttpResponseParser alloc] initForOperationType:OSSOperationTypeCopyObject];
     requestDelegate.allNeededMessage = [[OSSAllRequestNeededMessage alloc] initWithEndpoint:self.endpoint
@@ -457,6 +1043,148 @@ static NSObject * lock;
     return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
 }
 
+- (OSSTask *)multipartCopy:(OSSMultipartCopyRequest *)request {
+    OSSTask *preTask = [self checkMultipartCopyRequest:request];
+    if (preTask) {
+        return preTask;
+    }
+
+    return [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
+        OSSHeadObjectRequest *headRequest = [OSSHeadObjectRequest new];
+        headRequest.bucketName = request.sourceBucketName;
+        headRequest.objectKey = request.sourceObjectKey;
+        OSSTask *headTask = [self headObject:headRequest];
+        [headTask waitUntilFinished];
+        if (headTask.error) {
+            return headTask;
+        }
+        NSDictionary *sourceMeta = ((OSSHeadObjectResult *)headTask.result).objectMeta;
+        unsigned long long objectSize = [sourceMeta[@"Content-Length"] longLongValue];
+        NSString *sourceETag = sourceMeta[@"Etag"];
+        if (objectSize == 0) {
+            // no part can be copied from an empty object
+            return [self copyEmptyObjectForMultipartCopy:request];
+        }
+
+        NSUInteger partSize = request.partSize;
+        if ((objectSize + partSize - 1) / partSize > oss_multipart_max_part_number) {
+            partSize = (NSUInteger)((objectSize + oss_multipart_max_part_number - 1) / oss_multipart_max_part_number);
+        }
+        NSUInteger partCount = (NSUInteger)((objectSize + partSize - 1) / partSize);
+        OSSProgressReporter *progressReporter = [OSSProgressReporter reporterWithRequest:request progress:request.copyProgress];
+
+        /* the record is named after the source object's version, a modified source isn't resumed */
+        NSString *recordFilePath = [self multipartCopyRecordPathWithRequest:request sourceETag:sourceETag partSize:partSize];
+        NSString *uploadId = nil;
+        if (recordFilePath) {
+            NSData *recordData = [NSData dataWithContentsOfFile:recordFilePath];
+            uploadId = recordData ? [[NSString alloc] initWithData:recordData encoding:NSUTF8StringEncoding] : nil;
+        }
+
+        NSMutableArray<OSSPartInfo *> *partInfos = [NSMutableArray array];
+        NSMutableIndexSet *partNumbers = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(1, partCount)];
+        int64_t copiedLength = 0;
+        if ([uploadId oss_isNotEmpty]) {
+            OSSTask *listPartsTask = [self processListPartsWithObjectKey:request.objectKey
+                                                                  bucket:request.bucketName
+                                                                uploadId:uploadId
+                                                               totalSize:(NSUInteger)objectSize
+                                                                partSize:partSize];
+            [listPartsTask waitUntilFinished];
+            if (listPartsTask.error) {
+                return listPartsTask;
+            }
+            OSSListPartsResult *listPartsResult = listPartsTask.result;
+            if (!listPartsResult) {
+                uploadId = nil;
+            }
+            for (NSDictionary *part in listPartsResult.parts) {
+                int32_t partNumber = [part[OSSPartNumberXMLTOKEN] intValue];
+                int64_t size = [part[OSSSizeXMLTOKEN] longLongValue];
+                [partInfos addObject:[OSSPartInfo partInfoWithPartNum:partNumber eTag:part[OSSETagXMLTOKEN] size:size crc64:0]];
+                [partNumbers removeIndex:partNumber];
+                copiedLength += size;
+            }
+        }
+        if (copiedLength > 0) {
+            [progressReporter reportBytes:0 totalBytes:copiedLength totalBytesExpected:objectSize];
+        }
+
+        if (![uploadId oss_isNotEmpty]) {
+            OSSInitMultipartUploadRequest *initRequest = [OSSInitMultipartUploadRequest new];
+            initRequest.bucketName = request.bucketName;
+            initRequest.objectKey = request.objectKey;
+            initRequest.contentType = request.contentType;
+            initRequest.objectMeta = request.objectMeta;
+            OSSTask *initTask = [self processResumableInitMultipartUpload:initRequest recordFilePath:recordFilePath];
+            [initTask waitUntilFinished];
+            if (initTask.error) {
+                return initTask;
+            }
+            uploadId = ((OSSInitMultipartUploadResult *)initTask.result).uploadId;
+        }
+
+        OSSTask *errorTask = [self copyParts:partNumbers
+                                   ofRequest:request
+                                    uploadId:uploadId
+                                  objectSize:objectSize
+                                    partSize:partSize
+                                  sourceETag:sourceETag
+                                   partInfos:partInfos
+                                copiedLength:copiedLength
+                            progressReporter:progressReporter];
+        [progressReporter flush];
+        if (errorTask) {
+            // a recorded upload is kept to be resumed, unless the copy is cancelled and asked to delete it
+            if (!recordFilePath || (request.isCancelled && request.deleteUploadIdOnCancelling)) {
+                if (recordFilePath) {
+                    [[NSFileManager defaultManager] removeItemAtPath:recordFilePath error:nil];
+                }
+                OSSAbortMultipartUploadRequest *abort = [OSSAbortMultipartUploadRequest new];
+                abort.bucketName = request.bucketName;
+                abort.objectKey = request.objectKey;
+                abort.uploadId = uploadId;
+                [[self abortMultipartUpload:abort] waitUntilFinished];
+            }
+            return errorTask;
+        }
+
+        [partInfos sortUsingComparator:^NSComparisonResult(OSSPartInfo *part1, OSSPartInfo *part2) {
+            return part1.partNum < part2.partNum ? NSOrderedAscending : (part1.partNum > part2.partNum ? NSOrderedDescending : NSOrderedSame);
+        }];
+        OSSCompleteMultipartUploadRequest *complete = [OSSCompleteMultipartUploadRequest new];
+        complete.bucketName = request.bucketName;
+        complete.objectKey = request.objectKey;
+        complete.uploadId = uploadId;
+        complete.partInfos = partInfos;
+        OSSTask *completeTask = [self completeMultipartUpload:complete];
+        [completeTask waitUntilFinished];
+        if (completeTask.error) {
+            return completeTask;
+        }
+        if (recordFilePath) {
+            [[NSFileManager defaultManager] removeItemAtPath:recordFilePath error:nil];
+        }
+
+        OSSCompleteMultipartUploadResult *completeResult = completeTask.result;
+        NSString *sourceCRC64ecma = sourceMeta[@"x-oss-hash-crc64ecma"];
+        if (request.crcFlag != OSSRequestCRCClosed && [sourceCRC64ecma oss_isNotEmpty] && [completeResult.remoteCRC64ecma oss_isNotEmpty]
+            && ![sourceCRC64ecma isEqualToString:completeResult.remoteCRC64ecma]) {
+            NSString *errorMessage = [NSString stringWithFormat:@"source_crc64(%@) is not equal to remote_crc64(%@)!", sourceCRC64ecma, completeResult.remoteCRC64ecma];
+            return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                              code:OSSClientErrorCodeInvalidCRC
+                                                          userInfo:@{OSSErrorMessageTOKEN: errorMessage}]];
+        }
+
+        OSSMultipartCopyResult *result = [OSSMultipartCopyResult new];
+        result.requestId = completeResult.requestId;
+        result.httpResponseCode = completeResult.httpResponseCode;
+        result.httpResponseHeaderFields = completeResult.httpResponseHeaderFields;
+        result.eTag = completeResult.eTag;
+        return [OSSTask taskWithResult:result];
+    }];
+}
+
 - (OSSTask *)multipartUploadInit:(OSSInitMultipartUploadRequest *)request {
     OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
     NSMutableDictionary * headerParams = [NSMutableDictionary dictionaryWithDictionary:request.objectMeta];
@@ -502,17 +1230,18 @@ static NSObject * lock;
     [self enableCRC64WithFlag:request.crcFlag requestDelegate:requestDelegate];
     if (request.uploadPartData) {
         requestDelegate.uploadingData = request.uploadPartData;
-        if (requestDelegate.crc64Verifiable)
+        // multipart upload has already computed it together with the part md5
+        if (requestDelegate.crc64Verifiable && !requestDelegate.contentCRC.oss_isNotEmpty)
         {
-            NSMutableData *mutableData = [NSMutableData dataWithData:request.uploadPartData];
-            requestDelegate.contentCRC = [NSString stringWithFormat:@"%llu",[mutableData oss_crc64]];
+            uint64_t crc64 = [OSSUtil crc64ecma:0 buffer:(void *)request.uploadPartData.bytes length:request.uploadPartData.length];
+            requestDelegate.contentCRC = [NSString stringWithFormat:@"%llu", crc64];
         }
     }
     if (request.uploadPartFileURL) {
         requestDelegate.uploadingFileURL = request.uploadPartFileURL;
     }
     if (request.uploadPartProgress) {
-        requestDelegate.uploadProgress = request.uploadPartProgress;
+        requestDelegate.uploadProgress = [self progressBlockForRequest:request progress:request.uploadPartProgress];
     }
 
     OSSHttpResponseParser *responseParser = [[OSSHttpResponseParser alloc] initForOperationType:OSSOperationTypeUploadPart];
@@ -531,6 +1260,39 @@ static NSObject * lock;
                                                     querys:querys sha1:request.contentSHA1];
     requestDelegate.operType = OSSOperationTypeUploadPart;
 
+    if (request.contentCompression != OSSContentCompressionNone) {
+        return [self invokeRequest:requestDelegate compressingBodyWith:request.contentCompression requireAuthentication:request.isAuthenticationRequired];
+    }
+    return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
+}
+
+- (OSSTask *)uploadPartCopy:(OSSUploadPartCopyRequest *)request {
+    OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
+    NSMutableDictionary * querys = [NSMutableDictionary dictionaryWithObjectsAndKeys:[@(request.partNumber) stringValue], @"partNumber",
+                                    request.uploadId, @"uploadId", nil];
+    NSMutableDictionary * headerParams = [NSMutableDictionary dictionary];
+    NSString * copySource = [NSString stringWithFormat:@"/%@/%@", request.sourceBucketName, [OSSUtil encodeURL:request.sourceObjectKey]];
+    [headerParams setObject:copySource forKey:OSSHttpHeaderCopySource];
+    if (request.sourceCopyRange) {
+        [headerParams setObject:[request.sourceCopyRange toHeaderString] forKey:OSSHttpHeaderCopySourceRange];
+    }
+    if (request.sourceCopyIfMatch) {
+        [headerParams setObject:request.sourceCopyIfMatch forKey:OSSHttpHeaderCopySourceIfMatch];
+    }
+
+    requestDelegate.responseParser = [[OSSHttpResponseParser alloc] initForOperationType:OSSOperationTypeUploadPartCopy];
+    requestDelegate.allNeededMessage = [[OSSAllRequestNeededMessage alloc] initWithEndpoint:self.endpoint
+                                                httpMethod:@"PUT"
+                                                bucketName:request.bucketName
+                                                 objectKey:request.objectKey
+                                                      type:nil
+                                                       md5:nil
+                                                     range:nil
+                                                      date:[[NSDate oss_clockSkewFixedDate] oss_asStringValue]
+                                              headerParams:headerParams
+                                                    querys:querys sha1:nil];
+    requestDelegate.operType = OSSOperationTypeUploadPartCopy;
+
     return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
 }
 
@@ -575,6 +1337,12 @@ static NSObject * lock;
     OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
 
     NSMutableDictionary * querys = [NSMutableDictionary dictionaryWithObjectsAndKeys:request.uploadId, @"uploadId", nil];
+    if (request.maxParts > 0) {
+        [querys setObject:[@(request.maxParts) stringValue] forKey:@"max-parts"];
+    }
+    if (request.partNumberMarker > 0) {
+        [querys setObject:[@(request.partNumberMarker) stringValue] forKey:@"part-number-marker"];
+    }
     requestDelegate.responseParser = [[OSSHttpResponseParser alloc] initForOperationType:OSSOperationTypeListMultipart];
     requestDelegate.allNeededMessage = [[OSSAllRequestNeededMessage alloc] initWithEndpoint:self.endpoint
                                                 httpMethod:@"GET"
@@ -635,7 +1403,7 @@ static NSObject * lock;
         NSString *recordFileName = [OSSUtil dataMD5String:data];
         NSString *recordFilePath = [NSString stringWithFormat:@"%@/%@",resumableRequest.recordDirectoryPath,recordFileName];
         NSFileManager *fileManager = [NSFileManager defaultManager];
-        NSString *partInfosFilePath = [[[NSString oss_documentDirectory] stringByAppendingPathComponent:oss_partInfos_storage_name] stringByAppendingPathComponent:resumableRequest.uploadId];
+        NSString *partInfosFilePath = [self partInfosJournalPathWithUploadId:resumableRequest.uploadId];
         
         if([fileManager fileExistsAtPath:recordFilePath])
         {
@@ -676,6 +1444,18 @@ static NSObject * lock;
     return errorTask;
 }
 
+- (BOOL)handleEventsForBackgroundURLSession:(NSString *)identifier completionHandler:(void (^)(void))completionHandler {
+    OSSNetworking * networking = self.networking;
+    if (!networking.isUsingBackgroundSession
+        || ![networking.uploadFileSession.configuration.identifier isEqualToString:identifier]) {
+        return NO;
+    }
+    @synchronized(networking) {
+        networking.backgroundSessionCompletionHandler = completionHandler;
+    }
+    return YES;
+}
+
 - (OSSTask *)presignConstrainURLWithBucketName:(NSString *)bucketName
                                  withObjectKey:(NSString *)objectKey
                         withExpirationInterval:(NSTimeInterval)interval {
@@ -691,10 +1471,21 @@ static NSObject * lock;
                         withExpirationInterval:(NSTimeInterval)interval
                                 withParameters:(NSDictionary *)parameters {
 
+    return [[self presignConstrainURLsWithBucketName:bucketName
+                                      withObjectKeys:@[objectKey ?: @""]
+                              withExpirationInterval:interval
+                                      withParameters:parameters] continueWithSuccessBlock:^id(OSSTask *task) {
+        return [task.result firstObject];
+    }];
+}
+
+- (OSSTask *)presignConstrainURLsWithBucketName:(NSString *)bucketName
+                                 withObjectKeys:(NSArray<NSString *> *)objectKeys
+                         withExpirationInterval:(NSTimeInterval)interval
+                                 withParameters:(NSDictionary *)parameters {
+
     return [[OSSTask taskWithResult:nil] continueWithBlock:^id(OSSTask *task) {
-        NSString * resource = [NSString stringWithFormat:@"/%@/%@", bucketName, objectKey];
         NSString * expires = [@((int64_t)[[NSDate oss_clockSkewFixedDate] timeIntervalSince1970] + interval) stringValue];
-        NSString * wholeSign = nil;
         OSSFederationToken * token = nil;
         NSError * error = nil;
         NSMutableDictionary * params = [NSMutableDictionary new];
@@ -703,6 +1494,8 @@ static NSObject * lock;
             [params addEntriesFromDictionary:parameters];
         }
 
+        BOOL isSignedWithToken = [self.credentialProvider isKindOfClass:[OSSFederationCredentialProvider class]]
+                                 || [self.credentialProvider isKindOfClass:[OSSStsTokenCredentialProvider class]];
         if ([self.credentialProvider isKindOfClass:[OSSFederationCredentialProvider class]]) {
             token = [(OSSFederationCredentialProvider *)self.credentialProvider getToken:&error];
             if (error) {
@@ -711,54 +1504,67 @@ static NSObject * lock;
         } else if ([self.credentialProvider isKindOfClass:[OSSStsTokenCredentialProvider class]]) {
             token = [(OSSStsTokenCredentialProvider *)self.credentialProvider getToken];
         }
-
-        if ([self.credentialProvider isKindOfClass:[OSSFederationCredentialProvider class]]
-            || [self.credentialProvider isKindOfClass:[OSSStsTokenCredentialProvider class]]) {
-            if (token.tToken) {
-                [params setObject:token.tToken forKey:@"security-token"];
-            }
-            resource = [NSString stringWithFormat:@"%@?%@", resource, [OSSUtil populateSubresourceStringFromParameter:params]];
-            NSString * string2sign = [NSString stringWithFormat:@"GET\n\n\n%@\n%@", expires, resource];
-            wholeSign = [OSSUtil sign:string2sign withToken:token];
-        } else {
-            NSString * subresource = [OSSUtil populateSubresourceStringFromParameter:params];
-            if ([subresource length] > 0) {
-                resource = [NSString stringWithFormat:@"%@?%@", resource, [OSSUtil populateSubresourceStringFromParameter:params]];
-            }
-            NSString * string2sign = [NSString stringWithFormat:@"GET\n\n\n%@\n%@", expires, resource];
-            wholeSign = [self.credentialProvider sign:string2sign error:&error];
-            if (error) {
-                return [OSSTask taskWithError:error];
-            }
+        if (isSignedWithToken && token.tToken) {
+            [params setObject:token.tToken forKey:@"security-token"];
         }
 
-        NSArray * splitResult = [wholeSign componentsSeparatedByString:@":"];
-        if ([splitResult count] != 2
-            || ![((NSString *)[splitResult objectAtIndex:0]) hasPrefix:@"OSS "]) {
-            return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
-                                                             code:OSSClientErrorCodeSignFailed
-                                                         userInfo:@{OSSErrorMessageTOKEN: @"the returned signature is invalid"}]];
-        }
-        NSString * accessKey = [(NSString *)[splitResult objectAtIndex:0] substringFromIndex:4];
-        NSString * signature = [splitResult objectAtIndex:1];
+        // everything but the object key is the same for all the URLs
+        NSString * subresource = [OSSUtil populateSubresourceStringFromParameter:params];
+        NSString * resourceSuffix = [subresource length] > 0 ? [@"?" stringByAppendingString:subresource] : @"";
+        NSString * string2signPrefix = [NSString stringWithFormat:@"GET\n\n\n%@\n/%@/", expires, bucketName];
 
         NSURL * endpointURL = [NSURL URLWithString:self.endpoint];
         NSString * host = endpointURL.host;
         if ([OSSUtil isOssOriginBucketHost:host]) {
             host = [NSString stringWithFormat:@"%@.%@", bucketName, host];
         }
-        [params setObject:signature forKey:@"Signature"];
-        [params setObject:accessKey forKey:@"OSSAccessKeyId"];
-        [params setObject:expires forKey:@"Expires"];
-        NSString * stringURL = [NSString stringWithFormat:@"%@://%@/%@?%@",
-                                endpointURL.scheme,
-                                host,
-                                [OSSUtil encodeURL:objectKey],
-                                [OSSUtil populateQueryStringFromParameter:params]];
-        return [OSSTask taskWithResult:stringURL];
-    }];
-}
-
+        NSString * urlPrefix = [NSString stringWithFormat:@"%@://%@/", endpointURL.scheme, host];
+        NSString * queryString = [OSSUtil populateQueryStringFromParameter:params];
+
+        NSMutableArray<NSString *> * urls = [NSMutableArray arrayWithCapacity:objectKeys.count];
+        for (NSString * objectKey in objectKeys) {
+            NSString * string2sign = [NSString stringWithFormat:@"%@%@%@", string2signPrefix, objectKey, resourceSuffix];
+            NSString * accessKey = nil;
+            NSString * signature = nil;
+            if (isSignedWithToken) {
+                accessKey = token.tAccessKey;
+                signature = [OSSUtil calBase64Sha1WithData:string2sign withSecret:token.tSecretKey];
+            } else {
+                NSString * wholeSign = [self.credentialProvider sign:string2sign error:&error];
+                if (error) {
+                    return [OSSTask taskWithError:error];
+                }
+                NSArray * splitResult = [wholeSign componentsSeparatedByString:@":"];
+                if ([splitResult count] != 2
+                    || ![((NSString *)[splitResult objectAtIndex:0]) hasPrefix:@"OSS "]) {
+                    return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                                     code:OSSClientErrorCodeSignFailed
+                                                                 userInfo:@{OSSErrorMessageTOKEN: @"the returned signature is invalid"}]];
+                }
+                accessKey = [(NSString *)[splitResult objectAtIndex:0] substringFromIndex:4];
+                signature = [splitResult objectAtIndex:1];
+            }
+
+            NSMutableString * stringURL = [NSMutableString stringWithCapacity:urlPrefix.length + objectKey.length * 3 + queryString.length + 128];
+            [stringURL appendString:urlPrefix];
+            [OSSUtil appendEncodedURL:objectKey toString:stringURL];
+            [stringURL appendString:@"?"];
+            if ([queryString length] > 0) {
+                [stringURL appendString:queryString];
+                [stringURL appendString:@"&"];
+            }
+            [stringURL appendString:@"OSSAccessKeyId="];
+            [OSSUtil appendEncodedURL:accessKey toString:stringURL];
+            [stringURL appendString:@"&Expires="];
+            [stringURL appendString:expires];
+            [stringURL appendString:@"&Signature="];
+            [OSSUtil appendEncodedURL:signature toString:stringURL];
+            [urls addObject:stringURL];
+        }
+        return [OSSTask taskWithResult:urls];
+    }];
+}
+
 - (OSSTask *)presignPublicURLWithBucketName:(NSString *)bucketName
                               withObjectKey:(NSString *)objectKey {
 
@@ -798,6 +1604,68 @@ static NSObject * lock;
     return [self multipartUpload: request resumable: NO sequential: NO];
 }
 
+- (OSSTask *)streamingMultipartUpload:(OSSStreamingMultipartUploadRequest *)request
+{
+    OSSTask *preTask = nil;
+    if (!request.uploadingInputStream && !request.uploadingDataProducer) {
+        NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                             code:OSSClientErrorCodeInvalidArgument
+                                         userInfo:@{OSSErrorMessageTOKEN: @"Please set the request's uploadingInputStream or uploadingDataProducer!"}];
+        preTask = [OSSTask taskWithError:error];
+    } else if (![request.objectKey oss_isNotEmpty] || ![request.bucketName oss_isNotEmpty]) {
+        NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                             code:OSSClientErrorCodeInvalidArgument
+                                         userInfo:@{OSSErrorMessageTOKEN: @"streamingMultipartUpload requires nonnull bucketName and objectKey!"}];
+        preTask = [OSSTask taskWithError:error];
+    } else {
+        preTask = [self checkPartSizeForRequest:request];
+    }
+    if (preTask) {
+        return preTask;
+    }
+    [self checkRequestCrc64Setting:request];
+    
+    return [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
+        OSSInitMultipartUploadRequest *initRequest = [OSSInitMultipartUploadRequest new];
+        initRequest.bucketName = request.bucketName;
+        initRequest.objectKey = request.objectKey;
+        initRequest.contentType = request.contentType;
+        initRequest.objectMeta = request.completeMetaHeader;
+        initRequest.crcFlag = request.crcFlag;
+        
+        return [[self multipartUploadInit:initRequest] continueWithExecutor:self.ossOperationExecutor withSuccessBlock:^id(OSSTask *initTask) {
+            request.uploadId = ((OSSInitMultipartUploadResult *)initTask.result).uploadId;
+            
+            OSSStreamingBody *body = request.uploadingInputStream ? [[OSSStreamingBody alloc] initWithInputStream:request.uploadingInputStream]
+                                                                  : [[OSSStreamingBody alloc] initWithProducer:request.uploadingDataProducer];
+            NSMutableArray<OSSPartInfo *> *partInfos = [NSMutableArray array];
+            OSSProgressReporter *progressReporter = [OSSProgressReporter reporterWithRequest:request progress:request.uploadProgress];
+            OSSTask *uploadPartsTask = [self uploadPartsOfStreamingBody:body request:request partInfos:partInfos progressReporter:progressReporter];
+            return [uploadPartsTask continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *partsTask) {
+                [progressReporter flush];
+                if (request.backgroundPartTransfer) {
+                    [self removeSlicesWithUploadId:request.uploadId];
+                }
+                if (partsTask.error) {
+                    return [[self abortMultipartUpload:request sequential:NO resumable:NO] continueWithBlock:^id(OSSTask *abortTask) {
+                        return partsTask;
+                    }];
+                }
+                
+                [partInfos sortUsingComparator:^NSComparisonResult(OSSPartInfo *part1, OSSPartInfo *part2) {
+                    return part1.partNum < part2.partNum ? NSOrderedAscending : (part1.partNum > part2.partNum ? NSOrderedDescending : NSOrderedSame);
+                }];
+                // the crc64 of the whole body is computed as it's read, no need to combine the parts'
+                return [self processCompleteMultipartUpload:request
+                                                  partInfos:partInfos
+                                                clientCrc64:body.crc64
+                                             recordFilePath:nil
+                                         localPartInfosPath:nil];
+            }];
+        }];
+    }];
+}
+
 - (OSSTask *)processCompleteMultipartUpload:(OSSMultipartUploadRequest *)request partInfos:(NSArray<OSSPartInfo *> *)partInfos clientCrc64:(uint64_t)clientCrc64 recordFilePath:(NSString *)recordFilePath localPartInfosPath:(NSString *)localPartInfosPath
 {
     OSSCompleteMultipartUploadRequest * complete = [OSSCompleteMultipartUploadRequest new];
@@ -818,59 +1686,58 @@ static NSObject * lock;
         complete.callbackVar = request.callbackVar;
     }
     
-    OSSTask * completeTask = [self completeMultipartUpload:complete];
-    [completeTask waitUntilFinished];
-    
-    if (completeTask.error) {
-        OSSLogVerbose(@"completeTask.error %@: ",completeTask.error);
-        return completeTask;
-    } else
-    {
-        if(recordFilePath && [[NSFileManager defaultManager] fileExistsAtPath:recordFilePath])
+    return [[self completeMultipartUpload:complete] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *completeTask) {
+        if (completeTask.error) {
+            OSSLogVerbose(@"completeTask.error %@: ",completeTask.error);
+            return completeTask;
+        } else
         {
-            NSError *deleteError;
-            if (![[NSFileManager defaultManager] removeItemAtPath:recordFilePath error:&deleteError])
+            if(recordFilePath && [[NSFileManager defaultManager] fileExistsAtPath:recordFilePath])
             {
-                OSSLogError(@"delete localUploadIdPath failed!Error: %@",deleteError);
+                NSError *deleteError;
+                if (![[NSFileManager defaultManager] removeItemAtPath:recordFilePath error:&deleteError])
+                {
+                    OSSLogError(@"delete localUploadIdPath failed!Error: %@",deleteError);
+                }
             }
-        }
-        
-        if (localPartInfosPath && [[NSFileManager defaultManager] fileExistsAtPath:localPartInfosPath])
-        {
-            NSError *deleteError;
-            if (![[NSFileManager defaultManager] removeItemAtPath:localPartInfosPath error:&deleteError])
+            
+            if (localPartInfosPath && [[NSFileManager defaultManager] fileExistsAtPath:localPartInfosPath])
             {
-                OSSLogError(@"delete localPartInfosPath failed!Error: %@",deleteError);
+                NSError *deleteError;
+                if (![[NSFileManager defaultManager] removeItemAtPath:localPartInfosPath error:&deleteError])
+                {
+                    OSSLogError(@"delete localPartInfosPath failed!Error: %@",deleteError);
+                }
             }
-        }
-        OSSCompleteMultipartUploadResult * completeResult = completeTask.result;
-        if (complete.crcFlag == OSSRequestCRCOpen && completeResult.remoteCRC64ecma)
-        {
-            uint64_t remote_crc64 = 0;
-            NSScanner *scanner = [NSScanner scannerWithString:completeResult.remoteCRC64ecma];
-            if ([scanner scanUnsignedLongLong:&remote_crc64])
+            OSSCompleteMultipartUploadResult * completeResult = completeTask.result;
+            if (complete.crcFlag == OSSRequestCRCOpen && completeResult.remoteCRC64ecma)
             {
-                OSSLogVerbose(@"resumableUpload local_crc64 %llu",clientCrc64);
-                OSSLogVerbose(@"resumableUpload remote_crc64 %llu", remote_crc64);
-                if (remote_crc64 != clientCrc64)
+                uint64_t remote_crc64 = 0;
+                NSScanner *scanner = [NSScanner scannerWithString:completeResult.remoteCRC64ecma];
+                if ([scanner scanUnsignedLongLong:&remote_crc64])
                 {
-                    NSString *errorMessage = [NSString stringWithFormat:@"local_crc64(%llu) is not equal to remote_crc64(%llu)!",clientCrc64,remote_crc64];
-                    NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
-                                                         code:OSSClientErrorCodeInvalidCRC
-                                                     userInfo:@{OSSErrorMessageTOKEN:errorMessage}];
-                    return [OSSTask taskWithError:error];
+                    OSSLogVerbose(@"resumableUpload local_crc64 %llu",clientCrc64);
+                    OSSLogVerbose(@"resumableUpload remote_crc64 %llu", remote_crc64);
+                    if (remote_crc64 != clientCrc64)
+                    {
+                        NSString *errorMessage = [NSString stringWithFormat:@"local_crc64(%llu) is not equal to remote_crc64(%llu)!",clientCrc64,remote_crc64];
+                        NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                                             code:OSSClientErrorCodeInvalidCRC
+                                                         userInfo:@{OSSErrorMessageTOKEN:errorMessage}];
+                        return [OSSTask taskWithError:error];
+                    }
                 }
             }
+            
+            OSSResumableUploadResult * result = [OSSResumableUploadResult new];
+            result.requestId = completeResult.requestId;
+            result.httpResponseCode = completeResult.httpResponseCode;
+            result.httpResponseHeaderFields = completeResult.httpResponseHeaderFields;
+            result.serverReturnJsonString = completeResult.serverReturnJsonString;
+            
+            return [OSSTask taskWithResult:result];
         }
-        
-        OSSResumableUploadResult * result = [OSSResumableUploadResult new];
-        result.requestId = completeResult.requestId;
-        result.httpResponseCode = completeResult.httpResponseCode;
-        result.httpResponseHeaderFields = completeResult.httpResponseHeaderFields;
-        result.serverReturnJsonString = completeResult.serverReturnJsonString;
-        
-        return [OSSTask taskWithResult:result];
-    }
+    }];
 }
 
 
@@ -879,39 +1746,58 @@ static NSObject * lock;
     return [self multipartUpload: request resumable: YES sequential: NO];
 }
 
-- (OSSTask *)processListPartsWithObjectKey:(nonnull NSString *)objectKey bucket:(nonnull NSString *)bucket uploadId:(NSString * _Nonnull *)uploadId uploadedParts:(nonnull NSMutableArray *)uploadedParts uploadedLength:(NSUInteger *)uploadedLength totalSize:(NSUInteger)totalSize partSize:(NSUInteger)partSize
+/**
+ * lists the following pages while the result is truncated, the task result is the last page holding the parts of all of them
+ */
+- (OSSTask *)listAllParts:(OSSListPartsRequest *)request parts:(NSMutableArray *)parts
+{
+    return [[self listParts:request] continueWithExecutor:self.ossOperationExecutor withSuccessBlock:^id(OSSTask *task) {
+        OSSListPartsResult * result = task.result;
+        if (result.parts) {
+            [parts addObjectsFromArray:result.parts];
+        }
+        // a marker which doesn't move on would list the same page forever
+        if (result.isTruncated && result.nextPartNumberMarker > request.partNumberMarker) {
+            OSSListPartsRequest * nextRequest = [OSSListPartsRequest new];
+            nextRequest.bucketName = request.bucketName;
+            nextRequest.objectKey = request.objectKey;
+            nextRequest.uploadId = request.uploadId;
+            nextRequest.maxParts = request.maxParts;
+            nextRequest.partNumberMarker = result.nextPartNumberMarker;
+            return [self listAllParts:nextRequest parts:parts];
+        }
+        result.parts = parts;
+        return result;
+    }];
+}
+
+/**
+ * the task result is the OSSListPartsResult of all the parts, nil when the upload recorded was deleted on the server
+ */
+- (OSSTask *)processListPartsWithObjectKey:(nonnull NSString *)objectKey bucket:(nonnull NSString *)bucket uploadId:(nonnull NSString *)uploadId totalSize:(NSUInteger)totalSize partSize:(NSUInteger)partSize
 {
     OSSListPartsRequest * listParts = [OSSListPartsRequest new];
     listParts.bucketName = bucket;
     listParts.objectKey = objectKey;
-    listParts.uploadId = *uploadId;
-    OSSTask * listPartsTask = [self listParts:listParts];
-    [listPartsTask waitUntilFinished];
-    if (listPartsTask.error)
-    {
-        if ([listPartsTask.error.domain isEqualToString: OSSServerErrorDomain] && listPartsTask.error.code == -1 * 404)
-        {
-            OSSLogVerbose(@"local record existes but the remote record is deleted");
-            *uploadId = nil;
-        } else
+    listParts.uploadId = uploadId;
+    listParts.maxParts = 1000;
+    return [[self listAllParts:listParts parts:[NSMutableArray array]] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *listPartsTask) {
+        if (listPartsTask.error)
         {
+            if ([listPartsTask.error.domain isEqualToString: OSSServerErrorDomain] && listPartsTask.error.code == -1 * 404)
+            {
+                OSSLogVerbose(@"local record existes but the remote record is deleted");
+                return nil;
+            }
             return listPartsTask;
         }
-    }
-    else
-    {
+        
         OSSLogVerbose(@"resumableUpload listpart ok");
         OSSListPartsResult * result = listPartsTask.result;
-        if (result.parts.count) {
-            [uploadedParts addObjectsFromArray:result.parts];
-        }
         __block NSUInteger firstPartSize = 0;
         __block NSUInteger bUploadedLength = 0;
-        [uploadedParts enumerateObjectsUsingBlock:^(NSDictionary *part, NSUInteger idx, BOOL * _Nonnull stop) {
-            unsigned long long iPartSize = 0;
-            NSString *partSizeString = [part objectForKey:OSSSizeXMLTOKEN];
-            NSScanner *scanner = [NSScanner scannerWithString:partSizeString];
-            [scanner scanUnsignedLongLong:&iPartSize];
+        [result.parts enumerateObjectsUsingBlock:^(NSDictionary *part, NSUInteger idx, BOOL * _Nonnull stop) {
+            unsigned long long iPartSize = [[part objectForKey:OSSSizeXMLTOKEN] longLongValue];
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wshorten-64-to-32"
             bUploadedLength += iPartSize;
@@ -921,7 +1807,6 @@ static NSObject * lock;
             }
 #pragma clang diagnostic pop
         }];
-        *uploadedLength = bUploadedLength;
         
         if (totalSize < bUploadedLength)
         {
@@ -935,175 +1820,81 @@ static NSObject * lock;
                                                               code:OSSClientErrorCodeCannotResumeUpload
                                                           userInfo:@{OSSErrorMessageTOKEN: @"The part size setting is inconsistent with before"}]];
         }
-    }
-    return nil;
+        return listPartsTask;
+    }];
 }
 
 - (OSSTask *)processResumableInitMultipartUpload:(OSSInitMultipartUploadRequest *)request recordFilePath:(NSString *)recordFilePath
 {
-    OSSTask *task = [self multipartUploadInit:request];
-    [task waitUntilFinished];
-    
-    if(task.result && [recordFilePath oss_isNotEmpty])
-    {
-        OSSInitMultipartUploadResult *result = task.result;
-        if (![result.uploadId oss_isNotEmpty])
-        {
-            NSString *errorMessage = [NSString stringWithFormat:@"Can not get uploadId!"];
-            NSError *error = [NSError errorWithDomain:OSSServerErrorDomain
-                                                 code:OSSClientErrorCodeNilUploadid userInfo:@{OSSErrorMessageTOKEN:   errorMessage}];
-            return [OSSTask taskWithError:error];
-        }
-        
-        NSFileManager *defaultFM = [NSFileManager defaultManager];
-        if (![defaultFM fileExistsAtPath:recordFilePath])
+    return [[self multipartUploadInit:request] continueWithExecutor:self.ossOperationExecutor withSuccessBlock:^id(OSSTask *task) {
+        if([recordFilePath oss_isNotEmpty])
         {
-            if (![defaultFM createFileAtPath:recordFilePath contents:nil attributes:nil]) {
-                NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
-                                                     code:OSSClientErrorCodeFileCantWrite
-                                                 userInfo:@{OSSErrorMessageTOKEN: @"uploadId for this task can't be stored persistentially!"}];
-                OSSLogDebug(@"[Error]: %@", error);
+            OSSInitMultipartUploadResult *result = task.result;
+            if (![result.uploadId oss_isNotEmpty])
+            {
+                NSString *errorMessage = [NSString stringWithFormat:@"Can not get uploadId!"];
+                NSError *error = [NSError errorWithDomain:OSSServerErrorDomain
+                                                     code:OSSClientErrorCodeNilUploadid userInfo:@{OSSErrorMessageTOKEN:   errorMessage}];
                 return [OSSTask taskWithError:error];
             }
+            
+            NSFileManager *defaultFM = [NSFileManager defaultManager];
+            if (![defaultFM fileExistsAtPath:recordFilePath])
+            {
+                if (![defaultFM createFileAtPath:recordFilePath contents:nil attributes:nil]) {
+                    NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                                         code:OSSClientErrorCodeFileCantWrite
+                                                     userInfo:@{OSSErrorMessageTOKEN: @"uploadId for this task can't be stored persistentially!"}];
+                    OSSLogDebug(@"[Error]: %@", error);
+                    return [OSSTask taskWithError:error];
+                }
+            }
+            NSFileHandle * write = [NSFileHandle fileHandleForWritingAtPath:recordFilePath];
+            [write writeData:[result.uploadId dataUsingEncoding:NSUTF8StringEncoding]];
+            [write closeFile];
         }
-        NSFileHandle * write = [NSFileHandle fileHandleForWritingAtPath:recordFilePath];
-        [write writeData:[result.uploadId dataUsingEncoding:NSUTF8StringEncoding]];
-        [write closeFile];
-    }
-    return task;
+        return task;
+    }];
 }
 
 - (OSSTask *)upload:(OSSMultipartUploadRequest *)request
-        uploadIndex:(NSMutableArray *)alreadyUploadIndex
+        uploadIndex:(NSArray *)alreadyUploadIndex
          uploadPart:(NSMutableArray *)alreadyUploadPart
               count:(NSUInteger)partCout
-     uploadedLength:(NSUInteger *)uploadedLength
+     uploadedLength:(NSUInteger)uploadedLength
            fileSize:(unsigned long long)uploadFileSize
+   progressReporter:(OSSProgressReporter *)progressReporter
 {
-    NSOperationQueue *queue = [[NSOperationQueue alloc] init];
-    [queue setMaxConcurrentOperationCount: 5];
-    
-    OSSRequestCRCFlag crcFlag = request.crcFlag;
-    __block BOOL isCancel = NO;
-    __block OSSTask *errorTask;
-    __block NSMutableDictionary *localPartInfos = nil;
-    
-    if (crcFlag == OSSRequestCRCOpen) {
-        localPartInfos = [self localPartInfosDictoryWithUploadId:request.uploadId];
-    }
-    
-    if (!localPartInfos) {
-        localPartInfos = [NSMutableDictionary dictionary];
-    }
-    
-    NSInputStream *inputStream = [NSInputStream inputStreamWithURL:request.uploadingFileURL];
-    [inputStream open];
-    
-    NSData * uploadPartData;
-    NSInteger realPartLength = request.partSize;
-    
-    for (int i = 1; i <= partCout; i++) {
-        // if current transport is sequential and has error occurs,stop upload and return error!
-        if (isCancel) {
-            errorTask = [OSSTask taskWithError:[OSSClient cancelError]];
-            break;
-        }
-        @autoreleasepool{
-            if (i == partCout) {
-                realPartLength = uploadFileSize - request.partSize * (i - 1);
-            }
-            NSMutableData *myBuffer = [NSMutableData dataWithLength:realPartLength];
-            uint8_t *buffer = [myBuffer mutableBytes];
-            NSInteger length = [inputStream read:buffer maxLength:realPartLength];
-            uploadPartData = [NSData dataWithBytes:buffer length:length];
-        
-            if (![inputStream hasBytesAvailable]) {
-                [inputStream close];
-            }
-            //alreadyUploadIndex 为空 return false
-            if (alreadyUploadIndex && [alreadyUploadIndex containsObject:@(i)]) {
-                continue;
-            }
-            
-            NSBlockOperation * operation = [[NSBlockOperation alloc] init];
-            [operation addExecutionBlock:^{
-                @autoreleasepool {
-                    if (request.isCancelled) {
-                        @synchronized(lock){
-                            if(!isCancel){
-                                isCancel = YES;
-                                [queue cancelAllOperations];
-                            }
-                        }
-                    }else{
-                        OSSUploadPartRequest * uploadPart = [OSSUploadPartRequest new];
-                        uploadPart.bucketName = request.bucketName;
-                        uploadPart.objectkey = request.objectKey;
-                        uploadPart.partNumber = i;
-                        uploadPart.uploadId = request.uploadId;
-                        uploadPart.uploadPartData = uploadPartData;
-                        uploadPart.contentMd5 = [OSSUtil base64Md5ForData:uploadPartData];
-                        uploadPart.crcFlag = request.crcFlag;
-                        
-                        OSSTask * uploadPartTask = [self uploadPart:uploadPart];
-                        [uploadPartTask waitUntilFinished];
-                        if (uploadPartTask.error && uploadPartTask.error.code != 409) {
-                            errorTask = uploadPartTask;
-                        } else {
-                            OSSUploadPartResult * result = uploadPartTask.result;
-                            OSSPartInfo * partInfo = [OSSPartInfo new];
-                            partInfo.partNum = i;
-                            partInfo.eTag = result.eTag;
-                            partInfo.size = realPartLength;
-                            uint64_t crc64OfPart;
-                            @try {
-                                NSScanner *scanner = [NSScanner scannerWithString:result.remoteCRC64ecma];
-                                [scanner scanUnsignedLongLong:&crc64OfPart];
-                                partInfo.crc64 = crc64OfPart;
-                            } @catch (NSException *exception) {
-                                OSSLogError(@"multipart upload error with nil remote crc64!");
-                            }
-                            
-                            @synchronized(lock){
-                                [alreadyUploadPart addObject:partInfo];
-                                
-                                if (crcFlag == OSSRequestCRCOpen)
-                                {
-                                    [self processForLocalPartInfos:localPartInfos
-                                                          partInfo:partInfo
-                                                          uploadId:request.uploadId];
-                                    [self persistencePartInfos:localPartInfos
-                                                  withUploadId:request.uploadId];
-                                }
-                                
-                                *uploadedLength += realPartLength;
-                                if (request.uploadProgress)
-                                {
-                                    request.uploadProgress(realPartLength, *uploadedLength, uploadFileSize);
-                                }
-                            }
-                        }
-                    }
-                }
-            }];
-            [queue addOperation:operation];
-            
-            if (queue.operationCount >= 5) {
-                [queue waitUntilAllOperationsAreFinished];
-            }
-        }
-    }
-    [queue waitUntilAllOperationsAreFinished];
-    
-    return errorTask;
+    // sliding window: a slot is taken before a part is read and given back once the part is sent
+    OSSPartScheduler *scheduler = [self partSchedulerForRequest:request];
+    return [self uploadFileParts:request
+                       scheduler:scheduler
+                         inOrder:NO
+                     uploadIndex:alreadyUploadIndex
+                      uploadPart:alreadyUploadPart
+                           count:partCout
+                  uploadedLength:uploadedLength
+                        fileSize:uploadFileSize
+                progressReporter:progressReporter];
 }
 
-- (void)processForLocalPartInfos:(NSMutableDictionary *)localPartInfoDict partInfo:(OSSPartInfo *)partInfo uploadId:(NSString *)uploadId
+- (OSSTask *)uploadPartsOfStreamingBody:(OSSStreamingBody *)body
+                                request:(OSSStreamingMultipartUploadRequest *)request
+                              partInfos:(NSMutableArray<OSSPartInfo *> *)partInfos
+                       progressReporter:(OSSProgressReporter *)progressReporter
 {
-    NSDictionary *partInfoDict = [partInfo entityToDictionary];
-    NSString *keyString = [NSString stringWithFormat:@"%zi",partInfo.partNum];
-    [localPartInfoDict setObject:partInfoDict
-                          forKey:keyString];
+    OSSPartScheduler *scheduler = [self partSchedulerForRequest:request];
+    // the total length is unknown, so the parts keep the size asked for
+    scheduler.adaptsPartSize = NO;
+    
+    OSSMultipartPartsUpload *partsUpload = [OSSMultipartPartsUpload new];
+    partsUpload.request = request;
+    partsUpload.scheduler = scheduler;
+    partsUpload.progressReporter = progressReporter;
+    partsUpload.body = body;
+    partsUpload.maxPartCount = oss_multipart_max_part_number;
+    partsUpload.partInfos = partInfos;
+    return [self uploadParts:partsUpload];
 }
 
 - (BOOL)doesObjectExistInBucket:(NSString *)bucketName
@@ -1136,6 +1927,33 @@ static NSObject * lock;
 }
             
 - (OSSTask *)multipartUpload:(OSSMultipartUploadRequest *)request resumable:(BOOL)resumable sequential:(BOOL)sequential
+{
+    if (!request.skipsUnchangedObject || !request.uploadingFileURL) {
+        return [self sendMultipartUpload:request resumable:resumable sequential:sequential];
+    }
+    return [[self headObjectUnchangedByRequest:request
+                                    bucketName:request.bucketName
+                                     objectKey:request.objectKey
+                              uploadingFileURL:request.uploadingFileURL
+                                 uploadingData:nil] continueWithBlock:^id(OSSTask *headTask) {
+        if (headTask.error) {
+            return headTask;
+        }
+        OSSHeadObjectResult * headResult = headTask.result;
+        if (!headResult) {
+            return [self sendMultipartUpload:request resumable:resumable sequential:sequential];
+        }
+        OSSResumableUploadResult * result = [OSSResumableUploadResult new];
+        result.requestId = headResult.requestId;
+        result.httpResponseCode = headResult.httpResponseCode;
+        result.httpResponseHeaderFields = headResult.httpResponseHeaderFields;
+        result.remoteCRC64ecma = headResult.remoteCRC64ecma;
+        result.isSkipped = YES;
+        return [OSSTask taskWithResult:result];
+    }];
+}
+
+- (OSSTask *)sendMultipartUpload:(OSSMultipartUploadRequest *)request resumable:(BOOL)resumable sequential:(BOOL)sequential
 {
     if (resumable) {
         if (![request isKindOfClass:[OSSResumableUploadRequest class]]) {
@@ -1152,11 +1970,11 @@ static NSObject * lock;
         return preTask;
     }
     
+    // every step continues the task of the previous one, no thread waits for a request
     return [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
         
-        static NSUInteger uploadedLength = 0;
-        uploadedLength = 0;
-        __block OSSTask * errorTask;
+        OSSProgressReporter *progressReporter = [OSSProgressReporter reporterWithRequest:request progress:request.uploadProgress];
+        __block NSUInteger uploadedLength = 0;
         __block NSString *uploadId;
         
         NSError *error;
@@ -1172,18 +1990,15 @@ static NSObject * lock;
         }
         
         NSString *recordFilePath = nil;
-        NSMutableArray * uploadedPart = [NSMutableArray array];
-        NSString *localPartInfosPath = nil;
         NSDictionary *localPartInfos = nil;
         
         NSMutableArray<OSSPartInfo *> *uploadedPartInfos = [NSMutableArray array];
         NSMutableArray * alreadyUploadIndex = [NSMutableArray array];
+        OSSTask *listPartsTask = [OSSTask taskWithResult:nil];
         
         if (resumable) {
             OSSResumableUploadRequest *resumableRequest = (OSSResumableUploadRequest *)request;
             NSString *recordDirectoryPath = resumableRequest.recordDirectoryPath;
-            localPartInfosPath = [[[NSString oss_documentDirectory] stringByAppendingPathComponent:oss_partInfos_storage_name] stringByAppendingPathComponent:uploadId];
-            localPartInfos = [NSDictionary dictionaryWithContentsOfFile:localPartInfosPath];
             if ([recordDirectoryPath oss_isNotEmpty]) {
                 uploadId = [self readUploadIdWithFilePath: request.uploadingFileURL.path
                                                recordPath: recordDirectoryPath
@@ -1198,34 +2013,27 @@ static NSObject * lock;
             
             if(uploadId.oss_isNotEmpty)
             {
-                NSString *localPartInfosPath = [NSString oss_documentDirectory];
-                localPartInfosPath = [[localPartInfosPath stringByAppendingPathComponent:oss_partInfos_storage_name] stringByAppendingPathComponent:uploadId];
-                
-                localPartInfos = [[NSDictionary alloc] initWithContentsOfURL:[NSURL fileURLWithPath:localPartInfosPath]];
+                localPartInfos = [self localPartInfosDictoryWithUploadId:uploadId];
                 
-                OSSTask *listPartTask = [self processListPartsWithObjectKey:request.objectKey
-                                                                     bucket:request.bucketName
-                                                                   uploadId:&uploadId
-                                                              uploadedParts:uploadedPart
-                                                             uploadedLength:&uploadedLength
-                                                                  totalSize:uploadFileSize
-                                                                   partSize:request.partSize];
-                if (listPartTask.error)
-                {
-                    return listPartTask;
-                }
+                listPartsTask = [self processListPartsWithObjectKey:request.objectKey
+                                                             bucket:request.bucketName
+                                                           uploadId:uploadId
+                                                          totalSize:uploadFileSize
+                                                           partSize:request.partSize];
+            }
+        }
+        
+        return [[listPartsTask continueWithExecutor:self.ossOperationExecutor withSuccessBlock:^id(OSSTask *listTask) {
+            OSSListPartsResult *listPartsResult = listTask.result;
+            if (!listPartsResult) {
+                // nothing recorded, or the recorded upload is gone
+                uploadId = nil;
             }
             
-            [uploadedPart enumerateObjectsUsingBlock:^(NSDictionary *partInfo, NSUInteger idx, BOOL * _Nonnull stop) {
-                unsigned long long iPartNum = 0;
+            [listPartsResult.parts enumerateObjectsUsingBlock:^(NSDictionary *partInfo, NSUInteger idx, BOOL * _Nonnull stop) {
                 NSString *partNumberString = [partInfo objectForKey:OSSPartNumberXMLTOKEN];
-                NSScanner *scanner = [NSScanner scannerWithString:partNumberString];
-                [scanner scanUnsignedLongLong:&iPartNum];
-                
-                unsigned long long iPartSize = 0;
-                NSString *partSizeString = [partInfo objectForKey:OSSSizeXMLTOKEN];
-                scanner = [NSScanner scannerWithString:partSizeString];
-                [scanner scanUnsignedLongLong:&iPartSize];
+                unsigned long long iPartNum = [partNumberString longLongValue];
+                unsigned long long iPartSize = [[partInfo objectForKey:OSSSizeXMLTOKEN] longLongValue];
                 
                 NSString *eTag = [partInfo objectForKey:OSSETagXMLTOKEN];
                 
@@ -1236,9 +2044,10 @@ static NSObject * lock;
                                                                  eTag:eTag
                                                                  size:iPartSize
                                                                 crc64:0];
+                uploadedLength += iPartSize;
 #pragma clang diagnostic pop
                 
-                NSDictionary *tPartInfo = [localPartInfos objectForKey:[NSString stringWithFormat:@"%zi",iPartNum]];
+                NSDictionary *tPartInfo = [localPartInfos objectForKey:partNumberString];
                 if (tPartInfo)
                 {
                     info.crc64 = [tPartInfo[@"crc64"] unsignedLongLongValue];
@@ -1248,12 +2057,13 @@ static NSObject * lock;
                 [alreadyUploadIndex addObject:@(info.partNum)];
             }];
             
-            if ([alreadyUploadIndex count] > 0 && request.uploadProgress && uploadFileSize) {
-                request.uploadProgress(0, uploadedLength, uploadFileSize);
+            if ([alreadyUploadIndex count] > 0 && uploadFileSize) {
+                [progressReporter reportBytes:0 totalBytes:uploadedLength totalBytesExpected:uploadFileSize];
+            }
+            
+            if ([uploadId oss_isNotEmpty]) {
+                return nil;
             }
-        }
-        
-        if (![uploadId oss_isNotEmpty]) {
             OSSInitMultipartUploadRequest *initRequest = [OSSInitMultipartUploadRequest new];
             initRequest.bucketName = request.bucketName;
             initRequest.objectKey = request.objectKey;
@@ -1262,94 +2072,294 @@ static NSObject * lock;
             initRequest.sequential = sequential;
             initRequest.crcFlag = request.crcFlag;
             
-            OSSTask *task = [self processResumableInitMultipartUpload:initRequest
-                                                       recordFilePath:recordFilePath];
-            if (task.error)
-            {
-                return task;
+            return [[self processResumableInitMultipartUpload:initRequest
+                                               recordFilePath:recordFilePath] continueWithSuccessBlock:^id(OSSTask *initTask) {
+                OSSInitMultipartUploadResult *initResult = (OSSInitMultipartUploadResult *)initTask.result;
+                uploadId = initResult.uploadId;
+                return nil;
+            }];
+        }] continueWithExecutor:self.ossOperationExecutor withSuccessBlock:^id(OSSTask *task) {
+            request.uploadId = uploadId;
+            NSString *localPartInfosPath = nil;
+            if (request.crcFlag == OSSRequestCRCOpen) {
+                localPartInfosPath = [self partInfosJournalPathWithUploadId:uploadId];
             }
-            OSSInitMultipartUploadResult *initResult = (OSSInitMultipartUploadResult *)task.result;
-            uploadId = initResult.uploadId;
-        }
-        
-        request.uploadId = uploadId;
-        if (request.isCancelled)
-        {
-            if(resumable)
+            if (request.isCancelled)
             {
-                OSSResumableUploadRequest *resumableRequest = (OSSResumableUploadRequest *)request;
-                if (resumableRequest.deleteUploadIdOnCancelling) {
-                    OSSTask *abortTask = [self abortMultipartUpload:request sequential:sequential resumable:resumable];
-                    [abortTask waitUntilFinished];
+                OSSTask *cancelTask = [OSSTask taskWithError:[OSSClient cancelError]];
+                if(resumable)
+                {
+                    OSSResumableUploadRequest *resumableRequest = (OSSResumableUploadRequest *)request;
+                    if (resumableRequest.deleteUploadIdOnCancelling) {
+                        return [[self abortMultipartUpload:request sequential:sequential resumable:resumable] continueWithBlock:^id(OSSTask *abortTask) {
+                            return cancelTask;
+                        }];
+                    }
                 }
+                
+                return cancelTask;
             }
             
-            return [OSSTask taskWithError:[OSSClient cancelError]];
+            OSSTask *partsTask = nil;
+            if (sequential) {
+                partsTask = [self sequentialUpload:request
+                                       uploadIndex:alreadyUploadIndex
+                                        uploadPart:uploadedPartInfos
+                                             count:partCount
+                                    uploadedLength:uploadedLength
+                                          fileSize:uploadFileSize
+                                  progressReporter:progressReporter];
+            } else {
+                partsTask = [self upload:request
+                             uploadIndex:alreadyUploadIndex
+                              uploadPart:uploadedPartInfos
+                                   count:partCount
+                          uploadedLength:uploadedLength
+                                fileSize:uploadFileSize
+                        progressReporter:progressReporter];
+            }
+            
+            return [partsTask continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *errorTask) {
+                [progressReporter flush];
+                if (request.backgroundPartTransfer) {
+                    [self removeSlicesWithUploadId:uploadId];
+                }
+                
+                if(errorTask.error)
+                {
+                    OSSTask *abortTask;
+                    if(resumable)
+                    {
+                        OSSResumableUploadRequest *resumableRequest = (OSSResumableUploadRequest *)request;
+                        if (resumableRequest.deleteUploadIdOnCancelling || errorTask.error.code == OSSClientErrorCodeFileCantWrite) {
+                            abortTask = [self abortMultipartUpload:request sequential:sequential resumable:resumable];
+                        }
+                    }else
+                    {
+                        abortTask =[self abortMultipartUpload:request sequential:sequential resumable:resumable];
+                    }
+                    
+                    if (!abortTask) {
+                        return errorTask;
+                    }
+                    return [abortTask continueWithBlock:^id(OSSTask *task) {
+                        return errorTask;
+                    }];
+                }
+                
+                [uploadedPartInfos sortUsingComparator:^NSComparisonResult(OSSPartInfo *part1,OSSPartInfo* part2) {
+                    if(part1.partNum < part2.partNum){
+                        return NSOrderedAscending;
+                    }else if(part1.partNum > part2.partNum){
+                        return NSOrderedDescending;
+                    }else{
+                        return NSOrderedSame;
+                    }
+                }];
+                
+                // 如果开启了crc64的校验
+                uint64_t local_crc64 = 0;
+                if (request.crcFlag == OSSRequestCRCOpen)
+                {
+                    for (NSUInteger index = 0; index< uploadedPartInfos.count; index++)
+                    {
+                        uint64_t partCrc64 = uploadedPartInfos[index].crc64;
+                        int64_t partSize = uploadedPartInfos[index].size;
+                        local_crc64 = [OSSUtil crc64ForCombineCRC1:local_crc64 CRC2:partCrc64 length:partSize];
+                    }
+                }
+                return [self processCompleteMultipartUpload:request
+                                                  partInfos:uploadedPartInfos
+                                                clientCrc64:local_crc64
+                                             recordFilePath:recordFilePath
+                                         localPartInfosPath:localPartInfosPath];
+            }];
+        }];
+    }];
+}
+
+- (OSSTask *)bulkUpload:(OSSBulkUploadRequest *)request
+{
+    NSString *errorMessage = nil;
+    if (![request.bucketName oss_isNotEmpty]) {
+        errorMessage = @"bulkUpload requires nonnull bucketName!";
+    } else if (![request.directoryURL isFileURL] && request.fileURLs.count == 0) {
+        errorMessage = @"bulkUpload requires a local directoryURL or fileURLs!";
+    } else if (request.partSize < 100 * 1024) {
+        errorMessage = @"Part size must be greater than equal to 100KB";
+    }
+    if (errorMessage) {
+        return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                          code:OSSClientErrorCodeInvalidArgument
+                                                      userInfo:@{OSSErrorMessageTOKEN: errorMessage}]];
+    }
+
+    return [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
+        NSError *error = nil;
+        NSArray<OSSBulkUploadFile *> *files = [self filesOfBulkUploadRequest:request error:&error];
+        if (!files) {
+            return [OSSTask taskWithError:error];
         }
-        
-        if (sequential) {
-            errorTask = [self sequentialUpload:request
-                                   uploadIndex:alreadyUploadIndex
-                                    uploadPart:uploadedPartInfos
-                                         count:partCount
-                                uploadedLength:&uploadedLength
-                                      fileSize:uploadFileSize];
-        } else {
-            errorTask = [self upload:request
-                         uploadIndex:alreadyUploadIndex
-                          uploadPart:uploadedPartInfos
-                               count:partCount
-                      uploadedLength:&uploadedLength
-                            fileSize:uploadFileSize];
+
+        NSString *manifestPath = [self bulkUploadManifestPathWithRequest:request files:files];
+        NSDictionary<NSString *, NSString *> *uploadedVersions = [self readBulkUploadManifestAtPath:manifestPath];
+        NSFileHandle *manifest = nil;
+        if (manifestPath) {
+            if (![[NSFileManager defaultManager] fileExistsAtPath:manifestPath]) {
+                [[NSFileManager defaultManager] createFileAtPath:manifestPath contents:nil attributes:nil];
+            }
+            manifest = [NSFileHandle fileHandleForWritingAtPath:manifestPath];
+            if (!manifest) {
+                return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                                  code:OSSClientErrorCodeFileCantWrite
+                                                              userInfo:@{OSSErrorMessageTOKEN: @"manifest for this task can't be stored persistentially!"}]];
+            }
+            [manifest seekToEndOfFile];
         }
-        
-        if(errorTask.error)
-        {
-            OSSTask *abortTask;
-            if(resumable)
-            {
-                OSSResumableUploadRequest *resumableRequest = (OSSResumableUploadRequest *)request;
-                if (resumableRequest.deleteUploadIdOnCancelling || errorTask.error.code == OSSClientErrorCodeFileCantWrite) {
-                    abortTask = [self abortMultipartUpload:request sequential:sequential resumable:resumable];
-                }
-            }else
-            {
-                abortTask =[self abortMultipartUpload:request sequential:sequential resumable:resumable];
+
+        NSMutableArray<NSString *> *skippedObjects = [NSMutableArray array];
+        NSMutableArray<OSSBulkUploadFile *> *pendingFiles = [NSMutableArray arrayWithCapacity:files.count];
+        int64_t totalBytesSent = 0;
+        int64_t totalBytesExpected = 0;
+        for (OSSBulkUploadFile *file in files) {
+            totalBytesExpected += file.size;
+            if ([uploadedVersions[file.objectKey] isEqualToString:file.version]) {
+                [skippedObjects addObject:file.objectKey];
+                totalBytesSent += file.size;
+            } else {
+                [pendingFiles addObject:file];
             }
-            [abortTask waitUntilFinished];
-            
-            return errorTask;
         }
-        
-        [uploadedPartInfos sortUsingComparator:^NSComparisonResult(OSSPartInfo *part1,OSSPartInfo* part2) {
-            if(part1.partNum < part2.partNum){
-                return NSOrderedAscending;
-            }else if(part1.partNum > part2.partNum){
-                return NSOrderedDescending;
-            }else{
-                return NSOrderedSame;
+        OSSProgressReporter *progressReporter = [OSSProgressReporter reporterWithRequest:request progress:request.uploadProgress];
+        if (totalBytesSent > 0) {
+            [progressReporter reportBytes:0 totalBytes:totalBytesSent totalBytesExpected:totalBytesExpected];
+        }
+
+        OSSBulkFilesUpload *bulkUpload = [OSSBulkFilesUpload new];
+        bulkUpload.request = request;
+        bulkUpload.pendingFiles = pendingFiles;
+        bulkUpload.skippedObjects = skippedObjects;
+        bulkUpload.manifestPath = manifestPath;
+        bulkUpload.manifest = manifest;
+        bulkUpload.progressReporter = progressReporter;
+        bulkUpload.totalBytesSent = totalBytesSent;
+        bulkUpload.totalBytesExpected = totalBytesExpected;
+        bulkUpload.uploadedObjects = [NSMutableArray array];
+        bulkUpload.failedObjects = [NSMutableDictionary dictionary];
+        bulkUpload.completionSource = [OSSTaskCompletionSource taskCompletionSource];
+        // the files are chained to the operation, it doesn't hold a thread of the executor their parts need
+        [self startFilesOfBulkUpload:bulkUpload];
+        return bulkUpload.completionSource.task;
+    }];
+}
+
+- (void)startFilesOfBulkUpload:(OSSBulkFilesUpload *)bulkUpload
+{
+    NSUInteger concurrentCount = MAX(bulkUpload.request.concurrentFileCount, 1);
+    while (YES) {
+        OSSBulkUploadFile *file = nil;
+        @synchronized(bulkUpload) {
+            if (!bulkUpload.request.isCancelled
+                && !bulkUpload.isFinished
+                && bulkUpload.runningCount < concurrentCount
+                && bulkUpload.nextFileIndex < bulkUpload.pendingFiles.count) {
+                file = bulkUpload.pendingFiles[bulkUpload.nextFileIndex++];
+                bulkUpload.runningCount++;
             }
-        }];
-        
-        // 如果开启了crc64的校验
-        uint64_t local_crc64 = 0;
-        if (request.crcFlag == OSSRequestCRCOpen)
-        {
-            for (NSUInteger index = 0; index< uploadedPartInfos.count; index++)
-            {
-                uint64_t partCrc64 = uploadedPartInfos[index].crc64;
-                int64_t partSize = uploadedPartInfos[index].size;
-                local_crc64 = [OSSUtil crc64ForCombineCRC1:local_crc64 CRC2:partCrc64 length:partSize];
+        }
+        if (!file) {
+            break;
+        }
+        [self uploadFile:file ofBulkUpload:bulkUpload];
+    }
+    [self finishBulkUploadIfDone:bulkUpload];
+}
+
+- (void)uploadFile:(OSSBulkUploadFile *)file ofBulkUpload:(OSSBulkFilesUpload *)bulkUpload
+{
+    OSSBulkUploadRequest *request = bulkUpload.request;
+    // a file's progress is counted by its total, which a resumed multipart upload starts at its uploaded parts
+    __block int64_t fileBytesSent = 0;
+    OSSRequest *fileRequest = [self uploadRequestOfBulkUploadFile:file request:request progress:^(int64_t bytesSent, int64_t totalFileBytesSent, int64_t totalFileBytesExpected) {
+        @synchronized(bulkUpload) {
+            int64_t bytes = totalFileBytesSent - fileBytesSent;
+            fileBytesSent = totalFileBytesSent;
+            bulkUpload.totalBytesSent += bytes;
+            [bulkUpload.progressReporter reportBytes:bytes totalBytes:bulkUpload.totalBytesSent totalBytesExpected:bulkUpload.totalBytesExpected];
+        }
+    }];
+
+    NSHashTable<OSSRequest *> *runningChildrenRequests = request.runningChildrenRequests;
+    @synchronized(runningChildrenRequests) {
+        [runningChildrenRequests addObject:fileRequest];
+    }
+    OSSTask *fileTask = nil;
+    if ([fileRequest isKindOfClass:[OSSResumableUploadRequest class]]) {
+        fileTask = [self resumableUpload:(OSSResumableUploadRequest *)fileRequest];
+    } else if ([fileRequest isKindOfClass:[OSSMultipartUploadRequest class]]) {
+        fileTask = [self multipartUpload:(OSSMultipartUploadRequest *)fileRequest];
+    } else {
+        fileTask = [self putObject:(OSSPutObjectRequest *)fileRequest];
+    }
+    [fileTask continueWithBlock:^id(OSSTask *uploadTask) {
+        @synchronized(runningChildrenRequests) {
+            [runningChildrenRequests removeObject:fileRequest];
+        }
+        @synchronized(bulkUpload) {
+            if (uploadTask.error) {
+                OSSLogError(@"upload %@ to %@ failed: %@", file.fileURL.path, file.objectKey, uploadTask.error);
+                bulkUpload.firstError = bulkUpload.firstError ?: uploadTask.error;
+                bulkUpload.failedObjects[file.objectKey] = uploadTask.error;
+            } else {
+                [bulkUpload.uploadedObjects addObject:file.objectKey];
+                [self appendBulkUploadFile:file toManifest:bulkUpload.manifest];
             }
+            bulkUpload.runningCount--;
         }
-        return [self processCompleteMultipartUpload:request
-                                          partInfos:uploadedPartInfos
-                                        clientCrc64:local_crc64
-                                     recordFilePath:recordFilePath
-                                 localPartInfosPath:localPartInfosPath];
+        [self startFilesOfBulkUpload:bulkUpload];
+        return nil;
     }];
 }
 
+/**
+ * the upload completes once no file is running, and every file was started or it was cancelled
+ */
+- (void)finishBulkUploadIfDone:(OSSBulkFilesUpload *)bulkUpload
+{
+    OSSBulkUploadRequest *request = bulkUpload.request;
+    @synchronized(bulkUpload) {
+        if (bulkUpload.isFinished || bulkUpload.runningCount > 0) {
+            return;
+        }
+        if (!request.isCancelled && bulkUpload.nextFileIndex < bulkUpload.pendingFiles.count) {
+            return;
+        }
+        bulkUpload.isFinished = YES;
+    }
+    [bulkUpload.progressReporter flush];
+    [bulkUpload.manifest closeFile];
+
+    NSUInteger pendingCount = bulkUpload.pendingFiles.count;
+    if (request.isCancelled) {
+        [bulkUpload.completionSource setError:[OSSClient cancelError]];
+        return;
+    }
+    if (pendingCount > 0 && bulkUpload.failedObjects.count == pendingCount) {
+        [bulkUpload.completionSource setError:bulkUpload.firstError];
+        return;
+    }
+    if (bulkUpload.manifestPath && bulkUpload.failedObjects.count == 0) {
+        [[NSFileManager defaultManager] removeItemAtPath:bulkUpload.manifestPath error:nil];
+    }
+
+    OSSBulkUploadResult *result = [OSSBulkUploadResult new];
+    result.httpResponseCode = 200;
+    result.uploadedObjects = [bulkUpload.uploadedObjects copy];
+    result.skippedObjects = [bulkUpload.skippedObjects copy];
+    result.failedObjects = [bulkUpload.failedObjects copy];
+    [bulkUpload.completionSource setResult:result];
+}
+
 - (OSSTask *)triggerCallBack:(OSSCallBackRequest *)request
 {
     if (![request.bucketName oss_isNotEmpty]) {
@@ -1390,17 +2400,912 @@ static NSObject * lock;
     return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
 }
 
-# pragma mark - Private Methods
+#pragma mark - parallel download
 
-- (void)enableCRC64WithFlag:(OSSRequestCRCFlag)flag requestDelegate:(OSSNetworkingRequestDelegate *)delegate
+- (OSSTask *)parallelDownload:(OSSParallelDownloadRequest *)request
 {
-    switch (flag) {
-        case OSSRequestCRCOpen:
-            delegate.crc64Verifiable = YES;
-            break;
-        case OSSRequestCRCClosed:
-            delegate.crc64Verifiable = NO;
-            break;
+    OSSTask *preTask = [self checkParallelDownloadRequest:request];
+    if (preTask) {
+        return preTask;
+    }
+    [self checkRequestCrc64Setting:request];
+    
+    return [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
+        OSSHeadObjectResult *headResult = nil;
+        OSSTask *headTask = [self headObjectForDownload:request result:&headResult];
+        if (headTask.error) {
+            return headTask;
+        }
+        
+        unsigned long long objectSize = [headResult.objectMeta[@"Content-Length"] longLongValue];
+        NSUInteger partCount = (NSUInteger)((objectSize + request.partSize - 1) / request.partSize);
+        
+        int fd = -1;
+        OSSTask *openTask = [self openDownloadFile:request.downloadToFileURL size:objectSize truncate:YES fileDescriptor:&fd];
+        if (openTask) {
+            return openTask;
+        }
+        
+        NSMutableArray<NSNumber *> *partCRCs = [NSMutableArray arrayWithCapacity:partCount];
+        for (NSUInteger i = 0; i < partCount; i++) {
+            [partCRCs addObject:@0];
+        }
+        NSIndexSet *parts = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, partCount)];
+        int64_t downloadedLength = 0;
+        OSSProgressReporter *progressReporter = [OSSProgressReporter reporterWithRequest:request progress:request.downloadProgress];
+        OSSTask *errorTask = [self downloadParts:parts
+                                       ofRequest:request
+                                      objectSize:objectSize
+                                            eTag:headResult.objectMeta[@"Etag"]
+                                  fileDescriptor:fd
+                                        partCRCs:partCRCs
+                                downloadedLength:&downloadedLength
+                                progressReporter:progressReporter
+                                  partCompletion:nil];
+        close(fd);
+        [progressReporter flush];
+        if (errorTask) {
+            return errorTask;
+        }
+        
+        OSSTask *crcTask = [self checkDownloadCRCs:partCRCs ofRequest:request objectSize:objectSize headResult:headResult];
+        if (crcTask) {
+            return crcTask;
+        }
+        
+        return [OSSTask taskWithResult:[self downloadResultWithHeadResult:headResult]];
+    }];
+}
+
+- (OSSTask *)resumableDownload:(OSSResumableDownloadRequest *)request
+{
+    if (![request.recordDirectoryPath oss_isNotEmpty]) {
+        return [self parallelDownload:request];
+    }
+    OSSTask *preTask = [self checkParallelDownloadRequest:request];
+    if (preTask) {
+        return preTask;
+    }
+    [self checkRequestCrc64Setting:request];
+    
+    return [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
+        OSSHeadObjectResult *headResult = nil;
+        OSSTask *headTask = [self headObjectForDownload:request result:&headResult];
+        if (headTask.error) {
+            return headTask;
+        }
+        
+        unsigned long long objectSize = [headResult.objectMeta[@"Content-Length"] longLongValue];
+        NSUInteger partCount = (NSUInteger)((objectSize + request.partSize - 1) / request.partSize);
+        NSString *eTag = headResult.objectMeta[@"Etag"];
+        NSString *lastModified = headResult.objectMeta[@"Last-Modified"];
+        NSString *tempFilePath = [request.downloadToFileURL.path stringByAppendingString:oss_download_temp_file_suffix];
+        NSString *checkpointPath = [self downloadCheckpointPathWithRequest:request];
+        // the ranges finished since the checkpoint was written, one record each
+        NSString *journalPath = [checkpointPath stringByAppendingString:oss_partInfos_journal_suffix];
+        NSFileManager *defaultFM = [NSFileManager defaultManager];
+        
+        NSMutableDictionary *checkpoint = [NSMutableDictionary dictionaryWithContentsOfFile:checkpointPath];
+        NSMutableDictionary *finishedParts = nil;
+        if (checkpoint) {
+            BOOL sameObject = [checkpoint[OSSETagXMLTOKEN] isEqualToString:eTag ?: @""]
+                && [checkpoint[OSSLastModifiedXMLTOKEN] isEqualToString:lastModified ?: @""]
+                && [checkpoint[OSSSizeXMLTOKEN] unsignedLongLongValue] == objectSize;
+            if (!sameObject) {
+                [defaultFM removeItemAtPath:checkpointPath error:nil];
+                [defaultFM removeItemAtPath:journalPath error:nil];
+                [defaultFM removeItemAtPath:tempFilePath error:nil];
+                return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                                  code:OSSClientErrorCodeObjectModified
+                                                              userInfo:@{OSSErrorMessageTOKEN: @"The object has been modified since the checkpoint, can not resume the download"}]];
+            }
+            NSDictionary *attributes = [defaultFM attributesOfItemAtPath:tempFilePath error:nil];
+            if ([attributes[NSFileSize] unsignedLongLongValue] == objectSize) {
+                finishedParts = [checkpoint[OSSPartXMLTOKEN] mutableCopy] ?: [NSMutableDictionary dictionary];
+                OSSPartInfoJournal *journal = [[OSSPartInfoJournal alloc] initWithFilePath:journalPath];
+                [[journal partInfos] enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSDictionary *partInfo, BOOL *stop) {
+                    finishedParts[key] = partInfo[@"crc64"];
+                }];
+                [journal close];
+            }
+        }
+        
+        if (!finishedParts) {
+            OSSLogVerbose(@"no valid download checkpoint, start from the first range");
+            [defaultFM removeItemAtPath:journalPath error:nil];
+            finishedParts = [NSMutableDictionary dictionary];
+            checkpoint = [NSMutableDictionary dictionary];
+            checkpoint[OSSBucketXMLTOKEN] = request.bucketName;
+            checkpoint[OSSKeyXMLTOKEN] = request.objectKey;
+            checkpoint[OSSETagXMLTOKEN] = eTag ?: @"";
+            checkpoint[OSSLastModifiedXMLTOKEN] = lastModified ?: @"";
+            checkpoint[OSSSizeXMLTOKEN] = @(objectSize);
+        }
+        
+        int fd = -1;
+        OSSTask *openTask = [self openDownloadFile:[NSURL fileURLWithPath:tempFilePath]
+                                              size:objectSize
+                                          truncate:finishedParts.count == 0
+                                    fileDescriptor:&fd];
+        if (openTask) {
+            return openTask;
+        }
+        
+        NSMutableArray<NSNumber *> *partCRCs = [NSMutableArray arrayWithCapacity:partCount];
+        NSMutableIndexSet *pendingParts = [NSMutableIndexSet indexSet];
+        int64_t downloadedLength = 0;
+        for (NSUInteger i = 0; i < partCount; i++) {
+            NSNumber *crc64 = finishedParts[[@(i) stringValue]];
+            [partCRCs addObject:crc64 ?: @0];
+            if (crc64) {
+                downloadedLength += MIN((int64_t)request.partSize, (int64_t)objectSize - (int64_t)request.partSize * i);
+            } else {
+                [pendingParts addIndex:i];
+            }
+        }
+        OSSProgressReporter *progressReporter = [OSSProgressReporter reporterWithRequest:request progress:request.downloadProgress];
+        if (downloadedLength > 0) {
+            [progressReporter reportBytes:0 totalBytes:downloadedLength totalBytesExpected:objectSize];
+        }
+        
+        // the checkpoint is written once with the ranges known so far, the journal then starts over.
+        // A crash in between leaves ranges in both, read twice the same way
+        checkpoint[OSSPartXMLTOKEN] = finishedParts;
+        if (![checkpoint writeToFile:checkpointPath atomically:YES]) {
+            OSSLogError(@"persist the download checkpoint failed!");
+        }
+        [defaultFM removeItemAtPath:journalPath error:nil];
+        OSSPartInfoJournal *journal = [[OSSPartInfoJournal alloc] initWithFilePath:journalPath];
+        
+        OSSTask *errorTask = [self downloadParts:pendingParts
+                                       ofRequest:request
+                                      objectSize:objectSize
+                                            eTag:eTag
+                                  fileDescriptor:fd
+                                        partCRCs:partCRCs
+                                downloadedLength:&downloadedLength
+                                progressReporter:progressReporter
+                                  partCompletion:^(NSUInteger partIndex, uint64_t crc64) {
+                                      // an append per range, whatever the count of ranges already finished
+                                      int64_t partLength = MIN((int64_t)request.partSize, (int64_t)objectSize - (int64_t)request.partSize * partIndex);
+                                      OSSPartInfo *partInfo = [OSSPartInfo partInfoWithPartNum:(int32_t)partIndex eTag:@"" size:partLength crc64:crc64];
+                                      if (![journal appendPartInfo:partInfo error:nil]) {
+                                          OSSLogError(@"persist the download checkpoint failed!");
+                                      }
+                                  }];
+        [journal close];
+        close(fd);
+        [progressReporter flush];
+        if (errorTask) {
+            if (errorTask.error.code == OSSClientErrorCodeObjectModified) {
+                [defaultFM removeItemAtPath:checkpointPath error:nil];
+                [defaultFM removeItemAtPath:journalPath error:nil];
+                [defaultFM removeItemAtPath:tempFilePath error:nil];
+            }
+            return errorTask;
+        }
+        
+        OSSTask *crcTask = [self checkDownloadCRCs:partCRCs ofRequest:request objectSize:objectSize headResult:headResult];
+        if (crcTask) {
+            [defaultFM removeItemAtPath:checkpointPath error:nil];
+            [defaultFM removeItemAtPath:journalPath error:nil];
+            [defaultFM removeItemAtPath:tempFilePath error:nil];
+            return crcTask;
+        }
+        
+        NSError *moveError = nil;
+        [defaultFM removeItemAtPath:request.downloadToFileURL.path error:nil];
+        if (![defaultFM moveItemAtPath:tempFilePath toPath:request.downloadToFileURL.path error:&moveError]) {
+            return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                              code:OSSClientErrorCodeFileCantWrite
+                                                          userInfo:@{OSSErrorMessageTOKEN: [NSString stringWithFormat:@"Can not move the downloaded file: %@", moveError]}]];
+        }
+        [defaultFM removeItemAtPath:checkpointPath error:nil];
+        [defaultFM removeItemAtPath:journalPath error:nil];
+        
+        return [OSSTask taskWithResult:[self downloadResultWithHeadResult:headResult]];
+    }];
+}
+
+- (OSSParallelDownloadResult *)downloadResultWithHeadResult:(OSSHeadObjectResult *)headResult
+{
+    OSSParallelDownloadResult *result = [OSSParallelDownloadResult new];
+    result.httpResponseCode = headResult.httpResponseCode;
+    result.httpResponseHeaderFields = headResult.httpResponseHeaderFields;
+    result.requestId = headResult.requestId;
+    result.remoteCRC64ecma = headResult.remoteCRC64ecma;
+    result.objectMeta = headResult.objectMeta;
+    return result;
+}
+
+- (NSString *)downloadCheckpointPathWithRequest:(OSSResumableDownloadRequest *)request
+{
+    NSString *record = [NSString stringWithFormat:@"%@%@%@%zi", request.bucketName, request.objectKey, request.downloadToFileURL.path, request.partSize];
+    if (request.crcFlag == OSSRequestCRCOpen) {
+        record = [record stringByAppendingString:oss_record_info_suffix_with_crc];
+    }
+    NSString *recordFileName = [OSSUtil dataMD5String:[record dataUsingEncoding:NSUTF8StringEncoding]];
+    return [request.recordDirectoryPath stringByAppendingPathComponent:recordFileName];
+}
+
+- (OSSTask *)checkParallelDownloadRequest:(OSSParallelDownloadRequest *)request
+{
+    NSString *errorMessage = nil;
+    if (![request.bucketName oss_isNotEmpty]) {
+        errorMessage = @"parallelDownload requires nonnull bucketName!";
+    } else if (![request.objectKey oss_isNotEmpty]) {
+        errorMessage = @"parallelDownload requires nonnull objectKey!";
+    } else if (![request.downloadToFileURL isFileURL]) {
+        errorMessage = @"parallelDownload requires a local downloadToFileURL!";
+    } else if (request.partSize < 100 * 1024) {
+        errorMessage = @"Part size must be greater than equal to 100KB";
+    }
+    
+    if (errorMessage) {
+        return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                          code:OSSClientErrorCodeInvalidArgument
+                                                      userInfo:@{OSSErrorMessageTOKEN: errorMessage}]];
+    }
+    return nil;
+}
+
+- (OSSTask *)headObjectForDownload:(OSSParallelDownloadRequest *)request result:(OSSHeadObjectResult **)result
+{
+    OSSHeadObjectRequest *headRequest = [OSSHeadObjectRequest new];
+    headRequest.bucketName = request.bucketName;
+    headRequest.objectKey = request.objectKey;
+    OSSTask *headTask = [self headObject:headRequest];
+    [headTask waitUntilFinished];
+    *result = headTask.result;
+    return headTask;
+}
+
+- (OSSTask *)openDownloadFile:(NSURL *)fileURL size:(unsigned long long)size truncate:(BOOL)truncate fileDescriptor:(int *)fileDescriptor
+{
+    int flags = O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0);
+    int fd = open(fileURL.path.fileSystemRepresentation, flags, 0644);
+    // preallocate, so that every range can be written to its own offset
+    if (fd < 0 || ftruncate(fd, (off_t)size) != 0) {
+        NSString *errorMessage = [NSString stringWithFormat:@"Can not create the download file, errno: %d", errno];
+        if (fd >= 0) {
+            close(fd);
+        }
+        return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                          code:OSSClientErrorCodeFileCantWrite
+                                                      userInfo:@{OSSErrorMessageTOKEN: errorMessage}]];
+    }
+    *fileDescriptor = fd;
+    return nil;
+}
+
+- (OSSTask *)downloadParts:(NSIndexSet *)parts
+                 ofRequest:(OSSParallelDownloadRequest *)request
+                objectSize:(unsigned long long)objectSize
+                      eTag:(NSString *)eTag
+            fileDescriptor:(int)fd
+                  partCRCs:(NSMutableArray<NSNumber *> *)partCRCs
+          downloadedLength:(int64_t *)downloadedLength
+          progressReporter:(OSSProgressReporter *)progressReporter
+            partCompletion:(void (^)(NSUInteger partIndex, uint64_t crc64))partCompletion
+{
+    NSUInteger concurrentPartCount = MAX(request.concurrentPartCount, 1);
+    NSOperationQueue *queue = [[NSOperationQueue alloc] init];
+    [queue setMaxConcurrentOperationCount:concurrentPartCount];
+    dispatch_semaphore_t windowSemaphore = dispatch_semaphore_create(concurrentPartCount);
+    NSObject *downloadLock = [NSObject new];
+    NSHashTable<OSSRequest *> *runningChildrenRequests = request.runningChildrenRequests;
+    __block OSSTask *errorTask = nil;
+    
+    NSUInteger partIndex = [parts firstIndex];
+    while (partIndex != NSNotFound) {
+        dispatch_semaphore_wait(windowSemaphore, DISPATCH_TIME_FOREVER);
+        BOOL shouldStop = NO;
+        @synchronized(downloadLock) {
+            shouldStop = request.isCancelled || errorTask != nil;
+        }
+        if (shouldStop) {
+            dispatch_semaphore_signal(windowSemaphore);
+            break;
+        }
+        
+        NSUInteger index = partIndex;
+        int64_t start = (int64_t)request.partSize * index;
+        int64_t length = MIN((int64_t)request.partSize, (int64_t)objectSize - start);
+        
+        NSBlockOperation *operation = [NSBlockOperation blockOperationWithBlock:^{
+            @autoreleasepool {
+                __block int64_t writeOffset = start;
+                __block uint64_t crc64 = 0;
+                __block int writeErrno = 0;
+                
+                OSSGetObjectRequest *getRequest = [OSSGetObjectRequest new];
+                getRequest.bucketName = request.bucketName;
+                getRequest.objectKey = request.objectKey;
+                getRequest.range = [[OSSRange alloc] initWithStart:start withEnd:start + length - 1];
+                // the ranges of a large download don't go ahead of interactive gets, unless asked to
+                getRequest.priority = request.priority != OSSRequestPriorityDefault ? request.priority : OSSRequestPriorityNormal;
+                __weak OSSGetObjectRequest *weakGetRequest = getRequest;
+                getRequest.onRecieveData = ^(NSData *data) {
+                    if (writeErrno != 0) {
+                        return;
+                    }
+                    const uint8_t *bytes = data.bytes;
+                    size_t remain = data.length;
+                    while (remain > 0) {
+                        ssize_t written = pwrite(fd, bytes, remain, (off_t)writeOffset);
+                        if (written < 0) {
+                            if (errno == EINTR) {
+                                continue;
+                            }
+                            writeErrno = errno;
+                            [weakGetRequest cancel];
+                            return;
+                        }
+                        crc64 = [OSSUtil crc64ecma:crc64 buffer:(void *)bytes length:written];
+                        bytes += written;
+                        remain -= written;
+                        writeOffset += written;
+                    }
+                    
+                    @synchronized(downloadLock) {
+                        *downloadedLength += data.length;
+                        [progressReporter reportBytes:data.length totalBytes:*downloadedLength totalBytesExpected:objectSize];
+                    }
+                };
+                
+                @synchronized(runningChildrenRequests) {
+                    [runningChildrenRequests addObject:getRequest];
+                }
+                if (request.isCancelled) {
+                    [getRequest cancel];
+                }
+                OSSTask *getTask = [self getObject:getRequest];
+                [getTask waitUntilFinished];
+                @synchronized(runningChildrenRequests) {
+                    [runningChildrenRequests removeObject:getRequest];
+                }
+                
+                OSSTask *partErrorTask = nil;
+                if (writeErrno != 0) {
+                    partErrorTask = [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                                               code:OSSClientErrorCodeFileCantWrite
+                                                                           userInfo:@{OSSErrorMessageTOKEN: [NSString stringWithFormat:@"Can not write the download file, errno: %d", writeErrno]}]];
+                } else if (getTask.error) {
+                    partErrorTask = getTask;
+                } else {
+                    NSString *partETag = ((OSSGetObjectResult *)getTask.result).objectMeta[@"Etag"];
+                    if ([eTag oss_isNotEmpty] && [partETag oss_isNotEmpty] && ![eTag isEqualToString:partETag]) {
+                        partErrorTask = [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                                                   code:OSSClientErrorCodeObjectModified
+                                                                               userInfo:@{OSSErrorMessageTOKEN: @"The object has been modified during the download"}]];
+                    } else if (writeOffset != start + length) {
+                        partErrorTask = [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                                                   code:OSSClientErrorCodeNetworkError
+                                                                               userInfo:@{OSSErrorMessageTOKEN: @"The range response is shorter than requested"}]];
+                    }
+                }
+                
+                @synchronized(downloadLock) {
+                    if (partErrorTask) {
+                        if (!errorTask) {
+                            errorTask = partErrorTask;
+                        }
+                    } else {
+                        partCRCs[index] = @(crc64);
+                        if (partCompletion) {
+                            partCompletion(index, crc64);
+                        }
+                    }
+                }
+            }
+        }];
+        [operation setCompletionBlock:^{
+            dispatch_semaphore_signal(windowSemaphore);
+        }];
+        [queue addOperation:operation];
+        
+        partIndex = [parts indexGreaterThanIndex:partIndex];
+    }
+    [queue waitUntilAllOperationsAreFinished];
+    
+    if (request.isCancelled) {
+        return [OSSTask taskWithError:[OSSClient cancelError]];
+    }
+    return errorTask;
+}
+
+- (OSSTask *)checkDownloadCRCs:(NSArray<NSNumber *> *)partCRCs
+                     ofRequest:(OSSParallelDownloadRequest *)request
+                    objectSize:(unsigned long long)objectSize
+                    headResult:(OSSHeadObjectResult *)headResult
+{
+    if (request.crcFlag != OSSRequestCRCOpen || ![headResult.remoteCRC64ecma oss_isNotEmpty]) {
+        return nil;
+    }
+    
+    uint64_t local_crc64 = 0;
+    for (NSUInteger index = 0; index < partCRCs.count; index++) {
+        int64_t start = (int64_t)request.partSize * index;
+        int64_t length = MIN((int64_t)request.partSize, (int64_t)objectSize - start);
+        local_crc64 = [OSSUtil crc64ForCombineCRC1:local_crc64 CRC2:[partCRCs[index] unsignedLongLongValue] length:length];
+    }
+    
+    uint64_t remote_crc64 = 0;
+    NSScanner *scanner = [NSScanner scannerWithString:headResult.remoteCRC64ecma];
+    [scanner scanUnsignedLongLong:&remote_crc64];
+    if (local_crc64 != remote_crc64) {
+        NSString *errorMessage = [NSString stringWithFormat:@"crc validation fails(local_crc64ecma: %llu,remote_crc64ecma: %llu)", local_crc64, remote_crc64];
+        return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                          code:OSSClientErrorCodeInvalidCRC
+                                                      userInfo:@{OSSErrorMessageTOKEN: errorMessage}]];
+    }
+    return nil;
+}
+
+# pragma mark - Private Methods
+
+- (OSSTask *)checkMultipartCopyRequest:(OSSMultipartCopyRequest *)request
+{
+    NSString *errorMessage = nil;
+    if (![request.bucketName oss_isNotEmpty] || ![request.objectKey oss_isNotEmpty]) {
+        errorMessage = @"multipartCopy requires nonnull bucketName and objectKey!";
+    } else if (![request.sourceBucketName oss_isNotEmpty] || ![request.sourceObjectKey oss_isNotEmpty]) {
+        errorMessage = @"multipartCopy requires nonnull sourceBucketName and sourceObjectKey!";
+    } else if (request.partSize < 100 * 1024) {
+        errorMessage = @"Part size must be greater than equal to 100KB";
+    }
+
+    if (errorMessage) {
+        return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                          code:OSSClientErrorCodeInvalidArgument
+                                                      userInfo:@{OSSErrorMessageTOKEN: errorMessage}]];
+    }
+    return nil;
+}
+
+- (NSString *)multipartCopyRecordPathWithRequest:(OSSMultipartCopyRequest *)request sourceETag:(NSString *)sourceETag partSize:(NSUInteger)partSize
+{
+    if (![request.recordDirectoryPath oss_isNotEmpty]) {
+        return nil;
+    }
+    NSString *record = [NSString stringWithFormat:@"copy%@%@%@%@%@%zi", request.sourceBucketName, request.sourceObjectKey, sourceETag ?: @"", request.bucketName, request.objectKey, partSize];
+    NSString *recordFileName = [OSSUtil dataMD5String:[record dataUsingEncoding:NSUTF8StringEncoding]];
+    return [request.recordDirectoryPath stringByAppendingPathComponent:recordFileName];
+}
+
+- (OSSTask *)copyEmptyObjectForMultipartCopy:(OSSMultipartCopyRequest *)request
+{
+    OSSCopyObjectRequest *copy = [OSSCopyObjectRequest new];
+    copy.bucketName = request.bucketName;
+    copy.objectKey = request.objectKey;
+    copy.sourceCopyFrom = [NSString stringWithFormat:@"/%@/%@", request.sourceBucketName, [OSSUtil encodeURL:request.sourceObjectKey]];
+    copy.contentType = request.contentType;
+    copy.objectMeta = request.objectMeta;
+    return [[self copyObject:copy] continueWithSuccessBlock:^id(OSSTask *copyTask) {
+        OSSCopyObjectResult *copyResult = copyTask.result;
+        OSSMultipartCopyResult *result = [OSSMultipartCopyResult new];
+        result.requestId = copyResult.requestId;
+        result.httpResponseCode = copyResult.httpResponseCode;
+        result.httpResponseHeaderFields = copyResult.httpResponseHeaderFields;
+        result.eTag = copyResult.eTag;
+        return [OSSTask taskWithResult:result];
+    }];
+}
+
+- (OSSTask *)copyParts:(NSIndexSet *)partNumbers
+             ofRequest:(OSSMultipartCopyRequest *)request
+              uploadId:(NSString *)uploadId
+            objectSize:(unsigned long long)objectSize
+              partSize:(NSUInteger)partSize
+            sourceETag:(NSString *)sourceETag
+             partInfos:(NSMutableArray<OSSPartInfo *> *)partInfos
+          copiedLength:(int64_t)copiedLength
+      progressReporter:(OSSProgressReporter *)progressReporter
+{
+    NSUInteger concurrentPartCount = MAX(request.concurrentPartCount, 1);
+    dispatch_semaphore_t windowSemaphore = dispatch_semaphore_create(concurrentPartCount);
+    dispatch_group_t group = dispatch_group_create();
+    NSHashTable<OSSRequest *> *runningChildrenRequests = request.runningChildrenRequests;
+    NSObject *copyLock = [NSObject new];
+    __block int64_t totalCopiedLength = copiedLength;
+    __block OSSTask *errorTask = nil;
+
+    NSUInteger partNumber = [partNumbers firstIndex];
+    while (partNumber != NSNotFound) {
+        dispatch_semaphore_wait(windowSemaphore, DISPATCH_TIME_FOREVER);
+        BOOL shouldStop = NO;
+        @synchronized(copyLock) {
+            shouldStop = request.isCancelled || errorTask != nil;
+        }
+        if (shouldStop) {
+            dispatch_semaphore_signal(windowSemaphore);
+            break;
+        }
+
+        int64_t start = (int64_t)partSize * (partNumber - 1);
+        int64_t length = MIN((int64_t)partSize, (int64_t)objectSize - start);
+        OSSUploadPartCopyRequest *partCopy = [OSSUploadPartCopyRequest new];
+        partCopy.bucketName = request.bucketName;
+        partCopy.objectKey = request.objectKey;
+        partCopy.uploadId = uploadId;
+        partCopy.partNumber = (int)partNumber;
+        partCopy.sourceBucketName = request.sourceBucketName;
+        partCopy.sourceObjectKey = request.sourceObjectKey;
+        partCopy.sourceCopyRange = [[OSSRange alloc] initWithStart:start withEnd:start + length - 1];
+        partCopy.sourceCopyIfMatch = sourceETag;
+        partCopy.isAuthenticationRequired = request.isAuthenticationRequired;
+
+        @synchronized(runningChildrenRequests) {
+            [runningChildrenRequests addObject:partCopy];
+        }
+        dispatch_group_enter(group);
+        [[self uploadPartCopy:partCopy] continueWithBlock:^id(OSSTask *partCopyTask) {
+            @synchronized(runningChildrenRequests) {
+                [runningChildrenRequests removeObject:partCopy];
+            }
+            @synchronized(copyLock) {
+                if (partCopyTask.error) {
+                    OSSLogError(@"copy part %d of %@ failed: %@", partCopy.partNumber, partCopy.objectKey, partCopyTask.error);
+                    errorTask = errorTask ?: partCopyTask;
+                } else {
+                    OSSUploadPartCopyResult *partCopyResult = partCopyTask.result;
+                    [partInfos addObject:[OSSPartInfo partInfoWithPartNum:partCopy.partNumber eTag:partCopyResult.eTag size:length crc64:0]];
+                    totalCopiedLength += length;
+                    [progressReporter reportBytes:length totalBytes:totalCopiedLength totalBytesExpected:objectSize];
+                }
+            }
+            dispatch_semaphore_signal(windowSemaphore);
+            dispatch_group_leave(group);
+            return nil;
+        }];
+
+        partNumber = [partNumbers indexGreaterThanIndex:partNumber];
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    if (request.isCancelled) {
+        return [OSSTask taskWithError:[OSSClient cancelError]];
+    }
+    return errorTask;
+}
+
+- (NSArray<OSSBulkUploadFile *> *)filesOfBulkUploadRequest:(OSSBulkUploadRequest *)request error:(NSError **)error
+{
+    NSString *prefix = request.objectKeyPrefix ?: @"";
+    NSMutableArray<OSSBulkUploadFile *> *files = [NSMutableArray array];
+    if (request.directoryURL) {
+        NSDirectoryEnumerator *enumerator = [[NSFileManager defaultManager] enumeratorAtPath:request.directoryURL.path];
+        if (!enumerator) {
+            *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                         code:OSSClientErrorCodeInvalidArgument
+                                     userInfo:@{OSSErrorMessageTOKEN: [NSString stringWithFormat:@"Can not read the directory %@", request.directoryURL.path]}];
+            return nil;
+        }
+        // the attributes come with the enumeration, the files aren't stat'ed again
+        for (NSString *relativePath in enumerator) {
+            NSDictionary *attributes = enumerator.fileAttributes;
+            if ([relativePath.lastPathComponent hasPrefix:@"."]) {
+                if ([attributes.fileType isEqualToString:NSFileTypeDirectory]) {
+                    [enumerator skipDescendants];
+                }
+                continue;
+            }
+            if (![attributes.fileType isEqualToString:NSFileTypeRegular]) {
+                continue;
+            }
+            [files addObject:[self bulkUploadFileWithURL:[request.directoryURL URLByAppendingPathComponent:relativePath]
+                                               objectKey:[prefix stringByAppendingString:relativePath]
+                                              attributes:attributes]];
+        }
+        return files;
+    }
+
+    for (NSURL *fileURL in request.fileURLs) {
+        NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:fileURL.path error:error];
+        if (!attributes) {
+            return nil;
+        }
+        [files addObject:[self bulkUploadFileWithURL:fileURL
+                                           objectKey:[prefix stringByAppendingString:fileURL.lastPathComponent]
+                                          attributes:attributes]];
+    }
+    return files;
+}
+
+- (OSSBulkUploadFile *)bulkUploadFileWithURL:(NSURL *)fileURL objectKey:(NSString *)objectKey attributes:(NSDictionary *)attributes
+{
+    OSSBulkUploadFile *file = [OSSBulkUploadFile new];
+    file.fileURL = fileURL;
+    file.objectKey = objectKey;
+    file.size = attributes.fileSize;
+    file.version = [NSString stringWithFormat:@"%llu-%lld", attributes.fileSize, (long long)([attributes.fileModificationDate timeIntervalSince1970] * 1000)];
+    return file;
+}
+
+- (OSSRequest *)uploadRequestOfBulkUploadFile:(OSSBulkUploadFile *)file
+                                      request:(OSSBulkUploadRequest *)request
+                                     progress:(OSSNetworkingUploadProgressBlock)progress
+{
+    if (file.size > request.multipartThreshold) {
+        OSSMultipartUploadRequest *multipart = nil;
+        if ([request.recordDirectoryPath oss_isNotEmpty]) {
+            OSSResumableUploadRequest *resumable = [OSSResumableUploadRequest new];
+            resumable.recordDirectoryPath = request.recordDirectoryPath;
+            // a cancelled bulk upload is resumed too
+            resumable.deleteUploadIdOnCancelling = NO;
+            multipart = resumable;
+        } else {
+            multipart = [OSSMultipartUploadRequest new];
+        }
+        multipart.bucketName = request.bucketName;
+        multipart.objectKey = file.objectKey;
+        multipart.uploadingFileURL = file.fileURL;
+        multipart.partSize = request.partSize;
+        multipart.uploadProgress = progress;
+        multipart.crcFlag = request.crcFlag;
+        multipart.priority = request.priority;
+        multipart.isAuthenticationRequired = request.isAuthenticationRequired;
+        return multipart;
+    }
+
+    OSSPutObjectRequest *put = [OSSPutObjectRequest new];
+    put.bucketName = request.bucketName;
+    put.objectKey = file.objectKey;
+    put.uploadingFileURL = file.fileURL;
+    put.uploadProgress = progress;
+    put.crcFlag = request.crcFlag;
+    put.priority = request.priority;
+    put.isAuthenticationRequired = request.isAuthenticationRequired;
+    return put;
+}
+
+- (NSString *)bulkUploadManifestPathWithRequest:(OSSBulkUploadRequest *)request files:(NSArray<OSSBulkUploadFile *> *)files
+{
+    if (![request.recordDirectoryPath oss_isNotEmpty]) {
+        return nil;
+    }
+    NSMutableString *record = [NSMutableString stringWithFormat:@"bulk%@%@%zi", request.bucketName, request.objectKeyPrefix ?: @"", request.partSize];
+    if (request.directoryURL) {
+        [record appendString:request.directoryURL.path];
+    } else {
+        for (OSSBulkUploadFile *file in files) {
+            [record appendString:file.fileURL.path];
+        }
+    }
+    NSString *recordFileName = [OSSUtil dataMD5String:[record dataUsingEncoding:NSUTF8StringEncoding]];
+    return [request.recordDirectoryPath stringByAppendingPathComponent:recordFileName];
+}
+
+/**
+ * the manifest has a json line [version, key] per file uploaded, a torn last line is ignored
+ */
+- (NSDictionary<NSString *, NSString *> *)readBulkUploadManifestAtPath:(NSString *)manifestPath
+{
+    NSData *data = manifestPath ? [NSData dataWithContentsOfFile:manifestPath] : nil;
+    if (!data.length) {
+        return nil;
+    }
+    NSMutableDictionary<NSString *, NSString *> *uploadedVersions = [NSMutableDictionary dictionary];
+    NSString *content = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    for (NSString *line in [content componentsSeparatedByString:@"\n"]) {
+        NSData *lineData = [line dataUsingEncoding:NSUTF8StringEncoding];
+        NSArray *entry = lineData.length ? [NSJSONSerialization JSONObjectWithData:lineData options:kNilOptions error:nil] : nil;
+        if ([entry isKindOfClass:[NSArray class]] && entry.count == 2) {
+            uploadedVersions[entry[1]] = entry[0];
+        }
+    }
+    return uploadedVersions;
+}
+
+- (void)appendBulkUploadFile:(OSSBulkUploadFile *)file toManifest:(NSFileHandle *)manifest
+{
+    if (!manifest) {
+        return;
+    }
+    NSMutableData *line = [[NSJSONSerialization dataWithJSONObject:@[file.version, file.objectKey] options:kNilOptions error:nil] mutableCopy];
+    [line appendBytes:"\n" length:1];
+    @try {
+        [manifest writeData:line];
+    } @catch (NSException *exception) {
+        OSSLogError(@"write the bulk upload manifest failed: %@", exception);
+    }
+}
+
+/**
+ * the in-memory or file body is compressed on the operation executor, its md5 and crc64 are the ones of the bytes sent
+ */
+- (OSSTask *)invokeRequest:(OSSNetworkingRequestDelegate *)requestDelegate
+       compressingBodyWith:(OSSContentCompression)compression
+     requireAuthentication:(BOOL)requireAuthentication
+{
+    if (requestDelegate.uploadingBody) {
+        // a streaming body is compressed as it's sent, its md5 can't be known beforehand
+        requestDelegate.allNeededMessage.contentMd5 = nil;
+        requestDelegate.allNeededMessage.contentSHA1 = nil;
+        return [self invokeRequest:requestDelegate requireAuthentication:requireAuthentication];
+    }
+
+    return [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
+        NSError *error = nil;
+        NSURL *compressedFileURL = nil;
+        if (requestDelegate.uploadingData) {
+            NSData *compressedData = [OSSContentCompressor compressData:requestDelegate.uploadingData compression:compression error:&error];
+            if (!compressedData) {
+                return [OSSTask taskWithError:error];
+            }
+            requestDelegate.uploadingData = compressedData;
+            requestDelegate.allNeededMessage.contentMd5 = [OSSUtil base64Md5ForData:compressedData];
+            if (requestDelegate.crc64Verifiable) {
+                uint64_t crc64 = [OSSUtil crc64ecma:0 buffer:(void *)compressedData.bytes length:compressedData.length];
+                requestDelegate.contentCRC = [NSString stringWithFormat:@"%llu", crc64];
+            }
+        } else if (requestDelegate.uploadingFileURL) {
+            // the file name is kept for the content type to be determined from its extension
+            NSString *fileName = [NSString stringWithFormat:@"%@-%@", [NSUUID UUID].UUIDString, requestDelegate.uploadingFileURL.lastPathComponent];
+            compressedFileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:fileName]];
+            if (![OSSContentCompressor compressFileAtURL:requestDelegate.uploadingFileURL toURL:compressedFileURL compression:compression error:&error]) {
+                return [OSSTask taskWithError:error];
+            }
+            requestDelegate.uploadingFileURL = compressedFileURL;
+            requestDelegate.allNeededMessage.contentMd5 = [OSSUtil base64Md5ForFileURL:compressedFileURL];
+        }
+        requestDelegate.allNeededMessage.contentSHA1 = nil;
+
+        OSSTask *invokeTask = [self invokeRequest:requestDelegate requireAuthentication:requireAuthentication];
+        if (!compressedFileURL) {
+            return invokeTask;
+        }
+        return [invokeTask continueWithBlock:^id(OSSTask *completedTask) {
+            [[NSFileManager defaultManager] removeItemAtURL:compressedFileURL error:nil];
+            return completedTask;
+        }];
+    }];
+}
+
+/* nil when the configuration doesn't coalesce reads */
+- (id<NSCopying>)coalescingKeyOfRequest:(OSSRequest *)request
+                             httpMethod:(NSString *)httpMethod
+                             bucketName:(NSString *)bucketName
+                              objectKey:(NSString *)objectKey
+                                  range:(NSString *)range
+                            xOssProcess:(NSString *)xOssProcess
+{
+    if (!self.clientConfiguration.coalescesIdenticalReads || ![objectKey oss_isNotEmpty]) {
+        return nil;
+    }
+    return @[httpMethod, bucketName ?: @"", objectKey, range ?: @"", xOssProcess ?: @"",
+             @(request.isAuthenticationRequired), @(request.crcFlag)];
+}
+
+/**
+ * heads the object, the task result is the head result if the object has the content to upload, nil if it
+ * has to be uploaded: it doesn't exist, can't be read, or has another length or digest.
+ * The crc64ecma is compared, or the MD5 for an object without it created by a single put.
+ */
+- (OSSTask *)headObjectUnchangedByRequest:(OSSRequest *)request
+                               bucketName:(NSString *)bucketName
+                                objectKey:(NSString *)objectKey
+                         uploadingFileURL:(NSURL *)fileURL
+                            uploadingData:(NSData *)data
+{
+    OSSHeadObjectRequest * head = [OSSHeadObjectRequest new];
+    head.bucketName = bucketName;
+    head.objectKey = objectKey;
+    head.isAuthenticationRequired = request.isAuthenticationRequired;
+    request.requestDelegate.cancellationHandler = ^{
+        [head cancel];
+    };
+
+    return [[self headObject:head] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *headTask) {
+        request.requestDelegate.cancellationHandler = nil;
+        if (request.isCancelled) {
+            return [OSSTask taskWithError:[OSSClient cancelError]];
+        }
+        if (headTask.error) {
+            OSSLogVerbose(@"upload of %@ isn't skipped, its head failed: %@", objectKey, headTask.error);
+            return [OSSTask taskWithResult:nil];
+        }
+        OSSHeadObjectResult * headResult = headTask.result;
+        unsigned long long remoteSize = [headResult.objectMeta[@"Content-Length"] longLongValue];
+        unsigned long long localSize = data.length;
+        if (!data) {
+            NSError * error = nil;
+            localSize = [self getSizeWithFilePath:fileURL.path error:&error];
+            if (error) {
+                return [OSSTask taskWithResult:nil];
+            }
+        }
+        if (remoteSize != localSize) {
+            return [OSSTask taskWithResult:nil];
+        }
+
+        OSSFileDigestCache * digestCache = self.clientConfiguration.fileDigestCache ?: self.fileDigestCache;
+        BOOL isUnchanged = NO;
+        if ([headResult.remoteCRC64ecma oss_isNotEmpty]) {
+            NSString * crc64ecma = data ? [NSString stringWithFormat:@"%llu", [OSSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length]]
+                                        : [digestCache crc64ecmaOfFileAtPath:fileURL.path];
+            isUnchanged = [crc64ecma isEqualToString:headResult.remoteCRC64ecma];
+        } else {
+            // only the ETag of a single put is the MD5 of the content
+            NSString * eTag = [headResult.objectMeta[@"Etag"] stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"\""]];
+            if ([eTag oss_isNotEmpty] && [headResult.objectMeta[@"x-oss-object-type"] isEqualToString:@"Normal"]) {
+                NSString * md5 = data ? [OSSUtil dataMD5String:data] : [digestCache md5OfFileAtPath:fileURL.path];
+                isUnchanged = md5 && [eTag caseInsensitiveCompare:md5] == NSOrderedSame;
+            }
+        }
+        OSSLogVerbose(@"upload of %@ is %@", objectKey, isUnchanged ? @"skipped, the object is unchanged" : @"needed");
+        return [OSSTask taskWithResult:isUnchanged ? headResult : nil];
+    }];
+}
+
+- (NSString *)objectCacheKeyForBucketName:(NSString *)bucketName objectKey:(NSString *)objectKey {
+    NSString * scope = [OSSObjectCache scopeWithEndpoint:self.endpoint credentialProvider:self.credentialProvider];
+    return [OSSObjectCache keyWithScope:scope bucketName:bucketName objectKey:objectKey];
+}
+
+- (OSSGetObjectResult *)getObjectResultOfCacheEntry:(OSSObjectCacheEntry *)entry
+                                               data:(NSData *)data
+                                            request:(OSSGetObjectRequest *)request
+                                   httpResponseCode:(NSInteger)httpResponseCode {
+    OSSGetObjectResult * result = [OSSGetObjectResult new];
+    result.httpResponseCode = httpResponseCode;
+    result.httpResponseHeaderFields = entry.httpResponseHeaderFields;
+    result.objectMeta = entry.objectMeta;
+    if (request.downloadBuffer) {
+        [request.downloadBuffer setData:data];
+        result.downloadedData = request.downloadBuffer;
+    } else {
+        result.downloadedData = data;
+    }
+    return result;
+}
+
+- (BOOL)isServerError:(NSError *)error withStatusCode:(NSInteger)statusCode {
+    return [error.domain isEqualToString:OSSServerErrorDomain] && error.code == -statusCode;
+}
+
+- (OSSTask *)deleteObjectsInBatch:(OSSDeleteMultipleObjectsRequest *)request {
+    OSSNetworkingRequestDelegate * requestDelegate = request.requestDelegate;
+    NSData * body = [OSSUtil constructHttpBodyForDeleteMultipleObjects:request.keys quiet:request.quiet];
+    requestDelegate.uploadingData = body;
+    NSMutableDictionary * querys = [NSMutableDictionary dictionaryWithObject:@"" forKey:@"delete"];
+
+    requestDelegate.responseParser = [[OSSHttpResponseParser alloc] initForOperationType:OSSOperationTypeDeleteMultipleObjects];
+    requestDelegate.allNeededMessage = [[OSSAllRequestNeededMessage alloc] initWithEndpoint:self.endpoint
+                                                httpMethod:@"POST"
+                                                bucketName:request.bucketName
+                                                 objectKey:nil
+                                                      type:@"application/xml"
+                                                       md5:[OSSUtil base64Md5ForData:body]
+                                                     range:nil
+                                                      date:[[NSDate oss_clockSkewFixedDate] oss_asStringValue]
+                                              headerParams:nil
+                                                    querys:querys sha1:nil];
+    requestDelegate.operType = OSSOperationTypeDeleteMultipleObjects;
+
+    return [self invokeRequest:requestDelegate requireAuthentication:request.isAuthenticationRequired];
+}
+
+- (OSSNetworkingUploadProgressBlock)progressBlockForRequest:(OSSRequest *)request progress:(OSSNetworkingUploadProgressBlock)progress
+{
+    if (![OSSProgressReporter isProgressThrottledForRequest:request]) {
+        return progress;
+    }
+    OSSProgressReporter *progressReporter = [OSSProgressReporter reporterWithRequest:request progress:progress];
+    return ^(int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend) {
+        [progressReporter reportBytes:bytesSent totalBytes:totalBytesSent totalBytesExpected:totalBytesExpectedToSend];
+    };
+}
+
+- (void)enableCRC64WithFlag:(OSSRequestCRCFlag)flag requestDelegate:(OSSNetworkingRequestDelegate *)delegate
+{
+    switch (flag) {
+        case OSSRequestCRCOpen:
+            delegate.crc64Verifiable = YES;
+            break;
+        case OSSRequestCRCClosed:
+            delegate.crc64Verifiable = NO;
+            break;
         default:
             delegate.crc64Verifiable = self.clientConfiguration.crc64Verifiable;
             break;
@@ -1479,6 +3384,19 @@ static NSObject * lock;
     return errorTask;
 }
 
+- (OSSPartScheduler *)partSchedulerForRequest:(OSSMultipartUploadRequest *)request
+{
+    OSSPartScheduler *scheduler = [[OSSPartScheduler alloc] initWithConcurrency:request.concurrentPartCount partSize:request.partSize];
+    if (request.adaptivePartScheduling) {
+        scheduler.adaptsConcurrency = YES;
+        scheduler.maxConcurrency = MAX(request.maxConcurrentPartCount, scheduler.concurrency);
+        // the resumable record and the listed parts are mapped to the file by a fixed part size
+        scheduler.adaptsPartSize = ![request isKindOfClass:[OSSResumableUploadRequest class]];
+        scheduler.maxPartSize = MAX(request.maxPartSize, request.partSize);
+    }
+    return scheduler;
+}
+
 - (NSInteger)judgePartSizeForMultipartRequest:(OSSMultipartUploadRequest *)request fileSize:(int64_t)fileSize
 {
     BOOL divisible = (fileSize % request.partSize == 0);
@@ -1536,120 +3454,448 @@ static NSObject * lock;
 #pragma mark - sequential multipart upload
 
 - (OSSTask *)sequentialUpload:(OSSMultipartUploadRequest *)request
-                  uploadIndex:(NSMutableArray *)alreadyUploadIndex
+                  uploadIndex:(NSArray *)alreadyUploadIndex
                    uploadPart:(NSMutableArray *)alreadyUploadPart
                         count:(NSUInteger)partCout
-               uploadedLength:(NSUInteger *)uploadedLength
+               uploadedLength:(NSUInteger)uploadedLength
                      fileSize:(unsigned long long)uploadFileSize
+             progressReporter:(OSSProgressReporter *)progressReporter
 {
-    OSSRequestCRCFlag crcFlag = request.crcFlag;
-    __block BOOL isCancel = NO;
-    __block OSSTask *errorTask;
-    __block NSMutableDictionary *localPartInfos = nil;
-    
-    if (crcFlag == OSSRequestCRCOpen) {
-        localPartInfos = [self localPartInfosDictoryWithUploadId:request.uploadId];
+    // parts of a fixed size sent one after the other, in order. The read-ahead parts are read and
+    // digested while the one before them is sent, the window holds them and the one on the wire
+    OSSPartScheduler *scheduler = [[OSSPartScheduler alloc] initWithConcurrency:1 + request.sequentialReadAheadPartCount
+                                                                       partSize:request.partSize];
+    return [self uploadFileParts:request
+                       scheduler:scheduler
+                         inOrder:YES
+                     uploadIndex:alreadyUploadIndex
+                      uploadPart:alreadyUploadPart
+                           count:partCout
+                  uploadedLength:uploadedLength
+                        fileSize:uploadFileSize
+                progressReporter:progressReporter];
+}
+
+#pragma mark - multipart upload parts
+
+- (OSSTask *)uploadFileParts:(OSSMultipartUploadRequest *)request
+                   scheduler:(OSSPartScheduler *)scheduler
+                     inOrder:(BOOL)inOrder
+                 uploadIndex:(NSArray *)alreadyUploadIndex
+                  uploadPart:(NSMutableArray *)alreadyUploadPart
+                       count:(NSUInteger)partCout
+              uploadedLength:(NSUInteger)uploadedLength
+                    fileSize:(unsigned long long)uploadFileSize
+            progressReporter:(OSSProgressReporter *)progressReporter
+{
+    NSData *mappedFileData = nil;
+    NSFileHandle *fileHandle = nil;
+    OSSTask *openTask = [self openPartSourceWithFileURL:request.uploadingFileURL
+                                            mappedData:&mappedFileData
+                                            fileHandle:&fileHandle];
+    if (openTask) {
+        return openTask;
     }
     
-    if (!localPartInfos) {
-        localPartInfos = [NSMutableDictionary dictionary];
+    OSSMultipartPartsUpload *partsUpload = [OSSMultipartPartsUpload new];
+    partsUpload.request = request;
+    partsUpload.scheduler = scheduler;
+    partsUpload.sendsPartsInOrder = inOrder;
+    partsUpload.progressReporter = progressReporter;
+    if (request.crcFlag == OSSRequestCRCOpen) {
+        partsUpload.partInfoJournal = [self partInfoJournalWithUploadId:request.uploadId];
+    }
+    partsUpload.mappedFileData = mappedFileData;
+    partsUpload.fileHandle = fileHandle;
+    partsUpload.fileSize = uploadFileSize;
+    // the parts count is only known upfront when the part size is fixed
+    partsUpload.maxPartCount = scheduler.adaptsPartSize ? oss_multipart_max_part_number : partCout;
+    partsUpload.alreadyUploadedPartNumbers = [NSSet setWithArray:alreadyUploadIndex];
+    partsUpload.partInfos = alreadyUploadPart;
+    partsUpload.uploadedLength = uploadedLength;
+    return [self uploadParts:partsUpload];
+}
+
+/**
+ * the task completes once the parts started are finished, with the first error or the cancel error if any
+ */
+- (OSSTask *)uploadParts:(OSSMultipartPartsUpload *)partsUpload
+{
+    partsUpload.completionSource = [OSSTaskCompletionSource taskCompletionSource];
+    partsUpload.nextPartNumber = 1;
+    [self startPartsOfUpload:partsUpload];
+    return partsUpload.completionSource.task;
+}
+
+- (void)startPartsOfUpload:(OSSMultipartPartsUpload *)partsUpload
+{
+    // one thread at a time reads the parts, a part finishing meanwhile has it look for a slot again
+    @synchronized(partsUpload) {
+        if (partsUpload.isStartingParts) {
+            partsUpload.needsStartParts = YES;
+            return;
+        }
+        partsUpload.isStartingParts = YES;
     }
     
-    NSInputStream *inputStream = [NSInputStream inputStreamWithURL:request.uploadingFileURL];
-    [inputStream open];
-    
-    NSData * uploadPartData;
-    NSInteger realPartLength = request.partSize;
-    
-    for (int i = 1; i <= partCout; i++) {
-        @autoreleasepool{
-            if (i == partCout) {
-                realPartLength = uploadFileSize - request.partSize * (i - 1);
+    BOOL needsStartParts = YES;
+    while (needsStartParts) {
+        @synchronized(partsUpload) {
+            partsUpload.needsStartParts = NO;
+        }
+        [self startPartsUntilWindowIsFull:partsUpload];
+        @synchronized(partsUpload) {
+            needsStartParts = partsUpload.needsStartParts;
+            partsUpload.isStartingParts = needsStartParts;
+        }
+    }
+    [self finishUploadIfDone:partsUpload];
+}
+
+- (void)startPartsUntilWindowIsFull:(OSSMultipartPartsUpload *)partsUpload
+{
+    OSSPartScheduler *scheduler = partsUpload.scheduler;
+    while (YES) {
+        @autoreleasepool {
+            BOOL shouldStop = NO;
+            @synchronized(partsUpload) {
+                if (partsUpload.request.isCancelled) {
+                    partsUpload.isCancelled = YES;
+                }
+                shouldStop = partsUpload.isCancelled || partsUpload.error || partsUpload.isExhausted;
             }
-            NSMutableData *myBuffer = [NSMutableData dataWithLength:realPartLength];
-            uint8_t *buffer = [myBuffer mutableBytes];
-            NSInteger length = [inputStream read:buffer maxLength:realPartLength];
-            uploadPartData = [NSData dataWithBytes:buffer length:length];
-            
-            if (![inputStream hasBytesAvailable]) {
-                [inputStream close];
+            // a part is read once there's a slot for it, so at most the window of parts stay in memory
+            if (shouldStop || ![scheduler tryAcquireSlot]) {
+                break;
             }
-            //alreadyUploadIndex 为空 return false
-            if (alreadyUploadIndex && [alreadyUploadIndex containsObject:@(i)]) {
-                continue;
+            // and once its bytes fit in the memory the transfers of all the clients may hold
+            OSSMemoryGovernor *memoryGovernor = [OSSMemoryGovernor sharedGovernor];
+            int64_t reservedLength = [self expectedLengthOfNextPartOfUpload:partsUpload];
+            __weak OSSClient *weakSelf = self;
+            if (![memoryGovernor reserveBytes:reservedLength orRetryWithBlock:^{
+                [weakSelf startPartsOfUpload:partsUpload];
+            }]) {
+                [scheduler releaseSlot];
+                break;
             }
             
-            if (request.isCancelled) {
-                @synchronized(lock){
-                    if(!isCancel){
-                        isCancel = YES;
-                    }
-                }
+            int partNumber = 0;
+            NSError *readError = nil;
+            NSData *partData = [self nextPartDataOfUpload:partsUpload partNumber:&partNumber error:&readError];
+            if ((int64_t)partData.length > reservedLength) {
+                [memoryGovernor holdBytes:(int64_t)partData.length - reservedLength];
             } else {
-                OSSUploadPartRequest * uploadPart = [OSSUploadPartRequest new];
-                uploadPart.bucketName = request.bucketName;
-                uploadPart.objectkey = request.objectKey;
-                uploadPart.partNumber = i;
-                uploadPart.uploadId = request.uploadId;
-                uploadPart.uploadPartData = uploadPartData;
-                uploadPart.contentMd5 = [OSSUtil base64Md5ForData:uploadPartData];
-                uploadPart.crcFlag = request.crcFlag;
-                
-                OSSTask * uploadPartTask = [self uploadPart:uploadPart];
-                [uploadPartTask waitUntilFinished];
-                if (uploadPartTask.error && uploadPartTask.error.code != 409) {
-                    errorTask = uploadPartTask;
-                    break;
+                [memoryGovernor releaseBytes:reservedLength - (int64_t)partData.length];
+            }
+            @synchronized(partsUpload) {
+                if (partData) {
+                    partsUpload.runningCount++;
+                } else if (readError) {
+                    partsUpload.error = partsUpload.error ?: readError;
                 } else {
-                    OSSUploadPartResult * result = uploadPartTask.result;
-                    OSSPartInfo * partInfo = [OSSPartInfo new];
-                    partInfo.partNum = i;
-                    partInfo.eTag = result.eTag;
-                    partInfo.size = realPartLength;
-                    uint64_t crc64OfPart;
-                    @try {
-                        NSScanner *scanner = [NSScanner scannerWithString:result.remoteCRC64ecma];
-                        [scanner scanUnsignedLongLong:&crc64OfPart];
-                        partInfo.crc64 = crc64OfPart;
-                    } @catch (NSException *exception) {
-                        OSSLogError(@"multipart upload error with nil remote crc64!");
-                    }
-                    
-                    @synchronized(lock){
-                        
-                        [alreadyUploadPart addObject:partInfo];
-                        
-                        if (crcFlag == OSSRequestCRCOpen)
-                        {
-                            [self processForLocalPartInfos:localPartInfos
-                                                  partInfo:partInfo
-                                                  uploadId:request.uploadId];
-                            [self persistencePartInfos:localPartInfos
-                                          withUploadId:request.uploadId];
-                        }
-                        *uploadedLength += realPartLength;
-                        if (request.uploadProgress)
-                        {
-                            request.uploadProgress(realPartLength, *uploadedLength, uploadFileSize);
-                        }
-                    }
+                    partsUpload.isExhausted = YES;
                 }
             }
-            if (isCancel) {
-                errorTask = [OSSTask taskWithError:[OSSClient cancelError]];
+            if (!partData) {
+                [scheduler releaseSlot];
                 break;
             }
+            [self sendPart:partNumber data:partData ofUpload:partsUpload];
         }
     }
+}
+
+/**
+ * the length of the next part as far as it's known before the part is read
+ */
+- (int64_t)expectedLengthOfNextPartOfUpload:(OSSMultipartPartsUpload *)partsUpload
+{
+    if (partsUpload.body) {
+        return partsUpload.request.partSize;
+    }
+    if (partsUpload.nextPartNumber > partsUpload.maxPartCount || partsUpload.partOffset >= partsUpload.fileSize) {
+        return 0;
+    }
+    return [partsUpload.scheduler partSizeForRemainingLength:partsUpload.fileSize - partsUpload.partOffset
+                                          remainingPartCount:partsUpload.maxPartCount - partsUpload.nextPartNumber + 1];
+}
+
+/**
+ * returns nil once there's no part left or on error
+ */
+- (NSData *)nextPartDataOfUpload:(OSSMultipartPartsUpload *)partsUpload partNumber:(int *)partNumber error:(NSError **)error
+{
+    OSSStreamingBody *body = partsUpload.body;
+    if (body) {
+        if (body.isAtEnd) {
+            return nil;
+        }
+        int i = partsUpload.nextPartNumber++;
+        // blocks until the part is read from the stream or produced
+        NSData *partData = [body readDataOfMaxLength:partsUpload.request.partSize error:error];
+        if (!partData) {
+            return nil;
+        }
+        if (i > oss_multipart_max_part_number && partData.length > 0) {
+            *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                         code:OSSClientErrorCodeInvalidArgument
+                                     userInfo:@{OSSErrorMessageTOKEN: @"The stream is larger than partSize * 5000, please set a larger partSize!"}];
+            return nil;
+        }
+        if (partData.length == 0 && i > 1) {
+            // the body ended right after a full part
+            return nil;
+        }
+        *partNumber = i;
+        return partData;
+    }
     
-    return errorTask;
+    while (partsUpload.nextPartNumber <= partsUpload.maxPartCount && partsUpload.partOffset < partsUpload.fileSize) {
+        int i = partsUpload.nextPartNumber++;
+        NSUInteger partLength = [partsUpload.scheduler partSizeForRemainingLength:partsUpload.fileSize - partsUpload.partOffset
+                                                               remainingPartCount:partsUpload.maxPartCount - i + 1];
+        unsigned long long offset = partsUpload.partOffset;
+        partsUpload.partOffset += partLength;
+        
+        if ([partsUpload.alreadyUploadedPartNumbers containsObject:@(i)]) {
+            continue;
+        }
+        *partNumber = i;
+        return [self partDataWithMappedData:partsUpload.mappedFileData
+                                 fileHandle:partsUpload.fileHandle
+                                      range:NSMakeRange((NSUInteger)offset, partLength)];
+    }
+    return nil;
 }
 
-- (NSMutableDictionary *)localPartInfosDictoryWithUploadId:(NSString *)uploadId
+- (void)sendPart:(int)partNumber data:(NSData *)partData ofUpload:(OSSMultipartPartsUpload *)partsUpload
+{
+    OSSMultipartUploadRequest *request = partsUpload.request;
+    __block CFAbsoluteTime startTime = 0;
+    // the digests are computed on the operation queue, alongside the other parts
+    OSSTask *preparedTask = [[OSSTask taskWithResult:nil] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *task) {
+        if (request.isCancelled) {
+            return [OSSTask taskWithError:[OSSClient cancelError]];
+        }
+        OSSUploadPartRequest * uploadPart = [OSSUploadPartRequest new];
+        uploadPart.bucketName = request.bucketName;
+        uploadPart.objectkey = request.objectKey;
+        uploadPart.partNumber = partNumber;
+        uploadPart.uploadId = request.uploadId;
+        uploadPart.uploadPartData = partData;
+        uploadPart.crcFlag = request.crcFlag;
+        uploadPart.priority = request.priority;
+        [self digestPartData:partData forUploadPart:uploadPart];
+        return uploadPart;
+    }];
+    if (partsUpload.sendsPartsInOrder && partsUpload.lastPartTask) {
+        // prepared meanwhile, the part waits for the previous one to be finished
+        preparedTask = [partsUpload.lastPartTask continueWithBlock:^id(OSSTask *lastPartTask) {
+            return preparedTask;
+        }];
+    }
+    
+    OSSTask *partTask = [[preparedTask continueWithExecutor:self.ossOperationExecutor withSuccessBlock:^id(OSSTask *task) {
+        BOOL previousPartFailed = NO;
+        @synchronized(partsUpload) {
+            previousPartFailed = partsUpload.sendsPartsInOrder && partsUpload.error != nil;
+        }
+        if (request.isCancelled || previousPartFailed) {
+            // the part after a failed one isn't sent, the upload fails with the first error
+            return [OSSTask taskWithError:[OSSClient cancelError]];
+        }
+        startTime = CFAbsoluteTimeGetCurrent();
+        return [self uploadPart:task.result ofRequest:request];
+    }] continueWithExecutor:self.ossOperationExecutor withBlock:^id(OSSTask *uploadPartTask) {
+        if (startTime > 0) {
+            [partsUpload.scheduler recordPartWithLength:partData.length
+                                              startTime:startTime
+                                                endTime:CFAbsoluteTimeGetCurrent()
+                                              succeeded:uploadPartTask.error == nil];
+        }
+        [self didSendPart:partNumber length:partData.length task:uploadPartTask ofUpload:partsUpload];
+        [[OSSMemoryGovernor sharedGovernor] releaseBytes:partData.length];
+        [partsUpload.scheduler releaseSlot];
+        [self startPartsOfUpload:partsUpload];
+        return nil;
+    }];
+    if (partsUpload.sendsPartsInOrder) {
+        partsUpload.lastPartTask = partTask;
+    }
+}
+
+- (void)didSendPart:(int)partNumber length:(NSUInteger)partLength task:(OSSTask *)uploadPartTask ofUpload:(OSSMultipartPartsUpload *)partsUpload
+{
+    if (uploadPartTask.error && (partsUpload.body || uploadPartTask.error.code != 409)) {
+        @synchronized(partsUpload) {
+            partsUpload.runningCount--;
+            partsUpload.error = partsUpload.error ?: uploadPartTask.error;
+        }
+        return;
+    }
+    
+    OSSUploadPartResult * result = uploadPartTask.result;
+    uint64_t crc64OfPart = 0;
+    if (result.remoteCRC64ecma) {
+        [[NSScanner scannerWithString:result.remoteCRC64ecma] scanUnsignedLongLong:&crc64OfPart];
+    } else if (partsUpload.request.crcFlag == OSSRequestCRCOpen) {
+        OSSLogError(@"multipart upload error with nil remote crc64!");
+    }
+    OSSPartInfo * partInfo = [OSSPartInfo partInfoWithPartNum:partNumber eTag:result.eTag size:partLength crc64:crc64OfPart];
+    
+    // the journal has its own lock, appending a record doesn't hold up the other parts
+    [partsUpload.partInfoJournal appendPartInfo:partInfo error:nil];
+    
+    // the byte count and the progress stay under one lock, so totals are reported in order
+    @synchronized(partsUpload) {
+        [partsUpload.partInfos addObject:partInfo];
+        partsUpload.uploadedLength += partLength;
+        partsUpload.runningCount--;
+        // the total of a streaming body isn't known before it's over
+        int64_t totalBytesExpected = partsUpload.body ? -1 : (int64_t)partsUpload.fileSize;
+        [partsUpload.progressReporter reportBytes:partLength totalBytes:partsUpload.uploadedLength totalBytesExpected:totalBytesExpected];
+    }
+}
+
+- (void)finishUploadIfDone:(OSSMultipartPartsUpload *)partsUpload
+{
+    NSError *error = nil;
+    @synchronized(partsUpload) {
+        BOOL isDone = partsUpload.runningCount == 0 && (partsUpload.isCancelled || partsUpload.error || partsUpload.isExhausted);
+        if (!isDone || partsUpload.isFinished) {
+            return;
+        }
+        partsUpload.isFinished = YES;
+        error = partsUpload.isCancelled ? [OSSClient cancelError] : partsUpload.error;
+    }
+    
+    [partsUpload.fileHandle closeFile];
+    [partsUpload.partInfoJournal close];
+    if (error) {
+        [partsUpload.completionSource setError:error];
+    } else {
+        [partsUpload.completionSource setResult:nil];
+    }
+}
+
+/**
+ * sends a part of a multipart upload, from a slice file in background mode
+ */
+- (OSSTask *)uploadPart:(OSSUploadPartRequest *)uploadPart ofRequest:(OSSMultipartUploadRequest *)request
+{
+    NSURL *sliceURL = nil;
+    if (request.backgroundPartTransfer) {
+        sliceURL = [self writeSliceWithData:uploadPart.uploadPartData uploadId:uploadPart.uploadId partNumber:uploadPart.partNumber];
+    }
+    if (!sliceURL) {
+        return [self uploadPart:uploadPart];
+    }
+    
+    uploadPart.uploadPartFileURL = sliceURL;
+    uploadPart.uploadPartData = nil;
+    uploadPart.requestDelegate.isUploadingFileSlice = YES;
+    return [[self uploadPart:uploadPart] continueWithBlock:^id(OSSTask *uploadPartTask) {
+        [[NSFileManager defaultManager] removeItemAtURL:sliceURL error:nil];
+        return uploadPartTask;
+    }];
+}
+
+- (NSString *)sliceDirectoryWithUploadId:(NSString *)uploadId
+{
+    NSString *slicesDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:@"com.aliyun.oss.slices"];
+    return [slicesDirectory stringByAppendingPathComponent:uploadId];
+}
+
+/**
+ * the slice is named uniquely, a task left by a previous process removes its own slice only
+ */
+- (NSURL *)writeSliceWithData:(NSData *)data uploadId:(NSString *)uploadId partNumber:(int)partNumber
+{
+    NSString *sliceDirectory = [self sliceDirectoryWithUploadId:uploadId];
+    NSError *error = nil;
+    if (![[NSFileManager defaultManager] createDirectoryAtPath:sliceDirectory withIntermediateDirectories:YES attributes:nil error:&error]) {
+        OSSLogError(@"create slice directory error: %@, the part is uploaded from memory", error);
+        return nil;
+    }
+    
+    NSString *sliceName = [NSString stringWithFormat:@"%d-%@", partNumber, [NSUUID UUID].UUIDString];
+    NSURL *sliceURL = [NSURL fileURLWithPath:[sliceDirectory stringByAppendingPathComponent:sliceName]];
+    NSDataWritingOptions options = NSDataWritingAtomic;
+#if TARGET_OS_IOS
+    // the background session has to read it while the device is locked
+    options |= NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication;
+#endif
+    if (![data writeToURL:sliceURL options:options error:&error]) {
+        OSSLogError(@"write slice error: %@, the part is uploaded from memory", error);
+        return nil;
+    }
+    return sliceURL;
+}
+
+- (void)removeSlicesWithUploadId:(NSString *)uploadId
+{
+    if ([uploadId oss_isNotEmpty]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[self sliceDirectoryWithUploadId:uploadId] error:nil];
+    }
+}
+
+- (void)digestPartData:(NSData *)partData forUploadPart:(OSSUploadPartRequest *)uploadPart
+{
+    OSSInputStreamHelper *helper = [[OSSInputStreamHelper alloc] initWithData:partData];
+    helper.digestTypes = OSSDigestTypeMD5;
+    if (uploadPart.crcFlag == OSSRequestCRCOpen) {
+        helper.digestTypes |= OSSDigestTypeCRC64;
+    }
+    [helper syncReadBuffers];
+    
+    uploadPart.contentMd5 = helper.base64Md5;
+    if (uploadPart.crcFlag == OSSRequestCRCOpen) {
+        uploadPart.requestDelegate.contentCRC = [NSString stringWithFormat:@"%llu", helper.crc64];
+    }
+}
+
+- (OSSTask *)openPartSourceWithFileURL:(NSURL *)fileURL mappedData:(NSData **)mappedData fileHandle:(NSFileHandle **)fileHandle
+{
+    NSError *error = nil;
+    // map the file so that part bodies are served straight from the page cache
+    *mappedData = [NSData dataWithContentsOfURL:fileURL options:NSDataReadingMappedAlways error:&error];
+    if (*mappedData) {
+        return nil;
+    }
+    OSSLogDebug(@"map file failed(%@), fall back to ranged reads", error);
+    
+    *fileHandle = [NSFileHandle fileHandleForReadingFromURL:fileURL error:&error];
+    if (!*fileHandle) {
+        return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                          code:OSSClientErrorCodeInvalidArgument
+                                                      userInfo:@{OSSErrorMessageTOKEN: [NSString stringWithFormat:@"Can not read the uploading file: %@", error]}]];
+    }
+    return nil;
+}
+
+- (NSData *)partDataWithMappedData:(NSData *)mappedData fileHandle:(NSFileHandle *)fileHandle range:(NSRange)range
+{
+    if (mappedData) {
+        // the slice shares the mapped pages, its deallocator keeps the mapping alive
+        void *partBytes = (uint8_t *)mappedData.bytes + range.location;
+        return [[NSData alloc] initWithBytesNoCopy:partBytes length:range.length deallocator:^(void *bytes, NSUInteger length) {
+            [mappedData self];
+        }];
+    }
+    
+    [fileHandle seekToFileOffset:range.location];
+    return [fileHandle readDataOfLength:range.length];
+}
+
+- (NSString *)partInfosJournalPathWithUploadId:(NSString *)uploadId
+{
+    NSString *partInfosDirectory = [[NSString oss_documentDirectory] stringByAppendingPathComponent:oss_partInfos_storage_name];
+    return [[partInfosDirectory stringByAppendingPathComponent:uploadId] stringByAppendingString:oss_partInfos_journal_suffix];
+}
+
+- (OSSPartInfoJournal *)partInfoJournalWithUploadId:(NSString *)uploadId
 {
-    NSMutableDictionary *localPartInfoDict = nil;
     NSString *partInfosDirectory = [[NSString oss_documentDirectory] stringByAppendingPathComponent:oss_partInfos_storage_name];
-    NSString *partInfosPath = [partInfosDirectory stringByAppendingPathComponent:uploadId];
     BOOL isDirectory;
     NSFileManager *defaultFM = [NSFileManager defaultManager];
     if (!([defaultFM fileExistsAtPath:partInfosDirectory isDirectory:&isDirectory] && isDirectory))
@@ -1661,31 +3907,28 @@ static NSObject * lock;
         };
     }
     
-    if (![defaultFM fileExistsAtPath:partInfosPath])
+    OSSPartInfoJournal *journal = [[OSSPartInfoJournal alloc] initWithFilePath:[self partInfosJournalPathWithUploadId:uploadId]];
+    
+    // former versions stored the part infos of an upload as a plist named by its uploadId
+    NSString *legacyPartInfosPath = [partInfosDirectory stringByAppendingPathComponent:uploadId];
+    if ([defaultFM fileExistsAtPath:legacyPartInfosPath])
     {
-        if (![defaultFM createFileAtPath:partInfosPath
-                               contents:nil
-                             attributes:nil])
+        NSDictionary *legacyPartInfos = [NSDictionary dictionaryWithContentsOfFile:legacyPartInfosPath];
+        if (legacyPartInfos.count > 0 && [journal partInfos].count == 0)
         {
-            OSSLogError(@"create local partInfo file failed!");
+            [journal resetWithPartInfos:legacyPartInfos error:nil];
         }
+        [defaultFM removeItemAtPath:legacyPartInfosPath error:nil];
     }
-    localPartInfoDict = [[NSMutableDictionary alloc] initWithContentsOfURL:[NSURL fileURLWithPath:partInfosPath]];
-    return localPartInfoDict;
+    return journal;
 }
 
-- (OSSTask *)persistencePartInfos:(NSDictionary *)partInfos withUploadId:(NSString *)uploadId
+- (NSMutableDictionary *)localPartInfosDictoryWithUploadId:(NSString *)uploadId
 {
-    NSString *filePath = [[[NSString oss_documentDirectory] stringByAppendingPathComponent:oss_partInfos_storage_name] stringByAppendingPathComponent:uploadId];
-    if (![partInfos writeToFile:filePath atomically:YES])
-    {
-        NSError *error = [NSError errorWithDomain:OSSClientErrorDomain
-                                             code:OSSClientErrorCodeFileCantWrite
-                                         userInfo:@{OSSErrorMessageTOKEN: @"uploadId for this task can't be stored persistentially!"}];
-        OSSLogDebug(@"[Error]: %@", error);
-        return [OSSTask taskWithError:error];
-    }
-    return nil;
+    OSSPartInfoJournal *journal = [self partInfoJournalWithUploadId:uploadId];
+    NSMutableDictionary *localPartInfoDict = [journal partInfos];
+    [journal close];
+    return localPartInfoDict;
 }
 
 - (OSSTask *)checkFileSizeWithRequest:(OSSMultipartUploadRequest *)request {
@@ -0,0 +1,72 @@
+//
+//  OSSContentCompressor.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "OSSModel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Compresses an upload body with zlib into the gzip or deflate (RFC 1950) Content-Encoding.
+
+ The bytes are compressed in pieces as they come, so a body of any length is compressed with
+ a fixed amount of memory. An instance compresses one body, it isn't thread safe.
+ */
+@interface OSSContentCompressor : NSObject
+
+@property (nonatomic, assign, readonly) OSSContentCompression compression;
+
+/**
+ The Content-Encoding header of the compressed body, gzip or deflate.
+ */
+@property (nonatomic, copy, readonly) NSString * contentEncoding;
+
+/**
+ Returns nil for OSSContentCompressionNone.
+ */
+- (nullable instancetype)initWithCompression:(OSSContentCompression)compression;
+
+/**
+ Compresses the next bytes of the body. The result may be empty while zlib buffers the input.
+ finish ends the body and returns the rest of it, the compressor can't be used after that.
+ Returns nil on error.
+ */
+- (nullable NSData *)compressData:(nullable NSData *)data finish:(BOOL)finish error:(NSError **)error;
+
++ (nullable NSData *)compressData:(NSData *)data compression:(OSSContentCompression)compression error:(NSError **)error;
+
+/**
+ Writes the compressed file to destinationURL, replacing it if it exists.
+ */
++ (BOOL)compressFileAtURL:(NSURL *)fileURL
+                    toURL:(NSURL *)destinationURL
+              compression:(OSSContentCompression)compression
+                    error:(NSError **)error;
+
+/**
+ Returns a producer of the compressed bytes of the ones made by producer, which are compressed
+ on the thread reading the new producer.
+ */
++ (OSSUploadDataProducerBlock)producerCompressingProducer:(OSSUploadDataProducerBlock)producer
+                                              compression:(OSSContentCompression)compression;
+
+/**
+ Returns a producer of the compressed bytes read from inputStream. The stream is opened on the
+ first call and closed at its end.
+ */
++ (OSSUploadDataProducerBlock)producerCompressingInputStream:(NSInputStream *)inputStream
+                                                 compression:(OSSContentCompression)compression;
+
+/**
+ Decodes gzip or deflate data, e.g. an object downloaded with a session that doesn't decode
+ Content-Encoding itself.
+ */
++ (nullable NSData *)decompressData:(NSData *)data error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,259 @@
+//
+//  OSSContentCompressor.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSContentCompressor.h"
+#import "OSSDefine.h"
+#import "OSSLog.h"
+#import <zlib.h>
+
+static NSUInteger const oss_compression_chunk_size = 64 * 1024;
+/* zlib counts its input in uInt, larger data is fed in slices */
+static NSUInteger const oss_compression_max_slice = 1 << 30;
+
+static NSError * oss_compressionError(NSString *message, int code) {
+    return [NSError errorWithDomain:OSSClientErrorDomain
+                               code:OSSClientErrorCodeNotKnown
+                           userInfo:@{OSSErrorMessageTOKEN: [NSString stringWithFormat:@"%@ (zlib error %d)", message, code]}];
+}
+
+@implementation OSSContentCompressor {
+    z_stream _stream;
+    BOOL _finished;
+}
+
+- (instancetype)initWithCompression:(OSSContentCompression)compression {
+    if (compression != OSSContentCompressionGzip && compression != OSSContentCompressionDeflate) {
+        return nil;
+    }
+    if (self = [super init]) {
+        _compression = compression;
+        _contentEncoding = compression == OSSContentCompressionGzip ? @"gzip" : @"deflate";
+        // 16 more window bits ask zlib for the gzip header and trailer instead of the zlib ones
+        int windowBits = compression == OSSContentCompressionGzip ? MAX_WBITS + 16 : MAX_WBITS;
+        int ret = deflateInit2(&_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+        if (ret != Z_OK) {
+            OSSLogError(@"deflateInit2 failed: %d", ret);
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    deflateEnd(&_stream);
+}
+
+- (NSData *)compressData:(NSData *)data finish:(BOOL)finish error:(NSError **)error {
+    if (_finished) {
+        if (error) {
+            *error = oss_compressionError(@"The compressed body is already finished!", Z_STREAM_ERROR);
+        }
+        return nil;
+    }
+
+    NSMutableData *output = [NSMutableData data];
+    const uint8_t *bytes = data.bytes;
+    NSUInteger remain = data.length;
+    do {
+        NSUInteger slice = MIN(remain, oss_compression_max_slice);
+        BOOL lastSlice = slice == remain;
+        int flush = (finish && lastSlice) ? Z_FINISH : Z_NO_FLUSH;
+        _stream.next_in = (Bytef *)bytes;
+        _stream.avail_in = (uInt)slice;
+
+        int ret = Z_OK;
+        do {
+            NSUInteger offset = output.length;
+            [output setLength:offset + oss_compression_chunk_size];
+            _stream.next_out = (Bytef *)output.mutableBytes + offset;
+            _stream.avail_out = (uInt)oss_compression_chunk_size;
+            ret = deflate(&_stream, flush);
+            [output setLength:output.length - _stream.avail_out];
+            if (ret == Z_STREAM_ERROR) {
+                if (error) {
+                    *error = oss_compressionError(@"Can not compress the upload body!", ret);
+                }
+                return nil;
+            }
+            // the output buffer being filled up means zlib may have more to give
+        } while (_stream.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+
+        bytes += slice;
+        remain -= slice;
+    } while (remain > 0);
+
+    _finished = finish;
+    return output;
+}
+
++ (NSData *)compressData:(NSData *)data compression:(OSSContentCompression)compression error:(NSError **)error {
+    OSSContentCompressor *compressor = [[OSSContentCompressor alloc] initWithCompression:compression];
+    if (!compressor) {
+        if (error) {
+            *error = oss_compressionError(@"Unsupported content compression!", Z_STREAM_ERROR);
+        }
+        return nil;
+    }
+    return [compressor compressData:data finish:YES error:error];
+}
+
++ (BOOL)compressFileAtURL:(NSURL *)fileURL
+                    toURL:(NSURL *)destinationURL
+              compression:(OSSContentCompression)compression
+                    error:(NSError **)error {
+    OSSUploadDataProducerBlock producer = [self producerCompressingInputStream:[NSInputStream inputStreamWithURL:fileURL]
+                                                                   compression:compression];
+    NSOutputStream *outputStream = [NSOutputStream outputStreamWithURL:destinationURL append:NO];
+    [outputStream open];
+
+    BOOL succeeded = YES;
+    while (succeeded) {
+        @autoreleasepool {
+            NSError *producerError = nil;
+            NSData *compressed = producer(&producerError);
+            if (producerError) {
+                if (error) {
+                    *error = producerError;
+                }
+                succeeded = NO;
+                break;
+            }
+            if (!compressed.length) {
+                break;
+            }
+
+            const uint8_t *bytes = compressed.bytes;
+            NSUInteger remain = compressed.length;
+            while (remain > 0) {
+                NSInteger written = [outputStream write:bytes maxLength:remain];
+                if (written <= 0) {
+                    if (error) {
+                        *error = outputStream.streamError ?: [NSError errorWithDomain:OSSClientErrorDomain
+                                                                                 code:OSSClientErrorCodeFileCantWrite
+                                                                             userInfo:@{OSSErrorMessageTOKEN: @"Can not write the compressed file!"}];
+                    }
+                    succeeded = NO;
+                    break;
+                }
+                bytes += written;
+                remain -= written;
+            }
+        }
+    }
+    [outputStream close];
+
+    if (!succeeded) {
+        [[NSFileManager defaultManager] removeItemAtURL:destinationURL error:nil];
+    }
+    return succeeded;
+}
+
++ (OSSUploadDataProducerBlock)producerCompressingProducer:(OSSUploadDataProducerBlock)producer
+                                              compression:(OSSContentCompression)compression {
+    OSSContentCompressor *compressor = [[OSSContentCompressor alloc] initWithCompression:compression];
+    __block BOOL finished = NO;
+    return ^NSData *(NSError **error) {
+        // zlib holds small inputs back, so it's fed until some bytes come out or the body is over
+        while (!finished) {
+            NSError *producerError = nil;
+            NSData *data = producer(&producerError);
+            if (producerError) {
+                if (error) {
+                    *error = producerError;
+                }
+                return nil;
+            }
+
+            finished = data.length == 0;
+            NSData *compressed = [compressor compressData:data finish:finished error:error];
+            if (!compressed) {
+                return nil;
+            }
+            if (compressed.length) {
+                return compressed;
+            }
+        }
+        return nil;
+    };
+}
+
++ (OSSUploadDataProducerBlock)producerCompressingInputStream:(NSInputStream *)inputStream
+                                                 compression:(OSSContentCompression)compression {
+    OSSUploadDataProducerBlock reader = ^NSData *(NSError **error) {
+        if (inputStream.streamStatus == NSStreamStatusNotOpen) {
+            [inputStream open];
+        }
+        NSMutableData *data = [NSMutableData dataWithLength:oss_compression_chunk_size];
+        // blocks until bytes are available, the stream isn't scheduled in a run loop
+        NSInteger readLength = [inputStream read:data.mutableBytes maxLength:data.length];
+        if (readLength < 0) {
+            if (error) {
+                *error = inputStream.streamError ?: [NSError errorWithDomain:OSSClientErrorDomain
+                                                                        code:OSSClientErrorCodeNotKnown
+                                                                    userInfo:@{OSSErrorMessageTOKEN: @"Can not read the upload stream!"}];
+            }
+            [inputStream close];
+            return nil;
+        }
+        if (readLength == 0) {
+            [inputStream close];
+            return nil;
+        }
+        [data setLength:readLength];
+        return data;
+    };
+    return [self producerCompressingProducer:reader compression:compression];
+}
+
++ (NSData *)decompressData:(NSData *)data error:(NSError **)error {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // 32 more window bits let zlib tell the gzip and zlib headers apart
+    int ret = inflateInit2(&stream, MAX_WBITS + 32);
+    if (ret != Z_OK) {
+        if (error) {
+            *error = oss_compressionError(@"Can not decompress the data!", ret);
+        }
+        return nil;
+    }
+
+    NSMutableData *output = [NSMutableData dataWithCapacity:data.length * 4];
+    const uint8_t *bytes = data.bytes;
+    NSUInteger remain = data.length;
+    while (remain > 0 && ret == Z_OK) {
+        NSUInteger slice = MIN(remain, oss_compression_max_slice);
+        stream.next_in = (Bytef *)bytes;
+        stream.avail_in = (uInt)slice;
+        do {
+            NSUInteger offset = output.length;
+            [output setLength:offset + oss_compression_chunk_size];
+            stream.next_out = (Bytef *)output.mutableBytes + offset;
+            stream.avail_out = (uInt)oss_compression_chunk_size;
+            ret = inflate(&stream, Z_NO_FLUSH);
+            [output setLength:output.length - stream.avail_out];
+            if (ret == Z_STREAM_END && (stream.avail_in > 0 || remain > slice)) {
+                // the parts of a multipart upload compressed one by one are gzip members one after another
+                ret = inflateReset(&stream);
+            }
+        } while (ret == Z_OK && (stream.avail_in > 0 || stream.avail_out == 0));
+
+        NSUInteger consumed = slice - stream.avail_in;
+        bytes += consumed;
+        remain -= consumed;
+    }
+    inflateEnd(&stream);
+
+    if (ret != Z_STREAM_END || remain > 0) {
+        if (error) {
+            *error = oss_compressionError(@"Can not decompress the data!", ret);
+        }
+        return nil;
+    }
+    return output;
+}
+
+@end
@@ -63,9 +63,13 @@
 #define OSSHttpHeaderCacheControl               @"Cache-Control"
 #define OSSHttpHeaderExpires                    @"Expires"
 #define OSSHttpHeaderHashSHA1                   @"x-oss-hash-sha1"
+#define OSSHttpHeaderCopySource                 @"x-oss-copy-source"
+#define OSSHttpHeaderCopySourceRange            @"x-oss-copy-source-range"
+#define OSSHttpHeaderCopySourceIfMatch          @"x-oss-copy-source-if-match"
 
 #define OSSDefaultRetryCount                    3
 #define OSSDefaultMaxConcurrentNum              5
+#define OSSDeleteMultipleObjectsMaxKeys         1000
 #define OSSDefaultTimeoutForRequestInSecond     15
 #define OSSDefaultTimeoutForResourceInSecond    7 * 24 * 60 * 60
 
@@ -0,0 +1,71 @@
+//
+//  OSSEndpointSelector.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Picks the endpoint each request of a client is sent to, among its endpoint and the alternative ones,
+ e.g. the regional one and the transfer acceleration one.
+
+ Every endpoint has a health score: its smoothed connect time, plus a penalty growing with its recent
+ connect failures. The endpoints are raced Happy Eyeballs style, with a probe sent to each of them
+ in turn, stagger seconds apart, until one of them answers. They're raced when the selector is
+ created and again when the endpoint in use fails to connect, so the requests leave a failing edge
+ without each of them waiting for its timeout.
+
+ Until an alternative endpoint is measured, the first endpoint is used while it's healthy.
+ */
+@interface OSSEndpointSelector : NSObject
+
+/**
+ The endpoints, the first one is the endpoint of the client.
+ */
+@property (nonatomic, copy, readonly) NSArray<NSString *> * endpoints;
+
+/**
+ The delay between two probes of a race, 0.25 second by default as in RFC 8305.
+ */
+@property (atomic, assign) NSTimeInterval stagger;
+
+/**
+ The time a probe waits for an answer, 3 seconds by default.
+ */
+@property (atomic, assign) NSTimeInterval probeTimeout;
+
+- (instancetype)initWithEndpoints:(NSArray<NSString *> *)endpoints;
+
+/**
+ The endpoint with the best score.
+ */
+- (NSString *)bestEndpoint;
+
+/**
+ YES if an endpoint other than this one isn't penalized.
+ */
+- (BOOL)hasHealthyEndpointOtherThan:(NSString *)endpoint;
+
+/**
+ Probes the endpoints in the background, staggered, until one of them answers. A race already
+ running isn't started again.
+ */
+- (void)raceEndpoints;
+
+/**
+ Reports that a request reached the endpoint, with its connect time, 0 when it reused a connection.
+ */
+- (void)reportSuccessForEndpoint:(NSString *)endpoint connectRTT:(NSTimeInterval)rtt;
+
+/**
+ Reports that a request failed to connect to the endpoint. A race is started when it was the best one.
+ */
+- (void)reportConnectFailureForEndpoint:(NSString *)endpoint;
+
+@end
+
+NS_ASSUME_NONNULL_END
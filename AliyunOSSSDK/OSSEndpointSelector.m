@@ -0,0 +1,235 @@
+//
+//  OSSEndpointSelector.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSEndpointSelector.h"
+#import "OSSIPv6Adapter.h"
+#import "OSSLog.h"
+
+static NSTimeInterval const oss_endpoint_failure_penalty = 30;      // an endpoint which failed to connect is avoided this long per failure
+static NSUInteger const oss_endpoint_max_penalized_failures = 10;
+static NSTimeInterval const oss_endpoint_unmeasured_rtt = 10;       // the score of an alternative endpoint never measured
+static NSTimeInterval const oss_endpoint_min_race_interval = 5;
+static double const oss_endpoint_rtt_smoothing_factor = 0.3;
+
+@interface OSSEndpointHealth : NSObject
+
+@property (nonatomic, assign) NSTimeInterval rtt;       // smoothed connect time, 0 if never measured
+@property (nonatomic, assign) NSUInteger failureCount;  // consecutive connect failures
+@property (nonatomic, assign) NSTimeInterval lastFailureTime;
+
+@end
+
+@implementation OSSEndpointHealth
+@end
+
+@implementation OSSEndpointSelector {
+    NSArray<OSSEndpointHealth *> * _healths;
+    NSURLSession * _probeSession;
+    dispatch_queue_t _raceQueue;
+    BOOL _isRacing;
+    NSTimeInterval _lastRaceTime;
+}
+
+- (instancetype)initWithEndpoints:(NSArray<NSString *> *)endpoints {
+    if (self = [super init]) {
+        _endpoints = [[[NSOrderedSet orderedSetWithArray:endpoints] array] copy];
+        NSMutableArray<OSSEndpointHealth *> * healths = [NSMutableArray arrayWithCapacity:_endpoints.count];
+        for (NSUInteger i = 0; i < _endpoints.count; i++) {
+            [healths addObject:[OSSEndpointHealth new]];
+        }
+        _healths = healths;
+        _stagger = 0.25;
+        _probeTimeout = 3;
+        _raceQueue = dispatch_queue_create("com.aliyun.oss.endpoint.race", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_probeSession invalidateAndCancel];
+}
+
+- (NSString *)bestEndpoint {
+    @synchronized(self) {
+        return _endpoints[[self bestIndex]];
+    }
+}
+
+- (BOOL)hasHealthyEndpointOtherThan:(NSString *)endpoint {
+    NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+    @synchronized(self) {
+        for (NSUInteger i = 0; i < _endpoints.count; i++) {
+            if (![_endpoints[i] isEqualToString:endpoint] && [self penaltyOfHealth:_healths[i] now:now] == 0) {
+                return YES;
+            }
+        }
+    }
+    return NO;
+}
+
+- (void)raceEndpoints {
+    NSArray<NSString *> * orderedEndpoints = nil;
+    @synchronized(self) {
+        NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+        if (_endpoints.count < 2 || _isRacing || now - _lastRaceTime < oss_endpoint_min_race_interval) {
+            return;
+        }
+        _isRacing = YES;
+        _lastRaceTime = now;
+        if (!_probeSession) {
+            NSURLSessionConfiguration * configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+            configuration.timeoutIntervalForRequest = self.probeTimeout;
+            configuration.URLCache = nil;
+            _probeSession = [NSURLSession sessionWithConfiguration:configuration];
+        }
+        orderedEndpoints = [self endpointsByScore];
+    }
+
+    // a probe is only sent if the ones before it got no answer yet, the first answer ends the race
+    __block BOOL isAnswered = NO;
+    dispatch_group_t group = dispatch_group_create();
+    NSTimeInterval stagger = self.stagger;
+    for (NSUInteger i = 0; i < orderedEndpoints.count; i++) {
+        NSString * endpoint = orderedEndpoints[i];
+        NSURL * probeURL = [self probeURLOfEndpoint:endpoint];
+        if (!probeURL) {
+            continue;
+        }
+        dispatch_group_enter(group);
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(i * stagger * NSEC_PER_SEC)), _raceQueue, ^{
+            @synchronized(self) {
+                if (isAnswered) {
+                    dispatch_group_leave(group);
+                    return;
+                }
+            }
+            NSMutableURLRequest * request = [NSMutableURLRequest requestWithURL:probeURL];
+            request.HTTPMethod = @"HEAD";
+            NSDate * startDate = [NSDate date];
+            NSURLSessionDataTask * probeTask = [_probeSession dataTaskWithRequest:request completionHandler:^(NSData * data, NSURLResponse * response, NSError * error) {
+                // any answer, even an error status, means the edge is reachable
+                if (response) {
+                    @synchronized(self) {
+                        isAnswered = YES;
+                    }
+                    [self updateEndpoint:endpoint connectRTT:-[startDate timeIntervalSinceNow] failed:NO];
+                } else if (error.code != NSURLErrorCancelled) {
+                    OSSLogDebug(@"probe of endpoint %@ failed: %@", endpoint, error);
+                    [self updateEndpoint:endpoint connectRTT:0 failed:YES];
+                }
+                dispatch_group_leave(group);
+            }];
+            [probeTask resume];
+        });
+    }
+    dispatch_group_notify(group, _raceQueue, ^{
+        @synchronized(self) {
+            _isRacing = NO;
+        }
+        OSSLogDebug(@"endpoint race finished, best endpoint: %@", [self bestEndpoint]);
+    });
+}
+
+- (void)reportSuccessForEndpoint:(NSString *)endpoint connectRTT:(NSTimeInterval)rtt {
+    [self updateEndpoint:endpoint connectRTT:rtt failed:NO];
+}
+
+- (void)reportConnectFailureForEndpoint:(NSString *)endpoint {
+    BOOL wasBest = [[self bestEndpoint] isEqualToString:endpoint];
+    [self updateEndpoint:endpoint connectRTT:0 failed:YES];
+    if (wasBest) {
+        [self raceEndpoints];
+    }
+}
+
+#pragma mark - Private Methods
+
+- (void)updateEndpoint:(NSString *)endpoint connectRTT:(NSTimeInterval)rtt failed:(BOOL)failed {
+    @synchronized(self) {
+        NSUInteger index = [_endpoints indexOfObject:endpoint];
+        if (index == NSNotFound) {
+            return;
+        }
+        OSSEndpointHealth * health = _healths[index];
+        if (failed) {
+            health.failureCount++;
+            health.lastFailureTime = [[NSDate date] timeIntervalSince1970];
+            OSSLogDebug(@"endpoint %@ failed %lu times", endpoint, (unsigned long)health.failureCount);
+            return;
+        }
+        health.failureCount = 0;
+        if (rtt > 0) {
+            health.rtt = health.rtt > 0 ? (1 - oss_endpoint_rtt_smoothing_factor) * health.rtt + oss_endpoint_rtt_smoothing_factor * rtt : rtt;
+        }
+    }
+}
+
+- (NSTimeInterval)penaltyOfHealth:(OSSEndpointHealth *)health now:(NSTimeInterval)now {
+    NSTimeInterval penalty = oss_endpoint_failure_penalty * MIN(health.failureCount, oss_endpoint_max_penalized_failures);
+    return (health.failureCount > 0 && now - health.lastFailureTime < penalty) ? penalty : 0;
+}
+
+/* called while synchronized */
+- (NSTimeInterval)scoreOfIndex:(NSUInteger)index now:(NSTimeInterval)now {
+    OSSEndpointHealth * health = _healths[index];
+    NSTimeInterval rtt = health.rtt;
+    if (rtt == 0 && index > 0) {
+        rtt = oss_endpoint_unmeasured_rtt;
+    }
+    return rtt + [self penaltyOfHealth:health now:now];
+}
+
+/* called while synchronized */
+- (NSUInteger)bestIndex {
+    NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+    NSUInteger bestIndex = 0;
+    NSTimeInterval bestScore = DBL_MAX;
+    for (NSUInteger i = 0; i < _endpoints.count; i++) {
+        NSTimeInterval score = [self scoreOfIndex:i now:now];
+        if (score < bestScore) {
+            bestScore = score;
+            bestIndex = i;
+        }
+    }
+    return bestIndex;
+}
+
+/* called while synchronized */
+- (NSArray<NSString *> *)endpointsByScore {
+    NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+    NSMutableArray<NSNumber *> * indexes = [NSMutableArray arrayWithCapacity:_endpoints.count];
+    for (NSUInteger i = 0; i < _endpoints.count; i++) {
+        [indexes addObject:@(i)];
+    }
+    [indexes sortUsingComparator:^NSComparisonResult(NSNumber * index1, NSNumber * index2) {
+        NSTimeInterval score1 = [self scoreOfIndex:index1.unsignedIntegerValue now:now];
+        NSTimeInterval score2 = [self scoreOfIndex:index2.unsignedIntegerValue now:now];
+        return score1 < score2 ? NSOrderedAscending : (score1 > score2 ? NSOrderedDescending : NSOrderedSame);
+    }];
+    NSMutableArray<NSString *> * endpoints = [NSMutableArray arrayWithCapacity:_endpoints.count];
+    for (NSNumber * index in indexes) {
+        [endpoints addObject:_endpoints[index.unsignedIntegerValue]];
+    }
+    return endpoints;
+}
+
+- (NSURL *)probeURLOfEndpoint:(NSString *)endpoint {
+    NSURL * endpointURL = [NSURL URLWithString:endpoint];
+    NSString * host = endpointURL.host;
+    if (!host) {
+        return nil;
+    }
+    // an ip endpoint is reached through its synthesized address on an IPv6-only network
+    OSSIPv6Adapter * adapter = [OSSIPv6Adapter getInstance];
+    if ([adapter isIPv4Address:host]) {
+        host = [adapter handleIpv4Address:host];
+    }
+    NSString * port = endpointURL.port ? [NSString stringWithFormat:@":%@", endpointURL.port] : @"";
+    return [NSURL URLWithString:[NSString stringWithFormat:@"%@://%@%@/", endpointURL.scheme, host, port]];
+}
+
+@end
@@ -0,0 +1,57 @@
+//
+//  OSSFileDigestCache.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A cache of the digests of local files, set on OSSClientConfiguration.fileDigestCache and used by the
+ uploads skipping unchanged objects.
+
+ A digest is kept for the path, the size and the modification date of the file it was computed from:
+ an unchanged file isn't read again, a file written since is. The entries are kept in a least recently
+ used order, in memory and, when the cache has a directory, on disk so that they outlive the process.
+ */
+@interface OSSFileDigestCache : NSObject
+
+/**
+ Max entries, 1000 by default. The least recently used ones are removed first.
+ */
+@property (atomic, assign) NSUInteger maxEntryCount;
+
+/**
+ Where the entries are persisted, nil for a cache in memory only.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString * directory;
+
+/**
+ A cache in memory only.
+ */
+- (instancetype)init;
+
+/**
+ A cache persisted in the directory, which is created if needed and must only be used by this cache.
+ */
+- (instancetype)initWithDirectory:(nullable NSString *)directory NS_DESIGNATED_INITIALIZER;
+
+/**
+ The crc64ecma of the file as a decimal string, the format of the x-oss-hash-crc64ecma header.
+ It's read from the file when it's not cached for its size and modification date. nil if the file can't be read.
+ */
+- (nullable NSString *)crc64ecmaOfFileAtPath:(NSString *)path;
+
+/**
+ The uppercase hex MD5 of the file, the ETag of an object created by a single put. Cached like the crc64ecma.
+ */
+- (nullable NSString *)md5OfFileAtPath:(NSString *)path;
+
+- (void)removeAllEntries;
+
+@end
+
+NS_ASSUME_NONNULL_END
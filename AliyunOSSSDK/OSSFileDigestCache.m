@@ -0,0 +1,143 @@
+//
+//  OSSFileDigestCache.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSFileDigestCache.h"
+#import "OSSCacheIndex.h"
+#import "OSSInputStreamHelper.h"
+#import "OSSLog.h"
+
+static NSString * const oss_file_digest_cache_index_file_name = @"index.plist";
+static NSString * const oss_file_digest_cache_size_key = @"size";
+static NSString * const oss_file_digest_cache_modified_key = @"modified";
+static NSString * const oss_file_digest_cache_crc64_key = @"crc64";
+static NSString * const oss_file_digest_cache_md5_key = @"md5";
+
+@implementation OSSFileDigestCache {
+    /* the entries by path, property lists of the keys above */
+    OSSCacheIndex * _index;
+}
+
+- (instancetype)init {
+    return [self initWithDirectory:nil];
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory {
+    if (self = [super init]) {
+        _maxEntryCount = 1000;
+        _directory = [directory copy];
+
+        NSString * indexFilePath = nil;
+        if (_directory) {
+            [[NSFileManager defaultManager] createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+            indexFilePath = [_directory stringByAppendingPathComponent:oss_file_digest_cache_index_file_name];
+        }
+        _index = [[OSSCacheIndex alloc] initWithFilePath:indexFilePath queue:nil];
+        if (_directory) {
+            [self checkLoadedEntries];
+        }
+    }
+    return self;
+}
+
+- (NSString *)crc64ecmaOfFileAtPath:(NSString *)path {
+    return [self digestOfType:OSSDigestTypeCRC64 forKey:oss_file_digest_cache_crc64_key ofFileAtPath:path];
+}
+
+- (NSString *)md5OfFileAtPath:(NSString *)path {
+    return [self digestOfType:OSSDigestTypeMD5 forKey:oss_file_digest_cache_md5_key ofFileAtPath:path];
+}
+
+- (void)removeAllEntries {
+    @synchronized(self) {
+        [_index removeAllItems];
+    }
+}
+
+# pragma mark - Private Methods
+
+- (NSString *)digestOfType:(OSSDigestType)type forKey:(NSString *)digestKey ofFileAtPath:(NSString *)path {
+    path = [path stringByStandardizingPath];
+    NSDictionary * attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil];
+    if (![[attributes fileType] isEqualToString:NSFileTypeRegular]
+        || ![[NSFileManager defaultManager] isReadableFileAtPath:path]) {
+        return nil;
+    }
+    NSNumber * size = @([attributes fileSize]);
+    NSNumber * modified = @([[attributes fileModificationDate] timeIntervalSince1970]);
+
+    NSDictionary * entry = nil;
+    @synchronized(self) {
+        entry = [_index itemForKey:path];
+        if (![entry[oss_file_digest_cache_size_key] isEqual:size] || ![entry[oss_file_digest_cache_modified_key] isEqual:modified]) {
+            entry = nil;
+        }
+        NSString * digest = entry[digestKey];
+        if (digest) {
+            [_index touchKey:path];
+            return digest;
+        }
+    }
+
+    OSSInputStreamHelper * helper = [[OSSInputStreamHelper alloc] initWithFileAtPath:path];
+    helper.digestTypes = type;
+    [helper syncReadBuffers];
+    NSString * digest = nil;
+    if (type == OSSDigestTypeCRC64) {
+        digest = [NSString stringWithFormat:@"%llu", helper.crc64];
+    } else {
+        NSMutableString * hex = [NSMutableString stringWithCapacity:helper.md5.length * 2];
+        const unsigned char * bytes = helper.md5.bytes;
+        for (NSUInteger i = 0; i < helper.md5.length; i++) {
+            [hex appendFormat:@"%02X", bytes[i]];
+        }
+        digest = hex;
+    }
+
+    // a file written while it was read gets another modification date, the digest isn't kept for it
+    NSDictionary * attributesAfter = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil];
+    if ([attributesAfter fileSize] != size.unsignedLongLongValue
+        || [[attributesAfter fileModificationDate] timeIntervalSince1970] != modified.doubleValue) {
+        OSSLogDebug(@"file %@ changed while its digest was computed", path);
+        return digest;
+    }
+
+    @synchronized(self) {
+        NSDictionary * currentEntry = [_index itemForKey:path];
+        NSMutableDictionary * newEntry = [NSMutableDictionary dictionary];
+        if ([currentEntry[oss_file_digest_cache_size_key] isEqual:size] && [currentEntry[oss_file_digest_cache_modified_key] isEqual:modified]) {
+            // keeps the other digest of the same content
+            [newEntry addEntriesFromDictionary:currentEntry];
+        }
+        newEntry[oss_file_digest_cache_size_key] = size;
+        newEntry[oss_file_digest_cache_modified_key] = modified;
+        newEntry[digestKey] = digest;
+        [_index setItem:newEntry forKey:path];
+        [_index touchKey:path];
+        [self trimLocked];
+    }
+    return digest;
+}
+
+- (void)trimLocked {
+    while (_index.count > self.maxEntryCount) {
+        [_index removeItemForKey:_index.leastRecentlyUsedKey];
+    }
+}
+
+- (void)checkLoadedEntries {
+    for (NSString * path in [_index keys]) {
+        NSDictionary * entry = [_index itemForKey:path];
+        if (![entry[oss_file_digest_cache_size_key] isKindOfClass:[NSNumber class]]
+            || ![entry[oss_file_digest_cache_modified_key] isKindOfClass:[NSNumber class]]) {
+            [_index removeItemForKey:path];
+        }
+    }
+    [self trimLocked];
+    OSSLogDebug(@"file digest cache loaded %lu entries from %@", (unsigned long)_index.count, self.directory);
+}
+
+@end
@@ -393,6 +393,24 @@ extern unsigned long long const osskDDDefaultLogFilesDiskQuota;
  **/
 @property (nonatomic, readwrite, assign) BOOL automaticallyAppendNewlineForCustomFormatters;
 
+/**
+ * The log messages are buffered and written to the file in batches:
+ *
+ * `logBufferSize`
+ *   The bytes buffered before they're written, 64KB by default. Set 0 to write every message at once.
+ *
+ * `logFlushInterval`
+ *   The max seconds a message stays buffered, 1 by default.
+ *
+ * Error messages and flushLog write the buffer at once.
+ **/
+@property (readwrite, assign, atomic) NSUInteger logBufferSize;
+
+/**
+ *  See description for `logBufferSize`
+ */
+@property (readwrite, assign, atomic) NSTimeInterval logFlushInterval;
+
 /**
  *  You can optionally force the current log file to be rolled with this method.
  *  CompletionBlock will be called on main queue.
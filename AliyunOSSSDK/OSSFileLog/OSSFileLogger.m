@@ -553,6 +553,9 @@ unsigned long long const osskDDDefaultLogFilesDiskQuota   = 5 * 1024 * 1024; //
     
     unsigned long long _maximumFileSize;
     NSTimeInterval _rollingFrequency;
+
+    NSMutableData *_pendingLogData;
+    BOOL _isPendingLogDataWriteScheduled;
 }
 
 - (void)rollLogFileNow;
@@ -574,6 +577,8 @@ unsigned long long const osskDDDefaultLogFilesDiskQuota   = 5 * 1024 * 1024; //
         _maximumFileSize = osskDDDefaultLogMaxFileSize;
         _rollingFrequency = osskDDDefaultLogRollingFrequency;
         _automaticallyAppendNewlineForCustomFormatters = YES;
+        _logBufferSize = 64 * 1024;
+        _logFlushInterval = 1;
 
         logFileManager = aLogFileManager;
 
@@ -584,6 +589,9 @@ unsigned long long const osskDDDefaultLogFilesDiskQuota   = 5 * 1024 * 1024; //
 }
 
 - (void)dealloc {
+    if (_pendingLogData.length) {
+        [_currentLogFileHandle writeData:_pendingLogData];
+    }
     [_currentLogFileHandle synchronizeFile];
     [_currentLogFileHandle closeFile];
 
@@ -802,6 +810,9 @@ unsigned long long const osskDDDefaultLogFilesDiskQuota   = 5 * 1024 * 1024; //
 - (void)rollLogFileNow {
     OSSNSLogVerbose(@"OSSDDFileLogger: rollLogFileNow");
 
+    // the buffered messages belong to the file being rolled
+    [self lt_writePendingLogData];
+
     if (_currentLogFileHandle == nil) {
         return;
     }
@@ -998,20 +1009,73 @@ static int exception_count = 0;
 
         @try {
             [self willLogMessage];
-			
-            [[self currentLogFileHandle] writeData:logData];
 
-            [self didLogMessage];
+            if (self.logBufferSize == 0) {
+                [[self currentLogFileHandle] writeData:logData];
+
+                [self didLogMessage];
+            } else {
+                [self lt_bufferLogData:logData writeNow:(logMessage->_flag & OSSDDLogFlagError) != 0];
+            }
         } @catch (NSException *exception) {
-            exception_count++;
+            [self lt_logWriteException:exception];
+        }
+    }
+}
 
-            if (exception_count <= 10) {
-                OSSNSLogError(@"DDFileLogger.logMessage: %@", exception);
+- (void)flush {
+    // This method is invoked on the logger queue by DDLog's flushLog.
 
-                if (exception_count == 10) {
-                    OSSNSLogError(@"DDFileLogger.logMessage: Too many exceptions -- will not log any more of them.");
-                }
-            }
+    @try {
+        [self lt_writePendingLogData];
+    } @catch (NSException *exception) {
+        [self lt_logWriteException:exception];
+    }
+}
+
+- (void)lt_bufferLogData:(NSData *)logData writeNow:(BOOL)writeNow {
+    if (_pendingLogData == nil) {
+        _pendingLogData = [NSMutableData dataWithCapacity:self.logBufferSize];
+    }
+    [_pendingLogData appendData:logData];
+
+    if (writeNow || _pendingLogData.length >= self.logBufferSize) {
+        [self lt_writePendingLogData];
+    } else if (!_isPendingLogDataWriteScheduled) {
+        _isPendingLogDataWriteScheduled = YES;
+
+        __weak OSSDDFileLogger *weakSelf = self;
+        dispatch_time_t writeTime = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.logFlushInterval * NSEC_PER_SEC));
+        dispatch_after(writeTime, self.loggerQueue, ^{ @autoreleasepool {
+            [weakSelf flush];
+        } });
+    }
+}
+
+- (void)lt_writePendingLogData {
+    _isPendingLogDataWriteScheduled = NO;
+
+    if (_pendingLogData.length == 0) {
+        return;
+    }
+
+    // One write for the whole batch, and the size based rolling is checked once per batch.
+    NSData *logData = _pendingLogData;
+    _pendingLogData = nil;
+
+    [[self currentLogFileHandle] writeData:logData];
+
+    [self didLogMessage];
+}
+
+- (void)lt_logWriteException:(NSException *)exception {
+    exception_count++;
+
+    if (exception_count <= 10) {
+        OSSNSLogError(@"DDFileLogger.logMessage: %@", exception);
+
+        if (exception_count == 10) {
+            OSSNSLogError(@"DDFileLogger.logMessage: Too many exceptions -- will not log any more of them.");
         }
     }
 }
@@ -12,5 +12,39 @@
 
 + (instancetype)sharedInstance;
 
+/**
+ Returns the best known ip of the host, or nil if the host has not been resolved yet.
+ A resolving is started in the background when the host is unknown or about to expire.
+ */
 - (NSString *)asynGetIpByHost:(NSString *)host;
+
+/**
+ Resolves the hosts in batch in the background, so the first requests to them
+ can already use a resolved ip.
+ */
+- (void)preResolveHosts:(NSArray<NSString *> *)hosts;
+
+/**
+ Reports the connect time of a request sent to the address resolved for the host.
+ The address is the host of the request url, i.e. the ip or its IPv6 synthesized form.
+ */
+- (void)reportConnectRTT:(NSTimeInterval)rtt forHost:(NSString *)host address:(NSString *)address;
+
+/**
+ Reports that a request sent to the address resolved for the host failed to connect.
+ */
+- (void)reportConnectFailureForHost:(NSString *)host address:(NSString *)address;
+
+/**
+ Returns YES if the host has an ip other than the address which didn't fail to connect recently,
+ i.e. a request failing over to it needn't wait before it's sent again.
+ */
+- (BOOL)hasHealthyIpOfHost:(NSString *)host otherThanAddress:(NSString *)address;
+
+/**
+ Forgets the resolved ips and what was learnt about them, which belong to the former network, and
+ resolves the hosts again. Called when the network changes.
+ */
+- (void)flushResolvedHosts;
+
 @end
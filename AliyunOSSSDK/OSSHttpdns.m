@@ -9,6 +9,7 @@
 #import "OSSLog.h"
 #import "OSSHttpdns.h"
 #import "OSSIPv6Adapter.h"
+#import "OSSReachabilityManager.h"
 
 NSString * const HTTPDNS_SERVER_IP = @"203.107.1.1";
 NSString * const HTTPDNS_SERVER_PORT = @"80";
@@ -16,21 +17,45 @@ NSString * const HTTPDNS_SERVER_PORT = @"80";
 NSString * const ACCOUNT_ID = @"181345";
 NSTimeInterval const MAX_ENDURABLE_EXPIRED_TIME_IN_SECOND = 60; // The DNS entry's expiration time in seconds. After it expires, the entry is invalid.
 NSTimeInterval const PRERESOLVE_IN_ADVANCE_IN_SECOND = 10; // Once the remaining valid time of an DNS entry is less than this number, issue a DNS request to prefetch the data.
+NSTimeInterval const MAX_ENDURABLE_PERSISTED_TIME_IN_SECOND = 3600; // An entry loaded from disk stays usable this long after its expiration, while it is resolved again.
+NSTimeInterval const HTTPDNS_REQUEST_TIMEOUT_IN_SECOND = 5;
+NSTimeInterval const FAILED_IP_PENALTY_IN_SECOND = 60; // An ip which failed to connect is avoided for this long per failure.
+NSUInteger const MAX_HOSTS_PER_BATCH_RESOLVE = 5; // The limit of hosts in one batch resolve request of httpdns.
+double const RTT_SMOOTHING_FACTOR = 0.3;
+
+NSString * const HTTPDNS_CACHE_FILE_NAME = @"oss_httpdns_cache.plist";
+NSString * const HTTPDNS_CACHE_IPS_KEY = @"ips";
+NSString * const HTTPDNS_CACHE_EXPIRED_TIME_KEY = @"expiredTime";
 
 @interface IpObject : NSObject
 
 @property (nonatomic, copy) NSString * ip;
-@property (nonatomic, assign) NSTimeInterval expiredTime;
+@property (nonatomic, assign) NSTimeInterval rtt;       // smoothed connect time, 0 if never measured
+@property (nonatomic, assign) NSUInteger failureCount;  // consecutive connect failures
+@property (nonatomic, assign) NSTimeInterval lastFailureTime;
 
 @end
 
 @implementation IpObject
 @end
 
+@interface HostObject : NSObject
+
+@property (nonatomic, copy) NSArray<IpObject *> * ipObjects;
+@property (nonatomic, assign) NSTimeInterval expiredTime;
+@property (nonatomic, assign) BOOL isLoadedFromDisk;
+
+@end
+
+@implementation HostObject
+@end
+
 
 @implementation OSSHttpdns {
-    NSMutableDictionary * gHostIpMap;
+    NSMutableDictionary<NSString *, HostObject *> * gHostIpMap;
     NSMutableSet * penddingSet;
+    NSURLSession * session;
+    dispatch_queue_t persistQueue;
 }
 
 + (instancetype)sharedInstance {
@@ -46,10 +71,23 @@ NSTimeInterval const PRERESOLVE_IN_ADVANCE_IN_SECOND = 10; // Once the remaining
     if (self = [super init]) {
         gHostIpMap = [NSMutableDictionary new];
         penddingSet = [NSMutableSet new];
+        NSURLSessionConfiguration * configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+        configuration.timeoutIntervalForRequest = HTTPDNS_REQUEST_TIMEOUT_IN_SECOND;
+        session = [NSURLSession sessionWithConfiguration:configuration];
+        persistQueue = dispatch_queue_create("com.aliyun.oss.httpdns.persist", DISPATCH_QUEUE_SERIAL);
+        [self loadPersistedHosts];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(reachabilityDidChange:)
+                                                     name:OSSReachabilityChangedNotification
+                                                   object:[OSSReachabilityManager shareInstance]];
     }
     return self;
 }
 
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
 /**
  *  OSS SDK specific
  *
@@ -58,83 +96,290 @@ NSTimeInterval const PRERESOLVE_IN_ADVANCE_IN_SECOND = 10; // Once the remaining
  *  @return an ip in the ip list of the resolved host.
  */
 - (NSString *)asynGetIpByHost:(NSString *)host {
-    IpObject * ipObject = [gHostIpMap objectForKey:host];
-    if (!ipObject) {
+    HostObject * hostObject = nil;
+    @synchronized (self) {
+        hostObject = [gHostIpMap objectForKey:host];
+    }
+    NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+    NSTimeInterval endurableTime = hostObject.isLoadedFromDisk ? MAX_ENDURABLE_PERSISTED_TIME_IN_SECOND : MAX_ENDURABLE_EXPIRED_TIME_IN_SECOND;
+    if (!hostObject) {
 
         // if the host is not resolved, asynchronously resolve it and return nil
-        [self resolveHost:host];
+        [self resolveHosts:@[host]];
         return nil;
-    } else if ([[NSDate date] timeIntervalSince1970] - ipObject.expiredTime > MAX_ENDURABLE_EXPIRED_TIME_IN_SECOND) {
+    } else if (now - hostObject.expiredTime > endurableTime) {
 
         // If the entry is expired, asynchronously resolve it and return nil.
-        [self resolveHost:host];
+        [self resolveHosts:@[host]];
         return nil;
-    } else if (ipObject.expiredTime -[[NSDate date] timeIntervalSince1970] < PRERESOLVE_IN_ADVANCE_IN_SECOND) {
+    } else if (hostObject.isLoadedFromDisk || hostObject.expiredTime - now < PRERESOLVE_IN_ADVANCE_IN_SECOND) {
 
-        // If the entry is about to expire, asynchronously resolve it and return the current value.
-        [self resolveHost:host];
-        return ipObject.ip;
+        // If the entry is about to expire or comes from a former launch, asynchronously resolve it and return the current value.
+        [self resolveHosts:@[host]];
+        return [self bestIpOfHostObject:hostObject];
     } else {
 
         // returns the current result.
-        return ipObject.ip;
+        return [self bestIpOfHostObject:hostObject];
+    }
+}
+
+- (void)preResolveHosts:(NSArray<NSString *> *)hosts {
+    NSMutableArray<NSString *> * hostsToResolve = [NSMutableArray array];
+    NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+    @synchronized (self) {
+        for (NSString * host in hosts) {
+            HostObject * hostObject = gHostIpMap[host];
+            if (!hostObject || hostObject.isLoadedFromDisk || hostObject.expiredTime - now < PRERESOLVE_IN_ADVANCE_IN_SECOND) {
+                [hostsToResolve addObject:host];
+            }
+        }
+    }
+    for (NSUInteger i = 0; i < hostsToResolve.count; i += MAX_HOSTS_PER_BATCH_RESOLVE) {
+        NSRange range = NSMakeRange(i, MIN(MAX_HOSTS_PER_BATCH_RESOLVE, hostsToResolve.count - i));
+        [self resolveHosts:[hostsToResolve subarrayWithRange:range]];
+    }
+}
+
+- (void)reportConnectRTT:(NSTimeInterval)rtt forHost:(NSString *)host address:(NSString *)address {
+    @synchronized (self) {
+        IpObject * ipObject = [self ipObjectOfHost:host address:address];
+        if (ipObject) {
+            ipObject.rtt = ipObject.rtt > 0 ? (1 - RTT_SMOOTHING_FACTOR) * ipObject.rtt + RTT_SMOOTHING_FACTOR * rtt : rtt;
+            ipObject.failureCount = 0;
+        }
+    }
+}
+
+- (void)reportConnectFailureForHost:(NSString *)host address:(NSString *)address {
+    @synchronized (self) {
+        IpObject * ipObject = [self ipObjectOfHost:host address:address];
+        if (ipObject) {
+            ipObject.failureCount++;
+            ipObject.lastFailureTime = [[NSDate date] timeIntervalSince1970];
+            OSSLogDebug(@"Httpdns ip %@ of host %@ failed %lu times", ipObject.ip, host, (unsigned long)ipObject.failureCount);
+        }
     }
 }
 
+- (BOOL)hasHealthyIpOfHost:(NSString *)host otherThanAddress:(NSString *)address {
+    NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+    @synchronized (self) {
+        IpObject * failedIpObject = [self ipObjectOfHost:host address:address];
+        for (IpObject * ipObject in gHostIpMap[host].ipObjects) {
+            if (ipObject != failedIpObject
+                && (ipObject.failureCount == 0 || now - ipObject.lastFailureTime >= FAILED_IP_PENALTY_IN_SECOND * ipObject.failureCount)) {
+                return YES;
+            }
+        }
+    }
+    return NO;
+}
+
+- (void)flushResolvedHosts {
+    NSArray<NSString *> * hosts = nil;
+    @synchronized (self) {
+        hosts = [gHostIpMap allKeys];
+        [gHostIpMap removeAllObjects];
+        // the answers still in flight come from the former network, the hosts are resolved again meanwhile
+        [penddingSet removeAllObjects];
+    }
+    OSSLogDebug(@"Httpdns flushed %lu hosts", (unsigned long)hosts.count);
+    if ([OSSReachabilityManager shareInstance].isReachable) {
+        [self preResolveHosts:hosts];
+    }
+}
+
+#pragma mark - Private Methods
+
+- (void)reachabilityDidChange:(NSNotification *)notification {
+    OSSNetworkStatus status = [notification.userInfo[OSSReachabilityStatusKey] integerValue];
+    OSSNetworkStatus previousStatus = [notification.userInfo[OSSReachabilityPreviousStatusKey] integerValue];
+    // the first status, delivered at the start, isn't a change of network. Offline the ips are kept
+    // until a network is back, nothing could be resolved meanwhile
+    if (previousStatus == OSSNetworkStatusUnknown || status == previousStatus || status == OSSNetworkStatusNotReachable) {
+        return;
+    }
+    [self flushResolvedHosts];
+}
+
 /**
- *  resolve the host asynchronously
+ *  Picks the ip with the lowest connect time. Ips which have not been measured yet are tried first,
+ *  in the order returned by httpdns, and ips which failed recently are only used if all of them did.
+ */
+- (NSString *)bestIpOfHostObject:(HostObject *)hostObject {
+    NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+    IpObject * bestIpObject = nil;
+    NSTimeInterval bestScore = DBL_MAX;
+    @synchronized (self) {
+        for (IpObject * ipObject in hostObject.ipObjects) {
+            NSTimeInterval score = ipObject.rtt;
+            if (ipObject.failureCount > 0 && now - ipObject.lastFailureTime < FAILED_IP_PENALTY_IN_SECOND * ipObject.failureCount) {
+                score += FAILED_IP_PENALTY_IN_SECOND * ipObject.failureCount;
+            }
+            if (score < bestScore) {
+                bestScore = score;
+                bestIpObject = ipObject;
+            }
+        }
+    }
+    return bestIpObject.ip;
+}
+
+- (IpObject *)ipObjectOfHost:(NSString *)host address:(NSString *)address {
+    NSString * bareAddress = [address stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"[]"]];
+    for (IpObject * ipObject in gHostIpMap[host].ipObjects) {
+        if ([ipObject.ip isEqualToString:bareAddress]) {
+            return ipObject;
+        }
+    }
+    // on an IPv6-only network the request was sent to the synthesized address of the ip
+    for (IpObject * ipObject in gHostIpMap[host].ipObjects) {
+        NSString * synthesizedAddress = [[OSSIPv6Adapter getInstance] handleIpv4Address:ipObject.ip];
+        if ([synthesizedAddress isEqualToString:address] || [synthesizedAddress isEqualToString:[NSString stringWithFormat:@"[%@]", bareAddress]]) {
+            return ipObject;
+        }
+    }
+    return nil;
+}
+
+/**
+ *  resolve the hosts asynchronously, in one batch request if there are several of them
 
  *  If the host is being resolved, the call will be skipped.
  *
- *  @param host the host to resolve
+ *  @param hosts the hosts to resolve
  */
-- (void)resolveHost:(NSString *)host {
+- (void)resolveHosts:(NSArray<NSString *> *)hosts {
 
+    NSMutableArray<NSString *> * hostsToResolve = [NSMutableArray array];
     @synchronized (self) {
-        if ([penddingSet containsObject:host]) {
-            return;
-        } else {
-            [penddingSet addObject:host];
+        for (NSString * host in hosts) {
+            if (![penddingSet containsObject:host]) {
+                [penddingSet addObject:host];
+                [hostsToResolve addObject:host];
+            }
         }
     }
+    if (hostsToResolve.count == 0) {
+        return;
+    }
 
-    NSURL * url = [NSURL URLWithString:[NSString stringWithFormat:@"https://%@/%@/d?host=%@", [[OSSIPv6Adapter getInstance] handleIpv4Address:HTTPDNS_SERVER_IP], ACCOUNT_ID, host]];
-    NSURLSession * session = [NSURLSession sharedSession];
+    NSString * serverAddress = [[OSSIPv6Adapter getInstance] handleIpv4Address:HTTPDNS_SERVER_IP];
+    NSURL * url = nil;
+    if (hostsToResolve.count == 1) {
+        url = [NSURL URLWithString:[NSString stringWithFormat:@"https://%@/%@/d?host=%@", serverAddress, ACCOUNT_ID, hostsToResolve[0]]];
+    } else {
+        url = [NSURL URLWithString:[NSString stringWithFormat:@"https://%@/%@/resolve?host=%@", serverAddress, ACCOUNT_ID, [hostsToResolve componentsJoinedByString:@","]]];
+    }
 
     NSURLSessionDataTask * dataTask = [session dataTaskWithURL:url completionHandler:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
 
-        IpObject * ipObject = nil;
+        NSMutableDictionary<NSString *, HostObject *> * resolvedHosts = [NSMutableDictionary dictionary];
         NSUInteger statusCode = ((NSHTTPURLResponse *)response).statusCode;
-        if (statusCode != 200) {
-            OSSLogError(@"Httpdns resolve host: %@ failed, responseCode: %lu", host, (unsigned long)statusCode);
+        if (statusCode != 200 || !data) {
+            OSSLogError(@"Httpdns resolve hosts: %@ failed, responseCode: %lu", hostsToResolve, (unsigned long)statusCode);
         } else {
-            NSError *error = nil;
-            NSDictionary *json = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-
-            NSTimeInterval expiredTime = [[NSDate new] timeIntervalSince1970] + [[json objectForKey:@"ttl"] longLongValue];
-
-            NSArray *ips = [json objectForKey:@"ips"];
-            if (ips == nil || [ips count] == 0) {
-                OSSLogError(@"Httpdns resolve host: %@ failed, ip list empty.", host);
-            } else {
-                NSString * ip = ips[0];
-                ipObject = [IpObject new];
-                ipObject.expiredTime = expiredTime;
-                ipObject.ip = ip;
-                OSSLogDebug(@"Httpdns resolve host: %@ success, ip: %@, expiredTime: %lf", host, ipObject.ip, ipObject.expiredTime);
+            NSError *jsonError = nil;
+            NSDictionary *json = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&jsonError];
+            // a batch resolve returns {"dns": [{"host": ..., "ips": [...], "ttl": ...}]}
+            NSArray *results = [json isKindOfClass:[NSDictionary class]] ? ([json objectForKey:@"dns"] ?: (json ? @[json] : nil)) : nil;
+            for (NSDictionary *result in results) {
+                NSString *host = [result objectForKey:@"host"] ?: hostsToResolve[0];
+                NSArray *ips = [result objectForKey:@"ips"];
+                if (![ips isKindOfClass:[NSArray class]] || [ips count] == 0) {
+                    OSSLogError(@"Httpdns resolve host: %@ failed, ip list empty.", host);
+                    continue;
+                }
+                HostObject *hostObject = [HostObject new];
+                hostObject.expiredTime = [[NSDate new] timeIntervalSince1970] + [[result objectForKey:@"ttl"] longLongValue];
+                hostObject.ipObjects = [self ipObjectsWithIps:ips];
+                resolvedHosts[host] = hostObject;
+                OSSLogDebug(@"Httpdns resolve host: %@ success, ips: %@, expiredTime: %lf", host, ips, hostObject.expiredTime);
             }
         }
 
         @synchronized (self) {
-            if (ipObject) {
-                gHostIpMap[host] = ipObject;
+            [resolvedHosts enumerateKeysAndObjectsUsingBlock:^(NSString *host, HostObject *hostObject, BOOL *stop) {
+                [self mergeStatisticsOfHostObject:gHostIpMap[host] intoHostObject:hostObject];
+                gHostIpMap[host] = hostObject;
+            }];
+            [penddingSet minusSet:[NSSet setWithArray:hostsToResolve]];
+        }
+        if (resolvedHosts.count) {
+            [self persistHosts];
+        }
+    }];
+
+    [dataTask resume];
+}
+
+- (NSArray<IpObject *> *)ipObjectsWithIps:(NSArray<NSString *> *)ips {
+    NSMutableArray<IpObject *> * ipObjects = [NSMutableArray arrayWithCapacity:ips.count];
+    for (NSString * ip in ips) {
+        if ([ip isKindOfClass:[NSString class]]) {
+            IpObject * ipObject = [IpObject new];
+            ipObject.ip = ip;
+            [ipObjects addObject:ipObject];
+        }
+    }
+    return ipObjects;
+}
+
+// keeps what was learnt about the ips which are still returned
+- (void)mergeStatisticsOfHostObject:(HostObject *)oldHostObject intoHostObject:(HostObject *)hostObject {
+    for (IpObject * ipObject in hostObject.ipObjects) {
+        for (IpObject * oldIpObject in oldHostObject.ipObjects) {
+            if ([oldIpObject.ip isEqualToString:ipObject.ip]) {
+                ipObject.rtt = oldIpObject.rtt;
+                ipObject.failureCount = oldIpObject.failureCount;
+                ipObject.lastFailureTime = oldIpObject.lastFailureTime;
+                break;
             }
+        }
+    }
+}
 
-            [penddingSet removeObject:host];
+- (NSString *)cacheFilePath {
+    NSString * cachesDirectory = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject];
+    return [cachesDirectory stringByAppendingPathComponent:HTTPDNS_CACHE_FILE_NAME];
+}
+
+- (void)loadPersistedHosts {
+    NSDictionary * persistedHosts = [NSDictionary dictionaryWithContentsOfFile:[self cacheFilePath]];
+    NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+    [persistedHosts enumerateKeysAndObjectsUsingBlock:^(NSString *host, NSDictionary *entry, BOOL *stop) {
+        if (![entry isKindOfClass:[NSDictionary class]]) {
+            return;
         }
+        NSTimeInterval expiredTime = [entry[HTTPDNS_CACHE_EXPIRED_TIME_KEY] doubleValue];
+        NSArray * ips = entry[HTTPDNS_CACHE_IPS_KEY];
+        if (now - expiredTime > MAX_ENDURABLE_PERSISTED_TIME_IN_SECOND || ![ips isKindOfClass:[NSArray class]] || ips.count == 0) {
+            return;
+        }
+        HostObject * hostObject = [HostObject new];
+        hostObject.expiredTime = expiredTime;
+        hostObject.ipObjects = [self ipObjectsWithIps:ips];
+        hostObject.isLoadedFromDisk = YES;
+        gHostIpMap[host] = hostObject;
     }];
+    OSSLogDebug(@"Httpdns loaded %lu persisted hosts", (unsigned long)gHostIpMap.count);
+}
 
-    [dataTask resume];
+- (void)persistHosts {
+    NSMutableDictionary * persistedHosts = [NSMutableDictionary dictionary];
+    @synchronized (self) {
+        [gHostIpMap enumerateKeysAndObjectsUsingBlock:^(NSString *host, HostObject *hostObject, BOOL *stop) {
+            persistedHosts[host] = @{HTTPDNS_CACHE_IPS_KEY: [hostObject.ipObjects valueForKey:@"ip"],
+                                     HTTPDNS_CACHE_EXPIRED_TIME_KEY: @(hostObject.expiredTime)};
+        }];
+    }
+    NSString * cacheFilePath = [self cacheFilePath];
+    dispatch_async(persistQueue, ^{
+        if (![persistedHosts writeToFile:cacheFilePath atomically:YES]) {
+            OSSLogError(@"Httpdns persist cache failed: %@", cacheFilePath);
+        }
+    });
 }
 
 @end
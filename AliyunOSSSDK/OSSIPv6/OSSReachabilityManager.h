@@ -8,8 +8,33 @@
 
 #import <Foundation/Foundation.h>
 
+typedef NS_ENUM(NSInteger, OSSNetworkStatus) {
+    OSSNetworkStatusUnknown,
+    OSSNetworkStatusNotReachable,
+    OSSNetworkStatusReachableViaWiFi,
+    OSSNetworkStatusReachableViaWWAN,
+};
+
+/**
+ Posted on the reachability queue whenever the network changes, e.g. Wi-Fi to cellular or lost connection.
+ The user info has the status before and after the change as NSNumbers, under the keys below.
+ */
+extern NSString * const OSSReachabilityChangedNotification;
+extern NSString * const OSSReachabilityPreviousStatusKey;
+extern NSString * const OSSReachabilityStatusKey;
+
 @interface OSSReachabilityManager : NSObject
 
 + (OSSReachabilityManager *)shareInstance;
 
+/**
+ The status of the last change, unknown until the first one is delivered shortly after the start.
+ */
+@property (atomic, assign, readonly) OSSNetworkStatus networkStatus;
+
+/**
+ NO only once the network is known to be lost.
+ */
+@property (atomic, assign, readonly) BOOL isReachable;
+
 @end
\ No newline at end of file
@@ -27,10 +27,25 @@ static char *const OSSReachabilityQueueIdentifier = "com.alibaba.oss.network.Rea
 static dispatch_queue_t reachabilityQueue;
 static NSString *const CHECK_HOSTNAME = @"www.taobao.com";
 
+NSString * const OSSReachabilityChangedNotification = @"OSSReachabilityChangedNotification";
+NSString * const OSSReachabilityPreviousStatusKey = @"OSSReachabilityPreviousStatusKey";
+NSString * const OSSReachabilityStatusKey = @"OSSReachabilityStatusKey";
+
+@interface OSSReachabilityManager ()
+
+@property (atomic, assign, readwrite) OSSNetworkStatus networkStatus;
+
+@end
+
 @implementation OSSReachabilityManager {
     SCNetworkReachabilityRef            _reachabilityRef;
 }
 
+- (BOOL)isReachable
+{
+    return self.networkStatus != OSSNetworkStatusNotReachable;
+}
+
 + (OSSReachabilityManager *)shareInstance
 {
     static OSSReachabilityManager *s_SPDYNetworkStatusManager = nil;
@@ -82,9 +97,34 @@ static NSString *const CHECK_HOSTNAME = @"www.taobao.com";
     return NO;
 }
 
+static OSSNetworkStatus OSSNetworkStatusOfFlags(SCNetworkReachabilityFlags flags)
+{
+    if (!(flags & kSCNetworkReachabilityFlagsReachable)) {
+        return OSSNetworkStatusNotReachable;
+    }
+    // a connection needing the user, e.g. a VPN on demand asking for a password, isn't there yet
+    BOOL connectsAutomatically = (flags & (kSCNetworkReachabilityFlagsConnectionOnDemand | kSCNetworkReachabilityFlagsConnectionOnTraffic))
+                                 && !(flags & kSCNetworkReachabilityFlagsInterventionRequired);
+    if ((flags & kSCNetworkReachabilityFlagsConnectionRequired) && !connectsAutomatically) {
+        return OSSNetworkStatusNotReachable;
+    }
+#if TARGET_OS_IPHONE
+    if (flags & kSCNetworkReachabilityFlagsIsWWAN) {
+        return OSSNetworkStatusReachableViaWWAN;
+    }
+#endif
+    return OSSNetworkStatusReachableViaWiFi;
+}
+
 // Callback of Network change 
 static void ReachabilityCallback(SCNetworkReachabilityRef target, SCNetworkReachabilityFlags flags, void* info)
 {
+    OSSReachabilityManager *manager = (__bridge OSSReachabilityManager *)info;
+    OSSNetworkStatus previousStatus = manager.networkStatus;
+    OSSNetworkStatus status = OSSNetworkStatusOfFlags(flags);
+    manager.networkStatus = status;
+    OSSLogDebug(@"[AlicloudReachabilityManager]: Network status %ld -> %ld.", (long)previousStatus, (long)status);
+
     if ([[OSSIPv6Adapter getInstance] isIPv6OnlyNetwork]) {
         OSSLogDebug(@"[AlicloudReachabilityManager]: Network changed, Pre network status is IPv6-Only.");
     } else {
@@ -92,6 +132,11 @@ static void ReachabilityCallback(SCNetworkReachabilityRef target, SCNetworkReach
     }
 
     [[OSSIPv6Adapter getInstance] reResolveIPv6OnlyStatus];
+
+    [[NSNotificationCenter defaultCenter] postNotificationName:OSSReachabilityChangedNotification
+                                                        object:manager
+                                                      userInfo:@{OSSReachabilityPreviousStatusKey: @(previousStatus),
+                                                                 OSSReachabilityStatusKey: @(status)}];
 }
 
 @end
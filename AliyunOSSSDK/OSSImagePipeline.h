@@ -0,0 +1,120 @@
+//
+//  OSSImagePipeline.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#if TARGET_OS_IPHONE
+#import <UIKit/UIKit.h>
+typedef UIImage OSSImage;
+#else
+#import <AppKit/AppKit.h>
+typedef NSImage OSSImage;
+#endif
+
+@class OSSClient;
+@class OSSTask;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Loads the images of a bucket, original or processed by x-oss-process, e.g. the resized variant of each
+ screen density, for the cells of a feed.
+
+ A variant is an object key and an x-oss-process. Its encoded bytes are downloaded once and kept on disk
+ by an OSSObjectCache bounded by maxDiskSize, when the pipeline has a directory. They're decoded
+ on background queues, never on the caller's thread, and the decoded images are kept in memory in a least
+ recently used cache bounded by maxMemoryCost, the bytes of their bitmaps. The concurrent loads and
+ prefetches of the same variant share one download and one decode.
+
+ The prefetches are sent in the order they're asked for, maxConcurrentPrefetchCount at a time and with
+ OSSRequestPriorityNormal, so the loads of the visible images, OSSRequestPriorityInteractive, go first.
+ A load of a variant being prefetched doesn't wait for its turn.
+
+ The variants cached are used until they're evicted or removed, an object overwritten under the same key
+ is seen once its variants are removed. Only the first frame of an animated image is decoded.
+ */
+@interface OSSImagePipeline : NSObject
+
+@property (nonatomic, copy, readonly) NSString * bucketName;
+
+/**
+ Max bytes of decoded images kept in memory, 32MB by default.
+ */
+@property (atomic, assign) NSUInteger maxMemoryCost;
+
+/**
+ Max bytes of encoded images kept on disk, 64MB by default. At most 1000 variants are kept there.
+ */
+@property (atomic, assign) unsigned long long maxDiskSize;
+
+/**
+ Max prefetches in flight, 4 by default.
+ */
+@property (atomic, assign) NSUInteger maxConcurrentPrefetchCount;
+
+/**
+ The scale of the images returned, 1 by default, e.g. 2 for the variants of a @2x screen.
+ */
+@property (atomic, assign) CGFloat imageScale;
+
+/**
+ Where the encoded images are kept, nil for a cache in memory only.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString * directory;
+
+- (instancetype)initWithClient:(OSSClient *)client bucketName:(NSString *)bucketName;
+
+/**
+ A pipeline keeping the encoded images in the directory, which is created if needed and must only be
+ used by this pipeline. The images left there by an earlier pipeline are used again.
+ */
+- (instancetype)initWithClient:(OSSClient *)client
+                    bucketName:(NSString *)bucketName
+                     directory:(nullable NSString *)directory NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ The x-oss-process of the variant fitting in the pixels, e.g. the point size of a cell times the screen scale.
+ */
++ (NSString *)resizeProcessWithPixelWidth:(NSUInteger)width height:(NSUInteger)height;
+
+/**
+ The decoded image of the variant if it's in memory. It doesn't block, it may be called on the main thread.
+ */
+- (nullable OSSImage *)cachedImageForObjectKey:(NSString *)objectKey xOssProcess:(nullable NSString *)xOssProcess;
+
+/**
+ The decoded image of the variant as an OSSImage, read from memory, from disk or from OSS.
+ A data which isn't an image fails with OSSClientErrorCodeInvalidArgument.
+ */
+- (OSSTask *)imageForObjectKey:(NSString *)objectKey xOssProcess:(nullable NSString *)xOssProcess;
+
+/**
+ Loads the variants of the objects into memory before they're asked for, e.g. the ones of the cells about to be visible.
+ */
+- (void)prefetchImagesForObjectKeys:(NSArray<NSString *> *)objectKeys xOssProcess:(nullable NSString *)xOssProcess;
+
+/**
+ Cancels the prefetches of the variants no load is waiting for, e.g. once the cells scrolled away again.
+ */
+- (void)cancelPrefetchingForObjectKeys:(NSArray<NSString *> *)objectKeys xOssProcess:(nullable NSString *)xOssProcess;
+
+/**
+ Drops the variant from memory and disk, e.g. after the object was overwritten.
+ */
+- (void)removeImageForObjectKey:(NSString *)objectKey xOssProcess:(nullable NSString *)xOssProcess;
+
+- (void)removeAllImages;
+
+/**
+ Drops the decoded images, the ones on disk are decoded again when asked for. Called on memory warnings.
+ */
+- (void)removeAllImagesFromMemory;
+
+@end
+
+NS_ASSUME_NONNULL_END
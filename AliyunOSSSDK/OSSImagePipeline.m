@@ -0,0 +1,405 @@
+//
+//  OSSImagePipeline.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSImagePipeline.h"
+#import "OSSClient.h"
+#import "OSSDefine.h"
+#import "OSSModel.h"
+#import "OSSNetworking.h"
+#import "OSSBolts.h"
+#import "OSSLog.h"
+#import "OSSMemoryGovernor.h"
+#import "OSSObjectCache.h"
+#import "OSSRequestCoalescer.h"
+#import <ImageIO/ImageIO.h>
+
+#if TARGET_OS_IPHONE
+static UIImageOrientation oss_imageOrientationOfExifOrientation(NSInteger exifOrientation) {
+    switch (exifOrientation) {
+        case 2: return UIImageOrientationUpMirrored;
+        case 3: return UIImageOrientationDown;
+        case 4: return UIImageOrientationDownMirrored;
+        case 5: return UIImageOrientationLeftMirrored;
+        case 6: return UIImageOrientationRight;
+        case 7: return UIImageOrientationRightMirrored;
+        case 8: return UIImageOrientationLeft;
+        default: return UIImageOrientationUp;
+    }
+}
+#endif
+
+/**
+ A prefetch waiting for a slot, or started and waiting for the load of its variant.
+ */
+@interface OSSImagePipelinePrefetch : NSObject
+
+@property (nonatomic, copy) NSString * variantKey;
+@property (nonatomic, copy) NSString * objectKey;
+@property (nonatomic, copy) NSString * xOssProcess;
+/* cancelled to stop waiting, the load goes on if another caller waits for it */
+@property (nonatomic, strong) OSSNetworkingRequestDelegate * caller;
+@property (nonatomic, assign) BOOL isStarted;
+
+@end
+
+@implementation OSSImagePipelinePrefetch
+@end
+
+@implementation OSSImagePipeline {
+    OSSClient * _client;
+    /* the encoded images, on disk only */
+    OSSObjectCache * _encodedCache;
+    /* a variant is loaded once for all the loads and prefetches asking for it meanwhile */
+    OSSRequestCoalescer * _loadCoalescer;
+
+    NSMutableDictionary<NSString *, OSSImagePipelinePrefetch *> * _prefetches;
+    /* the prefetches waiting for a slot, in the order they were asked for */
+    NSMutableOrderedSet<NSString *> * _waitingPrefetches;
+    NSUInteger _runningPrefetchCount;
+
+    /* the decoded images, evicted in the order of their last use */
+    NSMutableDictionary<NSString *, OSSImage *> * _memoryImages;
+    NSMutableDictionary<NSString *, NSNumber *> * _memoryCosts;
+    NSMutableOrderedSet<NSString *> * _memoryRecentKeys;
+    NSUInteger _memoryCost;
+
+    OSSExecutor * _decodeExecutor;
+}
+
+- (instancetype)initWithClient:(OSSClient *)client bucketName:(NSString *)bucketName {
+    return [self initWithClient:client bucketName:bucketName directory:nil];
+}
+
+- (instancetype)initWithClient:(OSSClient *)client bucketName:(NSString *)bucketName directory:(NSString *)directory {
+    if (self = [super init]) {
+        _client = client;
+        _bucketName = [bucketName copy];
+        _directory = [directory copy];
+        _maxMemoryCost = 32 * 1024 * 1024;
+        _maxConcurrentPrefetchCount = 4;
+        _imageScale = 1;
+
+        _encodedCache = [[OSSObjectCache alloc] initWithDirectory:directory];
+        // the decoded images are the ones kept in memory
+        _encodedCache.maxMemoryCost = 0;
+        _encodedCache.maxObjectSize = NSUIntegerMax;
+        _encodedCache.maxDiskSize = 64 * 1024 * 1024;
+        _loadCoalescer = [OSSRequestCoalescer new];
+
+        _prefetches = [NSMutableDictionary new];
+        _waitingPrefetches = [NSMutableOrderedSet new];
+        _memoryImages = [NSMutableDictionary new];
+        _memoryCosts = [NSMutableDictionary new];
+        _memoryRecentKeys = [NSMutableOrderedSet new];
+        // decoding is bound by the cores, the images of the screen are waited for
+        _decodeExecutor = [OSSExecutor executorWithWidth:MAX([NSProcessInfo processInfo].activeProcessorCount, 1)
+                                        qualityOfService:QOS_CLASS_USER_INITIATED];
+        __weak OSSImagePipeline * weakSelf = self;
+        [[OSSMemoryGovernor sharedGovernor] addPressureObserver:self handler:^{
+            [weakSelf removeAllImagesFromMemory];
+        }];
+    }
+    return self;
+}
+
+- (unsigned long long)maxDiskSize {
+    return _encodedCache.maxDiskSize;
+}
+
+- (void)setMaxDiskSize:(unsigned long long)maxDiskSize {
+    _encodedCache.maxDiskSize = maxDiskSize;
+}
+
++ (NSString *)resizeProcessWithPixelWidth:(NSUInteger)width height:(NSUInteger)height {
+    // the image keeps its aspect ratio and fits in the box
+    return [NSString stringWithFormat:@"image/resize,m_lfit,w_%lu,h_%lu", (unsigned long)width, (unsigned long)height];
+}
+
+- (OSSImage *)cachedImageForObjectKey:(NSString *)objectKey xOssProcess:(NSString *)xOssProcess {
+    NSString * key = [self variantKeyOfObjectKey:objectKey xOssProcess:xOssProcess];
+    @synchronized(self) {
+        return [self memoryImageForKeyLocked:key];
+    }
+}
+
+- (OSSTask *)imageForObjectKey:(NSString *)objectKey xOssProcess:(NSString *)xOssProcess {
+    NSString * key = [self variantKeyOfObjectKey:objectKey xOssProcess:xOssProcess];
+    @synchronized(self) {
+        OSSImage * image = [self memoryImageForKeyLocked:key];
+        if (image) {
+            return [OSSTask taskWithResult:image];
+        }
+        // a load doesn't wait for the prefetches before it, the one of its variant isn't needed any more
+        if (!_prefetches[key].isStarted) {
+            [_prefetches removeObjectForKey:key];
+            [_waitingPrefetches removeObject:key];
+        }
+    }
+    OSSNetworkingRequestDelegate * caller = [OSSNetworkingRequestDelegate new];
+    caller.priority = OSSRequestPriorityInteractive;
+    return [self imageTaskForKey:key objectKey:objectKey xOssProcess:xOssProcess caller:caller];
+}
+
+- (void)prefetchImagesForObjectKeys:(NSArray<NSString *> *)objectKeys xOssProcess:(NSString *)xOssProcess {
+    @synchronized(self) {
+        for (NSString * objectKey in objectKeys) {
+            NSString * key = [self variantKeyOfObjectKey:objectKey xOssProcess:xOssProcess];
+            if (_memoryImages[key] || _prefetches[key]) {
+                continue;
+            }
+            OSSImagePipelinePrefetch * prefetch = [OSSImagePipelinePrefetch new];
+            prefetch.variantKey = key;
+            prefetch.objectKey = objectKey;
+            prefetch.xOssProcess = xOssProcess;
+            prefetch.caller = [OSSNetworkingRequestDelegate new];
+            // the prefetches make way for the images on screen
+            prefetch.caller.priority = OSSRequestPriorityNormal;
+            _prefetches[key] = prefetch;
+            [_waitingPrefetches addObject:key];
+        }
+    }
+    [self startWaitingPrefetches];
+}
+
+- (void)cancelPrefetchingForObjectKeys:(NSArray<NSString *> *)objectKeys xOssProcess:(NSString *)xOssProcess {
+    NSMutableArray<OSSImagePipelinePrefetch *> * startedPrefetches = [NSMutableArray array];
+    @synchronized(self) {
+        for (NSString * objectKey in objectKeys) {
+            NSString * key = [self variantKeyOfObjectKey:objectKey xOssProcess:xOssProcess];
+            OSSImagePipelinePrefetch * prefetch = _prefetches[key];
+            if (!prefetch) {
+                continue;
+            }
+            [_prefetches removeObjectForKey:key];
+            [_waitingPrefetches removeObject:key];
+            if (prefetch.isStarted) {
+                [startedPrefetches addObject:prefetch];
+            }
+        }
+    }
+    for (OSSImagePipelinePrefetch * prefetch in startedPrefetches) {
+        // its slot is given back once its wait ends, right away
+        [prefetch.caller cancel];
+    }
+}
+
+- (void)removeImageForObjectKey:(NSString *)objectKey xOssProcess:(NSString *)xOssProcess {
+    NSString * key = [self variantKeyOfObjectKey:objectKey xOssProcess:xOssProcess];
+    @synchronized(self) {
+        [self removeMemoryImageLocked:key];
+    }
+    [_encodedCache removeEntryForKey:[self encodedCacheKeyOfObjectKey:objectKey xOssProcess:xOssProcess]];
+}
+
+- (void)removeAllImages {
+    [self removeAllImagesFromMemory];
+    [_encodedCache removeAllEntries];
+}
+
+- (void)removeAllImagesFromMemory {
+    @synchronized(self) {
+        [_memoryImages removeAllObjects];
+        [_memoryCosts removeAllObjects];
+        [_memoryRecentKeys removeAllObjects];
+        _memoryCost = 0;
+    }
+}
+
+# pragma mark - Private Methods
+
+- (NSString *)variantKeyOfObjectKey:(NSString *)objectKey xOssProcess:(NSString *)xOssProcess {
+    return [NSString stringWithFormat:@"%@\n%@", objectKey, xOssProcess ?: @""];
+}
+
+- (NSString *)encodedCacheKeyOfObjectKey:(NSString *)objectKey xOssProcess:(NSString *)xOssProcess {
+    NSString * scope = [OSSObjectCache scopeWithEndpoint:_client.endpoint credentialProvider:_client.credentialProvider];
+    return [OSSObjectCache keyWithScope:scope bucketName:_bucketName objectKey:objectKey xOssProcess:xOssProcess];
+}
+
+- (void)startWaitingPrefetches {
+    NSMutableArray<OSSImagePipelinePrefetch *> * startedPrefetches = [NSMutableArray array];
+    @synchronized(self) {
+        NSUInteger maxCount = MAX(self.maxConcurrentPrefetchCount, 1);
+        while (_waitingPrefetches.count > 0 && _runningPrefetchCount < maxCount) {
+            NSString * key = _waitingPrefetches.firstObject;
+            [_waitingPrefetches removeObjectAtIndex:0];
+            OSSImagePipelinePrefetch * prefetch = _prefetches[key];
+            if (_memoryImages[key]) {
+                // loaded meanwhile
+                [_prefetches removeObjectForKey:key];
+                continue;
+            }
+            prefetch.isStarted = YES;
+            _runningPrefetchCount++;
+            [startedPrefetches addObject:prefetch];
+        }
+    }
+
+    for (OSSImagePipelinePrefetch * prefetch in startedPrefetches) {
+        OSSTask * task = [self imageTaskForKey:prefetch.variantKey
+                                     objectKey:prefetch.objectKey
+                                   xOssProcess:prefetch.xOssProcess
+                                        caller:prefetch.caller];
+        [task continueWithBlock:^id(OSSTask *imageTask) {
+            @synchronized(self) {
+                _runningPrefetchCount--;
+                if (_prefetches[prefetch.variantKey] == prefetch) {
+                    [_prefetches removeObjectForKey:prefetch.variantKey];
+                }
+            }
+            [self startWaitingPrefetches];
+            return nil;
+        }];
+    }
+}
+
+- (OSSTask *)imageTaskForKey:(NSString *)key
+                   objectKey:(NSString *)objectKey
+                 xOssProcess:(NSString *)xOssProcess
+                      caller:(OSSNetworkingRequestDelegate *)caller {
+    return [_loadCoalescer taskForKey:key caller:caller downloadProgress:nil startFlight:^OSSTask *(OSSNetworkingRequestDelegate *flightDelegate) {
+        return [[self loadImageForKey:key objectKey:objectKey xOssProcess:xOssProcess flightDelegate:flightDelegate] continueWithBlock:^id(OSSTask *task) {
+            if (task.error && task.error.code != OSSClientErrorCodeTaskCancelled) {
+                OSSLogError(@"image pipeline failed to load %@: %@", objectKey, task.error);
+            }
+            return task;
+        }];
+    }];
+}
+
+/* reads the encoded image from disk or from OSS, then decodes it, never on the caller's thread */
+- (OSSTask *)loadImageForKey:(NSString *)key
+                   objectKey:(NSString *)objectKey
+                 xOssProcess:(NSString *)xOssProcess
+              flightDelegate:(OSSNetworkingRequestDelegate *)flightDelegate {
+    NSString * cacheKey = [self encodedCacheKeyOfObjectKey:objectKey xOssProcess:xOssProcess];
+    __block BOOL isFromDisk = NO;
+    return [[OSSTask taskFromExecutor:_decodeExecutor withBlock:^id{
+        NSData * data = [_encodedCache entryForKey:cacheKey].hasData ? [_encodedCache dataForKey:cacheKey] : nil;
+        if (data) {
+            isFromDisk = YES;
+            return data;
+        }
+        return [self downloadDataOfObjectKey:objectKey xOssProcess:xOssProcess flightDelegate:flightDelegate];
+    }] continueWithExecutor:_decodeExecutor withSuccessBlock:^id(OSSTask *task) {
+        NSData * data = nil;
+        OSSGetObjectResult * result = nil;
+        if (isFromDisk) {
+            data = task.result;
+        } else {
+            result = task.result;
+            data = result.downloadedData;
+        }
+
+        NSUInteger cost = 0;
+        OSSImage * image = data ? [self decodedImageWithData:data cost:&cost] : nil;
+        if (!image) {
+            OSSLogError(@"image pipeline can't decode %@ (%@)", objectKey, xOssProcess);
+            [_encodedCache removeEntryForKey:cacheKey];
+            return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                              code:OSSClientErrorCodeInvalidArgument
+                                                          userInfo:@{OSSErrorMessageTOKEN: @"The object isn't an image!"}]];
+        }
+        if (result && self.directory) {
+            [_encodedCache storeHttpResponseHeaderFields:result.httpResponseHeaderFields
+                                              objectMeta:result.objectMeta
+                                                    data:data
+                                                  forKey:cacheKey];
+        }
+        @synchronized(self) {
+            [self storeImageLocked:image cost:cost forKey:key];
+            [self trimLocked];
+        }
+        return image;
+    }];
+}
+
+- (OSSTask *)downloadDataOfObjectKey:(NSString *)objectKey
+                         xOssProcess:(NSString *)xOssProcess
+                      flightDelegate:(OSSNetworkingRequestDelegate *)flightDelegate {
+    OSSGetObjectRequest * request = [OSSGetObjectRequest new];
+    request.bucketName = _bucketName;
+    request.objectKey = objectKey;
+    request.xOssProcess = xOssProcess;
+    request.priority = flightDelegate.priority;
+    // the flight is cancelled once none of its loads and prefetches waits for it
+    flightDelegate.cancellationHandler = ^{
+        [request cancel];
+    };
+    if (flightDelegate.isRequestCancelled) {
+        return [OSSTask taskWithError:[self cancelError]];
+    }
+    return [_client getObject:request];
+}
+
+- (OSSImage *)decodedImageWithData:(NSData *)data cost:(NSUInteger *)cost {
+    CGImageSourceRef imageSource = CGImageSourceCreateWithData((__bridge CFDataRef)data, NULL);
+    if (!imageSource) {
+        return nil;
+    }
+    // decoded now, on this queue, instead of when it's first drawn on the main thread
+    NSDictionary * options = @{(__bridge NSString *)kCGImageSourceShouldCacheImmediately: @YES};
+    CGImageRef cgImage = CGImageSourceCreateImageAtIndex(imageSource, 0, (__bridge CFDictionaryRef)options);
+    NSDictionary * properties = CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(imageSource, 0, NULL));
+    CFRelease(imageSource);
+    if (!cgImage) {
+        return nil;
+    }
+
+    *cost = CGImageGetBytesPerRow(cgImage) * CGImageGetHeight(cgImage);
+    CGFloat scale = self.imageScale > 0 ? self.imageScale : 1;
+#if TARGET_OS_IPHONE
+    NSInteger exifOrientation = [properties[(__bridge NSString *)kCGImagePropertyOrientation] integerValue];
+    OSSImage * image = [UIImage imageWithCGImage:cgImage scale:scale orientation:oss_imageOrientationOfExifOrientation(exifOrientation)];
+#else
+    NSSize size = NSMakeSize(CGImageGetWidth(cgImage) / scale, CGImageGetHeight(cgImage) / scale);
+    OSSImage * image = [[NSImage alloc] initWithCGImage:cgImage size:size];
+#endif
+    CGImageRelease(cgImage);
+    return image;
+}
+
+- (OSSImage *)memoryImageForKeyLocked:(NSString *)key {
+    OSSImage * image = _memoryImages[key];
+    if (image) {
+        [_memoryRecentKeys removeObject:key];
+        [_memoryRecentKeys addObject:key];
+    }
+    return image;
+}
+
+- (void)storeImageLocked:(OSSImage *)image cost:(NSUInteger)cost forKey:(NSString *)key {
+    [self removeMemoryImageLocked:key];
+    _memoryImages[key] = image;
+    _memoryCosts[key] = @(cost);
+    _memoryCost += cost;
+    [_memoryRecentKeys addObject:key];
+}
+
+- (void)removeMemoryImageLocked:(NSString *)key {
+    if (!_memoryImages[key]) {
+        return;
+    }
+    _memoryCost -= _memoryCosts[key].unsignedIntegerValue;
+    [_memoryImages removeObjectForKey:key];
+    [_memoryCosts removeObjectForKey:key];
+    [_memoryRecentKeys removeObject:key];
+}
+
+- (void)trimLocked {
+    while (_memoryCost > self.maxMemoryCost && _memoryRecentKeys.count > 0) {
+        [self removeMemoryImageLocked:_memoryRecentKeys.firstObject];
+    }
+}
+
+- (NSError *)cancelError {
+    return [NSError errorWithDomain:OSSClientErrorDomain
+                               code:OSSClientErrorCodeTaskCancelled
+                           userInfo:@{OSSErrorMessageTOKEN: @"This task has been cancelled!"}];
+}
+
+@end
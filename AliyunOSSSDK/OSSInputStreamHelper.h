@@ -8,15 +8,62 @@
 
 #import <Foundation/Foundation.h>
 
+/**
+ The digests computed by OSSInputStreamHelper. All selected digests are
+ updated from the same chunk, so the content is only read once.
+ */
+typedef NS_OPTIONS(NSUInteger, OSSDigestType) {
+    OSSDigestTypeCRC64 = 1 << 0,
+    OSSDigestTypeMD5 = 1 << 1,
+    OSSDigestTypeSHA1 = 1 << 2,
+};
+
 NS_ASSUME_NONNULL_BEGIN
 @interface OSSInputStreamHelper : NSObject
 
 @property (nonatomic, assign) uint64_t crc64;
 
+/**
+ Digests to compute, default is OSSDigestTypeCRC64.
+ */
+@property (nonatomic, assign) OSSDigestType digestTypes;
+
+/**
+ Raw MD5/SHA1 digests, nil unless the type is selected.
+ */
+@property (nonatomic, strong, readonly, nullable) NSData *md5;
+@property (nonatomic, strong, readonly, nullable) NSData *sha1;
+
+/**
+ Base64 encoded MD5, suitable for the Content-MD5 header.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString *base64Md5;
+
+/**
+ Lowercase hex SHA1.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString *sha1String;
+
+/**
+ A file is read through its memory mapping when it can be mapped, otherwise it's streamed.
+ From 4MB on, the selected digests run concurrently, each one on its own core, and the crc64 is
+ computed in slices on several cores then combined.
+ */
 - (instancetype)initWithFileAtPath:(nonnull NSString *)path;
 - (instancetype)initWithURL:(nonnull NSURL *)URL;
 
+/**
+ Digests a memory buffer, such as a multipart part, in one pass.
+ */
+- (instancetype)initWithData:(nonnull NSData *)data;
+
 - (void)syncReadBuffers;
 
+/**
+ Reads the buffers on a background queue. The digest getters block until
+ the reading is finished, so it can overlap with the upload of the same file.
+ */
+- (void)asyncReadBuffers;
+
 @end
 NS_ASSUME_NONNULL_END
@@ -9,12 +9,28 @@
 #import "OSSInputStreamHelper.h"
 #import "OSSLog.h"
 #import "aos_crc64.h"
+#import "CommonCrypto/CommonDigest.h"
+#import <unistd.h>
+
+// the chunk stays in L1/L2 while all digests consume it
+static NSUInteger const oss_digest_chunk_size = 32 * 1024;
+// from this length on, every digest runs on its own core and the crc64 on several
+static NSUInteger const oss_concurrent_digest_min_length = 4 * 1024 * 1024;
+// a digest running alone over mapped pages is fed large chunks, CC_LONG is 32 bits
+static NSUInteger const oss_concurrent_digest_chunk_size = 1024 * 1024;
+static NSUInteger const oss_crc64_min_slice_length = 1024 * 1024;
 
 @interface OSSInputStreamHelper ()
 {
     NSInputStream *_inputStream;
+    NSURL *_fileURL;
+    NSData *_data;
     CFAbsoluteTime _startTime;
     dispatch_semaphore_t _semaphore;
+    CC_MD5_CTX _md5Context;
+    CC_SHA1_CTX _sha1Context;
+    NSData *_md5;
+    NSData *_sha1;
 }
 
 @end
@@ -26,6 +42,8 @@
     self = [super init];
     if (self) {
         _crc64 = 0;
+        _digestTypes = OSSDigestTypeCRC64;
+        _fileURL = [NSURL fileURLWithPath:path];
         _inputStream = [NSInputStream inputStreamWithFileAtPath:path];
         _semaphore = dispatch_semaphore_create(1);
     }
@@ -37,44 +55,241 @@
     self = [super init];
     if (self) {
         _crc64 = 0;
+        _digestTypes = OSSDigestTypeCRC64;
+        _fileURL = URL.isFileURL ? URL : nil;
         _inputStream = [NSInputStream inputStreamWithURL:URL];
         _semaphore = dispatch_semaphore_create(1);
     }
     return self;
 }
 
+- (instancetype)initWithData:(nonnull NSData *)data
+{
+    self = [super init];
+    if (self) {
+        _crc64 = 0;
+        _digestTypes = OSSDigestTypeCRC64;
+        _data = data;
+        _semaphore = dispatch_semaphore_create(1);
+    }
+    return self;
+}
+
 - (void)syncReadBuffers
 {
     dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    [self readBuffers];
+    dispatch_semaphore_signal(_semaphore);
+}
 
+- (void)asyncReadBuffers
+{
+    // taken on the caller's thread, so any getter called later waits for the result
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
+        [self readBuffers];
+        dispatch_semaphore_signal(_semaphore);
+    });
+}
+
+- (void)readBuffers
+{
     _startTime = CFAbsoluteTimeGetCurrent();
-    [_inputStream open];
-    NSInteger length = 1;
-    while (length > 0)
-    {
-        @autoreleasepool{
-            uint8_t streamData[1024 * 4];
-            length = [_inputStream read:streamData maxLength:1024 * 4];
-            if (length > 0) {
-                _crc64 = aos_crc64(_crc64, streamData, length);
-            }
+    _crc64 = 0;
+    _md5 = nil;
+    _sha1 = nil;
+    
+    // a file is read through its mapping, without copying it into buffers
+    NSData *data = _data;
+    if (!data && _fileURL) {
+        NSError *error = nil;
+        data = [NSData dataWithContentsOfURL:_fileURL options:NSDataReadingMappedAlways error:&error];
+        if (!data) {
+            OSSLogDebug(@"map file failed(%@), fall back to reading it", error);
         }
     }
     
-    if (length < 0) {
-        OSSLogError(@"there is an error when reading buffer from file!");
+    if (data.length >= oss_concurrent_digest_min_length && [NSProcessInfo processInfo].activeProcessorCount > 1) {
+        [self digestBytesConcurrently:data.bytes length:data.length];
+    } else if (data) {
+        [self beginDigests];
+        const uint8_t *bytes = data.bytes;
+        NSUInteger total = data.length;
+        for (NSUInteger offset = 0; offset < total; offset += oss_digest_chunk_size) {
+            [self updateWithBytes:bytes + offset length:MIN(oss_digest_chunk_size, total - offset)];
+        }
+        [self finishDigests];
+    } else {
+        [self beginDigests];
+        [_inputStream open];
+        uint8_t *streamData = malloc(oss_digest_chunk_size);
+        NSInteger length = 1;
+        while (length > 0)
+        {
+            length = [_inputStream read:streamData maxLength:oss_digest_chunk_size];
+            if (length > 0) {
+                [self updateWithBytes:streamData length:length];
+            }
+        }
+        free(streamData);
+        
+        if (length < 0) {
+            OSSLogError(@"there is an error when reading buffer from file!");
+        }
+        [_inputStream close];
+        [self finishDigests];
     }
-    [_inputStream close];
     
     CFAbsoluteTime duration =  CFAbsoluteTimeGetCurrent() - _startTime;
     OSSLogDebug(@"read file cost time is :%f",duration);
+}
+
+- (void)beginDigests
+{
+    if (_digestTypes & OSSDigestTypeMD5) {
+        CC_MD5_Init(&_md5Context);
+    }
+    if (_digestTypes & OSSDigestTypeSHA1) {
+        CC_SHA1_Init(&_sha1Context);
+    }
+}
+
+- (void)finishDigests
+{
+    if (_digestTypes & OSSDigestTypeMD5) {
+        unsigned char digest[CC_MD5_DIGEST_LENGTH];
+        CC_MD5_Final(digest, &_md5Context);
+        _md5 = [NSData dataWithBytes:digest length:CC_MD5_DIGEST_LENGTH];
+    }
+    if (_digestTypes & OSSDigestTypeSHA1) {
+        unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+        CC_SHA1_Final(digest, &_sha1Context);
+        _sha1 = [NSData dataWithBytes:digest length:CC_SHA1_DIGEST_LENGTH];
+    }
+}
+
+/**
+ * MD5 and SHA1 can't be split, each one runs over the whole content on its own core. The crc64
+ * is computed over page aligned slices on the other cores, then the slices are combined
+ */
+- (void)digestBytesConcurrently:(const uint8_t *)bytes length:(NSUInteger)total
+{
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+    __block NSData *md5 = nil;
+    __block NSData *sha1 = nil;
     
-    dispatch_semaphore_signal(_semaphore);
+    if (_digestTypes & OSSDigestTypeMD5) {
+        dispatch_group_async(group, queue, ^{
+            CC_MD5_CTX context;
+            CC_MD5_Init(&context);
+            for (NSUInteger offset = 0; offset < total; offset += oss_concurrent_digest_chunk_size) {
+                CC_MD5_Update(&context, bytes + offset, (CC_LONG)MIN(oss_concurrent_digest_chunk_size, total - offset));
+            }
+            unsigned char digest[CC_MD5_DIGEST_LENGTH];
+            CC_MD5_Final(digest, &context);
+            md5 = [NSData dataWithBytes:digest length:CC_MD5_DIGEST_LENGTH];
+        });
+    }
+    if (_digestTypes & OSSDigestTypeSHA1) {
+        dispatch_group_async(group, queue, ^{
+            CC_SHA1_CTX context;
+            CC_SHA1_Init(&context);
+            for (NSUInteger offset = 0; offset < total; offset += oss_concurrent_digest_chunk_size) {
+                CC_SHA1_Update(&context, bytes + offset, (CC_LONG)MIN(oss_concurrent_digest_chunk_size, total - offset));
+            }
+            unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+            CC_SHA1_Final(digest, &context);
+            sha1 = [NSData dataWithBytes:digest length:CC_SHA1_DIGEST_LENGTH];
+        });
+    }
+    
+    NSUInteger sliceCount = 0;
+    NSUInteger sliceLength = 0;
+    uint64_t *sliceCRCs = NULL;
+    if (_digestTypes & OSSDigestTypeCRC64) {
+        NSUInteger processorCount = [NSProcessInfo processInfo].activeProcessorCount;
+        sliceCount = MAX(MIN(processorCount, total / oss_crc64_min_slice_length), 1);
+        NSUInteger pageSize = (NSUInteger)getpagesize();
+        sliceLength = ((total + sliceCount - 1) / sliceCount + pageSize - 1) / pageSize * pageSize;
+        sliceCount = (total + sliceLength - 1) / sliceLength;
+        sliceCRCs = calloc(sliceCount, sizeof(uint64_t));
+        for (NSUInteger i = 0; i < sliceCount; i++) {
+            dispatch_group_async(group, queue, ^{
+                NSUInteger offset = i * sliceLength;
+                sliceCRCs[i] = aos_crc64(0, (void *)(bytes + offset), MIN(sliceLength, total - offset));
+            });
+        }
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    
+    if (sliceCRCs) {
+        uint64_t crc64 = sliceCRCs[0];
+        for (NSUInteger i = 1; i < sliceCount; i++) {
+            NSUInteger offset = i * sliceLength;
+            crc64 = aos_crc64_combine(crc64, sliceCRCs[i], MIN(sliceLength, total - offset));
+        }
+        free(sliceCRCs);
+        _crc64 = crc64;
+    }
+    _md5 = md5;
+    _sha1 = sha1;
+}
+
+- (void)updateWithBytes:(const uint8_t *)bytes length:(NSUInteger)length
+{
+    if (_digestTypes & OSSDigestTypeCRC64) {
+        _crc64 = aos_crc64(_crc64, (void *)bytes, length);
+    }
+    if (_digestTypes & OSSDigestTypeMD5) {
+        CC_MD5_Update(&_md5Context, bytes, (CC_LONG)length);
+    }
+    if (_digestTypes & OSSDigestTypeSHA1) {
+        CC_SHA1_Update(&_sha1Context, bytes, (CC_LONG)length);
+    }
 }
 
 - (uint64_t)crc64
 {
-    return _crc64;
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    uint64_t crc64 = _crc64;
+    dispatch_semaphore_signal(_semaphore);
+    return crc64;
+}
+
+- (NSData *)md5
+{
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    NSData *md5 = _md5;
+    dispatch_semaphore_signal(_semaphore);
+    return md5;
+}
+
+- (NSData *)sha1
+{
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    NSData *sha1 = _sha1;
+    dispatch_semaphore_signal(_semaphore);
+    return sha1;
+}
+
+- (NSString *)base64Md5
+{
+    return [self.md5 base64EncodedStringWithOptions:NSDataBase64Encoding64CharacterLineLength];
+}
+
+- (NSString *)sha1String
+{
+    NSData *sha1 = self.sha1;
+    if (!sha1) {
+        return nil;
+    }
+    const unsigned char *bytes = sha1.bytes;
+    NSMutableString *hex = [NSMutableString stringWithCapacity:CC_SHA1_DIGEST_LENGTH * 2];
+    for (int i = 0; i < CC_SHA1_DIGEST_LENGTH; i++) {
+        [hex appendFormat:@"%02x", bytes[i]];
+    }
+    return hex;
 }
 
 @end
@@ -8,7 +8,15 @@
 
 #import <Foundation/Foundation.h>
 #import "OSSCocoaLumberjack.h"
-static const OSSDDLogLevel ossLogLevel = OSSDDLogLevelAll;
+
+/**
+ The most verbose level compiled into the sdk, e.g. build with -DOSS_LOG_LEVEL=OSSDDLogLevelError
+ to strip the verbose, debug and info logs from the binary, their arguments included.
+ */
+#ifndef OSS_LOG_LEVEL
+#define OSS_LOG_LEVEL OSSDDLogLevelAll
+#endif
+static const OSSDDLogLevel ossLogLevel = OSS_LOG_LEVEL;
 
 // colorful log configuration
 // see https://github.com/robbiehanson/XcodeColors
@@ -19,27 +27,33 @@ static const OSSDDLogLevel ossLogLevel = OSSDDLogLevelAll;
 #define XCODE_COLORS_RESET_BG  XCODE_COLORS_ESCAPE @"bg;" // Clear any background color
 #define XCODE_COLORS_RESET     XCODE_COLORS_ESCAPE @";"   // Clear any foreground or background color
 
+/**
+ Whether the logs of the flag are compiled in and logging is enabled. The arguments of a log are
+ only evaluated when it's YES, so guard the work done only to be logged with it.
+ The format of the logs must be a string literal, it's prefixed at compile time.
+ */
+#define OSSLogIsEnabled(flg) ((ossLogLevel & (flg)) && [OSSLog isLogEnable])
+
 #define OSSLogVerbose(frmt, ...)\
-if ([OSSLog isLogEnable]) {\
-OSSDDLogVerbose(@"[Verbose]: %@", [NSString stringWithFormat:(frmt), ##__VA_ARGS__]);\
-}
+do { if (OSSLogIsEnabled(OSSDDLogFlagVerbose)) {\
+OSSDDLogVerbose(@"[Verbose]: " frmt, ##__VA_ARGS__);\
+} } while (0)
 
 #define OSSLogDebug(frmt, ...)\
-if ([OSSLog isLogEnable]) {\
-OSSDDLogDebug(@"[Debug]: %@", [NSString stringWithFormat:(frmt), ##__VA_ARGS__]);\
-}
+do { if (OSSLogIsEnabled(OSSDDLogFlagDebug)) {\
+OSSDDLogDebug(@"[Debug]: " frmt, ##__VA_ARGS__);\
+} } while (0)
 
 #define OSSLogDebugNoFile(frmt, ...)\
-if ([OSSLog isLogEnable]) {\
-NSLog(@"[Debug]: %@", [NSString stringWithFormat:(frmt), ##__VA_ARGS__]);\
-}
+do { if (OSSLogIsEnabled(OSSDDLogFlagDebug)) {\
+NSLog(@"[Debug]: " frmt, ##__VA_ARGS__);\
+} } while (0)
 
+/* unlike OSSDDLogError it's queued asynchronously too, the file logger writes errors through at once */
 #define OSSLogError(frmt, ...)\
-if ([OSSLog isLogEnable]) {\
-OSSDDLogError(@"[Error]: %@", [NSString stringWithFormat:(frmt), ##__VA_ARGS__]);\
-}
-
-static BOOL isEnable;
+do { if (OSSLogIsEnabled(OSSDDLogFlagError)) {\
+OSSLOG_MACRO(OSSLOG_ASYNC_ENABLED, OSSLOG_LEVEL_DEF, OSSDDLogFlagError, 0, nil, __PRETTY_FUNCTION__, @"[Error]: " frmt, ##__VA_ARGS__);\
+} } while (0)
 
 @interface OSSLog : NSObject
 
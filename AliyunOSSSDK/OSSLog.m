@@ -9,6 +9,8 @@
 #import "OSSLog.h"
 #import "OSSUtil.h"
 
+static BOOL isEnable;
+
 @implementation OSSLog
 + (void)enableLog {
     if([OSSUtil hasPhoneFreeSpace]){
@@ -0,0 +1,71 @@
+//
+//  OSSMemoryGovernor.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Bounds the memory the transfers of all the clients hold at the same time.
+
+ The buffers of the parts in flight and the response bodies being collected in memory are counted.
+ A part is only read once its bytes fit under maxBytes with the ones already held, otherwise it waits for
+ bytes to be released; a part is always read when nothing is held, however large it is. Response bodies
+ can't wait, they're counted as they arrive and hold up the next parts.
+
+ On a memory warning or a memory pressure event, the ceiling drops to a quarter of maxBytes for
+ pressureDuration, so fewer parts are in flight, and the observers release their caches.
+ */
+@interface OSSMemoryGovernor : NSObject
+
++ (instancetype)sharedGovernor;
+
+/**
+ The bytes held above which no part is read, an eighth of the physical memory between 32MB and 512MB by default.
+ */
+@property (atomic, assign) int64_t maxBytes;
+
+/**
+ The seconds the ceiling stays lowered after a memory warning, 30 by default.
+ */
+@property (atomic, assign) NSTimeInterval pressureDuration;
+
+@property (atomic, assign, readonly) int64_t heldBytes;
+
+/**
+ Whether a memory warning was received in the last pressureDuration.
+ */
+@property (atomic, assign, readonly) BOOL isUnderPressure;
+
+/**
+ Holds the bytes if they fit under the ceiling and returns YES. Otherwise returns NO and calls the block
+ on a background queue once bytes are released or the pressure is over, at the latest a second later,
+ for the caller to try again.
+ */
+- (BOOL)reserveBytes:(int64_t)bytes orRetryWithBlock:(dispatch_block_t)block;
+
+/**
+ Counts bytes which are held whether they fit or not.
+ */
+- (void)holdBytes:(int64_t)bytes;
+
+- (void)releaseBytes:(int64_t)bytes;
+
+/**
+ Calls the handler on a background queue on each memory warning, until the observer is deallocated or removed.
+ */
+- (void)addPressureObserver:(id)observer handler:(dispatch_block_t)handler;
+- (void)removePressureObserver:(id)observer;
+
+/**
+ Called on the memory warnings, may be called to release memory before a large transfer.
+ */
+- (void)handleMemoryPressure;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,189 @@
+//
+//  OSSMemoryGovernor.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSMemoryGovernor.h"
+#import "OSSLog.h"
+#if TARGET_OS_IOS
+#import <UIKit/UIApplication.h>
+#endif
+
+static int64_t const oss_memory_governor_min_bytes = 32 * 1024 * 1024;
+static int64_t const oss_memory_governor_max_bytes = 512 * 1024 * 1024;
+static NSTimeInterval const oss_memory_governor_retry_interval = 1;
+
+@implementation OSSMemoryGovernor {
+    int64_t _heldBytes;
+    CFAbsoluteTime _pressureEndTime;
+
+    /* the callers waiting for bytes, called at least every retry interval */
+    NSMutableArray<dispatch_block_t> * _retryBlocks;
+    BOOL _isRetryScheduled;
+
+    NSMapTable<id, dispatch_block_t> * _pressureHandlers;
+    dispatch_source_t _pressureSource;
+}
+
++ (instancetype)sharedGovernor {
+    static OSSMemoryGovernor * governor = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        governor = [OSSMemoryGovernor new];
+    });
+    return governor;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        int64_t physicalMemory = (int64_t)[NSProcessInfo processInfo].physicalMemory;
+        _maxBytes = MIN(MAX(physicalMemory / 8, oss_memory_governor_min_bytes), oss_memory_governor_max_bytes);
+        _pressureDuration = 30;
+        _retryBlocks = [NSMutableArray new];
+        _pressureHandlers = [NSMapTable weakToStrongObjectsMapTable];
+
+        __weak OSSMemoryGovernor * weakSelf = self;
+        _pressureSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+                                                 DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+                                                 dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+        dispatch_source_set_event_handler(_pressureSource, ^{
+            [weakSelf handleMemoryPressure];
+        });
+        dispatch_resume(_pressureSource);
+#if TARGET_OS_IOS
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(didReceiveMemoryWarning:)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+#endif
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    dispatch_source_cancel(_pressureSource);
+}
+
+- (int64_t)heldBytes {
+    @synchronized(self) {
+        return _heldBytes;
+    }
+}
+
+- (BOOL)isUnderPressure {
+    @synchronized(self) {
+        return CFAbsoluteTimeGetCurrent() < _pressureEndTime;
+    }
+}
+
+- (BOOL)reserveBytes:(int64_t)bytes orRetryWithBlock:(dispatch_block_t)block {
+    @synchronized(self) {
+        int64_t ceiling = self.maxBytes;
+        if (CFAbsoluteTimeGetCurrent() < _pressureEndTime) {
+            ceiling /= 4;
+        }
+        if (bytes <= 0 || _heldBytes == 0 || _heldBytes + bytes <= ceiling) {
+            _heldBytes += MAX(bytes, 0);
+            return YES;
+        }
+        [_retryBlocks addObject:[block copy]];
+        [self scheduleRetryLocked];
+    }
+    return NO;
+}
+
+- (void)holdBytes:(int64_t)bytes {
+    @synchronized(self) {
+        _heldBytes += bytes;
+    }
+}
+
+- (void)releaseBytes:(int64_t)bytes {
+    if (bytes <= 0) {
+        return;
+    }
+    @synchronized(self) {
+        _heldBytes = MAX(_heldBytes - bytes, 0);
+    }
+    [self retryWaiters];
+}
+
+- (void)addPressureObserver:(id)observer handler:(dispatch_block_t)handler {
+    @synchronized(self) {
+        [_pressureHandlers setObject:[handler copy] forKey:observer];
+    }
+}
+
+- (void)removePressureObserver:(id)observer {
+    @synchronized(self) {
+        [_pressureHandlers removeObjectForKey:observer];
+    }
+}
+
+- (void)handleMemoryPressure {
+    NSArray<dispatch_block_t> * handlers = nil;
+    NSTimeInterval pressureDuration = self.pressureDuration;
+    @synchronized(self) {
+        _pressureEndTime = CFAbsoluteTimeGetCurrent() + pressureDuration;
+        handlers = [[_pressureHandlers objectEnumerator] allObjects];
+    }
+    OSSLogDebug(@"memory pressure, the transfers hold %lld bytes", self.heldBytes);
+
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    for (dispatch_block_t handler in handlers) {
+        dispatch_async(queue, handler);
+    }
+    // the parts waiting for the lowered ceiling go on once it's back up
+    __weak OSSMemoryGovernor * weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(pressureDuration * NSEC_PER_SEC)), queue, ^{
+        [weakSelf retryWaiters];
+    });
+}
+
+# pragma mark - Private Methods
+
+- (void)didReceiveMemoryWarning:(NSNotification *)notification {
+    // posted on the main thread
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [self handleMemoryPressure];
+    });
+}
+
+- (void)scheduleRetryLocked {
+    if (_isRetryScheduled) {
+        return;
+    }
+    // a waiting caller may have been cancelled meanwhile, it learns it on its retry
+    _isRetryScheduled = YES;
+    __weak OSSMemoryGovernor * weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(oss_memory_governor_retry_interval * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        OSSMemoryGovernor * strongSelf = weakSelf;
+        if (strongSelf) {
+            @synchronized(strongSelf) {
+                strongSelf->_isRetryScheduled = NO;
+            }
+            [strongSelf retryWaiters];
+        }
+    });
+}
+
+- (void)retryWaiters {
+    NSArray<dispatch_block_t> * retryBlocks = nil;
+    @synchronized(self) {
+        if (_retryBlocks.count == 0) {
+            return;
+        }
+        retryBlocks = [_retryBlocks copy];
+        [_retryBlocks removeAllObjects];
+    }
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    for (dispatch_block_t block in retryBlocks) {
+        dispatch_async(queue, block);
+    }
+}
+
+@end
@@ -12,6 +12,11 @@
 @class OSSFederationToken;
 @class OSSTask;
 @class OSSClientConfiguration;
+@class OSSExecutor;
+@class OSSRequestMetrics;
+@class OSSObjectCache;
+@class OSSFileDigestCache;
+@protocol OSSRetryPolicy;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -33,7 +38,9 @@ typedef NS_ENUM(NSInteger, OSSOperationType) {
     OSSOperationTypeCompleteMultipartUpload,
     OSSOperationTypeAbortMultipartUpload,
     OSSOperationTypeListMultipart,
-    OSSOperationTypeTriggerCallBack
+    OSSOperationTypeTriggerCallBack,
+    OSSOperationTypeDeleteMultipleObjects,
+    OSSOperationTypeUploadPartCopy
 };
 
 typedef NS_ENUM(NSInteger, OSSClientErrorCODE) {
@@ -47,7 +54,8 @@ typedef NS_ENUM(NSInteger, OSSClientErrorCODE) {
     OSSClientErrorCodeInvalidCRC,
     OSSClientErrorCodeCannotResumeUpload,
     OSSClientErrorCodeExcpetionCatched,
-    OSSClientErrorCodeNotKnown
+    OSSClientErrorCodeNotKnown,
+    OSSClientErrorCodeObjectModified
 };
 
 typedef NS_ENUM(NSUInteger, OSSRequestCRCFlag) {
@@ -56,6 +64,37 @@ typedef NS_ENUM(NSUInteger, OSSRequestCRCFlag) {
     OSSRequestCRCClosed
 };
 
+/**
+ The order in which the requests waiting for the transfer scheduler of a client are sent.
+ By default object gets and heads are interactive, part uploads bulk and the other requests normal.
+ */
+typedef NS_ENUM(NSInteger, OSSRequestPriority) {
+    OSSRequestPriorityDefault = 0,
+    OSSRequestPriorityBulk,
+    OSSRequestPriorityNormal,
+    OSSRequestPriorityInteractive
+};
+
+/**
+ Multipath TCP modes, mirroring NSURLSessionMultipathServiceType.
+ */
+typedef NS_ENUM(NSInteger, OSSMultipathServiceType) {
+    OSSMultipathServiceTypeNone = 0,
+    OSSMultipathServiceTypeHandover = 1,
+    OSSMultipathServiceTypeInteractive = 2,
+    OSSMultipathServiceTypeAggregate = 3
+};
+
+/**
+ Compression of an upload body. The object is stored compressed with its Content-Encoding, and
+ decoded by NSURLSession when it's downloaded with getObject.
+ */
+typedef NS_ENUM(NSInteger, OSSContentCompression) {
+    OSSContentCompressionNone = 0,
+    OSSContentCompressionGzip,
+    OSSContentCompressionDeflate
+};
+
 typedef void (^OSSNetworkingUploadProgressBlock) (int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend);
 typedef void (^OSSNetworkingDownloadProgressBlock) (int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite);
 typedef void (^OSSNetworkingRetryBlock) (void);
@@ -65,6 +104,9 @@ typedef void (^OSSNetworkingOnRecieveDataBlock) (NSData * data);
 typedef NSString* _Nullable (^OSSCustomSignContentBlock) (NSString * contentToSign, NSError **error);
 typedef OSSFederationToken * _Nullable (^OSSGetFederationTokenBlock) (void);
 typedef NSData * _Nullable (^OSSResponseDecoderBlock) (NSData * data);
+/* returns the next bytes of an upload body, nil or empty data at its end; sets error and returns nil on failure */
+typedef NSData * _Nullable (^OSSUploadDataProducerBlock) (NSError * _Nullable * _Nullable error);
+typedef void (^OSSRequestMetricsBlock) (OSSRequestMetrics * metrics);
 
 /**
  Categories NSDictionary
@@ -79,6 +121,7 @@ typedef NSData * _Nullable (^OSSResponseDecoderBlock) (NSData * data);
 @interface NSDate (OSS)
 + (void)oss_setClockSkew:(NSTimeInterval)clockSkew;
 + (NSDate *)oss_dateFromString:(NSString *)string;
++ (NSDate *)oss_dateFromISO8601String:(NSString *)string;
 + (NSDate *)oss_clockSkewFixedDate;
 - (NSString *)oss_asStringValue;
 @end
@@ -96,6 +139,21 @@ typedef NSData * _Nullable (^OSSResponseDecoderBlock) (NSData * data);
 - (void)removeObjectForKey:(id)aKey;
 @end
 
+/**
+ A thread-safe dictionary optimized for concurrent lookups.
+ Keys are spread over a fixed number of shards, each guarded by its own read-write lock,
+ so readers never wait on each other and writers only block the shard they touch.
+ It can be used wherever an OSSSyncMutableDictionary is, through the methods only:
+ its dictionary and dispatchQueue properties aren't used.
+ */
+@interface OSSShardedMutableDictionary : OSSSyncMutableDictionary
+
+- (id)objectForKey:(id)aKey;
+- (NSArray *)allKeys;
+- (void)setObject:(id)anObject forKey:(id <NSCopying>)aKey;
+- (void)removeObjectForKey:(id)aKey;
+@end
+
 /**
  FederationToken class
  */
@@ -161,12 +219,27 @@ TODOTODO
 @property (nonatomic, strong) OSSFederationToken * cachedToken;
 @property (nonatomic, copy) OSSFederationToken * (^federationTokenGetter)(void);
 
+/**
+ The seconds before its last 5 minutes at which a token is refreshed in the background, 60 by default.
+ The cached token keeps being used meanwhile. 0 to only get a new token once the cached one is about to expire.
+ */
+@property (atomic, assign) NSTimeInterval refreshAheadInterval;
+
 /**
  During the task execution, this method is called to get the new STS token.
- It runs in the background thread, not the UI thread.
+ It runs in the background thread, not the UI thread. Only one token is got at a time, whoever asks for it.
  */
 - (instancetype)initWithFederationTokenGetter:(OSSGetFederationTokenBlock)federationTokenGetter;
+
+/**
+ Returns the cached token, or waits for a new one if it's about to expire.
+ */
 - (nullable OSSFederationToken *)getToken:(NSError **)error;
+
+/**
+ Same as getToken: without blocking the thread, the task completes with the token.
+ */
+- (OSSTask *)getTokenAsync;
 @end
 
 /**
@@ -204,21 +277,54 @@ TODOTODO
 @property (nonatomic, assign) uint32_t maxRetryCount;
 
 /**
- Max concurrent requests
+ Retry policy shared by all the requests of the client. When it's nil, an OSSJitteredRetryPolicy
+ with maxRetryCount is used. When it's set, maxRetryCount is ignored in favor of the policy's own.
+ */
+@property (nonatomic, strong, nullable) id<OSSRetryPolicy> retryPolicy;
+
+/**
+ Max concurrent requests. The requests above it wait in the transfer scheduler of the client and
+ are sent by priority.
  */
 @property (nonatomic, assign) uint32_t maxConcurrentRequestCount;
 
+/**
+ Max bytes being uploaded at once by the client, 0 by default for no limit. A request is always
+ sent when no other one is in flight.
+ */
+@property (nonatomic, assign) int64_t maxInFlightBytes;
+
+/**
+ Max bytes per second uploaded and downloaded by the client, 0 by default for no limit.
+ It's applied when requests are sent, so it's an average over the transfers, not a per-byte pace.
+ */
+@property (nonatomic, assign) int64_t maxBandwidth;
+
 /**
  Flag of enabling background file transmit service.
  Note: it's only applicable for file upload.
  */
 @property (nonatomic, assign) BOOL enableBackgroundTransmitService;
 
+/**
+ Endpoints the requests fail over to, e.g. @[@"https://oss-accelerate.aliyuncs.com"]. When it's set,
+ each request is sent to the healthiest of the client's endpoint and these ones, which are raced
+ staggered when the client is created and whenever the endpoint in use fails to connect.
+ The client's endpoint is used until an alternative one is measured faster or it fails.
+ */
+@property (nonatomic, copy, nullable) NSArray<NSString *> * alternativeEndpoints;
+
 /**
  Flag of using Http request for DNS resolution.
  */
 @property (nonatomic, assign) BOOL isHttpdnsEnable;
 
+/**
+ Hosts resolved by httpdns in batch when the client is created, e.g. @[@"bucket.oss-cn-hangzhou.aliyuncs.com"].
+ Only takes effect when isHttpdnsEnable is YES.
+ */
+@property (nonatomic, copy) NSArray<NSString *> * httpdnsPreResolveHosts;
+
 /**
 Sets the session Id for background file transmission
  */
@@ -240,6 +346,60 @@ Sets the session Id for background file transmission
 @property (nonatomic, copy) NSString * proxyHost;
 @property (nonatomic, strong) NSNumber * proxyPort;
 
+/**
+ Max simultaneous connections to one host. 0 keeps the system default, which is 4 on iOS.
+ Raise it together with maxConcurrentRequestCount for highly parallel uploads.
+ */
+@property (nonatomic, assign) NSInteger maxConnectionsPerHost;
+
+/**
+ Flag of using HTTP/1.1 pipelining. HTTP/2 is negotiated by NSURLSession over https whenever
+ the endpoint supports it, and then requests are multiplexed on one connection regardless of this flag.
+ */
+@property (nonatomic, assign) BOOL HTTPShouldUsePipelining;
+
+/**
+ Sets the network service type of the sessions, NSURLNetworkServiceTypeDefault by default.
+ */
+@property (nonatomic, assign) NSURLRequestNetworkServiceType networkServiceType;
+
+/**
+ Sets the Multipath TCP mode, e.g. OSSMultipathServiceTypeHandover to move transfers between wifi and cellular.
+ It only takes effect on iOS 11 and later, and the app needs the Multipath entitlement.
+ */
+@property (nonatomic, assign) OSSMultipathServiceType multipathServiceType;
+
+/**
+ Flag of sharing the url sessions with the other clients of the same endpoint and networking configuration,
+ so that connections and TLS sessions are reused across them.
+ */
+@property (nonatomic, assign) BOOL enableSessionSharing;
+
+/**
+ Called with the metrics of every request of the client once it completes, successfully or not,
+ before the task of the request completes. It's called on a background thread.
+ */
+@property (nonatomic, copy) OSSRequestMetricsBlock requestMetricsHandler;
+
+/**
+ Caches the metadata and the content of the objects, see OSSObjectCache. nil by default for no cache.
+ */
+@property (nonatomic, strong) OSSObjectCache * objectCache;
+
+/**
+ The digests of the local files uploaded with skipsUnchangedObject, see OSSFileDigestCache.
+ nil by default for a cache in memory of the client.
+ */
+@property (nonatomic, strong) OSSFileDigestCache * fileDigestCache;
+
+/**
+ Flag of sending the identical getObject: and headObject: requests in flight at the same time once, NO by default.
+ Two reads are identical when they have the same bucket, key, range, x-oss-process, authentication and crc flags,
+ the reads to a file, a buffer or onRecieveData are never coalesced. The callers share the result object.
+ See OSSRequestCoalescer for the progress and the cancellation.
+ */
+@property (nonatomic, assign) BOOL coalescesIdenticalReads;
+
 /**
  Sets UA
  */
@@ -323,12 +483,114 @@ Sets the session Id for background file transmission
  */
 @property (nonatomic, assign) OSSRequestCRCFlag crcFlag;
 
+/**
+ Minimum interval in seconds between two progress callbacks. Default is 0, every update is reported.
+ For multipart and parallel transfers the progress of all parts is coalesced.
+ */
+@property (nonatomic, assign) NSTimeInterval progressReportInterval;
+
+/**
+ Minimum number of bytes transferred between two progress callbacks. Default is 0.
+ */
+@property (nonatomic, assign) int64_t progressReportGranularity;
+
+/**
+ The executor on which progress callbacks are delivered, e.g. [OSSExecutor mainThreadExecutor].
+ Default is nil, progress is delivered on the networking thread.
+ */
+@property (nonatomic, strong) OSSExecutor * progressReportExecutor;
+
+/**
+ The priority of the request in the transfer scheduler of the client. The part requests of
+ multipart uploads and parallel downloads have the priority of their request.
+ */
+@property (nonatomic, assign) OSSRequestPriority priority;
+
 /**
  Cancels the request
  */
 - (void)cancel;
 @end
 
+/**
+ The metrics of a request, from its scheduling to its completion.
+ The timing phases come from the metrics collected by NSURLSession, on iOS 10 and later only,
+ and are the ones of the last attempt. They're 0 when the phase didn't happen,
+ e.g. no dns lookup nor connect on a reused connection.
+ */
+@interface OSSRequestMetrics : NSObject
+
+@property (nonatomic, assign) OSSOperationType operationType;
+@property (nonatomic, copy) NSString * httpMethod;
+@property (nonatomic, copy) NSString * bucketName;
+@property (nonatomic, copy) NSString * objectKey;
+
+/**
+ The http response code of the last attempt, 0 if no response was received.
+ */
+@property (nonatomic, assign) NSInteger httpResponseCode;
+@property (nonatomic, copy) NSString * requestId;
+
+/**
+ The error the request failed with, nil if it succeeded.
+ */
+@property (nonatomic, strong) NSError * error;
+
+/**
+ When the request was scheduled.
+ */
+@property (nonatomic, strong) NSDate * startDate;
+
+/**
+ The seconds the request waited in the client for its turn to be sent.
+ */
+@property (nonatomic, assign) NSTimeInterval queueDuration;
+
+/**
+ The seconds from the scheduling to the completion, including the retries and their backoff.
+ */
+@property (nonatomic, assign) NSTimeInterval totalDuration;
+
+@property (nonatomic, assign) NSTimeInterval domainLookupDuration;
+@property (nonatomic, assign) NSTimeInterval connectDuration;
+/** a part of the connect duration */
+@property (nonatomic, assign) NSTimeInterval secureConnectionDuration;
+/** sending the headers and the body */
+@property (nonatomic, assign) NSTimeInterval requestDuration;
+/** from the start of the request to the first byte of the response */
+@property (nonatomic, assign) NSTimeInterval timeToFirstByte;
+/** receiving the response */
+@property (nonatomic, assign) NSTimeInterval responseDuration;
+
+/**
+ Whether the last attempt was sent on a connection already opened by a previous request.
+ */
+@property (nonatomic, assign) BOOL isReusedConnection;
+
+/**
+ The protocol of the last attempt, e.g. @"http/1.1" or @"h2".
+ */
+@property (nonatomic, copy) NSString * networkProtocolName;
+
+/**
+ The body bytes sent and received, summed over the attempts.
+ */
+@property (nonatomic, assign) int64_t bytesSent;
+@property (nonatomic, assign) int64_t bytesReceived;
+
+/**
+ The error of each attempt which was retried, in order.
+ */
+@property (nonatomic, copy) NSArray<NSError *> * retryErrors;
+@property (nonatomic, assign, readonly) uint32_t retryCount;
+
+/**
+ The ip resolved by httpdns the last attempt was sent to, nil if the host was resolved by the system.
+ */
+@property (nonatomic, copy) NSString * httpdnsAddress;
+
+@end
+
 /**
  The base class of result from OSS.
  */
@@ -360,6 +622,11 @@ It's a unique Id represents this request. This is used for troubleshooting when
  */
 @property (nonatomic, copy) NSString *localCRC64ecma;
 
+/**
+ The metrics of the request which returned this result.
+ */
+@property (nonatomic, strong) OSSRequestMetrics * metrics;
+
 @end
 
 /**
@@ -629,6 +896,50 @@ It's a unique Id represents this request. This is used for troubleshooting when
 @property (nonatomic, copy) NSDictionary * objectMeta;
 @end
 
+/**
+ Request class of getting the metadata of objects in batch.
+ Each key is sent by a Head Object request, the requests running concurrently.
+ */
+@interface OSSHeadMultipleObjectsRequest : OSSRequest
+
+/**
+ Bucket name
+ */
+@property (nonatomic, copy) NSString * bucketName;
+
+/**
+ The object keys to check
+ */
+@property (nonatomic, copy) NSArray<NSString *> * keys;
+
+/**
+ The max requests running at once, OSSDefaultMaxConcurrentNum by default.
+ */
+@property (nonatomic, assign) NSUInteger concurrentRequestCount;
+@end
+
+/**
+ Result class of getting the metadata of objects in batch
+ */
+@interface OSSHeadMultipleObjectsResult : OSSResult
+
+/**
+ The result of each existing object, by key.
+ */
+@property (nonatomic, strong) NSDictionary<NSString *, OSSHeadObjectResult *> * headObjectResults;
+
+/**
+ The keys of the objects that don't exist.
+ */
+@property (nonatomic, strong) NSArray<NSString *> * missingObjects;
+
+/**
+ The keys of the requests that failed, with their error.
+ The task only fails when every request failed.
+ */
+@property (nonatomic, strong) NSDictionary<NSString *, NSError *> * failedObjects;
+@end
+
 /**
  The request class to get object
  */
@@ -670,6 +981,18 @@ It's a unique Id represents this request. This is used for troubleshooting when
  It runs under background thread (not UI thread)
  */
 @property (nonatomic, copy) OSSNetworkingOnRecieveDataBlock onRecieveData;
+
+/**
+ The buffer the in-memory content is received into, e.g. to reuse one across downloads.
+ It's emptied first, and it's the downloadedData of the result. Optional.
+ */
+@property (nonatomic, strong) NSMutableData * downloadBuffer;
+
+/**
+ The max bytes downloaded in memory, 0 by default for no limit. The request fails with
+ OSSClientErrorCodeInvalidArgument once the object is known to be larger.
+ */
+@property (nonatomic, assign) int64_t maxDownloadedDataLength;
 @end
 
 /**
@@ -720,6 +1043,19 @@ It's a unique Id represents this request. This is used for troubleshooting when
  */
 @property (nonatomic, strong) NSURL * uploadingFileURL;
 
+/**
+ The stream to upload, read once while it's sent with chunked transfer encoding.
+ contentMd5 can't be computed for it, the crc64 is checked if enabled. The request isn't retried
+ once the stream started to be sent.
+ */
+@property (nonatomic, strong) NSInputStream * uploadingInputStream;
+
+/**
+ The producer of the bytes to upload, called until it returns nil or empty data.
+ It's sent like uploadingInputStream.
+ */
+@property (nonatomic, copy) OSSUploadDataProducerBlock uploadingDataProducer;
+
 /**
  The callback parameters.
  */
@@ -787,7 +1123,26 @@ It's a unique Id represents this request. This is used for troubleshooting when
  * the sha1 of content
  */
 @property (nonatomic, copy) NSString *contentSHA1;
- 
+
+/**
+ Compresses the body before it's sent, OSSContentCompressionNone by default.
+ Content-Encoding is set to gzip or deflate in place of contentEncoding. The data or file is compressed
+ on a background queue first, and contentMd5 and contentSHA1 are replaced by the ones of the compressed
+ bytes. A stream or producer body is compressed while it's sent, and is sent without them.
+ The crc64 is checked on the compressed bytes.
+ */
+@property (nonatomic, assign) OSSContentCompression contentCompression;
+
+/**
+ Heads the object first and doesn't upload the data or file if the object already has it, NO by default.
+ The length then the x-oss-hash-crc64ecma of the object are compared with the ones of the content, or
+ its ETag with the MD5 for an object created by a single put without crc64ecma. The digests of a file are
+ kept in the client configuration's fileDigestCache, so an unchanged file isn't read again. The result of
+ a skipped upload has isSkipped set, and the object keeps its metadata: the ones of the request aren't
+ compared nor applied. Ignored for a stream or producer body, or with contentCompression.
+ */
+@property (nonatomic, assign) BOOL skipsUnchangedObject;
+
 @end
 
 /**
@@ -818,6 +1173,12 @@ It's the MD5 value for put object request. If the object is created by other API
  If the callback is specified, this is the callback response result.
  */
 @property (nonatomic, copy) NSString * serverReturnJsonString;
+
+/**
+ Whether the upload was skipped as the object already had the content, see skipsUnchangedObject.
+ The result is the one of the head then.
+ */
+@property (nonatomic, assign) BOOL isSkipped;
 @end
 
 /**
@@ -946,6 +1307,50 @@ It's the MD5 value for put object request. If the object is created by other API
 @interface OSSDeleteObjectResult : OSSResult
 @end
 
+/**
+ Request class of deleting objects in batch (Delete Multiple Objects).
+ Any number of keys is accepted, they are sent by requests of up to 1000 keys running concurrently.
+ */
+@interface OSSDeleteMultipleObjectsRequest : OSSRequest
+
+/**
+ Bucket name
+ */
+@property (nonatomic, copy) NSString * bucketName;
+
+/**
+ The object keys to delete
+ */
+@property (nonatomic, copy) NSArray<NSString *> * keys;
+
+/**
+ Quiet mode, in which OSS doesn't return the deleted keys. NO by default.
+ */
+@property (nonatomic, assign) BOOL quiet;
+
+/**
+ The max requests running at once, OSSDefaultMaxConcurrentNum by default.
+ */
+@property (nonatomic, assign) NSUInteger concurrentRequestCount;
+@end
+
+/**
+ Result class of deleting objects in batch
+ */
+@interface OSSDeleteMultipleObjectsResult : OSSResult
+
+/**
+ The keys deleted, as returned by OSS. It's empty in quiet mode.
+ */
+@property (nonatomic, strong) NSArray<NSString *> * deletedObjects;
+
+/**
+ The keys of the requests that failed, with the error of their request.
+ The task only fails when every request failed.
+ */
+@property (nonatomic, strong) NSDictionary<NSString *, NSError *> * failedObjects;
+@end
+
 /**
  Request class of copying an object in OSS.
  */
@@ -1127,6 +1532,13 @@ It's the MD5 value for put object request. If the object is created by other API
  */
 @property (nonatomic, copy) NSString *contentSHA1;
 
+/**
+ Compresses the part before it's sent, like OSSPutObjectRequest's contentCompression. Each part is
+ compressed on its own, so use gzip, whose members may follow one another, and set the contentEncoding
+ of the OSSInitMultipartUploadRequest to gzip.
+ */
+@property (nonatomic, assign) OSSContentCompression contentCompression;
+
 @end
 
 /**
@@ -1136,6 +1548,66 @@ It's the MD5 value for put object request. If the object is created by other API
 @property (nonatomic, copy) NSString * eTag;
 @end
 
+/**
+ The request class of copying one part from an existing object (Upload Part Copy).
+ OSS copies the bytes itself, they don't go through the client.
+ */
+@interface OSSUploadPartCopyRequest : OSSRequest
+
+/**
+ Bucket name
+ */
+@property (nonatomic, copy) NSString * bucketName;
+
+/**
+ Object name
+ */
+@property (nonatomic, copy) NSString * objectKey;
+
+/**
+ Multipart Upload id.
+ */
+@property (nonatomic, copy) NSString * uploadId;
+
+/**
+ The part number of this part.
+ */
+@property (nonatomic, assign) int partNumber;
+
+/**
+ The bucket and the key of the source object (the caller needs the read permission on this object)
+ */
+@property (nonatomic, copy) NSString * sourceBucketName;
+@property (nonatomic, copy) NSString * sourceObjectKey;
+
+/**
+ The bytes of the source object copied into the part, the whole object if it's nil.
+ */
+@property (nonatomic, strong) OSSRange * sourceCopyRange;
+
+/**
+ The part is only copied if the source object still has this ETag.
+ */
+@property (nonatomic, copy) NSString * sourceCopyIfMatch;
+
+@end
+
+/**
+ The result class of copying one part.
+ */
+@interface OSSUploadPartCopyResult : OSSResult
+
+/**
+ The last modified time
+ */
+@property (nonatomic, copy) NSString * lastModifed;
+
+/**
+ The ETag of the part.
+ */
+@property (nonatomic, copy) NSString * eTag;
+@end
+
 /**
  The Part information. It's called by CompleteMultipartUpload().
  */
@@ -1357,6 +1829,45 @@ The result class of listing uploaded parts.
  */
 @property (nonatomic, assign) NSUInteger partSize;
 
+/**
+ The max number of parts being uploaded at the same time, default is 5.
+ A new part is read and sent as soon as one of the running parts finishes.
+ */
+@property (nonatomic, assign) NSUInteger concurrentPartCount;
+
+/**
+ Adapts the upload to the measured throughput, NO by default.
+ The number of parts in flight starts at concurrentPartCount and is adjusted between 1 and
+ maxConcurrentPartCount. The size of the parts not started yet starts at partSize and is adjusted
+ between 100KB and maxPartSize; resumable uploads keep partSize, as their record maps the
+ part numbers to fixed size parts.
+ */
+@property (nonatomic, assign) BOOL adaptivePartScheduling;
+
+/**
+ The upper bound of the parts in flight in adaptive mode, default is 8.
+ */
+@property (nonatomic, assign) NSUInteger maxConcurrentPartCount;
+
+/**
+ The upper bound of the part size in adaptive mode, default is 4MB.
+ */
+@property (nonatomic, assign) NSUInteger maxPartSize;
+
+/**
+ Uploads the parts from temporary slice files instead of memory, NO by default.
+ With enableBackgroundTransmitService set in the client configuration, the parts are sent by the
+ background session and keep going while the app is suspended or the device is locked.
+ */
+@property (nonatomic, assign) BOOL backgroundPartTransfer;
+
+/**
+ The parts read and digested ahead of the one being sent by sequentialMultipartUpload:, 0 by default.
+ The parts are still sent one after the other in order, but the next part is ready once the previous one
+ is finished, so only the network runs between them. A part after a failed one isn't sent.
+ */
+@property (nonatomic, assign) NSUInteger sequentialReadAheadPartCount;
+
 /**
  Upload progress callback.
  It runs at the background thread (not UI thread).
@@ -1388,10 +1899,29 @@ The result class of listing uploaded parts.
  */
 @property (nonatomic, copy) NSString *contentSHA1;
 
+/**
+ Heads the object first and doesn't upload the file if the object already has it, NO by default,
+ like OSSPutObjectRequest's skipsUnchangedObject.
+ */
+@property (nonatomic, assign) BOOL skipsUnchangedObject;
+
 
 - (void)cancel;
 @end
 
+/**
+ The request class of multipart upload from a stream or a producer block.
+ The parts are cut as the bytes arrive, of partSize bytes except the last one, so the object can't
+ be larger than partSize * 5000. uploadingFileURL is ignored and the upload can't be resumed.
+ */
+@interface OSSStreamingMultipartUploadRequest : OSSMultipartUploadRequest
+
+@property (nonatomic, strong) NSInputStream * uploadingInputStream;
+
+@property (nonatomic, copy) OSSUploadDataProducerBlock uploadingDataProducer;
+
+@end
+
 /**
  The request class of resumable upload.
  */
@@ -1427,8 +1957,160 @@ The result class of listing uploaded parts.
  */
 @property (nonatomic, copy) NSString * serverReturnJsonString;
 
+/**
+ Whether the upload was skipped as the object already had the content, see skipsUnchangedObject.
+ */
+@property (nonatomic, assign) BOOL isSkipped;
+
+@end
+
+
+/**
+ The request class of copying an object of any size by a multipart upload whose parts are
+ copied from the source object by OSS, several of them at the same time.
+ */
+@interface OSSMultipartCopyRequest : OSSRequest
+
+/**
+ The bucket and the key of the new object
+ */
+@property (nonatomic, copy) NSString * bucketName;
+@property (nonatomic, copy) NSString * objectKey;
+
+/**
+ The bucket and the key of the source object (the caller needs the read permission on this object)
+ */
+@property (nonatomic, copy) NSString * sourceBucketName;
+@property (nonatomic, copy) NSString * sourceObjectKey;
+
+/**
+ The size of every part, default is 10MB, minimal value is 100KB.
+ It's increased if the object would need more than 5000 parts.
+ */
+@property (nonatomic, assign) NSUInteger partSize;
+
+/**
+ The max number of parts being copied at the same time, default is 5.
+ */
+@property (nonatomic, assign) NSUInteger concurrentPartCount;
+
+/**
+ Content type and metadata of the new object, they aren't copied from the source object.
+ */
+@property (nonatomic, copy) NSString * contentType;
+@property (nonatomic, copy) NSDictionary * objectMeta;
+
+/**
+ directory path about create record uploadId file, resuming is disabled if it is empty.
+ An interrupted copy of the same source object resumes from the parts already copied.
+ */
+@property (nonatomic, copy) NSString * recordDirectoryPath;
+
+/**
+ need or not delete uploadId with cancel, YES by default.
+ */
+@property (nonatomic, assign) BOOL deleteUploadIdOnCancelling;
+
+/**
+ Copy progress callback, called once a part is copied.
+ It runs at the background thread (not UI thread).
+ */
+@property (nonatomic, copy) OSSNetworkingUploadProgressBlock copyProgress;
+
 @end
 
+/**
+ The result class of multipart copying
+ */
+@interface OSSMultipartCopyResult : OSSResult
+
+/**
+ The ETag of the new object.
+ */
+@property (nonatomic, copy) NSString * eTag;
+
+@end
+
+/**
+ The request class of uploading many files, the files of a directory or a list of files.
+ Several files are uploaded at the same time, each one by Put Object, or by parts if it's larger than
+ multipartThreshold.
+ */
+@interface OSSBulkUploadRequest : OSSRequest
+
+/**
+ Bucket name
+ */
+@property (nonatomic, copy) NSString * bucketName;
+
+/**
+ The directory whose regular files are uploaded, including the ones of its subdirectories but not the hidden ones.
+ Their object keys are objectKeyPrefix followed by their path relative to the directory.
+ */
+@property (nonatomic, strong) NSURL * directoryURL;
+
+/**
+ The files uploaded when directoryURL is nil, their object keys are objectKeyPrefix followed by their file name.
+ */
+@property (nonatomic, copy) NSArray<NSURL *> * fileURLs;
+
+/**
+ The prefix of the object keys, e.g. "photos/". Empty by default.
+ */
+@property (nonatomic, copy) NSString * objectKeyPrefix;
+
+/**
+ The files larger than this are uploaded by parts of partSize, default is 5MB.
+ */
+@property (nonatomic, assign) NSUInteger multipartThreshold;
+
+/**
+ The part size of the files uploaded by parts, default is 1MB, minimal value is 100KB.
+ */
+@property (nonatomic, assign) NSUInteger partSize;
+
+/**
+ The max number of files being uploaded at the same time, default is 5.
+ */
+@property (nonatomic, assign) NSUInteger concurrentFileCount;
+
+/**
+ directory path about create the manifest file, resuming is disabled if it is empty.
+ The manifest records the files uploaded, an interrupted upload of the same files skips the ones unchanged
+ since. The files uploaded by parts are resumed from their parts too.
+ */
+@property (nonatomic, copy) NSString * recordDirectoryPath;
+
+/**
+ Upload progress callback of all the files together.
+ It runs at the background thread (not UI thread).
+ */
+@property (nonatomic, copy) OSSNetworkingUploadProgressBlock uploadProgress;
+
+@end
+
+/**
+ The result class of bulk uploading
+ */
+@interface OSSBulkUploadResult : OSSResult
+
+/**
+ The keys of the files uploaded.
+ */
+@property (nonatomic, strong) NSArray<NSString *> * uploadedObjects;
+
+/**
+ The keys of the files skipped, they had been uploaded by an interrupted bulk upload already.
+ */
+@property (nonatomic, strong) NSArray<NSString *> * skippedObjects;
+
+/**
+ The keys of the files that failed, with their error.
+ The task only fails when every file failed.
+ */
+@property (nonatomic, strong) NSDictionary<NSString *, NSError *> * failedObjects;
+
+@end
 
 /**
  for more information,Please refer to the link https://help.aliyun.com/document_detail/31989.html?spm=5176.doc31988.6.908.CkOpBW
@@ -1466,6 +2148,68 @@ The result class of listing uploaded parts.
 
 @end
 
+/**
+ The request class to download an object to a local file over several range connections.
+ */
+@interface OSSParallelDownloadRequest : OSSRequest
+
+/**
+ Bucket name
+ */
+@property (nonatomic, copy) NSString * bucketName;
+
+/**
+ Object key
+ */
+@property (nonatomic, copy) NSString * objectKey;
+
+/**
+ The local file path to download to. The file is created with the object's size and filled in place.
+ */
+@property (nonatomic, strong) NSURL * downloadToFileURL;
+
+/**
+ The size of every range request, default is 1MB, minimal value is 100KB.
+ */
+@property (nonatomic, assign) NSUInteger partSize;
+
+/**
+ The max number of ranges being downloaded at the same time, default is 5.
+ */
+@property (nonatomic, assign) NSUInteger concurrentPartCount;
+
+/**
+ Download progress callback.
+ It runs at the background thread (not UI thread).
+ */
+@property (nonatomic, copy) OSSNetworkingDownloadProgressBlock downloadProgress;
+
+@end
+
+/**
+ The request class to download an object with a checkpoint, an interrupted download resumes from the finished ranges.
+ */
+@interface OSSResumableDownloadRequest : OSSParallelDownloadRequest
+
+/**
+ directory path about create the checkpoint file, resuming is disabled if it is empty.
+ */
+@property (nonatomic, copy) NSString * recordDirectoryPath;
+
+@end
+
+/**
+ The result class of parallel downloading
+ */
+@interface OSSParallelDownloadResult : OSSResult
+
+/**
+ Object metadata from the HEAD request the download was planned with.
+ */
+@property (nonatomic, copy) NSDictionary * objectMeta;
+
+@end
+
 #pragma mark Others
 
 /**
@@ -1473,6 +2217,10 @@ The result class of listing uploaded parts.
  */
 @interface OSSHttpResponseParser : NSObject
 @property (nonatomic, strong) NSURL * downloadingFileURL;
+/** the in-memory body is received into it instead of a new buffer */
+@property (nonatomic, strong) NSMutableData * collectingBuffer;
+/** the max bytes of the in-memory body, 0 for no limit */
+@property (nonatomic, assign) int64_t maxCollectingDataLength;
 @property (nonatomic, copy) OSSNetworkingOnRecieveDataBlock onRecieveBlock;
 /** 是否开启crc64校验 */
 @property (nonatomic, assign) BOOL crc64Verifiable;
@@ -12,7 +12,9 @@
 #import "OSSNetworking.h"
 #import "OSSLog.h"
 #import "OSSXMLDictionary.h"
-#import "NSMutableData+OSS_CRC.h"
+#import "OSSXMLResponseParser.h"
+#import "OSSMemoryGovernor.h"
+#import <pthread.h>
 #if TARGET_OS_IOS
 #import <UIKit/UIDevice.h>
 #endif
@@ -56,22 +58,111 @@ static NSTimeInterval _clockSkew = 0.0;
     return [[NSDate date] dateByAddingTimeInterval:(-1 * skew)];
 }
 
+static const char * const oss_week_day_names[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char * const oss_month_names[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+// the Date header only changes once per second, the string of the current second is shared by all requests
+static pthread_mutex_t oss_date_string_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static time_t oss_date_string_cache_second = -1;
+static NSString * oss_date_string_cache_value = nil;
+
++ (NSDateFormatter *)oss_cachedFormatterWithFormat:(NSString *)format {
+    // NSDateFormatter is expensive to build and not safe to share, keep one per thread and format
+    NSMutableDictionary *threadDictionary = [NSThread currentThread].threadDictionary;
+    NSString *key = [@"com.aliyun.oss.dateformatter." stringByAppendingString:format];
+    NSDateFormatter *dateFormatter = threadDictionary[key];
+    if (!dateFormatter) {
+        dateFormatter = [NSDateFormatter new];
+        dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
+        dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+        dateFormatter.dateFormat = format;
+        threadDictionary[key] = dateFormatter;
+    }
+    return dateFormatter;
+}
+
 + (NSDate *)oss_dateFromString:(NSString *)string {
-    NSDateFormatter *dateFormatter = [NSDateFormatter new];
-    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-    dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
-    dateFormatter.dateFormat = serverReturnDateFormat;
+    if (string == nil) {
+        return nil;
+    }
+    // fast path for the RFC 1123 GMT dates returned by OSS, e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+    char weekDay[4] = {0}, month[4] = {0}, zone[4] = {0};
+    struct tm tm = {0};
+    int consumed = 0;
+    if (sscanf(string.UTF8String, "%3[A-Za-z], %2d %3[A-Za-z] %4d %2d:%2d:%2d %3[A-Za-z]%n",
+               weekDay, &tm.tm_mday, month, &tm.tm_year, &tm.tm_hour, &tm.tm_min, &tm.tm_sec, zone, &consumed) == 8
+        && consumed == (int)strlen(string.UTF8String)
+        && (strcmp(zone, "GMT") == 0 || strcmp(zone, "UTC") == 0)) {
+        for (int i = 0; i < 12; i++) {
+            if (strcmp(month, oss_month_names[i]) == 0) {
+                tm.tm_mon = i;
+                tm.tm_year -= 1900;
+                return [NSDate dateWithTimeIntervalSince1970:timegm(&tm)];
+            }
+        }
+    }
+
+    return [[self oss_cachedFormatterWithFormat:serverReturnDateFormat] dateFromString:string];
+}
 
-    return [dateFormatter dateFromString:string];
++ (NSDate *)oss_dateFromISO8601String:(NSString *)string {
+    if (string == nil) {
+        return nil;
+    }
+    // fast path for "yyyy-MM-dd'T'HH:mm:ssZ" with a "Z" or "+hh:mm" zone
+    struct tm tm = {0};
+    char sign = 0;
+    int zoneHour = 0, zoneMinute = 0, consumed = 0;
+    const char *cString = string.UTF8String;
+    int matched = sscanf(cString, "%4d-%2d-%2dT%2d:%2d:%2d%n",
+                         &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &consumed);
+    if (matched == 6) {
+        const char *zone = cString + consumed;
+        NSTimeInterval offset = -1;
+        if (strcmp(zone, "Z") == 0) {
+            offset = 0;
+        } else if ((sscanf(zone, "%c%2d:%2d%n", &sign, &zoneHour, &zoneMinute, &consumed) == 3
+                    || sscanf(zone, "%c%2d%2d%n", &sign, &zoneHour, &zoneMinute, &consumed) == 3)
+                   && zone[consumed] == '\0' && (sign == '+' || sign == '-')) {
+            offset = (sign == '+' ? 1 : -1) * (zoneHour * 3600 + zoneMinute * 60);
+        }
+        if (offset != -1) {
+            tm.tm_year -= 1900;
+            tm.tm_mon -= 1;
+            return [NSDate dateWithTimeIntervalSince1970:timegm(&tm) - offset];
+        }
+    }
+
+    return [[self oss_cachedFormatterWithFormat:@"yyyy-MM-dd'T'HH:mm:ssZ"] dateFromString:string];
 }
 
 - (NSString *)oss_asStringValue {
-    NSDateFormatter *dateFormatter = [NSDateFormatter new];
-    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-    dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
-    dateFormatter.dateFormat = serverReturnDateFormat;
+    time_t second = (time_t)floor([self timeIntervalSince1970]);
 
-    return [dateFormatter stringFromDate:self];
+    pthread_mutex_lock(&oss_date_string_cache_lock);
+    if (second == oss_date_string_cache_second) {
+        NSString *cachedString = oss_date_string_cache_value;
+        pthread_mutex_unlock(&oss_date_string_cache_lock);
+        return cachedString;
+    }
+    pthread_mutex_unlock(&oss_date_string_cache_lock);
+
+    struct tm tm;
+    gmtime_r(&second, &tm);
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%s, %02d %s %04d %02d:%02d:%02d GMT",
+             oss_week_day_names[tm.tm_wday], tm.tm_mday, oss_month_names[tm.tm_mon],
+             tm.tm_year + 1900, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    NSString *dateString = [NSString stringWithUTF8String:buffer];
+
+    pthread_mutex_lock(&oss_date_string_cache_lock);
+    // only move the cache forward, requests signed with a skewed or past date must not evict the current second
+    if (second > oss_date_string_cache_second) {
+        oss_date_string_cache_second = second;
+        oss_date_string_cache_value = dateString;
+    }
+    pthread_mutex_unlock(&oss_date_string_cache_lock);
+    return dateString;
 }
 
 @end
@@ -119,6 +210,76 @@ static NSTimeInterval _clockSkew = 0.0;
 
 @end
 
+#define OSS_DICTIONARY_SHARD_COUNT 16
+
+@implementation OSSShardedMutableDictionary {
+    NSMutableDictionary * _shards[OSS_DICTIONARY_SHARD_COUNT];
+    pthread_rwlock_t _locks[OSS_DICTIONARY_SHARD_COUNT];
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        for (int i = 0; i < OSS_DICTIONARY_SHARD_COUNT; i++) {
+            _shards[i] = [NSMutableDictionary new];
+            pthread_rwlock_init(&_locks[i], NULL);
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    for (int i = 0; i < OSS_DICTIONARY_SHARD_COUNT; i++) {
+        pthread_rwlock_destroy(&_locks[i]);
+    }
+}
+
+- (NSUInteger)shardIndexForKey:(id)aKey {
+    NSUInteger hash = [aKey hash];
+    // task identifiers are sequential, mix the high bits in so neighbours still spread out
+    hash ^= (hash >> 16);
+    return hash % OSS_DICTIONARY_SHARD_COUNT;
+}
+
+- (NSArray *)allKeys {
+    NSMutableArray * allKeys = [NSMutableArray array];
+    for (int i = 0; i < OSS_DICTIONARY_SHARD_COUNT; i++) {
+        pthread_rwlock_rdlock(&_locks[i]);
+        [allKeys addObjectsFromArray:[_shards[i] allKeys]];
+        pthread_rwlock_unlock(&_locks[i]);
+    }
+    return allKeys;
+}
+
+- (id)objectForKey:(id)aKey {
+    if (aKey == nil) {
+        return nil;
+    }
+    NSUInteger index = [self shardIndexForKey:aKey];
+    pthread_rwlock_rdlock(&_locks[index]);
+    id returnObject = [_shards[index] objectForKey:aKey];
+    pthread_rwlock_unlock(&_locks[index]);
+    return returnObject;
+}
+
+- (void)setObject:(id)anObject forKey:(id <NSCopying>)aKey {
+    NSUInteger index = [self shardIndexForKey:aKey];
+    pthread_rwlock_wrlock(&_locks[index]);
+    [_shards[index] setObject:anObject forKey:aKey];
+    pthread_rwlock_unlock(&_locks[index]);
+}
+
+- (void)removeObjectForKey:(id)aKey {
+    if (aKey == nil) {
+        return;
+    }
+    NSUInteger index = [self shardIndexForKey:aKey];
+    pthread_rwlock_wrlock(&_locks[index]);
+    [_shards[index] removeObjectForKey:aKey];
+    pthread_rwlock_unlock(&_locks[index]);
+}
+
+@end
+
 @implementation OSSFederationToken
 
 - (NSString *)description
@@ -185,54 +346,121 @@ static NSTimeInterval _clockSkew = 0.0;
 
 @end
 
+/* a token expiring in less than this isn't used anymore, it could be expired when the request arrives at OSS */
+static NSTimeInterval const oss_federationTokenExpirationWindow = 5 * 60;
+
+@interface OSSFederationCredentialProvider ()
+/* the token fetch in progress, shared by all the callers waiting for a token meanwhile */
+@property (nonatomic, strong) OSSTaskCompletionSource * fetchingTokenSource;
+@end
+
 @implementation OSSFederationCredentialProvider
 
 - (instancetype)initWithFederationTokenGetter:(OSSGetFederationTokenBlock)federationTokenGetter {
     if (self = [super init]) {
         self.federationTokenGetter = federationTokenGetter;
+        self.refreshAheadInterval = 60;
     }
     return self;
 }
 
 - (nullable OSSFederationToken *)getToken:(NSError **)error {
-    OSSFederationToken * validToken = nil;
-    @synchronized(self) {
-        if (self.cachedToken == nil) {
-
-            self.cachedToken = self.federationTokenGetter();
-        } else {
-            if (self.cachedToken.expirationTimeInGMTFormat) {
-                NSDateFormatter * fm = [NSDateFormatter new];
-                [fm setDateFormat:@"yyyy-MM-dd'T'HH:mm:ssZ"];
-                self.cachedToken.expirationTimeInMilliSecond = [[fm dateFromString:self.cachedToken.expirationTimeInGMTFormat] timeIntervalSince1970] * 1000;
-                self.cachedToken.expirationTimeInGMTFormat = nil;
-                OSSLogVerbose(@"Transform GMT date to expirationTimeInMilliSecond: %lld", self.cachedToken.expirationTimeInMilliSecond);
-            }
+    OSSTask * task = [self getTokenAsync];
+    [task waitUntilFinished];
+    if (task.error) {
+        if (error != nil) {
+            *error = task.error;
+        }
+        return nil;
+    }
+    return task.result;
+}
 
-            NSDate * expirationDate = [NSDate dateWithTimeIntervalSince1970:(NSTimeInterval)(self.cachedToken.expirationTimeInMilliSecond / 1000)];
-            NSTimeInterval interval = [expirationDate timeIntervalSinceDate:[NSDate oss_clockSkewFixedDate]];
-            /* if this token will be expired after less than 2min, we abort it in case of when request arrived oss server,
-               it's expired already. */
-            if (interval < 5 * 60) {
-                OSSLogDebug(@"get federation token, but after %lf second it would be expired", interval);
-                self.cachedToken = self.federationTokenGetter();
+- (OSSTask *)getTokenAsync {
+    @synchronized(self) {
+        OSSFederationToken * cachedToken = self.cachedToken;
+        if (cachedToken) {
+            NSTimeInterval interval = [self expirationIntervalOfToken:cachedToken];
+            if (interval >= oss_federationTokenExpirationWindow) {
+                if (interval < oss_federationTokenExpirationWindow + self.refreshAheadInterval) {
+                    [self fetchTokenLocked];
+                }
+                return [OSSTask taskWithResult:cachedToken];
             }
+            OSSLogDebug(@"get federation token, but after %lf second it would be expired", interval);
         }
+        return [self fetchTokenLocked];
+    }
+}
 
-        validToken = self.cachedToken;
+# pragma mark - Private Methods
+
+- (NSTimeInterval)expirationIntervalOfToken:(OSSFederationToken *)token {
+    if (token.expirationTimeInGMTFormat) {
+        token.expirationTimeInMilliSecond = [[NSDate oss_dateFromISO8601String:token.expirationTimeInGMTFormat] timeIntervalSince1970] * 1000;
+        token.expirationTimeInGMTFormat = nil;
+        OSSLogVerbose(@"Transform GMT date to expirationTimeInMilliSecond: %lld", token.expirationTimeInMilliSecond);
     }
-    if (!validToken)
-    {
-        if (error != nil)
-        {
-            *error = [NSError errorWithDomain:OSSClientErrorDomain
-                                         code:OSSClientErrorCodeSignFailed
-                                     userInfo:@{OSSErrorMessageTOKEN: @"Can't get a federation token"}];
+    NSDate * expirationDate = [NSDate dateWithTimeIntervalSince1970:(NSTimeInterval)(token.expirationTimeInMilliSecond / 1000)];
+    return [expirationDate timeIntervalSinceDate:[NSDate oss_clockSkewFixedDate]];
+}
+
+- (OSSTask *)fetchTokenLocked {
+    if (self.fetchingTokenSource) {
+        return self.fetchingTokenSource.task;
+    }
+    OSSTaskCompletionSource * source = [OSSTaskCompletionSource taskCompletionSource];
+    self.fetchingTokenSource = source;
+    // the getter may wait for the network, it's never called with the lock held
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        OSSFederationToken * token = self.federationTokenGetter ? self.federationTokenGetter() : nil;
+        [self didFetchToken:token source:source];
+    });
+    return source.task;
+}
+
+- (void)didFetchToken:(OSSFederationToken *)token source:(OSSTaskCompletionSource *)source {
+    @synchronized(self) {
+        self.fetchingTokenSource = nil;
+        if (token) {
+            self.cachedToken = token;
+            [self scheduleRefreshOfTokenLocked:token];
+        } else if (self.cachedToken && [self expirationIntervalOfToken:self.cachedToken] >= oss_federationTokenExpirationWindow) {
+            // a failed refresh ahead of time keeps serving the token still valid
+            OSSLogError(@"refresh federation token failed, the cached one is still used");
+            token = self.cachedToken;
         }
-        
-        return nil;
     }
-    return validToken;
+
+    if (token) {
+        [source setResult:token];
+    } else {
+        [source setError:[NSError errorWithDomain:OSSClientErrorDomain
+                                             code:OSSClientErrorCodeSignFailed
+                                         userInfo:@{OSSErrorMessageTOKEN: @"Can't get a federation token"}]];
+    }
+}
+
+- (void)scheduleRefreshOfTokenLocked:(OSSFederationToken *)token {
+    NSTimeInterval refreshAheadInterval = self.refreshAheadInterval;
+    NSTimeInterval delay = [self expirationIntervalOfToken:token] - oss_federationTokenExpirationWindow - refreshAheadInterval;
+    // a long-lived token is refreshed by the first request inside its refresh window instead
+    if (refreshAheadInterval <= 0 || delay <= 0 || delay > 24 * 60 * 60) {
+        return;
+    }
+    __weak OSSFederationCredentialProvider * weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        OSSFederationCredentialProvider * strongSelf = weakSelf;
+        if (!strongSelf) {
+            return;
+        }
+        @synchronized(strongSelf) {
+            if (strongSelf.cachedToken == token) {
+                OSSLogDebug(@"refresh federation token ahead of its expiration");
+                [strongSelf fetchTokenLocked];
+            }
+        }
+    });
 }
 
 @end
@@ -335,6 +563,8 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
         self.backgroundSesseionIdentifier = BACKGROUND_SESSION_IDENTIFIER;
         self.timeoutIntervalForRequest = OSSDefaultTimeoutForRequestInSecond;
         self.timeoutIntervalForResource = OSSDefaultTimeoutForResourceInSecond;
+        self.networkServiceType = NSURLNetworkServiceTypeDefault;
+        self.multipathServiceType = OSSMultipathServiceTypeNone;
     }
     return self;
 }
@@ -366,101 +596,99 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 
 - (OSSTask *)interceptRequestMessage:(OSSAllRequestNeededMessage *)requestMessage {
     OSSLogVerbose(@"signing intercepting - ");
+
+    /* if credential provider is a federation token provider, it need to specially handle */
+    if ([self.credentialProvider isKindOfClass:[OSSFederationCredentialProvider class]]) {
+        // the token is waited for without blocking the thread, it's only fetched when the cached one is about to expire
+        return [[(OSSFederationCredentialProvider *)self.credentialProvider getTokenAsync] continueWithSuccessBlock:^id(OSSTask *task) {
+            return [self signRequestMessage:requestMessage withFederationToken:task.result];
+        }];
+    } else if ([self.credentialProvider isKindOfClass:[OSSStsTokenCredentialProvider class]]) {
+        return [self signRequestMessage:requestMessage withFederationToken:[(OSSStsTokenCredentialProvider *)self.credentialProvider getToken]];
+    }
+    return [self signRequestMessage:requestMessage withFederationToken:nil];
+}
+
+- (OSSTask *)signRequestMessage:(OSSAllRequestNeededMessage *)requestMessage withFederationToken:(OSSFederationToken *)federationToken {
     NSError * error = nil;
 
     /****************************************************************
-    * define a constant array to contain all specified subresource */
-    static NSArray * OSSSubResourceARRAY = nil;
+    * define a constant set to contain all specified subresource */
+    static NSSet * OSSSubResourceSET = nil;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
-        OSSSubResourceARRAY = @[@"acl", @"uploadId", @"partNumber", @"uploads", @"logging", @"website", @"location",
-                                @"lifecycle", @"referer", @"cors", @"delete", @"append", @"position", @"security-token", @"x-oss-process", @"sequential"];
+        OSSSubResourceSET = [NSSet setWithArray:@[@"acl", @"uploadId", @"partNumber", @"uploads", @"logging", @"website", @"location",
+                                                  @"lifecycle", @"referer", @"cors", @"delete", @"append", @"position", @"security-token", @"x-oss-process", @"sequential"]];
     });
     /****************************************************************/
 
-    /* initial each part of content to sign */
-    NSString * method = requestMessage.httpMethod;
-    NSString * contentType = @"";
-    NSString * contentMd5 = @"";
-    NSString * date = requestMessage.date;
-    NSString * xossHeader = @"";
-    NSString * resource = @"";
-
-    OSSFederationToken * federationToken = nil;
-
-    if (requestMessage.contentType) {
-        contentType = requestMessage.contentType;
-    }
-    if (requestMessage.contentMd5) {
-        contentMd5 = requestMessage.contentMd5;
-    }
-
-    /* if credential provider is a federation token provider, it need to specially handle */
-    if ([self.credentialProvider isKindOfClass:[OSSFederationCredentialProvider class]]) {
-        federationToken = [(OSSFederationCredentialProvider *)self.credentialProvider getToken:&error];
-        if (error) {
-            return [OSSTask taskWithError:error];
-        }
-        [requestMessage.headerParams setObject:federationToken.tToken forKey:@"x-oss-security-token"];
-    } else if ([self.credentialProvider isKindOfClass:[OSSStsTokenCredentialProvider class]]) {
-        federationToken = [(OSSStsTokenCredentialProvider *)self.credentialProvider getToken];
+    if (federationToken) {
         [requestMessage.headerParams setObject:federationToken.tToken forKey:@"x-oss-security-token"];
     }
-    
+
     if (requestMessage.contentSHA1) {
         [requestMessage.headerParams setObject:requestMessage.contentSHA1 forKey:OSSHttpHeaderHashSHA1];
     }
-        
 
-    /* construct CanonicalizedOSSHeaders */
+    /* the content to sign is built in one buffer: VERB\nContent-MD5\nContent-Type\nDate\nCanonicalizedOSSHeaders CanonicalizedResource */
+    NSMutableString * stringToSign = [NSMutableString stringWithCapacity:256];
+    [stringToSign appendString:requestMessage.httpMethod ?: @""];
+    [stringToSign appendString:@"\n"];
+    [stringToSign appendString:requestMessage.contentMd5 ?: @""];
+    [stringToSign appendString:@"\n"];
+    [stringToSign appendString:requestMessage.contentType ?: @""];
+    [stringToSign appendString:@"\n"];
+    [stringToSign appendString:requestMessage.date ?: @""];
+    [stringToSign appendString:@"\n"];
+
+    /* construct CanonicalizedOSSHeaders, only the x-oss- headers are sorted */
     if (requestMessage.headerParams) {
-        NSMutableArray * params = [[NSMutableArray alloc] init];
-        NSArray * sortedKey = [[requestMessage.headerParams allKeys] sortedArrayUsingComparator:^NSComparisonResult(id obj1, id obj2) {
-            return [obj1 compare:obj2];
-        }];
-        for (NSString * key in sortedKey) {
+        NSMutableArray * ossHeaderKeys = [NSMutableArray array];
+        for (NSString * key in requestMessage.headerParams) {
             if ([key hasPrefix:@"x-oss-"]) {
-                [params addObject:[NSString stringWithFormat:@"%@:%@", key, [requestMessage.headerParams objectForKey:key]]];
+                [ossHeaderKeys addObject:key];
             }
         }
-        if ([params count]) {
-            xossHeader = [NSString stringWithFormat:@"%@\n", [params componentsJoinedByString:@"\n"]];
+        [ossHeaderKeys sortUsingSelector:@selector(compare:)];
+        for (NSString * key in ossHeaderKeys) {
+            [stringToSign appendString:key];
+            [stringToSign appendString:@":"];
+            [stringToSign appendString:[[requestMessage.headerParams objectForKey:key] description]];
+            [stringToSign appendString:@"\n"];
         }
     }
 
     /* construct CanonicalizedResource */
-    resource = @"/";
+    NSString * resource = @"/";
     if (requestMessage.bucketName) {
         resource = [NSString stringWithFormat:@"/%@/", requestMessage.bucketName];
     }
     if (requestMessage.objectKey) {
         resource = [resource oss_stringByAppendingPathComponentForURL:requestMessage.objectKey];
     }
+    [stringToSign appendString:resource];
     if (requestMessage.querys) {
-        NSMutableArray * querys = [[NSMutableArray alloc] init];
-        NSArray * sortedKey = [[requestMessage.querys allKeys] sortedArrayUsingComparator:^NSComparisonResult(id obj1, id obj2) {
-            return [obj1 compare:obj2];
-        }];
-        for (NSString * key in sortedKey) {
-            NSString * value = [requestMessage.querys objectForKey:key];
-
-            if (![OSSSubResourceARRAY containsObject:key]) { // notice it's based on content compare
-                continue;
-            }
-
-            if ([value isEqualToString:@""]) {
-                [querys addObject:[NSString stringWithFormat:@"%@", key]];
-            } else {
-                [querys addObject:[NSString stringWithFormat:@"%@=%@", key, value]];
+        NSMutableArray * subResourceKeys = [NSMutableArray array];
+        for (NSString * key in requestMessage.querys) {
+            if ([OSSSubResourceSET containsObject:key]) { // notice it's based on content compare
+                [subResourceKeys addObject:key];
             }
         }
-        if ([querys count]) {
-            resource = [resource stringByAppendingString:[NSString stringWithFormat:@"?%@",[querys componentsJoinedByString:@"&"]]];
+        [subResourceKeys sortUsingSelector:@selector(compare:)];
+        BOOL isFirst = YES;
+        for (NSString * key in subResourceKeys) {
+            NSString * value = [requestMessage.querys objectForKey:key];
+            [stringToSign appendString:isFirst ? @"?" : @"&"];
+            [stringToSign appendString:key];
+            if (![value isEqualToString:@""]) {
+                [stringToSign appendString:@"="];
+                [stringToSign appendString:value];
+            }
+            isFirst = NO;
         }
     }
 
-    /* now, join every part of content and sign */
-    NSString * stringToSign = [NSString stringWithFormat:@"%@\n%@\n%@\n%@\n%@%@", method, contentMd5, contentType, date, xossHeader, resource];
+    /* now, sign the content */
     OSSLogDebug(@"string to sign: %@", stringToSign);
     if ([self.credentialProvider isKindOfClass:[OSSFederationCredentialProvider class]]
         || [self.credentialProvider isKindOfClass:[OSSStsTokenCredentialProvider class]])
@@ -592,6 +820,11 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
     return self;
 }
 
+- (void)setPriority:(OSSRequestPriority)priority {
+    _priority = priority;
+    self.requestDelegate.priority = priority;
+}
+
 - (void)cancel {
     _isCancelled = YES;
 
@@ -602,6 +835,27 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 
 @end
 
+@implementation OSSRequestMetrics
+
+- (NSArray<NSError *> *)retryErrors {
+    return _retryErrors ?: @[];
+}
+
+- (uint32_t)retryCount {
+    return (uint32_t)_retryErrors.count;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"OSSRequestMetrics<%p> : {%@ %@/%@, httpResponseCode: %ld, requestId: %@, total: %.3fs, queue: %.3fs, dns: %.3fs, connect: %.3fs, tls: %.3fs, request: %.3fs, ttfb: %.3fs, response: %.3fs, reused: %d, protocol: %@, sent: %lld, received: %lld, retries: %u, httpdns: %@, error: %@}",
+            self, self.httpMethod, self.bucketName, self.objectKey, (long)self.httpResponseCode, self.requestId,
+            self.totalDuration, self.queueDuration, self.domainLookupDuration, self.connectDuration, self.secureConnectionDuration,
+            self.requestDuration, self.timeToFirstByte, self.responseDuration, self.isReusedConnection, self.networkProtocolName,
+            self.bytesSent, self.bytesReceived, self.retryCount, self.httpdnsAddress, self.error];
+}
+
+@end
+
 @implementation OSSResult
 
 - (NSString *)description
@@ -680,6 +934,34 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 @implementation OSSHeadObjectResult
 @end
 
+@interface OSSHeadMultipleObjectsRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
+
+@implementation OSSHeadMultipleObjectsRequest
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.concurrentRequestCount = OSSDefaultMaxConcurrentNum;
+        self.runningChildrenRequests = [NSHashTable weakObjectsHashTable];
+    }
+    return self;
+}
+
+- (void)cancel {
+    [super cancel];
+    NSArray<OSSRequest *> *children;
+    @synchronized(self.runningChildrenRequests) {
+        children = [self.runningChildrenRequests allObjects];
+    }
+    [children makeObjectsPerformSelector:@selector(cancel)];
+}
+
+@end
+
+@implementation OSSHeadMultipleObjectsResult
+@end
+
 @implementation OSSGetObjectRequest
 @end
 
@@ -726,6 +1008,34 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 @implementation OSSDeleteObjectResult
 @end
 
+@interface OSSDeleteMultipleObjectsRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
+
+@implementation OSSDeleteMultipleObjectsRequest
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.concurrentRequestCount = OSSDefaultMaxConcurrentNum;
+        self.runningChildrenRequests = [NSHashTable weakObjectsHashTable];
+    }
+    return self;
+}
+
+- (void)cancel {
+    [super cancel];
+    NSArray<OSSRequest *> *children;
+    @synchronized(self.runningChildrenRequests) {
+        children = [self.runningChildrenRequests allObjects];
+    }
+    [children makeObjectsPerformSelector:@selector(cancel)];
+}
+
+@end
+
+@implementation OSSDeleteMultipleObjectsResult
+@end
+
 @implementation OSSCopyObjectRequest
 
 - (instancetype)init {
@@ -760,6 +1070,12 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 @implementation OSSUploadPartResult
 @end
 
+@implementation OSSUploadPartCopyRequest
+@end
+
+@implementation OSSUploadPartCopyResult
+@end
+
 @implementation OSSPartInfo
 
 + (instancetype)partInfoWithPartNum:(int32_t)partNum
@@ -835,16 +1151,115 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 - (instancetype)init {
     if (self = [super init]) {
         self.partSize = 256 * 1024;
+        self.concurrentPartCount = OSSDefaultMaxConcurrentNum;
+        self.maxConcurrentPartCount = 8;
+        self.maxPartSize = 4 * 1024 * 1024;
+    }
+    return self;
+}
+
+- (void)cancel {
+    [super cancel];
+}
+
+@end
+
+@implementation OSSStreamingMultipartUploadRequest
+@end
+
+@interface OSSParallelDownloadRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
+
+@implementation OSSParallelDownloadRequest
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.partSize = 1024 * 1024;
+        self.concurrentPartCount = OSSDefaultMaxConcurrentNum;
+        self.runningChildrenRequests = [NSHashTable weakObjectsHashTable];
     }
     return self;
 }
 
 - (void)cancel {
     [super cancel];
+    NSArray<OSSRequest *> *children;
+    @synchronized(self.runningChildrenRequests) {
+        children = [self.runningChildrenRequests allObjects];
+    }
+    [children makeObjectsPerformSelector:@selector(cancel)];
 }
 
 @end
 
+@implementation OSSResumableDownloadRequest
+@end
+
+@implementation OSSParallelDownloadResult
+@end
+
+@interface OSSMultipartCopyRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
+
+@implementation OSSMultipartCopyRequest
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.partSize = 10 * 1024 * 1024;
+        self.concurrentPartCount = OSSDefaultMaxConcurrentNum;
+        self.deleteUploadIdOnCancelling = YES;
+        self.runningChildrenRequests = [NSHashTable weakObjectsHashTable];
+    }
+    return self;
+}
+
+- (void)cancel {
+    [super cancel];
+    NSArray<OSSRequest *> *children;
+    @synchronized(self.runningChildrenRequests) {
+        children = [self.runningChildrenRequests allObjects];
+    }
+    [children makeObjectsPerformSelector:@selector(cancel)];
+}
+
+@end
+
+@implementation OSSMultipartCopyResult
+@end
+
+@interface OSSBulkUploadRequest ()
+@property (nonatomic, strong) NSHashTable<OSSRequest *> * runningChildrenRequests;
+@end
+
+@implementation OSSBulkUploadRequest
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.objectKeyPrefix = @"";
+        self.multipartThreshold = 5 * 1024 * 1024;
+        self.partSize = 1024 * 1024;
+        self.concurrentFileCount = OSSDefaultMaxConcurrentNum;
+        self.runningChildrenRequests = [NSHashTable weakObjectsHashTable];
+    }
+    return self;
+}
+
+- (void)cancel {
+    [super cancel];
+    NSArray<OSSRequest *> *children;
+    @synchronized(self.runningChildrenRequests) {
+        children = [self.runningChildrenRequests allObjects];
+    }
+    [children makeObjectsPerformSelector:@selector(cancel)];
+}
+
+@end
+
+@implementation OSSBulkUploadResult
+@end
+
 @implementation OSSResumableUploadRequest
 
 - (instancetype)init {
@@ -882,14 +1297,31 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 
     NSFileHandle * _fileHandle;
     NSMutableData * _collectingData;
+    OSSXMLResponseParser * _xmlParser;
     NSHTTPURLResponse * _response;
     uint64_t _crc64ecma;
+    /* the bytes collected, counted by the memory governor until the result is made */
+    int64_t _heldBytes;
+}
+
+- (void)dealloc {
+    [self releaseHeldBytes];
+}
+
+- (void)releaseHeldBytes {
+    if (_heldBytes > 0) {
+        [[OSSMemoryGovernor sharedGovernor] releaseBytes:_heldBytes];
+        _heldBytes = 0;
+    }
 }
 
 - (void)reset {
+    [self releaseHeldBytes];
     _collectingData = nil;
+    _xmlParser = nil;
     _fileHandle = nil;
     _response = nil;
+    _crc64ecma = 0;
 }
 
 - (instancetype)initForOperationType:(OSSOperationType)operationType {
@@ -907,16 +1339,12 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 {
     if (_crc64Verifiable&&(_operationTypeForThisParser == OSSOperationTypeGetObject))
     {
-        NSMutableData *mutableData = [NSMutableData dataWithData:data];
-        if (_crc64ecma != 0)
-        {
-            _crc64ecma = [OSSUtil crc64ForCombineCRC1:_crc64ecma
-                                                 CRC2:[mutableData oss_crc64]
-                                               length:mutableData.length];
-        }else
-        {
-            _crc64ecma = [mutableData oss_crc64];
-        }
+        /* continued over the received bytes in place, a chunk may be made of several regions */
+        __block uint64_t crc64ecma = _crc64ecma;
+        [data enumerateByteRangesUsingBlock:^(const void * bytes, NSRange byteRange, BOOL * stop) {
+            crc64ecma = [OSSUtil crc64ecma:crc64ecma buffer:(void *)bytes length:byteRange.length];
+        }];
+        _crc64ecma = crc64ecma;
     }
     
     if (self.onRecieveBlock) {
@@ -969,13 +1397,35 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
         }
     } else
     {
-        if (!_collectingData)
+        /* list results are parsed while they are being received */
+        if (!_xmlParser && !_collectingData)
+        {
+            _xmlParser = [OSSXMLResponseParser parserForOperationType:_operationTypeForThisParser];
+        }
+        if (_xmlParser)
         {
-            _collectingData = [[NSMutableData alloc] initWithData:data];
+            [_xmlParser feedData:data];
         }
         else
         {
+            int64_t collectedLength = (int64_t)_collectingData.length + (int64_t)data.length;
+            int64_t expectedLength = _response.expectedContentLength;
+            if (self.maxCollectingDataLength > 0
+                && (collectedLength > self.maxCollectingDataLength || expectedLength > self.maxCollectingDataLength))
+            {
+                return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                                 code:OSSClientErrorCodeInvalidArgument
+                                                             userInfo:@{OSSErrorMessageTOKEN: [NSString stringWithFormat:@"The response body is larger than %lld bytes", self.maxCollectingDataLength]}]];
+            }
+            if (!_collectingData)
+            {
+                /* sized once for the whole body, so that receiving it doesn't reallocate */
+                _collectingData = self.collectingBuffer ?: [NSMutableData dataWithCapacity:(NSUInteger)MAX(expectedLength, (int64_t)data.length)];
+                [_collectingData setLength:0];
+            }
             [_collectingData appendData:data];
+            [[OSSMemoryGovernor sharedGovernor] holdBytes:(int64_t)data.length];
+            _heldBytes += (int64_t)data.length;
         }
     }
     return [OSSTask taskWithResult:nil];
@@ -1022,6 +1472,9 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 
 - (nullable id)constructResultObject
 {
+    // the collected body belongs to the result from now on
+    [self releaseHeldBytes];
+
     if (self.onRecieveBlock)
     {
         return nil;
@@ -1109,48 +1562,13 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
 
         case OSSOperationTypeGetBucket:
         {
-            OSSGetBucketResult * getBucketResult = [OSSGetBucketResult new];
+            [_xmlParser finish];
+            OSSGetBucketResult * getBucketResult = (OSSGetBucketResult *)_xmlParser.result ?: [OSSGetBucketResult new];
             if (_response) {
                 [self parseResponseHeader:_response toResultObject:getBucketResult];
             }
-            if (_collectingData) {
-                NSDictionary * parsedDict = [NSDictionary oss_dictionaryWithXMLData:_collectingData];
-                OSSLogVerbose(@"Get bucket dict: %@", parsedDict);
-
-                if (parsedDict) {
-                    getBucketResult.bucketName = [parsedDict objectForKey:OSSNameXMLTOKEN];
-                    getBucketResult.prefix = [parsedDict objectForKey:OSSPrefixXMLTOKEN];
-                    getBucketResult.marker = [parsedDict objectForKey:OSSMarkerXMLTOKEN];
-                    getBucketResult.nextMarker = [parsedDict objectForKey:OSSNextMarkerXMLTOKEN];
-                    getBucketResult.maxKeys = (int32_t)[[parsedDict objectForKey:OSSMaxKeysXMLTOKEN] integerValue];
-                    getBucketResult.delimiter = [parsedDict objectForKey:OSSDelimiterXMLTOKEN];
-                    getBucketResult.isTruncated = [[parsedDict objectForKey:OSSIsTruncatedXMLTOKEN] boolValue];
-
-                    id contentObject = [parsedDict objectForKey:OSSContentsXMLTOKEN];
-                    if ([contentObject isKindOfClass:[NSArray class]]) {
-                        getBucketResult.contents = contentObject;
-                    } else if ([contentObject isKindOfClass:[NSDictionary class]]) {
-                        NSArray * arr = [NSArray arrayWithObject:contentObject];
-                        getBucketResult.contents = arr;
-                    } else {
-                        getBucketResult.contents = nil;
-                    }
-
-                    NSMutableArray * commentPrefixesArr = [NSMutableArray new];
-                    id commentPrefixes = [parsedDict objectForKey:OSSCommonPrefixesXMLTOKEN];
-                    if ([commentPrefixes isKindOfClass:[NSArray class]]) {
-                        for (NSDictionary * prefix in commentPrefixes) {
-                            [commentPrefixesArr addObject:[prefix objectForKey:@"Prefix"]];
-                        }
-                    } else if ([commentPrefixes isKindOfClass:[NSDictionary class]]) {
-                        [commentPrefixesArr addObject:[(NSDictionary *)commentPrefixes objectForKey:@"Prefix"]];
-                    } else {
-                        commentPrefixesArr = nil;
-                    }
-
-                    getBucketResult.commentPrefixes = commentPrefixesArr;
-                }
-            }
+            OSSLogVerbose(@"Get bucket result, keys: %lu, common prefixes: %lu",
+                          (unsigned long)getBucketResult.contents.count, (unsigned long)getBucketResult.commentPrefixes.count);
             return getBucketResult;
         }
 
@@ -1256,6 +1674,22 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
             return copyObjectResult;
         }
 
+        case OSSOperationTypeUploadPartCopy: {
+            OSSUploadPartCopyResult * uploadPartCopyResult = [OSSUploadPartCopyResult new];
+            if (_response) {
+                [self parseResponseHeader:_response toResultObject:uploadPartCopyResult];
+            }
+            if (_collectingData) {
+                NSDictionary * parsedDict = [NSDictionary oss_dictionaryWithXMLData:_collectingData];
+                OSSLogVerbose(@"upload part copy result: %@", parsedDict);
+                if (parsedDict) {
+                    uploadPartCopyResult.lastModifed = [parsedDict objectForKey:OSSLastModifiedXMLTOKEN];
+                    uploadPartCopyResult.eTag = [parsedDict objectForKey:OSSETagXMLTOKEN];
+                }
+            }
+            return uploadPartCopyResult;
+        }
+
         case OSSOperationTypeInitMultipartUpload: {
             OSSInitMultipartUploadResult * initMultipartUploadResult = [OSSInitMultipartUploadResult new];
             if (_response) {
@@ -1306,32 +1740,27 @@ NSString * const BACKGROUND_SESSION_IDENTIFIER = @"com.aliyun.oss.backgroundsess
         }
 
         case OSSOperationTypeListMultipart: {
-            OSSListPartsResult * listPartsReuslt = [OSSListPartsResult new];
+            [_xmlParser finish];
+            OSSListPartsResult * listPartsReuslt = (OSSListPartsResult *)_xmlParser.result ?: [OSSListPartsResult new];
             if (_response) {
                 [self parseResponseHeader:_response toResultObject:listPartsReuslt];
             }
-            if (_collectingData) {
-                NSDictionary * parsedDict = [NSDictionary oss_dictionaryWithXMLData:_collectingData];
-                OSSLogVerbose(@"list multipart upload result: %@", parsedDict);
-                if (parsedDict) {
-                    listPartsReuslt.nextPartNumberMarker = [[parsedDict objectForKey:OSSNextPartNumberMarkerXMLTOKEN] intValue];
-                    listPartsReuslt.maxParts = [[parsedDict objectForKey:OSSMaxKeysXMLTOKEN] intValue];
-                    listPartsReuslt.isTruncated = [[parsedDict objectForKey:OSSMaxKeysXMLTOKEN] boolValue];
-
-                    id partsObject = [parsedDict objectForKey:OSSPartXMLTOKEN];
-                    if ([partsObject isKindOfClass:[NSArray class]]) {
-                        listPartsReuslt.parts = partsObject;
-                    } else if ([partsObject isKindOfClass:[NSDictionary class]]) {
-                        NSArray * arr = [NSArray arrayWithObject:partsObject];
-                        listPartsReuslt.parts = arr;
-                    } else {
-                        listPartsReuslt.parts = nil;
-                    }
-                }
-            }
+            OSSLogVerbose(@"list multipart upload result, parts: %lu", (unsigned long)listPartsReuslt.parts.count);
             return listPartsReuslt;
         }
 
+        case OSSOperationTypeDeleteMultipleObjects: {
+            [_xmlParser finish];
+            OSSDeleteMultipleObjectsResult * deleteResult = (OSSDeleteMultipleObjectsResult *)_xmlParser.result ?: [OSSDeleteMultipleObjectsResult new];
+            if (_response) {
+                [self parseResponseHeader:_response toResultObject:deleteResult];
+            }
+            if (!deleteResult.deletedObjects) {
+                deleteResult.deletedObjects = @[];
+            }
+            return deleteResult;
+        }
+
         case OSSOperationTypeAbortMultipartUpload: {
             OSSAbortMultipartUploadResult * abortMultipartUploadResult = [OSSAbortMultipartUploadResult new];
             if (_response) {
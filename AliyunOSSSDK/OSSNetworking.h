@@ -12,6 +12,8 @@
 @class OSSSyncMutableDictionary;
 @class OSSNetworkingRequestDelegate;
 @class OSSExecutor;
+@class OSSStreamingBody;
+@class OSSEndpointSelector;
 
 /**
  Retry type definition
@@ -24,10 +26,34 @@ typedef NS_ENUM(NSInteger, OSSNetworkingRetryType) {
     OSSNetworkingRetryTypeShouldCorrectClockSkewAndRetry
 };
 
+/**
+ The retry policy interface. One policy instance is shared by all the requests of a client,
+ so implementations must be thread safe.
+ */
+@protocol OSSRetryPolicy <NSObject>
+@property (nonatomic, assign) uint32_t maxRetryCount;
+
+- (OSSNetworkingRetryType)shouldRetry:(uint32_t)currentRetryCount
+                      requestDelegate:(OSSNetworkingRequestDelegate *)delegate
+                             response:(NSHTTPURLResponse *)response
+                                error:(NSError *)error;
+
+- (NSTimeInterval)timeIntervalForRetry:(uint32_t)currentRetryCount
+                       requestDelegate:(OSSNetworkingRequestDelegate *)delegate
+                              response:(NSHTTPURLResponse *)response
+                             retryType:(OSSNetworkingRetryType)retryType;
+
+@optional
+/**
+ Called once a request completes successfully, possibly after retries.
+ */
+- (void)requestDidSucceed:(OSSNetworkingRequestDelegate *)delegate;
+@end
+
 /**
  The retry handler interface
  */
-@interface OSSURLRequestRetryHandler : NSObject
+@interface OSSURLRequestRetryHandler : NSObject <OSSRetryPolicy>
 @property (nonatomic, assign) uint32_t maxRetryCount;
 
 - (OSSNetworkingRetryType)shouldRetry:(uint32_t)currentRetryCount
@@ -41,6 +67,56 @@ typedef NS_ENUM(NSInteger, OSSNetworkingRetryType) {
 + (instancetype)defaultRetryHandler;
 @end
 
+/**
+ The default retry policy of OSSClient.
+
+ - Backoff uses decorrelated jitter: sleep = min(maxDelay, random(baseDelay, max(baseDelay, lastSleep) * 3)),
+   from the first retry on, so clients hit by the same network blip don't retry in lockstep.
+ - Retries draw from a client-wide token bucket. Each retry costs retryCost tokens (timeouts cost
+   timeoutRetryCost), each successful request refunds successRefund tokens. Once the bucket is
+   drained, failures are returned immediately instead of amplifying the load.
+ - Non-idempotent operations (see -isIdempotentRequest:) are only retried when the request
+   never reached the server. Appends carrying a position are considered idempotent because
+   the server rejects a duplicate with PositionNotEqualToLength.
+ - 5xx and 429 responses are retried, waiting at least the Retry-After the server asked for.
+   If the server asks for more than maxRetryAfter, the error is returned immediately.
+ */
+@interface OSSJitteredRetryPolicy : NSObject <OSSRetryPolicy>
+@property (nonatomic, assign) uint32_t maxRetryCount;
+
+/** The minimum backoff, 0.2s by default. */
+@property (nonatomic, assign) NSTimeInterval baseDelay;
+
+/** The maximum backoff, 20s by default. */
+@property (nonatomic, assign) NSTimeInterval maxDelay;
+
+/** The longest Retry-After that is honored, 30s by default. */
+@property (nonatomic, assign) NSTimeInterval maxRetryAfter;
+
+/** The capacity of the retry token bucket, 500 by default. */
+@property (nonatomic, assign) NSUInteger retryTokenCapacity;
+
+/** Tokens taken by a retry, 5 by default. */
+@property (nonatomic, assign) NSUInteger retryCost;
+
+/** Tokens taken by a retry after a timeout, 10 by default. */
+@property (nonatomic, assign) NSUInteger timeoutRetryCost;
+
+/** Tokens given back by a successful request, 1 by default. */
+@property (nonatomic, assign) NSUInteger successRefund;
+
+/** Tokens currently left in the bucket. */
+@property (nonatomic, assign, readonly) NSUInteger availableRetryTokens;
+
++ (instancetype)policyWithMaxRetryCount:(uint32_t)maxRetryCount;
+
+/**
+ Whether the request can be sent again without changing the result.
+ Subclasses can override this to extend the rules.
+ */
+- (BOOL)isIdempotentRequest:(OSSNetworkingRequestDelegate *)delegate;
+@end
+
 /**
  Network parameters
  */
@@ -53,6 +129,11 @@ typedef NS_ENUM(NSInteger, OSSNetworkingRetryType) {
 @property (nonatomic, assign) NSTimeInterval timeoutIntervalForResource;
 @property (nonatomic, strong) NSString * proxyHost;
 @property (nonatomic, strong) NSNumber * proxyPort;
+@property (nonatomic, strong) id<OSSRetryPolicy> retryPolicy;
+@property (nonatomic, assign) NSInteger maxConnectionsPerHost;
+@property (nonatomic, assign) BOOL HTTPShouldUsePipelining;
+@property (nonatomic, assign) NSURLRequestNetworkServiceType networkServiceType;
+@property (nonatomic, assign) OSSMultipathServiceType multipathServiceType;
 @end
 
 /**
@@ -67,20 +148,38 @@ typedef NS_ENUM(NSInteger, OSSNetworkingRetryType) {
 @property (nonatomic, assign) BOOL isAccessViaProxy;
 
 @property (nonatomic, assign) BOOL isRequestCancelled;
+/** called when the request is cancelled while it waits to be sent */
+@property (atomic, copy) void (^cancellationHandler)(void);
+/** its session task was cancelled by a network change, it's sent again instead of failing */
+@property (atomic, assign) BOOL isInterruptedByNetworkChange;
+@property (nonatomic, assign) OSSRequestPriority priority;
 
 @property (nonatomic, strong) OSSHttpResponseParser * responseParser;
 
 @property (nonatomic, strong) NSData * uploadingData;
 @property (nonatomic, strong) NSURL * uploadingFileURL;
+/** the body of a streaming upload, sent once through needNewBodyStream: */
+@property (nonatomic, strong) OSSStreamingBody * uploadingBody;
+
+/** picks the endpoint of each attempt when the client has alternative endpoints */
+@property (nonatomic, strong) OSSEndpointSelector * endpointSelector;
+/** the endpoint the last attempt was sent to */
+@property (nonatomic, copy) NSString * selectedEndpoint;
 
 @property (nonatomic, assign) int64_t payloadTotalBytesWritten;
 
 @property (nonatomic, assign) BOOL isBackgroundUploadFileTask;
+/** the uploading file is a temporary part slice, removed by the networking if its task outlives the process which sent it */
+@property (nonatomic, assign) BOOL isUploadingFileSlice;
 @property (nonatomic, assign) BOOL isHttpdnsEnable;
 
-@property (nonatomic, strong) OSSURLRequestRetryHandler * retryHandler;
+@property (nonatomic, strong) id<OSSRetryPolicy> retryHandler;
 @property (nonatomic, assign) uint32_t currentRetryCount;
+/** the backoff slept before the last retry, used by jittered retry policies */
+@property (nonatomic, assign) NSTimeInterval lastRetryInterval;
 @property (nonatomic, strong) NSError * error;
+/** collected for every attempt when it's set, by the client before the request is scheduled */
+@property (nonatomic, strong) OSSRequestMetrics * metrics;
 @property (nonatomic, assign) BOOL isHttpRequestNotSuccessResponse;
 @property (nonatomic, strong) NSMutableData * httpRequestNotSuccessResponseBody;
 
@@ -164,10 +263,26 @@ typedef NS_ENUM(NSInteger, OSSNetworkingRetryType) {
 @property (nonatomic, strong) NSURLSession * dataSession;
 @property (nonatomic, strong) NSURLSession * uploadFileSession;
 @property (nonatomic, assign) BOOL isUsingBackgroundSession;
+/**
+ An OSSShardedMutableDictionary, so the lookups of the session callbacks don't wait on each other.
+ */
 @property (nonatomic, strong) OSSSyncMutableDictionary * sessionDelagateManager;
 @property (nonatomic, strong) OSSNetworkingConfiguration * configuration;
 @property (nonatomic, strong) OSSExecutor * taskExecutor;
 
+/**
+ The handler given to application:handleEventsForBackgroundURLSession:completionHandler:,
+ it's called on the main thread once the events of the background session are delivered.
+ */
+@property (nonatomic, copy) void (^backgroundSessionCompletionHandler)(void);
+
 - (instancetype)initWithConfiguration:(OSSNetworkingConfiguration *)configuration;
+
+/**
+ Returns the networking instance shared by the clients of the same endpoint host and
+ session related configuration, creating it on first use.
+ */
++ (instancetype)sharedNetworkingForEndpoint:(NSString *)endpoint configuration:(OSSNetworkingConfiguration *)configuration;
+
 - (OSSTask *)sendRequest:(OSSNetworkingRequestDelegate *)request;
 @end
@@ -15,7 +15,29 @@
 #import "OSSXMLDictionary.h"
 #import "NSMutableData+OSS_CRC.h"
 #import "OSSInputStreamHelper.h"
+#import "OSSHttpdns.h"
+#import "OSSEndpointSelector.h"
+#import "OSSXMLResponseParser.h"
+#import "OSSStreamingBody.h"
+#import "OSSReachabilityManager.h"
 
+static NSString * const oss_file_slice_task_description_prefix = @"oss-slice:";
+
+static NSTimeInterval oss_timeIntervalBetweenDates(NSDate * startDate, NSDate * endDate) {
+    if (!startDate || !endDate) {
+        return 0;
+    }
+    return MAX([endDate timeIntervalSinceDate:startDate], 0);
+}
+
+@interface OSSNetworkingRequestDelegate ()
+
+/**
+ * crc64 of the uploading file, computed on a background queue while the file is being uploaded.
+ */
+@property (nonatomic, strong) OSSInputStreamHelper *uploadingFileCRCHelper;
+
+@end
 
 @implementation OSSURLRequestRetryHandler
 
@@ -37,7 +59,7 @@
     }
     
     if ([error.domain isEqualToString:OSSClientErrorDomain]) {
-        if (error.code == OSSClientErrorCodeTaskCancelled) {
+        if (error.code == OSSClientErrorCodeTaskCancelled || error.code == OSSClientErrorCodeInvalidArgument) {
             return OSSNetworkingRetryTypeShouldNotRetry;
         } else {
             return OSSNetworkingRetryTypeShouldRetry;
@@ -69,6 +91,13 @@
     }
 }
 
+- (NSTimeInterval)timeIntervalForRetry:(uint32_t)currentRetryCount
+                       requestDelegate:(OSSNetworkingRequestDelegate *)delegate
+                              response:(NSHTTPURLResponse *)response
+                             retryType:(OSSNetworkingRetryType)retryType {
+    return [self timeIntervalForRetry:currentRetryCount retryType:retryType];
+}
+
 + (instancetype)defaultRetryHandler {
     OSSURLRequestRetryHandler * retryHandler = [OSSURLRequestRetryHandler new];
     retryHandler.maxRetryCount = OSSDefaultRetryCount;
@@ -77,6 +106,210 @@
 
 @end
 
+@implementation OSSJitteredRetryPolicy {
+    NSUInteger _availableRetryTokens;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _maxRetryCount = OSSDefaultRetryCount;
+        _baseDelay = 0.2;
+        _maxDelay = 20;
+        _maxRetryAfter = 30;
+        _retryTokenCapacity = 500;
+        _retryCost = 5;
+        _timeoutRetryCost = 10;
+        _successRefund = 1;
+        _availableRetryTokens = _retryTokenCapacity;
+    }
+    return self;
+}
+
++ (instancetype)policyWithMaxRetryCount:(uint32_t)maxRetryCount {
+    OSSJitteredRetryPolicy * policy = [OSSJitteredRetryPolicy new];
+    policy.maxRetryCount = maxRetryCount;
+    return policy;
+}
+
+- (void)setRetryTokenCapacity:(NSUInteger)retryTokenCapacity {
+    @synchronized(self) {
+        _retryTokenCapacity = retryTokenCapacity;
+        _availableRetryTokens = MIN(_availableRetryTokens, retryTokenCapacity);
+    }
+}
+
+- (NSUInteger)availableRetryTokens {
+    @synchronized(self) {
+        return _availableRetryTokens;
+    }
+}
+
+- (OSSNetworkingRetryType)shouldRetry:(uint32_t)currentRetryCount
+                      requestDelegate:(OSSNetworkingRequestDelegate *)delegate
+                             response:(NSHTTPURLResponse *)response
+                                error:(NSError *)error {
+    if (currentRetryCount >= self.maxRetryCount) {
+        return OSSNetworkingRetryTypeShouldNotRetry;
+    }
+
+    /* the data already handed to onRecieveData can't be taken back */
+    if (delegate.onRecieveData != nil) {
+        return OSSNetworkingRetryTypeShouldNotRetry;
+    }
+
+    BOOL idempotent = [self isIdempotentRequest:delegate];
+    NSUInteger cost = self.retryCost;
+
+    if ([error.domain isEqualToString:OSSClientErrorDomain]) {
+        if (error.code == OSSClientErrorCodeTaskCancelled || error.code == OSSClientErrorCodeInvalidArgument) {
+            return OSSNetworkingRetryTypeShouldNotRetry;
+        }
+        if (!idempotent && ![self isErrorBeforeSending:error]) {
+            return OSSNetworkingRetryTypeShouldNotRetry;
+        }
+        if (error.code == OSSClientErrorCodeNetworkError
+            && [error.userInfo[@"OriginErrorCode"] integerValue] == NSURLErrorTimedOut) {
+            cost = self.timeoutRetryCost;
+        }
+        return [self acquireRetryTokens:cost] ? OSSNetworkingRetryTypeShouldRetry : OSSNetworkingRetryTypeShouldNotRetry;
+    }
+
+    switch (response.statusCode) {
+        case 403:
+            /* the request was rejected before being processed, and it costs no token */
+            if ([[[error userInfo] objectForKey:@"Code"] isEqualToString:@"RequestTimeTooSkewed"]) {
+                return OSSNetworkingRetryTypeShouldCorrectClockSkewAndRetry;
+            }
+            break;
+
+        case 429:
+        case 500:
+        case 502:
+        case 503:
+        case 504: {
+            /* a throttled request wasn't processed, any other 5xx may have been */
+            if (!idempotent && response.statusCode != 429) {
+                break;
+            }
+            NSTimeInterval retryAfter = [self retryAfterOfResponse:response];
+            if (retryAfter > self.maxRetryAfter) {
+                OSSLogDebug(@"server asks to retry after %.1fs, give up", retryAfter);
+                break;
+            }
+            if ([self acquireRetryTokens:cost]) {
+                return OSSNetworkingRetryTypeShouldRetry;
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return OSSNetworkingRetryTypeShouldNotRetry;
+}
+
+- (NSTimeInterval)timeIntervalForRetry:(uint32_t)currentRetryCount
+                       requestDelegate:(OSSNetworkingRequestDelegate *)delegate
+                              response:(NSHTTPURLResponse *)response
+                             retryType:(OSSNetworkingRetryType)retryType {
+    switch (retryType) {
+        case OSSNetworkingRetryTypeShouldCorrectClockSkewAndRetry:
+        case OSSNetworkingRetryTypeShouldRefreshCredentialsAndRetry:
+            return 0;
+
+        default:
+            break;
+    }
+
+    // the first retry is drawn from [base, 3 * base] too, the clients which failed together don't retry together
+    NSTimeInterval base = self.baseDelay;
+    NSTimeInterval upper = MAX(base, delegate.lastRetryInterval) * 3;
+    NSTimeInterval interval = base + (upper - base) * ((double)arc4random() / UINT32_MAX);
+    interval = MIN(self.maxDelay, interval);
+    delegate.lastRetryInterval = interval;
+
+    return MAX(interval, [self retryAfterOfResponse:response]);
+}
+
+- (void)requestDidSucceed:(OSSNetworkingRequestDelegate *)delegate {
+    @synchronized(self) {
+        _availableRetryTokens = MIN(_retryTokenCapacity, _availableRetryTokens + _successRefund);
+    }
+}
+
+- (BOOL)isIdempotentRequest:(OSSNetworkingRequestDelegate *)delegate {
+    switch (delegate.operType) {
+        case OSSOperationTypeAppendObject:
+            return [delegate.allNeededMessage.querys objectForKey:@"position"] != nil;
+
+        case OSSOperationTypeInitMultipartUpload:
+        case OSSOperationTypeCompleteMultipartUpload:
+        case OSSOperationTypeTriggerCallBack:
+            return NO;
+
+        default:
+            return YES;
+    }
+}
+
+# pragma mark - Private Methods
+
+- (BOOL)acquireRetryTokens:(NSUInteger)cost {
+    @synchronized(self) {
+        if (_availableRetryTokens < cost) {
+            OSSLogDebug(@"retry token bucket is drained, give up retrying");
+            return NO;
+        }
+        _availableRetryTokens -= cost;
+        return YES;
+    }
+}
+
+/**
+ Whether the error guarantees the request never reached the server.
+ */
+- (BOOL)isErrorBeforeSending:(NSError *)error {
+    if (error.code == OSSClientErrorCodeSignFailed) {
+        return YES;
+    }
+    if (error.code != OSSClientErrorCodeNetworkError) {
+        return NO;
+    }
+    switch ([error.userInfo[@"OriginErrorCode"] integerValue]) {
+        case NSURLErrorCannotFindHost:
+        case NSURLErrorCannotConnectToHost:
+        case NSURLErrorDNSLookupFailed:
+        case NSURLErrorNotConnectedToInternet:
+            return YES;
+
+        default:
+            return NO;
+    }
+}
+
+/**
+ Retry-After in seconds, either delta-seconds or an HTTP date. 0 if absent.
+ */
+- (NSTimeInterval)retryAfterOfResponse:(NSHTTPURLResponse *)response {
+    NSString * value = [response.allHeaderFields objectForKey:@"Retry-After"];
+    if (!value) {
+        value = [response.allHeaderFields objectForKey:@"retry-after"];
+    }
+    if (![value isKindOfClass:[NSString class]] || value.length == 0) {
+        return 0;
+    }
+    NSScanner * scanner = [NSScanner scannerWithString:value];
+    double seconds = 0;
+    if ([scanner scanDouble:&seconds] && [scanner isAtEnd]) {
+        return MAX(0, seconds);
+    }
+    NSDate * date = [NSDate oss_dateFromString:value];
+    return date ? MAX(0, [date timeIntervalSinceDate:[NSDate oss_clockSkewFixedDate]]) : 0;
+}
+
+@end
+
 @implementation OSSNetworkingConfiguration
 @end
 
@@ -84,7 +317,6 @@
 
 - (instancetype)init {
     if (self = [super init]) {
-        self.retryHandler = [OSSURLRequestRetryHandler defaultRetryHandler];
         self.interceptors = [[NSMutableArray alloc] init];
         self.isHttpdnsEnable = YES;
     }
@@ -101,6 +333,10 @@
 
 - (void)cancel {
     self.isRequestCancelled = YES;
+    void (^cancellationHandler)(void) = self.cancellationHandler;
+    if (cancellationHandler) {
+        cancellationHandler();
+    }
     if (self.currentSessionTask) {
         OSSLogDebug(@"this task is cancelled now!");
         [self.currentSessionTask cancel];
@@ -135,45 +371,48 @@
         return validateParam;
     }
 
-#define URLENCODE(a) [OSSUtil encodeURL:(a)]
     OSSLogDebug(@"start to build request");
-    // build base url string
-    NSString * urlString = self.allNeededMessage.endpoint;
-
-    NSURL * endPointURL = [NSURL URLWithString:self.allNeededMessage.endpoint];
-    if ([OSSUtil isOssOriginBucketHost:endPointURL.host] && self.allNeededMessage.bucketName) {
-        urlString = [NSString stringWithFormat:@"%@://%@.%@", endPointURL.scheme, self.allNeededMessage.bucketName, endPointURL.host];
+    // build the url in one string: base url, object key and query string
+    OSSAllRequestNeededMessage * message = self.allNeededMessage;
+    // each attempt goes to the healthiest of the client's endpoints, the signature doesn't cover the host
+    NSString * endpoint = message.endpoint;
+    if (self.endpointSelector && [endpoint isEqualToString:self.endpointSelector.endpoints.firstObject]) {
+        endpoint = [self.endpointSelector bestEndpoint];
     }
-
-    endPointURL = [NSURL URLWithString:urlString];
+    self.selectedEndpoint = endpoint;
+    NSURL * endPointURL = [NSURL URLWithString:endpoint];
     NSString * urlHost = endPointURL.host;
-    if (!self.isAccessViaProxy && [OSSUtil isOssOriginBucketHost:urlHost] && self.isHttpdnsEnable) {
-        NSString * httpdnsResolvedResult = [OSSUtil getIpByHost:urlHost];
-        urlString = [NSString stringWithFormat:@"%@://%@", endPointURL.scheme, httpdnsResolvedResult];
+    BOOL isOssOriginHost = [OSSUtil isOssOriginBucketHost:urlHost];
+    if (isOssOriginHost && message.bucketName) {
+        urlHost = [NSString stringWithFormat:@"%@.%@", message.bucketName, urlHost];
     }
 
-    if (self.allNeededMessage.objectKey) {
-        urlString = [urlString oss_stringByAppendingPathComponentForURL:URLENCODE(self.allNeededMessage.objectKey)];
+    NSMutableString * urlString = [NSMutableString stringWithCapacity:endpoint.length + message.objectKey.length * 3 + 64];
+    if (!self.isAccessViaProxy && isOssOriginHost && self.isHttpdnsEnable) {
+        [urlString appendFormat:@"%@://%@", endPointURL.scheme, [OSSUtil getIpByHost:urlHost]];
+    } else if (isOssOriginHost && message.bucketName) {
+        [urlString appendFormat:@"%@://%@", endPointURL.scheme, urlHost];
+    } else {
+        [urlString appendString:endpoint];
     }
 
-    // join query string
-    if (self.allNeededMessage.querys) {
-        NSMutableArray * querys = [[NSMutableArray alloc] init];
-        for (NSString * key in [self.allNeededMessage.querys allKeys]) {
-            NSString * value = [self.allNeededMessage.querys objectForKey:key];
-            if (value) {
-                if ([value isEqualToString:@""]) {
-                    [querys addObject:URLENCODE(key)];
-                } else {
-                    [querys addObject:[NSString stringWithFormat:@"%@=%@", URLENCODE(key), URLENCODE(value)]];
-                }
-            }
-        }
-        if (querys && [querys count]) {
-            NSString * queryString = [querys componentsJoinedByString:@"&"];
-            urlString = [NSString stringWithFormat:@"%@?%@", urlString, queryString];
+    if (message.objectKey) {
+        if (![urlString hasSuffix:@"/"]) {
+            [urlString appendString:@"/"];
         }
+        [OSSUtil appendEncodedURL:message.objectKey toString:urlString];
     }
+
+    __block BOOL hasQuery = NO;
+    [message.querys enumerateKeysAndObjectsUsingBlock:^(NSString * key, NSString * value, BOOL * stop) {
+        [urlString appendString:hasQuery ? @"&" : @"?"];
+        hasQuery = YES;
+        [OSSUtil appendEncodedURL:key toString:urlString];
+        if (![value isEqualToString:@""]) {
+            [urlString appendString:@"="];
+            [OSSUtil appendEncodedURL:value toString:urlString];
+        }
+    }];
     OSSLogDebug(@"built full url: %@", urlString);
 
     NSString * headerHost = urlHost;
@@ -215,7 +454,6 @@
     OSSLogVerbose(@"buidlInternalHttpRequest -\nmethod: %@\nurl: %@\nheader: %@", self.internalRequest.HTTPMethod,
                   self.internalRequest.URL, self.internalRequest.allHTTPHeaderFields);
 
-#undef URLENCODE//(a)
     return [OSSTask taskWithResult:nil];
 }
 @end
@@ -331,7 +569,12 @@
 
 @end
 
-@implementation OSSNetworking
+@implementation OSSNetworking {
+    /* the requests interrupted by the loss of the network, sent again once it's back */
+    NSMutableArray<OSSNetworkingRequestDelegate *> * _requestsWaitingForNetwork;
+    /* the last status posted to it, the one of the reachability manager at first */
+    BOOL _isOffline;
+}
 
 - (instancetype)initWithConfiguration:(OSSNetworkingConfiguration *)configuration {
     if (self = [super init]) {
@@ -358,6 +601,20 @@
         }
         dataSessionConfig.URLCache = nil;
         uploadSessionConfig.URLCache = nil;
+        for (NSURLSessionConfiguration * sessionConfig in @[dataSessionConfig, uploadSessionConfig]) {
+            if (configuration.maxConnectionsPerHost > 0) {
+                sessionConfig.HTTPMaximumConnectionsPerHost = configuration.maxConnectionsPerHost;
+            }
+            sessionConfig.HTTPShouldUsePipelining = configuration.HTTPShouldUsePipelining;
+            sessionConfig.networkServiceType = configuration.networkServiceType;
+#if TARGET_OS_IOS
+            // multipathServiceType is only available since iOS 11
+            if (configuration.multipathServiceType != OSSMultipathServiceTypeNone
+                && [sessionConfig respondsToSelector:@selector(setMultipathServiceType:)]) {
+                [sessionConfig setValue:@(configuration.multipathServiceType) forKey:@"multipathServiceType"];
+            }
+#endif
+        }
         if (configuration.proxyHost && configuration.proxyPort) {
             // Create an NSURLSessionConfiguration that uses the proxy
             NSDictionary *proxyDict = @{
@@ -381,30 +638,73 @@
                                                   delegateQueue:operationQueue];
 
         self.isUsingBackgroundSession = configuration.enableBackgroundTransmitService;
-        _sessionDelagateManager = [OSSSyncMutableDictionary new];
-
-        NSOperationQueue * queue = [NSOperationQueue new];
-        if (configuration.maxConcurrentRequestCount) {
-            queue.maxConcurrentOperationCount = configuration.maxConcurrentRequestCount;
+        _sessionDelagateManager = [OSSShardedMutableDictionary new];
+
+        // signing and building the requests, a bounded number of threads whatever the count of requests
+        NSUInteger taskExecutorWidth = configuration.maxConcurrentRequestCount ?: [NSProcessInfo processInfo].activeProcessorCount * 2;
+        self.taskExecutor = [OSSExecutor executorWithWidth:taskExecutorWidth qualityOfService:QOS_CLASS_DEFAULT];
+
+        _requestsWaitingForNetwork = [NSMutableArray new];
+        OSSReachabilityManager * reachabilityManager = [OSSReachabilityManager shareInstance];
+        _isOffline = !reachabilityManager.isReachable;
+        // the changes of the device, and the ones posted to this networking only, e.g. by the tests
+        for (id object in @[reachabilityManager, self]) {
+            [[NSNotificationCenter defaultCenter] addObserver:self
+                                                     selector:@selector(reachabilityDidChange:)
+                                                         name:OSSReachabilityChangedNotification
+                                                       object:object];
         }
-        self.taskExecutor = [OSSExecutor executorWithOperationQueue:queue];
     }
     return self;
 }
 
-- (OSSTask *)sendRequest:(OSSNetworkingRequestDelegate *)request {
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
-        OSSLogVerbose(@"NetWorkConnectedMsg : %@",[OSSUtil buildNetWorkConnectedMsg]);
-        NSString *operator = [OSSUtil buildOperatorMsg];
-        if(operator) OSSLogVerbose(@"Operator : %@",[OSSUtil buildOperatorMsg]);
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
++ (instancetype)sharedNetworkingForEndpoint:(NSString *)endpoint configuration:(OSSNetworkingConfiguration *)configuration {
+    static NSMapTable<NSString *, OSSNetworking *> * sharedNetworkings;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedNetworkings = [NSMapTable strongToWeakObjectsMapTable];
     });
+
+    NSString * key = [self sharingKeyForEndpoint:endpoint configuration:configuration];
+    @synchronized(sharedNetworkings) {
+        OSSNetworking * networking = [sharedNetworkings objectForKey:key];
+        if (!networking) {
+            networking = [[OSSNetworking alloc] initWithConfiguration:configuration];
+            [sharedNetworkings setObject:networking forKey:key];
+        } else {
+            OSSLogVerbose(@"reuse the networking of %@", key);
+        }
+        return networking;
+    }
+}
+
+- (OSSTask *)sendRequest:(OSSNetworkingRequestDelegate *)request {
+    if (OSSLogIsEnabled(OSSDDLogFlagVerbose)) {
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
+            OSSLogVerbose(@"NetWorkConnectedMsg : %@",[OSSUtil buildNetWorkConnectedMsg]);
+            NSString *operator = [OSSUtil buildOperatorMsg];
+            if(operator) OSSLogVerbose(@"Operator : %@",operator);
+        });
+    }
     OSSLogVerbose(@"send request --------");
     if (self.configuration.proxyHost && self.configuration.proxyPort) {
         request.isAccessViaProxy = YES;
     }
 
-    /* set maximum retry */
-    request.retryHandler.maxRetryCount = self.configuration.maxRetryCount;
+    /* unless the client has set its own, use the retry policy of the configuration, otherwise set maximum retry */
+    if (!request.retryHandler) {
+        if (self.configuration.retryPolicy) {
+            request.retryHandler = self.configuration.retryPolicy;
+        } else {
+            OSSURLRequestRetryHandler * retryHandler = [OSSURLRequestRetryHandler defaultRetryHandler];
+            retryHandler.maxRetryCount = self.configuration.maxRetryCount;
+            request.retryHandler = retryHandler;
+        }
+    }
 
     OSSTaskCompletionSource * taskCompletionSource = [OSSTaskCompletionSource taskCompletionSource];
 
@@ -434,9 +734,13 @@
     NSURLComponents *urlComponents = [NSURLComponents componentsWithURL:delegate.internalRequest.URL resolvingAgainstBaseURL:YES];
     BOOL hasXOSSProcess = [urlComponents.query containsString:@"x-oss-process"];
     BOOL enableCRC = delegate.crc64Verifiable;
+    // the crc64 of a gzip or deflate object is the one of its encoded bytes, which NSURLSession decodes as they come
+    NSString *contentEncoding = [result.httpResponseHeaderFields[OSSHttpHeaderContentEncoding] lowercaseString];
+    BOOL isBodyDecoded = delegate.operType == OSSOperationTypeGetObject
+                         && ([contentEncoding isEqualToString:@"gzip"] || [contentEncoding isEqualToString:@"deflate"]);
     // 3.判断如果未开启crc校验,或者headerFields里面有Range字段或者参数表中存在
     //   x-oss-process字段,都将不进行crc校验
-    if (!enableCRC || hasRange || hasXOSSProcess)
+    if (!enableCRC || hasRange || hasXOSSProcess || isBodyDecoded)
     {
         [source setResult:response];
     }
@@ -459,8 +763,11 @@
             OSSLogVerbose(@"delegate.uploadingFileURL : %@",delegate.uploadingFileURL);
             if (delegate.uploadingFileURL)
             {
-                OSSInputStreamHelper *helper = [[OSSInputStreamHelper alloc] initWithURL:delegate.uploadingFileURL];
-                [helper syncReadBuffers];
+                OSSInputStreamHelper *helper = delegate.uploadingFileCRCHelper;
+                if (!helper) {
+                    helper = [[OSSInputStreamHelper alloc] initWithURL:delegate.uploadingFileURL];
+                    [helper syncReadBuffers];
+                }
                 if (helper.crc64 != 0) {
                     result.localCRC64ecma = [NSString stringWithFormat:@"%llu",helper.crc64];
                 }
@@ -530,11 +837,11 @@
 
     [[[[[OSSTask taskWithResult:nil] continueWithExecutor:self.taskExecutor withSuccessBlock:^id(OSSTask *task) {
         OSSLogVerbose(@"start to intercept request");
+        // an interceptor may complete later, e.g. the signer waiting for a token, the next one runs after it
         for (id<OSSRequestInterceptor> interceptor in requestDelegate.interceptors) {
-            task = [interceptor interceptRequestMessage:requestDelegate.allNeededMessage];
-            if (task.error) {
-                return task;
-            }
+            task = [task continueWithSuccessBlock:^id(OSSTask *previousTask) {
+                return [interceptor interceptRequestMessage:requestDelegate.allNeededMessage];
+            }];
         }
         return task;
     }] continueWithSuccessBlock:^id(OSSTask *task) {
@@ -550,10 +857,22 @@
             sessionTask = [_dataSession dataTaskWithRequest:requestDelegate.internalRequest];
         } else if (requestDelegate.uploadingFileURL) {
             sessionTask = [_uploadFileSession uploadTaskWithRequest:requestDelegate.internalRequest fromFile:requestDelegate.uploadingFileURL];
+            
+            if (requestDelegate.crc64Verifiable && !requestDelegate.uploadingFileCRCHelper) {
+                // overlap the local crc64 with the transfer instead of reading the file again after it
+                requestDelegate.uploadingFileCRCHelper = [[OSSInputStreamHelper alloc] initWithURL:requestDelegate.uploadingFileURL];
+                [requestDelegate.uploadingFileCRCHelper asyncReadBuffers];
+            }
 
             if (self.isUsingBackgroundSession) {
                 requestDelegate.isBackgroundUploadFileTask = YES;
             }
+            if (requestDelegate.isUploadingFileSlice) {
+                sessionTask.taskDescription = [oss_file_slice_task_description_prefix stringByAppendingString:requestDelegate.uploadingFileURL.path];
+            }
+        } else if (requestDelegate.uploadingBody) {
+            // the body stream is asked for by URLSession:task:needNewBodyStream:
+            sessionTask = [_dataSession uploadTaskWithStreamedRequest:requestDelegate.internalRequest];
         } else { // not upload request
             sessionTask = [_dataSession dataTaskWithRequest:requestDelegate.internalRequest];
         }
@@ -594,10 +913,45 @@
     if (delegate == nil) {
         OSSLogVerbose(@"delegate: %@", delegate);
         /* if the background transfer service is enable, may recieve the previous task complete callback */
-        /* for now, we ignore it */
+        /* the part it uploaded is found by listing the parts when the upload resumes, only its slice is left to remove */
+        if ([sessionTask.taskDescription hasPrefix:oss_file_slice_task_description_prefix]) {
+            NSString * slicePath = [sessionTask.taskDescription substringFromIndex:oss_file_slice_task_description_prefix.length];
+            [[NSFileManager defaultManager] removeItemAtPath:slicePath error:nil];
+        }
         return ;
     }
 
+    NSString * httpdnsHost = nil;
+    NSString * httpdnsAddress = nil;
+    BOOL isSentToHttpdnsAddress = [self httpdnsHost:&httpdnsHost address:&httpdnsAddress ofTask:sessionTask];
+    if (isSentToHttpdnsAddress && [self isConnectFailure:error]) {
+        [[OSSHttpdns sharedInstance] reportConnectFailureForHost:httpdnsHost address:httpdnsAddress];
+    }
+    if (delegate.endpointSelector && delegate.selectedEndpoint) {
+        if ([self isConnectFailure:error]) {
+            [delegate.endpointSelector reportConnectFailureForEndpoint:delegate.selectedEndpoint];
+        } else if (httpResponse) {
+            [delegate.endpointSelector reportSuccessForEndpoint:delegate.selectedEndpoint connectRTT:0];
+        }
+    }
+
+    OSSRequestMetrics * metrics = delegate.metrics;
+    if (metrics) {
+        metrics.httpResponseCode = httpResponse.statusCode;
+        metrics.bytesSent += sessionTask.countOfBytesSent;
+        metrics.bytesReceived += sessionTask.countOfBytesReceived;
+        metrics.httpdnsAddress = isSentToHttpdnsAddress ? httpdnsAddress : nil;
+    }
+
+    if (delegate.isInterruptedByNetworkChange) {
+        delegate.isInterruptedByNetworkChange = NO;
+        // unless it was cancelled by its caller too, the attempt didn't fail, it's no retry
+        if (!delegate.isRequestCancelled && [error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled) {
+            [self resendRequestInterruptedByNetworkChange:delegate];
+            return;
+        }
+    }
+
     NSString * dateStr = [[httpResponse allHeaderFields] objectForKey:@"Date"];
     if ([dateStr length]) {
         NSDate * serverTime = [NSDate oss_dateFromString:dateStr];
@@ -624,7 +978,10 @@
         }
         if (delegate.error) {
             OSSLogDebug(@"networking request completed with error: %@", error);
-            if ([delegate.error.domain isEqualToString:NSURLErrorDomain] && delegate.error.code == NSURLErrorCancelled) {
+            if ([delegate.error.domain isEqualToString:OSSClientErrorDomain]) {
+                /* set while the response was received, the task was cancelled because of it */
+                return [OSSTask taskWithError:delegate.error];
+            } else if ([delegate.error.domain isEqualToString:NSURLErrorDomain] && delegate.error.code == NSURLErrorCancelled) {
                 return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
                                                                  code:OSSClientErrorCodeTaskCancelled
                                                              userInfo:[error userInfo]]];
@@ -646,7 +1003,7 @@
             }
             NSString * notSuccessResponseBody = [[NSString alloc] initWithData:delegate.httpRequestNotSuccessResponseBody encoding:NSUTF8StringEncoding];
             OSSLogError(@"http error response: %@", notSuccessResponseBody);
-            NSDictionary * dict = [NSDictionary oss_dictionaryWithXMLString:notSuccessResponseBody];
+            NSDictionary * dict = [OSSXMLResponseParser errorDictionaryWithData:delegate.httpRequestNotSuccessResponseBody];
 
             return [OSSTask taskWithError:[NSError errorWithDomain:OSSServerErrorDomain
                                                              code:(-1 * httpResponse.statusCode)
@@ -661,6 +1018,10 @@
                                                                   requestDelegate:delegate
                                                                          response:httpResponse
                                                                             error:task.error];
+            if (delegate.uploadingBody.isBodyStreamTaken) {
+                // a streamed body is read once, it can't be sent again
+                retryType = OSSNetworkingRetryTypeShouldNotRetry;
+            }
             OSSLogVerbose(@"current retry count: %u, retry type: %d", delegate.currentRetryCount, (int)retryType);
 
             switch (retryType) {
@@ -681,8 +1042,20 @@
             }
 
             /* now, should retry */
-            NSTimeInterval suspendTime = [delegate.retryHandler timeIntervalForRetry:delegate.currentRetryCount retryType:retryType];
+            NSTimeInterval suspendTime = [delegate.retryHandler timeIntervalForRetry:delegate.currentRetryCount
+                                                                      requestDelegate:delegate
+                                                                             response:httpResponse
+                                                                            retryType:retryType];
+            if ([self isConnectFailure:error]
+                && ([delegate.endpointSelector hasHealthyEndpointOtherThan:delegate.selectedEndpoint]
+                    || (isSentToHttpdnsAddress && [[OSSHttpdns sharedInstance] hasHealthyIpOfHost:httpdnsHost otherThanAddress:httpdnsAddress]))) {
+                // the next attempt goes to another endpoint or ip, it needn't back off from this one
+                suspendTime = 0;
+            }
             delegate.currentRetryCount++;
+            if (delegate.metrics) {
+                delegate.metrics.retryErrors = [delegate.metrics.retryErrors arrayByAddingObject:task.error];
+            }
             [NSThread sleepForTimeInterval:suspendTime];
             
             if(delegate.retryCallback){
@@ -695,12 +1068,22 @@
             
             [self dataTaskWithDelegate:delegate];
         } else {
+            if ([delegate.retryHandler respondsToSelector:@selector(requestDidSucceed:)]) {
+                [delegate.retryHandler requestDidSucceed:delegate];
+            }
             delegate.completionHandler([delegate.responseParser constructResultObject], nil);
         }
         return nil;
     }];
 }
 
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task needNewBodyStream:(void (^)(NSInputStream * _Nullable))completionHandler
+{
+    OSSNetworkingRequestDelegate * delegate = [self.sessionDelagateManager objectForKey:@(task.taskIdentifier)];
+    // nil fails the task if the session asks again, e.g. after an authentication challenge
+    completionHandler([delegate.uploadingBody takeBodyStream]);
+}
+
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend
 {
     OSSNetworkingRequestDelegate * delegate = [self.sessionDelagateManager objectForKey:@(task.taskIdentifier)];
@@ -742,7 +1125,47 @@
 
 - (void)URLSessionDidFinishEventsForBackgroundURLSession:(NSURLSession *)session
 {
-    
+    void (^completionHandler)(void) = nil;
+    @synchronized(self) {
+        completionHandler = self.backgroundSessionCompletionHandler;
+        self.backgroundSessionCompletionHandler = nil;
+    }
+    OSSLogVerbose(@"background session %@ finished its events", session.configuration.identifier);
+    if (completionHandler) {
+        dispatch_async(dispatch_get_main_queue(), completionHandler);
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics NS_AVAILABLE(10_12, 10_0)
+{
+    /* it's called before didCompleteWithError, the delegate is still registered */
+    OSSNetworkingRequestDelegate * delegate = [self.sessionDelagateManager objectForKey:@(task.taskIdentifier)];
+    NSURLSessionTaskTransactionMetrics * lastTransactionMetrics = metrics.transactionMetrics.lastObject;
+    if (delegate.metrics && lastTransactionMetrics) {
+        [self collectTransactionMetrics:lastTransactionMetrics intoMetrics:delegate.metrics];
+    }
+
+    if (delegate.endpointSelector && delegate.selectedEndpoint && task.response) {
+        for (NSURLSessionTaskTransactionMetrics * transactionMetrics in metrics.transactionMetrics) {
+            if (transactionMetrics.connectStartDate && transactionMetrics.connectEndDate) {
+                NSTimeInterval rtt = [transactionMetrics.connectEndDate timeIntervalSinceDate:transactionMetrics.connectStartDate];
+                [delegate.endpointSelector reportSuccessForEndpoint:delegate.selectedEndpoint connectRTT:rtt];
+            }
+        }
+    }
+
+    NSString * host = nil;
+    NSString * address = nil;
+    if (![self httpdnsHost:&host address:&address ofTask:task]) {
+        return;
+    }
+    /* a reused connection has no connect dates, only new connections tell the rtt of the ip */
+    for (NSURLSessionTaskTransactionMetrics * transactionMetrics in metrics.transactionMetrics) {
+        if (transactionMetrics.connectStartDate && transactionMetrics.connectEndDate) {
+            NSTimeInterval rtt = [transactionMetrics.connectEndDate timeIntervalSinceDate:transactionMetrics.connectStartDate];
+            [[OSSHttpdns sharedInstance] reportConnectRTT:rtt forHost:host address:address];
+        }
+    }
 }
 
 #pragma mark - NSURLSessionDataDelegate Methods
@@ -808,6 +1231,143 @@
 
 #pragma mark - Private Methods
 
+- (void)reachabilityDidChange:(NSNotification *)notification {
+    OSSNetworkStatus status = [notification.userInfo[OSSReachabilityStatusKey] integerValue];
+    OSSNetworkStatus previousStatus = [notification.userInfo[OSSReachabilityPreviousStatusKey] integerValue];
+    BOOL wasReachable = previousStatus == OSSNetworkStatusReachableViaWiFi || previousStatus == OSSNetworkStatusReachableViaWWAN;
+    NSArray<OSSNetworkingRequestDelegate *> * requests = nil;
+    @synchronized(self) {
+        // set before the requests are interrupted, the ones parked from now on are resent by the next change
+        _isOffline = status == OSSNetworkStatusNotReachable;
+        if (!_isOffline) {
+            requests = [_requestsWaitingForNetwork copy];
+        }
+    }
+    if (wasReachable && status != previousStatus) {
+        [self interruptRequestsForNetworkChange];
+    }
+    for (OSSNetworkingRequestDelegate * request in requests) {
+        [self resendRequestWaitingForNetwork:request];
+    }
+}
+
+/* the connections of the former interface are gone, the requests on them would only fail once they time out */
+- (void)interruptRequestsForNetworkChange {
+    for (id key in [self.sessionDelagateManager allKeys]) {
+        OSSNetworkingRequestDelegate * delegate = [self.sessionDelagateManager objectForKey:key];
+        if (!delegate || delegate.isRequestCancelled || delegate.isInterruptedByNetworkChange
+            || ![self canResendRequestInterruptedByNetworkChange:delegate]) {
+            continue;
+        }
+        OSSLogDebug(@"the network changed, the request to %@ is sent again", delegate.internalRequest.URL.host);
+        delegate.isInterruptedByNetworkChange = YES;
+        [delegate.currentSessionTask cancel];
+    }
+}
+
+/*
+ the background tasks go on by themselves, the data already given to the caller and the streamed bodies
+ can't be sent again, and the posts, e.g. an append or a complete, may have been applied already
+ */
+- (BOOL)canResendRequestInterruptedByNetworkChange:(OSSNetworkingRequestDelegate *)delegate {
+    return !delegate.isBackgroundUploadFileTask
+           && !delegate.onRecieveData
+           && !delegate.uploadingBody
+           && ![delegate.internalRequest.HTTPMethod isEqualToString:@"POST"];
+}
+
+- (void)resendRequestInterruptedByNetworkChange:(OSSNetworkingRequestDelegate *)delegate {
+    [delegate reset];
+    @synchronized(self) {
+        if (_isOffline) {
+            OSSLogDebug(@"the request to %@ waits for the network", delegate.internalRequest.URL.host);
+            [_requestsWaitingForNetwork addObject:delegate];
+            __weak OSSNetworking * weakSelf = self;
+            __weak OSSNetworkingRequestDelegate * weakDelegate = delegate;
+            delegate.cancellationHandler = ^{
+                // sent now, it fails with the cancel error
+                [weakSelf resendRequestWaitingForNetwork:weakDelegate];
+            };
+
+            // like a session waiting for connectivity, it waits until the resource timeout
+            NSTimeInterval timeout = self.configuration.timeoutIntervalForResource;
+            if (timeout > 0) {
+                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)),
+                               dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                    [weakSelf resendRequestWaitingForNetwork:weakDelegate];
+                });
+            }
+            return;
+        }
+    }
+    [self dataTaskWithDelegate:delegate];
+}
+
+- (void)resendRequestWaitingForNetwork:(OSSNetworkingRequestDelegate *)delegate {
+    if (!delegate) {
+        return;
+    }
+    @synchronized(self) {
+        if (![_requestsWaitingForNetwork containsObject:delegate]) {
+            return;
+        }
+        [_requestsWaitingForNetwork removeObject:delegate];
+    }
+    delegate.cancellationHandler = nil;
+    [self dataTaskWithDelegate:delegate];
+}
+
+/* the endpoint host plus every configuration that is baked into the sessions or the task executor */
++ (NSString *)sharingKeyForEndpoint:(NSString *)endpoint configuration:(OSSNetworkingConfiguration *)configuration {
+    NSURL * url = [NSURL URLWithString:endpoint];
+    return [NSString stringWithFormat:@"%@://%@:%@|%d|%@|%.3f|%.3f|%@|%@|%u|%ld|%d|%ld|%ld",
+            url.scheme, url.host, url.port,
+            configuration.enableBackgroundTransmitService, configuration.backgroundSessionIdentifier,
+            configuration.timeoutIntervalForRequest, configuration.timeoutIntervalForResource,
+            configuration.proxyHost, configuration.proxyPort,
+            configuration.maxConcurrentRequestCount, (long)configuration.maxConnectionsPerHost,
+            configuration.HTTPShouldUsePipelining, (long)configuration.networkServiceType,
+            (long)configuration.multipathServiceType];
+}
+
+- (void)collectTransactionMetrics:(NSURLSessionTaskTransactionMetrics *)transactionMetrics intoMetrics:(OSSRequestMetrics *)metrics NS_AVAILABLE(10_12, 10_0) {
+    metrics.domainLookupDuration = oss_timeIntervalBetweenDates(transactionMetrics.domainLookupStartDate, transactionMetrics.domainLookupEndDate);
+    metrics.connectDuration = oss_timeIntervalBetweenDates(transactionMetrics.connectStartDate, transactionMetrics.connectEndDate);
+    metrics.secureConnectionDuration = oss_timeIntervalBetweenDates(transactionMetrics.secureConnectionStartDate, transactionMetrics.secureConnectionEndDate);
+    metrics.requestDuration = oss_timeIntervalBetweenDates(transactionMetrics.requestStartDate, transactionMetrics.requestEndDate);
+    metrics.timeToFirstByte = oss_timeIntervalBetweenDates(transactionMetrics.requestStartDate, transactionMetrics.responseStartDate);
+    metrics.responseDuration = oss_timeIntervalBetweenDates(transactionMetrics.responseStartDate, transactionMetrics.responseEndDate);
+    metrics.isReusedConnection = transactionMetrics.isReusedConnection;
+    metrics.networkProtocolName = transactionMetrics.networkProtocolName;
+}
+
+/* returns NO if the task was not sent to an ip resolved by httpdns */
+- (BOOL)httpdnsHost:(NSString **)host address:(NSString **)address ofTask:(NSURLSessionTask *)task {
+    NSString * hostHeader = [task.originalRequest valueForHTTPHeaderField:@"Host"];
+    NSString * urlHost = task.originalRequest.URL.host;
+    if (!hostHeader || !urlHost || [hostHeader isEqualToString:urlHost] || ![OSSUtil isOssOriginBucketHost:hostHeader]) {
+        return NO;
+    }
+    *host = hostHeader;
+    *address = urlHost;
+    return YES;
+}
+
+- (BOOL)isConnectFailure:(NSError *)error {
+    if (![error.domain isEqualToString:NSURLErrorDomain]) {
+        return NO;
+    }
+    switch (error.code) {
+        case NSURLErrorCannotConnectToHost:
+        case NSURLErrorTimedOut:
+        case NSURLErrorNetworkConnectionLost:
+        case NSURLErrorSecureConnectionFailed:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
 - (BOOL)evaluateServerTrust:(SecTrustRef)serverTrust forDomain:(NSString *)domain {
     /*
      * Creates the policies for certificate verification.
@@ -0,0 +1,91 @@
+//
+//  OSSObjectAppender.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class OSSClient;
+@class OSSTask;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Appends a stream of writes to an appendable object with few requests.
+
+ The writes are buffered and sent as one append once flushSize bytes are buffered or
+ flushInterval has elapsed. The appends are sent one at a time, in order, each from the
+ position and crc64 returned by the previous one, so the caller doesn't track them.
+ Once maxBufferedSize bytes are buffered or being sent, appendData:error: blocks until an
+ append finishes.
+
+ After an append failed, the appender stops: every write and flush returns the error.
+ */
+@interface OSSObjectAppender : NSObject
+
+/**
+ The bytes buffered before an append is sent. 1MB by default.
+ */
+@property (nonatomic, assign) NSUInteger flushSize;
+
+/**
+ The max seconds a write waits in the buffer. 5 by default, 0 disables the timer.
+ */
+@property (nonatomic, assign) NSTimeInterval flushInterval;
+
+/**
+ The bytes buffered and being sent above which writes block. 8MB by default.
+ */
+@property (nonatomic, assign) NSUInteger maxBufferedSize;
+
+/**
+ The content type and the metadata, sent with the append which creates the object.
+ */
+@property (nonatomic, copy, nullable) NSString * contentType;
+@property (nonatomic, copy, nullable) NSDictionary * objectMeta;
+
+/**
+ The object length once the appends sent so far are done, i.e. the position of the next append.
+ */
+@property (nonatomic, assign, readonly) int64_t nextPosition;
+
+/**
+ The crc64ecma of the object after the appends done so far, nil if the object's crc64ecma
+ wasn't given at the creation.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString * crc64ecma;
+
+@property (nonatomic, strong, readonly, nullable) NSError * error;
+
+/**
+ @param position the current object length, 0 for a new object
+ @param crc64ecma the current crc64ecma of the object (x-oss-hash-crc64ecma), checked from then on if given
+ */
+- (instancetype)initWithClient:(OSSClient *)client
+                    bucketName:(NSString *)bucketName
+                     objectKey:(NSString *)objectKey
+                      position:(int64_t)position
+                     crc64ecma:(nullable NSString *)crc64ecma;
+
+/**
+ Buffers the data, blocking while the buffer is full. Don't call it on the main thread.
+ Returns NO if the appender failed or is closed.
+ */
+- (BOOL)appendData:(NSData *)data error:(NSError **)error;
+
+/**
+ Sends the data buffered so far. The task completes once it's appended, with the
+ OSSAppendObjectResult of the last append.
+ */
+- (OSSTask *)flush;
+
+/**
+ Flushes and stops the appender, later writes fail.
+ */
+- (OSSTask *)close;
+
+@end
+
+NS_ASSUME_NONNULL_END
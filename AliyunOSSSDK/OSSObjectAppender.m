@@ -0,0 +1,251 @@
+//
+//  OSSObjectAppender.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSObjectAppender.h"
+#import "OSSClient.h"
+#import "OSSDefine.h"
+#import "OSSModel.h"
+#import "OSSUtil.h"
+#import "OSSBolts.h"
+#import "OSSLog.h"
+
+@implementation OSSObjectAppender {
+    OSSClient * _client;
+    NSString * _bucketName;
+    NSString * _objectKey;
+
+    NSCondition * _condition;
+    NSMutableData * _buffer;
+    NSUInteger _sendingLength;
+    BOOL _isTimerDue;
+    BOOL _isClosed;
+    dispatch_source_t _timer;
+
+    BOOL _isCrcKnown;
+    uint64_t _crc64;
+
+    /* the bytes written and appended since the creation, a flush waits for the ones written before it */
+    int64_t _writtenLength;
+    int64_t _appendedLength;
+    NSMutableArray<NSNumber *> * _flushTargets;
+    NSMutableArray<OSSTaskCompletionSource *> * _flushSources;
+    OSSAppendObjectResult * _lastResult;
+}
+
+- (instancetype)initWithClient:(OSSClient *)client
+                    bucketName:(NSString *)bucketName
+                     objectKey:(NSString *)objectKey
+                      position:(int64_t)position
+                     crc64ecma:(NSString *)crc64ecma {
+    if (self = [super init]) {
+        _client = client;
+        _bucketName = [bucketName copy];
+        _objectKey = [objectKey copy];
+        _nextPosition = position;
+        _flushSize = 1024 * 1024;
+        _flushInterval = 5;
+        _maxBufferedSize = 8 * 1024 * 1024;
+
+        _condition = [NSCondition new];
+        _buffer = [NSMutableData new];
+        _flushTargets = [NSMutableArray new];
+        _flushSources = [NSMutableArray new];
+        if ([crc64ecma oss_isNotEmpty]) {
+            _isCrcKnown = [[NSScanner scannerWithString:crc64ecma] scanUnsignedLongLong:&_crc64];
+        } else if (position == 0) {
+            _isCrcKnown = YES;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+    }
+}
+
+- (NSString *)crc64ecma {
+    [_condition lock];
+    NSString * crc64ecma = _isCrcKnown ? [NSString stringWithFormat:@"%llu", _crc64] : nil;
+    [_condition unlock];
+    return crc64ecma;
+}
+
+- (BOOL)appendData:(NSData *)data error:(NSError **)error {
+    if (!data.length) {
+        return YES;
+    }
+
+    [_condition lock];
+    // a write larger than maxBufferedSize still goes once nothing else is pending
+    while (!_error && !_isClosed && _buffer.length + _sendingLength > 0
+           && _buffer.length + _sendingLength + data.length > self.maxBufferedSize) {
+        [_condition wait];
+    }
+    NSError * appenderError = _error ?: (_isClosed ? [self closedError] : nil);
+    if (!appenderError) {
+        [_buffer appendData:data];
+        _writtenLength += data.length;
+    }
+    [_condition unlock];
+
+    if (appenderError) {
+        if (error) {
+            *error = appenderError;
+        }
+        return NO;
+    }
+    [self startTimerIfNeeded];
+    [self sendIfNeeded];
+    return YES;
+}
+
+- (OSSTask *)flush {
+    OSSTask * task = nil;
+    [_condition lock];
+    if (_error) {
+        task = [OSSTask taskWithError:_error];
+    } else if (_appendedLength == _writtenLength) {
+        task = [OSSTask taskWithResult:_lastResult];
+    } else {
+        OSSTaskCompletionSource * source = [OSSTaskCompletionSource taskCompletionSource];
+        [_flushTargets addObject:@(_writtenLength)];
+        [_flushSources addObject:source];
+        task = source.task;
+    }
+    [_condition unlock];
+
+    [self sendIfNeeded];
+    return task;
+}
+
+- (OSSTask *)close {
+    [_condition lock];
+    _isClosed = YES;
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+        _timer = nil;
+    }
+    [_condition broadcast];
+    [_condition unlock];
+    return [self flush];
+}
+
+# pragma mark - Private Methods
+
+- (void)startTimerIfNeeded {
+    [_condition lock];
+    if (!_timer && !_isClosed && self.flushInterval > 0) {
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+        uint64_t interval = (uint64_t)(self.flushInterval * NSEC_PER_SEC);
+        dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, interval / 10);
+        __weak OSSObjectAppender * weakSelf = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weakSelf timerDidFire];
+        });
+        dispatch_resume(_timer);
+    }
+    [_condition unlock];
+}
+
+- (void)timerDidFire {
+    [_condition lock];
+    _isTimerDue = _buffer.length > 0;
+    [_condition unlock];
+    [self sendIfNeeded];
+}
+
+- (void)sendIfNeeded {
+    NSData * data = nil;
+    int64_t position = 0;
+    NSString * crc64ecma = nil;
+
+    [_condition lock];
+    BOOL isDue = _buffer.length >= MAX(self.flushSize, 1) || _flushTargets.count || _isTimerDue || _isClosed;
+    // one append at a time, the next one starts at the position returned by this one
+    if (!_error && _sendingLength == 0 && _buffer.length && isDue) {
+        data = [_buffer copy];
+        [_buffer setLength:0];
+        _sendingLength = data.length;
+        _isTimerDue = NO;
+        position = _nextPosition;
+        crc64ecma = _isCrcKnown ? [NSString stringWithFormat:@"%llu", _crc64] : nil;
+    }
+    [_condition unlock];
+    if (!data) {
+        return;
+    }
+
+    OSSAppendObjectRequest * request = [OSSAppendObjectRequest new];
+    request.bucketName = _bucketName;
+    request.objectKey = _objectKey;
+    request.appendPosition = position;
+    request.uploadingData = data;
+    if (position == 0) {
+        request.contentType = self.contentType;
+        request.objectMeta = self.objectMeta;
+    }
+    if (!crc64ecma) {
+        // the crc of the object so far is unknown, the one after the append can't be checked
+        request.crcFlag = OSSRequestCRCClosed;
+    }
+    [[_client appendObject:request withCrc64ecma:crc64ecma] continueWithBlock:^id(OSSTask *task) {
+        [self didAppendData:data task:task];
+        return nil;
+    }];
+}
+
+- (void)didAppendData:(NSData *)data task:(OSSTask *)task {
+    uint64_t dataCrc64 = _isCrcKnown ? [OSSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length] : 0;
+    NSArray<OSSTaskCompletionSource *> * finishedSources = nil;
+
+    [_condition lock];
+    _sendingLength = 0;
+    if (task.error) {
+        OSSLogError(@"append %lu bytes at %lld to %@ failed: %@", (unsigned long)data.length, _nextPosition, _objectKey, task.error);
+        _error = task.error;
+        finishedSources = [_flushSources copy];
+        [_flushSources removeAllObjects];
+        [_flushTargets removeAllObjects];
+    } else {
+        OSSAppendObjectResult * result = task.result;
+        _lastResult = result;
+        _nextPosition = result.xOssNextAppendPosition > 0 ? result.xOssNextAppendPosition : _nextPosition + (int64_t)data.length;
+        if (_isCrcKnown) {
+            _crc64 = [OSSUtil crc64ForCombineCRC1:_crc64 CRC2:dataCrc64 length:data.length];
+        }
+        _appendedLength += data.length;
+
+        NSUInteger finishedCount = 0;
+        while (finishedCount < _flushTargets.count && [_flushTargets[finishedCount] longLongValue] <= _appendedLength) {
+            finishedCount++;
+        }
+        finishedSources = [_flushSources subarrayWithRange:NSMakeRange(0, finishedCount)];
+        [_flushSources removeObjectsInRange:NSMakeRange(0, finishedCount)];
+        [_flushTargets removeObjectsInRange:NSMakeRange(0, finishedCount)];
+    }
+    [_condition broadcast];
+    [_condition unlock];
+
+    for (OSSTaskCompletionSource * source in finishedSources) {
+        if (task.error) {
+            [source trySetError:task.error];
+        } else {
+            [source trySetResult:task.result];
+        }
+    }
+    [self sendIfNeeded];
+}
+
+- (NSError *)closedError {
+    return [NSError errorWithDomain:OSSClientErrorDomain
+                               code:OSSClientErrorCodeInvalidArgument
+                           userInfo:@{OSSErrorMessageTOKEN: @"The appender is closed!"}];
+}
+
+@end
@@ -0,0 +1,145 @@
+//
+//  OSSObjectCache.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@protocol OSSCredentialProvider;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The cached HEAD metadata of an object.
+ */
+@interface OSSObjectCacheEntry : NSObject
+
+@property (nonatomic, copy, readonly) NSDictionary * httpResponseHeaderFields;
+@property (nonatomic, copy, readonly) NSDictionary * objectMeta;
+@property (nonatomic, copy, readonly, nullable) NSString * eTag;
+@property (nonatomic, copy, readonly, nullable) NSString * lastModified;
+
+/**
+ When OSS last returned or confirmed the metadata.
+ */
+@property (nonatomic, strong, readonly) NSDate * validatedDate;
+
+/**
+ Whether the content of the object is cached too.
+ */
+@property (nonatomic, assign, readonly) BOOL hasData;
+
+@end
+
+/**
+ A client side cache of object metadata and content, set on OSSClientConfiguration.objectCache.
+
+ headObject: returns the cached metadata while it's younger than timeToLive. getObject: returns the
+ cached content while it's younger than timeToLive, and afterwards sends If-None-Match and
+ If-Modified-Since so that an unchanged object isn't downloaded again: on 304 the cached content is
+ returned with httpResponseCode 304. Only whole objects downloaded in memory are cached, without
+ range nor image processing.
+
+ The entries are keyed by the endpoint and the credentials of the client too, so that the clients of other
+ endpoints or accounts sharing a cache don't read each other's objects. The entries are kept in a least recently used order, in memory and, when the cache has a directory,
+ on disk so that they outlive the process. An object modified or deleted through the client is removed
+ from the cache; changes made by others are seen once the entry is older than timeToLive.
+ */
+@interface OSSObjectCache : NSObject
+
+/**
+ The seconds an entry is used without asking OSS, 0 by default to always revalidate it.
+ */
+@property (atomic, assign) NSTimeInterval timeToLive;
+
+/**
+ Max entries, 1000 by default. The least recently used ones are removed first.
+ */
+@property (atomic, assign) NSUInteger maxEntryCount;
+
+/**
+ Max bytes of content kept in memory, 8MB by default.
+ */
+@property (atomic, assign) NSUInteger maxMemoryCost;
+
+/**
+ Max bytes of content kept on disk, 64MB by default.
+ */
+@property (atomic, assign) unsigned long long maxDiskSize;
+
+/**
+ The content of larger objects isn't cached, only their metadata. 2MB by default.
+ */
+@property (atomic, assign) NSUInteger maxObjectSize;
+
+/**
+ Where the entries are persisted, nil for a cache in memory only.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString * directory;
+
+/**
+ A cache in memory only.
+ */
+- (instancetype)init;
+
+/**
+ A cache persisted in the directory, which is created if needed and must only be used by this cache.
+ */
+- (instancetype)initWithDirectory:(nullable NSString *)directory NS_DESIGNATED_INITIALIZER;
+
+/**
+ Where the objects read through the endpoint with the credentials are kept. The credentials are known by
+ their access key id, or by the auth server of an OSSAuthCredentialProvider. The entries of the other
+ providers are only shared by the clients of the same provider object, and not used again after a relaunch.
+ */
++ (NSString *)scopeWithEndpoint:(NSString *)endpoint credentialProvider:(nullable id<OSSCredentialProvider>)credentialProvider;
+
+/**
+ The key of the object in the cache.
+ @param scope the one of the client reading the object, see scopeWithEndpoint:credentialProvider:
+ */
++ (NSString *)keyWithScope:(NSString *)scope bucketName:(NSString *)bucketName objectKey:(NSString *)objectKey;
+
+/**
+ The key of the object processed by x-oss-process, e.g. for the variants an OSSImagePipeline keeps.
+ */
++ (NSString *)keyWithScope:(NSString *)scope
+                bucketName:(NSString *)bucketName
+                 objectKey:(NSString *)objectKey
+               xOssProcess:(nullable NSString *)xOssProcess;
+
+- (nullable OSSObjectCacheEntry *)entryForKey:(NSString *)key;
+
+/**
+ Whether the entry is younger than timeToLive.
+ */
+- (BOOL)isEntryFresh:(OSSObjectCacheEntry *)entry;
+
+/**
+ The cached content of the object, read from disk if it's not in memory.
+ */
+- (nullable NSData *)dataForKey:(NSString *)key;
+
+/**
+ Caches the metadata returned by OSS, validated now.
+ @param data the content of the object, nil to keep the content cached for the same ETag
+ */
+- (void)storeHttpResponseHeaderFields:(NSDictionary *)headerFields
+                           objectMeta:(nullable NSDictionary *)objectMeta
+                                 data:(nullable NSData *)data
+                               forKey:(NSString *)key;
+
+- (void)removeEntryForKey:(NSString *)key;
+
+- (void)removeAllEntries;
+
+/**
+ Drops the contents kept in memory, the ones on disk are read again when asked for. Called on memory warnings.
+ */
+- (void)removeAllContentsFromMemory;
+
+@end
+
+NS_ASSUME_NONNULL_END
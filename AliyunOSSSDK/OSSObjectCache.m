@@ -0,0 +1,422 @@
+//
+//  OSSObjectCache.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSObjectCache.h"
+#import "OSSCacheIndex.h"
+#import "OSSModel.h"
+#import "OSSUtil.h"
+#import "OSSLog.h"
+
+static NSString * const oss_object_cache_index_file_name = @"index.plist";
+static NSString * const oss_object_cache_headers_key = @"headers";
+static NSString * const oss_object_cache_meta_key = @"meta";
+static NSString * const oss_object_cache_validated_date_key = @"validatedDate";
+static NSString * const oss_object_cache_data_length_key = @"dataLength";
+
+@interface OSSObjectCacheEntry ()
+
+@property (nonatomic, copy, readwrite) NSDictionary * httpResponseHeaderFields;
+@property (nonatomic, copy, readwrite) NSDictionary * objectMeta;
+@property (nonatomic, copy, readwrite) NSString * eTag;
+@property (nonatomic, copy, readwrite) NSString * lastModified;
+@property (nonatomic, strong, readwrite) NSDate * validatedDate;
+@property (nonatomic, assign, readwrite) BOOL hasData;
+
+@property (nonatomic, assign) NSUInteger dataLength;
+@property (nonatomic, assign) BOOL isDataOnDisk;
+
+@end
+
+@implementation OSSObjectCacheEntry
+
+- (instancetype)entryWithData:(BOOL)hasData onDisk:(BOOL)isDataOnDisk {
+    OSSObjectCacheEntry * entry = [OSSObjectCacheEntry new];
+    entry.httpResponseHeaderFields = self.httpResponseHeaderFields;
+    entry.objectMeta = self.objectMeta;
+    entry.eTag = self.eTag;
+    entry.lastModified = self.lastModified;
+    entry.validatedDate = self.validatedDate;
+    entry.hasData = hasData;
+    entry.dataLength = hasData ? self.dataLength : 0;
+    entry.isDataOnDisk = hasData && isDataOnDisk;
+    return entry;
+}
+
+@end
+
+@implementation OSSObjectCache {
+    /* the entries are replaced, never changed, once they're in the cache */
+    NSMutableDictionary<NSString *, OSSObjectCacheEntry *> * _entries;
+    /* the order of use of the entries, and what's persisted of them */
+    OSSCacheIndex * _index;
+    NSMutableDictionary<NSString *, NSData *> * _memoryData;
+    NSUInteger _memoryCost;
+    unsigned long long _diskSize;
+
+    /* the content files and the index are written on it, in order */
+    dispatch_queue_t _ioQueue;
+}
+
+- (instancetype)init {
+    return [self initWithDirectory:nil];
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory {
+    if (self = [super init]) {
+        _timeToLive = 0;
+        _maxEntryCount = 1000;
+        _maxMemoryCost = 8 * 1024 * 1024;
+        _maxDiskSize = 64 * 1024 * 1024;
+        _maxObjectSize = 2 * 1024 * 1024;
+        _directory = [directory copy];
+
+        _entries = [NSMutableDictionary new];
+        _memoryData = [NSMutableDictionary new];
+        _ioQueue = dispatch_queue_create("com.aliyun.oss.object-cache", DISPATCH_QUEUE_SERIAL);
+
+        NSString * indexFilePath = nil;
+        if (_directory) {
+            [[NSFileManager defaultManager] createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+            indexFilePath = [_directory stringByAppendingPathComponent:oss_object_cache_index_file_name];
+        }
+        _index = [[OSSCacheIndex alloc] initWithFilePath:indexFilePath queue:_ioQueue];
+        if (_directory) {
+            [self loadEntries];
+        }
+    }
+    return self;
+}
+
++ (NSString *)scopeWithEndpoint:(NSString *)endpoint credentialProvider:(id<OSSCredentialProvider>)credentialProvider {
+    NSString * identity = [self identityOfCredentialProvider:credentialProvider];
+    NSString * scope = [NSString stringWithFormat:@"%@\n%@", endpoint ?: @"", identity];
+    // the access key id isn't written in the index
+    return [OSSUtil dataMD5String:[scope dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
++ (NSString *)keyWithScope:(NSString *)scope bucketName:(NSString *)bucketName objectKey:(NSString *)objectKey {
+    return [self keyWithScope:scope bucketName:bucketName objectKey:objectKey xOssProcess:nil];
+}
+
++ (NSString *)keyWithScope:(NSString *)scope
+                bucketName:(NSString *)bucketName
+                 objectKey:(NSString *)objectKey
+               xOssProcess:(NSString *)xOssProcess {
+    NSString * key = [NSString stringWithFormat:@"%@/%@/%@", scope, bucketName, objectKey];
+    if (xOssProcess) {
+        key = [key stringByAppendingFormat:@"?x-oss-process=%@", xOssProcess];
+    }
+    return key;
+}
+
+- (OSSObjectCacheEntry *)entryForKey:(NSString *)key {
+    @synchronized(self) {
+        OSSObjectCacheEntry * entry = _entries[key];
+        if (entry) {
+            [_index touchKey:key];
+        }
+        return entry;
+    }
+}
+
+- (BOOL)isEntryFresh:(OSSObjectCacheEntry *)entry {
+    NSTimeInterval timeToLive = self.timeToLive;
+    return timeToLive > 0 && -[entry.validatedDate timeIntervalSinceNow] < timeToLive;
+}
+
+- (NSData *)dataForKey:(NSString *)key {
+    OSSObjectCacheEntry * entry = nil;
+    @synchronized(self) {
+        entry = _entries[key];
+        if (!entry.hasData) {
+            return nil;
+        }
+        [_index touchKey:key];
+        NSData * data = _memoryData[key];
+        if (data) {
+            return data;
+        }
+    }
+    if (!entry.isDataOnDisk) {
+        return nil;
+    }
+
+    // queued after the write of the file, if it's still pending
+    __block NSData * data = nil;
+    NSString * dataFilePath = [self dataFilePathForKey:key];
+    dispatch_sync(_ioQueue, ^{
+        data = [NSData dataWithContentsOfFile:dataFilePath options:NSDataReadingMappedIfSafe error:nil];
+    });
+
+    @synchronized(self) {
+        if (_entries[key] != entry) {
+            // replaced while it was read, the data may not match the entry any more
+            return nil;
+        }
+        if (data.length != entry.dataLength) {
+            OSSLogError(@"object cache lost the content of %@", key);
+            _diskSize -= entry.dataLength;
+            [self setEntryLocked:[entry entryWithData:NO onDisk:NO] forKey:key];
+            return nil;
+        }
+        if (data.length <= self.maxMemoryCost) {
+            _memoryData[key] = data;
+            _memoryCost += data.length;
+            [self trimLocked];
+        }
+    }
+    return data;
+}
+
+- (void)storeHttpResponseHeaderFields:(NSDictionary *)headerFields
+                           objectMeta:(NSDictionary *)objectMeta
+                                 data:(NSData *)data
+                               forKey:(NSString *)key {
+    OSSObjectCacheEntry * entry = [OSSObjectCacheEntry new];
+    entry.httpResponseHeaderFields = headerFields ?: @{};
+    entry.objectMeta = objectMeta ?: @{};
+    entry.eTag = [self valueOfHeader:@"ETag" inHeaderFields:headerFields];
+    entry.lastModified = [self valueOfHeader:@"Last-Modified" inHeaderFields:headerFields];
+    entry.validatedDate = [NSDate date];
+
+    if (data.length > self.maxObjectSize || (!self.directory && data.length > self.maxMemoryCost)) {
+        data = nil;
+    }
+    NSData * storedData = [data copy];
+
+    @synchronized(self) {
+        OSSObjectCacheEntry * oldEntry = _entries[key];
+        BOOL keepsData = !storedData && oldEntry.hasData && entry.eTag && [oldEntry.eTag isEqualToString:entry.eTag];
+        if (keepsData) {
+            entry.hasData = YES;
+            entry.dataLength = oldEntry.dataLength;
+            entry.isDataOnDisk = oldEntry.isDataOnDisk;
+        } else if (oldEntry) {
+            [self removeDataOfKeyLocked:key entry:oldEntry];
+        }
+
+        if (storedData) {
+            entry.hasData = YES;
+            entry.dataLength = storedData.length;
+            if (storedData.length <= self.maxMemoryCost) {
+                _memoryData[key] = storedData;
+                _memoryCost += storedData.length;
+            }
+            if (self.directory) {
+                entry.isDataOnDisk = YES;
+                _diskSize += storedData.length;
+                NSString * dataFilePath = [self dataFilePathForKey:key];
+                dispatch_async(_ioQueue, ^{
+                    if (![storedData writeToFile:dataFilePath atomically:YES]) {
+                        OSSLogError(@"object cache can't write %@", dataFilePath);
+                    }
+                });
+            }
+        }
+
+        [self setEntryLocked:entry forKey:key];
+        [_index touchKey:key];
+        [self trimLocked];
+    }
+}
+
+- (void)removeEntryForKey:(NSString *)key {
+    @synchronized(self) {
+        if (_entries[key]) {
+            [self removeKeyLocked:key];
+        }
+    }
+}
+
+- (void)removeAllEntries {
+    @synchronized(self) {
+        for (NSString * key in [_index keys]) {
+            [self removeKeyLocked:key];
+        }
+    }
+}
+
+- (void)removeAllContentsFromMemory {
+    @synchronized(self) {
+        for (NSString * key in _memoryData) {
+            OSSObjectCacheEntry * entry = _entries[key];
+            if (entry.hasData && !entry.isDataOnDisk) {
+                _entries[key] = [entry entryWithData:NO onDisk:NO];
+            }
+        }
+        [_memoryData removeAllObjects];
+        _memoryCost = 0;
+    }
+}
+
+# pragma mark - Private Methods
+
++ (NSString *)identityOfCredentialProvider:(id<OSSCredentialProvider>)credentialProvider {
+    if ([credentialProvider isKindOfClass:[OSSPlainTextAKSKPairCredentialProvider class]]) {
+        return [@"ak:" stringByAppendingString:((OSSPlainTextAKSKPairCredentialProvider *)credentialProvider).accessKey ?: @""];
+    }
+    if ([credentialProvider isKindOfClass:[OSSStsTokenCredentialProvider class]]) {
+        return [@"ak:" stringByAppendingString:((OSSStsTokenCredentialProvider *)credentialProvider).accessKeyId ?: @""];
+    }
+    if ([credentialProvider isKindOfClass:[OSSAuthCredentialProvider class]]) {
+        return [@"auth:" stringByAppendingString:((OSSAuthCredentialProvider *)credentialProvider).authServerUrl ?: @""];
+    }
+    if (!credentialProvider) {
+        return @"anonymous";
+    }
+
+    // a token getter or a signer may give any account, only the provider itself is known
+    static NSMapTable<id, NSString *> * oss_credentialProviderIdentities = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        oss_credentialProviderIdentities = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality)
+                                                                 valueOptions:NSPointerFunctionsStrongMemory];
+    });
+    @synchronized(oss_credentialProviderIdentities) {
+        NSString * identity = [oss_credentialProviderIdentities objectForKey:credentialProvider];
+        if (!identity) {
+            identity = [@"provider:" stringByAppendingString:[NSUUID UUID].UUIDString];
+            [oss_credentialProviderIdentities setObject:identity forKey:credentialProvider];
+        }
+        return identity;
+    }
+}
+
+- (NSString *)dataFilePathForKey:(NSString *)key {
+    NSString * fileName = [OSSUtil dataMD5String:[key dataUsingEncoding:NSUTF8StringEncoding]];
+    return [self.directory stringByAppendingPathComponent:fileName];
+}
+
+- (NSString *)valueOfHeader:(NSString *)name inHeaderFields:(NSDictionary *)headerFields {
+    __block NSString * value = nil;
+    [headerFields enumerateKeysAndObjectsUsingBlock:^(NSString * key, id obj, BOOL * stop) {
+        if ([key isKindOfClass:[NSString class]] && [key caseInsensitiveCompare:name] == NSOrderedSame
+            && [obj isKindOfClass:[NSString class]]) {
+            value = obj;
+            *stop = YES;
+        }
+    }];
+    return value;
+}
+
+- (void)setEntryLocked:(OSSObjectCacheEntry *)entry forKey:(NSString *)key {
+    _entries[key] = entry;
+    [_index setItem:@{oss_object_cache_headers_key: entry.httpResponseHeaderFields,
+                      oss_object_cache_meta_key: entry.objectMeta,
+                      oss_object_cache_validated_date_key: entry.validatedDate,
+                      oss_object_cache_data_length_key: @(entry.isDataOnDisk ? entry.dataLength : 0)}
+             forKey:key];
+}
+
+- (void)removeKeyLocked:(NSString *)key {
+    [self removeDataOfKeyLocked:key entry:_entries[key]];
+    [_entries removeObjectForKey:key];
+    [_index removeItemForKey:key];
+}
+
+- (void)removeDataOfKeyLocked:(NSString *)key entry:(OSSObjectCacheEntry *)entry {
+    NSData * memoryData = _memoryData[key];
+    if (memoryData) {
+        _memoryCost -= memoryData.length;
+        [_memoryData removeObjectForKey:key];
+    }
+    if (entry.isDataOnDisk) {
+        _diskSize -= entry.dataLength;
+        [self removeDataFileOfKey:key];
+    }
+}
+
+- (void)removeDataFileOfKey:(NSString *)key {
+    NSString * dataFilePath = [self dataFilePathForKey:key];
+    dispatch_async(_ioQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtPath:dataFilePath error:nil];
+    });
+}
+
+/* drops the least recently used entries, then contents, until the cache fits its limits */
+- (void)trimLocked {
+    while (_entries.count > self.maxEntryCount && _index.count > 0) {
+        [self removeKeyLocked:_index.leastRecentlyUsedKey];
+    }
+
+    NSUInteger maxMemoryCost = self.maxMemoryCost;
+    unsigned long long maxDiskSize = self.maxDiskSize;
+    for (NSString * key in [_index keys]) {
+        if (_memoryCost <= maxMemoryCost && _diskSize <= maxDiskSize) {
+            break;
+        }
+        OSSObjectCacheEntry * entry = _entries[key];
+        NSData * memoryData = _memoryData[key];
+        BOOL isInMemory = memoryData != nil;
+        BOOL isOnDisk = entry.isDataOnDisk;
+
+        if (isInMemory && _memoryCost > maxMemoryCost) {
+            _memoryCost -= memoryData.length;
+            [_memoryData removeObjectForKey:key];
+            isInMemory = NO;
+        }
+        if (isOnDisk && _diskSize > maxDiskSize) {
+            _diskSize -= entry.dataLength;
+            [self removeDataFileOfKey:key];
+            isOnDisk = NO;
+        }
+        if (isOnDisk != entry.isDataOnDisk || (!isInMemory && !isOnDisk && entry.hasData)) {
+            [self setEntryLocked:[entry entryWithData:(isInMemory || isOnDisk) onDisk:isOnDisk] forKey:key];
+        }
+    }
+}
+
+- (void)loadEntries {
+    NSFileManager * fileManager = [NSFileManager defaultManager];
+    NSMutableSet<NSString *> * dataFileNames = [NSMutableSet set];
+
+    for (NSString * key in [_index keys]) {
+        NSDictionary * item = [_index itemForKey:key];
+        NSDictionary * headerFields = item[oss_object_cache_headers_key];
+        NSDictionary * objectMeta = item[oss_object_cache_meta_key];
+        NSDate * validatedDate = item[oss_object_cache_validated_date_key];
+        if (![headerFields isKindOfClass:[NSDictionary class]] || ![objectMeta isKindOfClass:[NSDictionary class]]
+            || ![validatedDate isKindOfClass:[NSDate class]]) {
+            [_index removeItemForKey:key];
+            continue;
+        }
+
+        OSSObjectCacheEntry * entry = [OSSObjectCacheEntry new];
+        entry.httpResponseHeaderFields = headerFields;
+        entry.objectMeta = objectMeta;
+        entry.eTag = [self valueOfHeader:@"ETag" inHeaderFields:headerFields];
+        entry.lastModified = [self valueOfHeader:@"Last-Modified" inHeaderFields:headerFields];
+        entry.validatedDate = validatedDate;
+
+        NSUInteger dataLength = [item[oss_object_cache_data_length_key] unsignedIntegerValue];
+        NSString * dataFilePath = [self dataFilePathForKey:key];
+        if (dataLength > 0
+            && [[fileManager attributesOfItemAtPath:dataFilePath error:nil] fileSize] == dataLength) {
+            entry.hasData = YES;
+            entry.dataLength = dataLength;
+            entry.isDataOnDisk = YES;
+            _diskSize += dataLength;
+            [dataFileNames addObject:dataFilePath.lastPathComponent];
+        }
+        if (dataLength > 0 && !entry.hasData) {
+            [self setEntryLocked:entry forKey:key];
+        } else {
+            _entries[key] = entry;
+        }
+    }
+
+    // the contents written after the last index was, they're not known
+    for (NSString * fileName in [fileManager contentsOfDirectoryAtPath:self.directory error:nil]) {
+        if (![fileName isEqualToString:oss_object_cache_index_file_name] && ![dataFileNames containsObject:fileName]) {
+            [fileManager removeItemAtPath:[self.directory stringByAppendingPathComponent:fileName] error:nil];
+        }
+    }
+    [self trimLocked];
+    OSSLogDebug(@"object cache loaded %lu entries from %@", (unsigned long)_entries.count, self.directory);
+}
+
+@end
@@ -0,0 +1,107 @@
+//
+//  OSSObjectReader.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class OSSClient;
+@class OSSTask;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Random access to the content of an object, like a file handle, e.g. to play a video or to read
+ the entries of an archive stored on OSS.
+
+ The object is read in blocks of blockSize bytes, each one a ranged getObject:. The blocks are kept
+ in a least recently used cache bounded by maxMemoryCost and, when the reader has a directory, by
+ maxDiskSize on disk. Once a read follows the previous one, the next readAheadBlockCount blocks are
+ fetched concurrently before they're asked for. A read elsewhere is a seek: the fetches of blocks it
+ doesn't need any more are cancelled.
+
+ The object length and ETag are learnt by a headObject: on the first read. A block of another ETag
+ fails the read with OSSClientErrorCodeObjectModified and drops the cached blocks.
+ */
+@interface OSSObjectReader : NSObject
+
+@property (nonatomic, copy, readonly) NSString * bucketName;
+@property (nonatomic, copy, readonly) NSString * objectKey;
+
+/**
+ The bytes of a block, 512KB by default. Set it before the first read.
+ */
+@property (nonatomic, assign) NSUInteger blockSize;
+
+/**
+ The blocks fetched ahead of a sequential read, 4 by default, 0 disables the read-ahead.
+ */
+@property (atomic, assign) NSUInteger readAheadBlockCount;
+
+/**
+ Max bytes of blocks kept in memory, 8MB by default.
+ */
+@property (atomic, assign) NSUInteger maxMemoryCost;
+
+/**
+ Max bytes of blocks kept on disk, 64MB by default.
+ */
+@property (atomic, assign) unsigned long long maxDiskSize;
+
+/**
+ Where the blocks are kept once they're out of memory, nil for a cache in memory only.
+ */
+@property (nonatomic, copy, readonly, nullable) NSString * directory;
+
+/**
+ The object length and ETag, known once open completed.
+ */
+@property (atomic, assign, readonly) int64_t contentLength;
+@property (atomic, copy, readonly, nullable) NSString * eTag;
+
+/**
+ The position of the next readDataOfLength:error:.
+ */
+@property (atomic, assign) int64_t offset;
+
+- (instancetype)initWithClient:(OSSClient *)client
+                    bucketName:(NSString *)bucketName
+                     objectKey:(NSString *)objectKey;
+
+/**
+ A reader keeping the blocks in the directory, which is created if needed and must only be used by
+ this reader. The blocks of the same ETag left there by an earlier reader are read again.
+ */
+- (instancetype)initWithClient:(OSSClient *)client
+                    bucketName:(NSString *)bucketName
+                     objectKey:(NSString *)objectKey
+                     directory:(nullable NSString *)directory NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Learns the object length and ETag. It's called by the first read, and again by the next one after it failed.
+ */
+- (OSSTask *)open;
+
+/**
+ The content in [offset, offset + length) as NSData, shorter at the end of the object.
+ */
+- (OSSTask *)readDataAtOffset:(int64_t)offset length:(NSUInteger)length;
+
+/**
+ Reads from offset and moves it past the bytes read, blocking until they're there. Don't call it on
+ the main thread. Returns empty data at the end of the object and nil on error.
+ */
+- (nullable NSData *)readDataOfLength:(NSUInteger)length error:(NSError **)error;
+
+/**
+ Cancels the running fetches, later reads fail.
+ */
+- (void)close;
+
+@end
+
+NS_ASSUME_NONNULL_END
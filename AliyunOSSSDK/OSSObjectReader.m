@@ -0,0 +1,469 @@
+//
+//  OSSObjectReader.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSObjectReader.h"
+#import "OSSClient.h"
+#import "OSSDefine.h"
+#import "OSSModel.h"
+#import "OSSUtil.h"
+#import "OSSBolts.h"
+#import "OSSLog.h"
+#import "OSSMemoryGovernor.h"
+
+static NSUInteger oss_lengthOfBlock(int64_t contentLength, NSUInteger blockSize, NSUInteger index) {
+    int64_t start = (int64_t)index * blockSize;
+    return start < contentLength ? (NSUInteger)MIN((int64_t)blockSize, contentLength - start) : 0;
+}
+
+/**
+ A block being read from OSS, or from disk when request is nil.
+ */
+@interface OSSObjectReaderFetch : NSObject
+
+@property (nonatomic, assign) NSUInteger index;
+@property (nonatomic, strong) OSSGetObjectRequest * request;
+@property (nonatomic, strong) OSSTaskCompletionSource * source;
+/* only the fetches no read is waiting for are cancelled by a seek */
+@property (nonatomic, assign) BOOL isPrefetch;
+
+@end
+
+@implementation OSSObjectReaderFetch
+@end
+
+@interface OSSObjectReader ()
+
+@property (atomic, assign, readwrite) int64_t contentLength;
+@property (atomic, copy, readwrite) NSString * eTag;
+
+@end
+
+@implementation OSSObjectReader {
+    OSSClient * _client;
+    OSSTask * _openTask;
+    BOOL _isClosed;
+
+    NSMutableDictionary<NSNumber *, OSSObjectReaderFetch *> * _fetches;
+    /* the blocks from the least to the most recently used */
+    NSMutableDictionary<NSNumber *, NSData *> * _memoryBlocks;
+    NSMutableOrderedSet<NSNumber *> * _memoryRecentBlocks;
+    NSUInteger _memoryCost;
+    NSMutableOrderedSet<NSNumber *> * _diskRecentBlocks;
+    unsigned long long _diskSize;
+    /* the block files of the opened ETag and block size are named after it */
+    NSString * _blockFilePrefix;
+
+    /* the range of the last read, the next one is sequential if it starts in it or right after it */
+    int64_t _lastReadOffset;
+    int64_t _lastReadEnd;
+
+    /* the disk is only touched on it, in order */
+    dispatch_queue_t _ioQueue;
+}
+
+- (instancetype)initWithClient:(OSSClient *)client
+                    bucketName:(NSString *)bucketName
+                     objectKey:(NSString *)objectKey {
+    return [self initWithClient:client bucketName:bucketName objectKey:objectKey directory:nil];
+}
+
+- (instancetype)initWithClient:(OSSClient *)client
+                    bucketName:(NSString *)bucketName
+                     objectKey:(NSString *)objectKey
+                     directory:(NSString *)directory {
+    if (self = [super init]) {
+        _client = client;
+        _bucketName = [bucketName copy];
+        _objectKey = [objectKey copy];
+        _directory = [directory copy];
+        _blockSize = 512 * 1024;
+        _readAheadBlockCount = 4;
+        _maxMemoryCost = 8 * 1024 * 1024;
+        _maxDiskSize = 64 * 1024 * 1024;
+
+        _fetches = [NSMutableDictionary new];
+        _memoryBlocks = [NSMutableDictionary new];
+        _memoryRecentBlocks = [NSMutableOrderedSet new];
+        _diskRecentBlocks = [NSMutableOrderedSet new];
+        _ioQueue = dispatch_queue_create("com.aliyun.oss.object-reader", DISPATCH_QUEUE_SERIAL);
+        // the blocks in memory are fetched again, or read from disk, when they're needed
+        __weak OSSObjectReader * weakSelf = self;
+        [[OSSMemoryGovernor sharedGovernor] addPressureObserver:self handler:^{
+            [weakSelf removeMemoryBlocks];
+        }];
+
+        if (_directory) {
+            [[NSFileManager defaultManager] createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+        }
+    }
+    return self;
+}
+
+- (OSSTask *)open {
+    @synchronized(self) {
+        if (_isClosed) {
+            return [OSSTask taskWithError:[self closedError]];
+        }
+        if (!_openTask) {
+            OSSHeadObjectRequest * request = [OSSHeadObjectRequest new];
+            request.bucketName = _bucketName;
+            request.objectKey = _objectKey;
+            _openTask = [[_client headObject:request] continueWithBlock:^id(OSSTask *task) {
+                if (task.error) {
+                    // the next read tries again
+                    @synchronized(self) {
+                        self->_openTask = nil;
+                    }
+                    return task;
+                }
+                [self didOpenWithObjectMeta:((OSSHeadObjectResult *)task.result).objectMeta];
+                return nil;
+            }];
+        }
+        return _openTask;
+    }
+}
+
+- (OSSTask *)readDataAtOffset:(int64_t)offset length:(NSUInteger)length {
+    if (offset < 0) {
+        return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                          code:OSSClientErrorCodeInvalidArgument
+                                                      userInfo:@{OSSErrorMessageTOKEN: @"The read offset can't be negative!"}]];
+    }
+
+    return [[self open] continueWithSuccessBlock:^id(OSSTask *task) {
+        int64_t end = MIN(offset + (int64_t)length, self.contentLength);
+        if (offset >= end) {
+            return [OSSTask taskWithResult:[NSData data]];
+        }
+        NSUInteger blockSize = self.blockSize;
+        NSUInteger firstBlock = (NSUInteger)(offset / blockSize);
+        NSUInteger lastBlock = (NSUInteger)((end - 1) / blockSize);
+
+        NSMutableArray<OSSTask *> * blockTasks = [NSMutableArray arrayWithCapacity:lastBlock - firstBlock + 1];
+        NSMutableArray<OSSObjectReaderFetch *> * newFetches = [NSMutableArray array];
+        @synchronized(self) {
+            if (self->_isClosed) {
+                return [OSSTask taskWithError:[self closedError]];
+            }
+            BOOL isSequential = offset >= self->_lastReadOffset && offset <= self->_lastReadEnd;
+            if (!isSequential) {
+                [self cancelPrefetchesOutsideBlocksLocked:NSMakeRange(firstBlock, lastBlock - firstBlock + 1)];
+            }
+            self->_lastReadOffset = offset;
+            self->_lastReadEnd = end;
+
+            for (NSUInteger i = firstBlock; i <= lastBlock; i++) {
+                [blockTasks addObject:[self taskOfBlockLocked:i prefetch:NO newFetches:newFetches]];
+            }
+            if (isSequential) {
+                NSUInteger blockCount = (NSUInteger)((self.contentLength + blockSize - 1) / blockSize);
+                NSUInteger aheadEnd = MIN(lastBlock + 1 + self.readAheadBlockCount, blockCount);
+                for (NSUInteger i = lastBlock + 1; i < aheadEnd; i++) {
+                    [self taskOfBlockLocked:i prefetch:YES newFetches:newFetches];
+                }
+            }
+        }
+        // started out of the lock, their completion may run right away
+        for (OSSObjectReaderFetch * fetch in newFetches) {
+            [self startFetch:fetch];
+        }
+
+        return [[OSSTask taskForCompletionOfAllTasks:blockTasks] continueWithBlock:^id(OSSTask *allTask) {
+            for (OSSTask * blockTask in blockTasks) {
+                if (blockTask.error) {
+                    return [OSSTask taskWithError:blockTask.error];
+                }
+            }
+            if (blockTasks.count == 1) {
+                NSData * block = blockTasks[0].result;
+                int64_t blockStart = (int64_t)firstBlock * blockSize;
+                return [OSSTask taskWithResult:[block subdataWithRange:NSMakeRange((NSUInteger)(offset - blockStart), (NSUInteger)(end - offset))]];
+            }
+
+            NSMutableData * data = [NSMutableData dataWithCapacity:(NSUInteger)(end - offset)];
+            for (NSUInteger i = firstBlock; i <= lastBlock; i++) {
+                NSData * block = blockTasks[i - firstBlock].result;
+                int64_t blockStart = (int64_t)i * blockSize;
+                NSUInteger from = (NSUInteger)(MAX(offset, blockStart) - blockStart);
+                NSUInteger to = (NSUInteger)(MIN(end, blockStart + (int64_t)block.length) - blockStart);
+                [data appendBytes:(const uint8_t *)block.bytes + from length:to - from];
+            }
+            return [OSSTask taskWithResult:data];
+        }];
+    }];
+}
+
+- (NSData *)readDataOfLength:(NSUInteger)length error:(NSError **)error {
+    int64_t offset = self.offset;
+    OSSTask * task = [self readDataAtOffset:offset length:length];
+    [task waitUntilFinished];
+    if (task.error) {
+        if (error) {
+            *error = task.error;
+        }
+        return nil;
+    }
+    NSData * data = task.result;
+    self.offset = offset + (int64_t)data.length;
+    return data;
+}
+
+- (void)close {
+    NSArray<OSSObjectReaderFetch *> * fetches = nil;
+    @synchronized(self) {
+        _isClosed = YES;
+        fetches = [_fetches allValues];
+        [_fetches removeAllObjects];
+    }
+    for (OSSObjectReaderFetch * fetch in fetches) {
+        [fetch.request cancel];
+        [fetch.source trySetError:[self closedError]];
+    }
+}
+
+# pragma mark - Private Methods
+
+- (void)didOpenWithObjectMeta:(NSDictionary *)objectMeta {
+    int64_t contentLength = [objectMeta[@"Content-Length"] longLongValue];
+    NSString * eTag = objectMeta[@"Etag"];
+    NSUInteger blockSize = self.blockSize;
+    NSString * objectVersion = [NSString stringWithFormat:@"%@/%@/%@/%lu", _bucketName, _objectKey, eTag ?: @"", (unsigned long)blockSize];
+    NSString * blockFilePrefix = [[OSSUtil dataMD5String:[objectVersion dataUsingEncoding:NSUTF8StringEncoding]] stringByAppendingString:@"-"];
+
+    // the blocks of this version left on disk are used again, the other files are stale
+    NSMutableOrderedSet<NSNumber *> * diskBlocks = [NSMutableOrderedSet orderedSet];
+    if (self.directory) {
+        NSString * directory = self.directory;
+        dispatch_sync(_ioQueue, ^{
+            NSFileManager * fileManager = [NSFileManager defaultManager];
+            for (NSString * fileName in [fileManager contentsOfDirectoryAtPath:directory error:nil]) {
+                NSString * filePath = [directory stringByAppendingPathComponent:fileName];
+                if ([fileName hasPrefix:blockFilePrefix]) {
+                    NSInteger index = [[fileName substringFromIndex:blockFilePrefix.length] integerValue];
+                    NSUInteger blockLength = index >= 0 ? oss_lengthOfBlock(contentLength, blockSize, index) : 0;
+                    if (blockLength > 0 && [[fileManager attributesOfItemAtPath:filePath error:nil] fileSize] == blockLength) {
+                        [diskBlocks addObject:@(index)];
+                        continue;
+                    }
+                }
+                [fileManager removeItemAtPath:filePath error:nil];
+            }
+        });
+    }
+
+    @synchronized(self) {
+        if (self.eTag && ![self.eTag isEqualToString:eTag ?: @""]) {
+            [self removeAllBlocksLocked];
+        }
+        self.contentLength = contentLength;
+        self.eTag = eTag;
+        _blockFilePrefix = blockFilePrefix;
+        [_diskRecentBlocks unionOrderedSet:diskBlocks];
+        _diskSize = 0;
+        for (NSNumber * key in _diskRecentBlocks) {
+            _diskSize += oss_lengthOfBlock(contentLength, blockSize, key.unsignedIntegerValue);
+        }
+        [self trimLocked];
+    }
+    OSSLogDebug(@"object reader opened %@, %lld bytes, %lu blocks on disk", _objectKey, contentLength, (unsigned long)diskBlocks.count);
+}
+
+/* the task of a block's NSData, new fetches are added to newFetches to be started */
+- (OSSTask *)taskOfBlockLocked:(NSUInteger)index prefetch:(BOOL)prefetch newFetches:(NSMutableArray<OSSObjectReaderFetch *> *)newFetches {
+    NSNumber * key = @(index);
+    NSData * block = _memoryBlocks[key];
+    if (block) {
+        [_memoryRecentBlocks removeObject:key];
+        [_memoryRecentBlocks addObject:key];
+        return [OSSTask taskWithResult:block];
+    }
+
+    OSSObjectReaderFetch * fetch = _fetches[key];
+    if (fetch) {
+        fetch.isPrefetch = fetch.isPrefetch && prefetch;
+        return fetch.source.task;
+    }
+
+    fetch = [OSSObjectReaderFetch new];
+    fetch.index = index;
+    fetch.isPrefetch = prefetch;
+    fetch.source = [OSSTaskCompletionSource taskCompletionSource];
+    if (![_diskRecentBlocks containsObject:key]) {
+        fetch.request = [self requestOfBlock:index];
+    }
+    _fetches[key] = fetch;
+    [newFetches addObject:fetch];
+    return fetch.source.task;
+}
+
+- (OSSGetObjectRequest *)requestOfBlock:(NSUInteger)index {
+    int64_t start = (int64_t)index * self.blockSize;
+    NSUInteger length = oss_lengthOfBlock(self.contentLength, self.blockSize, index);
+    OSSGetObjectRequest * request = [OSSGetObjectRequest new];
+    request.bucketName = _bucketName;
+    request.objectKey = _objectKey;
+    request.range = [[OSSRange alloc] initWithStart:start withEnd:start + (int64_t)length - 1];
+    // the crc64 in the response is the one of the whole object, it can't be checked against a block
+    request.crcFlag = OSSRequestCRCClosed;
+    return request;
+}
+
+- (void)startFetch:(OSSObjectReaderFetch *)fetch {
+    NSUInteger index = fetch.index;
+    if (!fetch.request) {
+        NSString * blockFilePath = [self filePathOfBlock:index];
+        NSUInteger blockLength = oss_lengthOfBlock(self.contentLength, self.blockSize, index);
+        dispatch_async(_ioQueue, ^{
+            NSData * block = [NSData dataWithContentsOfFile:blockFilePath options:NSDataReadingMappedIfSafe error:nil];
+            if (block.length == blockLength) {
+                [self didFetchBlock:index fetch:fetch data:block error:nil fromDisk:YES];
+                return;
+            }
+            OSSLogError(@"object reader lost the block file %@", blockFilePath);
+            @synchronized(self) {
+                [self removeDiskBlockLocked:@(index)];
+                if (self->_fetches[@(index)] != fetch) {
+                    return;
+                }
+                fetch.request = [self requestOfBlock:index];
+            }
+            [self startFetch:fetch];
+        });
+        return;
+    }
+
+    [[_client getObject:fetch.request] continueWithBlock:^id(OSSTask *task) {
+        NSError * error = task.error;
+        OSSGetObjectResult * result = task.result;
+        NSString * eTag = self.eTag;
+        NSString * blockETag = result.objectMeta[@"Etag"];
+        if (!error && [eTag oss_isNotEmpty] && [blockETag oss_isNotEmpty] && ![eTag isEqualToString:blockETag]) {
+            error = [NSError errorWithDomain:OSSClientErrorDomain
+                                        code:OSSClientErrorCodeObjectModified
+                                    userInfo:@{OSSErrorMessageTOKEN: @"The object has been modified during the read"}];
+            // the next read opens the new version
+            @synchronized(self) {
+                [self removeAllBlocksLocked];
+                self->_openTask = nil;
+            }
+        } else if (!error && result.downloadedData.length != oss_lengthOfBlock(self.contentLength, self.blockSize, index)) {
+            error = [NSError errorWithDomain:OSSClientErrorDomain
+                                        code:OSSClientErrorCodeNetworkError
+                                    userInfo:@{OSSErrorMessageTOKEN: @"The range response is shorter than requested"}];
+        }
+        [self didFetchBlock:index fetch:fetch data:(error ? nil : result.downloadedData) error:error fromDisk:NO];
+        return nil;
+    }];
+}
+
+- (void)didFetchBlock:(NSUInteger)index fetch:(OSSObjectReaderFetch *)fetch data:(NSData *)block error:(NSError *)error fromDisk:(BOOL)fromDisk {
+    NSNumber * key = @(index);
+    @synchronized(self) {
+        // a cancelled fetch isn't in _fetches any more, a later one may be
+        BOOL isCurrent = _fetches[key] == fetch;
+        if (isCurrent) {
+            [_fetches removeObjectForKey:key];
+        }
+        if (block && isCurrent && !_isClosed) {
+            _memoryBlocks[key] = block;
+            _memoryCost += block.length;
+            [_memoryRecentBlocks addObject:key];
+            if (fromDisk) {
+                [_diskRecentBlocks removeObject:key];
+                [_diskRecentBlocks addObject:key];
+            } else if (self.directory && _blockFilePrefix) {
+                [_diskRecentBlocks addObject:key];
+                _diskSize += block.length;
+                NSString * blockFilePath = [self filePathOfBlock:index];
+                dispatch_async(_ioQueue, ^{
+                    if (![block writeToFile:blockFilePath atomically:YES]) {
+                        OSSLogError(@"object reader can't write %@", blockFilePath);
+                    }
+                });
+            }
+            [self trimLocked];
+        }
+    }
+
+    if (error) {
+        if (error.code != OSSClientErrorCodeTaskCancelled) {
+            OSSLogError(@"object reader failed to fetch block %lu of %@: %@", (unsigned long)index, _objectKey, error);
+        }
+        [fetch.source trySetError:error];
+    } else {
+        [fetch.source trySetResult:block];
+    }
+}
+
+- (void)cancelPrefetchesOutsideBlocksLocked:(NSRange)blocks {
+    for (NSNumber * key in [_fetches allKeys]) {
+        OSSObjectReaderFetch * fetch = _fetches[key];
+        // the ones read from disk are quick, they're left to finish
+        if (fetch.isPrefetch && fetch.request && !NSLocationInRange(key.unsignedIntegerValue, blocks)) {
+            [_fetches removeObjectForKey:key];
+            [fetch.request cancel];
+        }
+    }
+}
+
+- (NSString *)filePathOfBlock:(NSUInteger)index {
+    NSString * fileName = [NSString stringWithFormat:@"%@%lu", _blockFilePrefix, (unsigned long)index];
+    return [self.directory stringByAppendingPathComponent:fileName];
+}
+
+- (void)removeDiskBlockLocked:(NSNumber *)key {
+    if (![_diskRecentBlocks containsObject:key]) {
+        return;
+    }
+    [_diskRecentBlocks removeObject:key];
+    _diskSize -= oss_lengthOfBlock(self.contentLength, self.blockSize, key.unsignedIntegerValue);
+    NSString * blockFilePath = [self filePathOfBlock:key.unsignedIntegerValue];
+    dispatch_async(_ioQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtPath:blockFilePath error:nil];
+    });
+}
+
+- (void)removeMemoryBlocks {
+    @synchronized(self) {
+        [_memoryBlocks removeAllObjects];
+        [_memoryRecentBlocks removeAllObjects];
+        _memoryCost = 0;
+    }
+}
+
+- (void)removeAllBlocksLocked {
+    [_memoryBlocks removeAllObjects];
+    [_memoryRecentBlocks removeAllObjects];
+    _memoryCost = 0;
+    for (NSNumber * key in [_diskRecentBlocks copy]) {
+        [self removeDiskBlockLocked:key];
+    }
+}
+
+/* drops the least recently used blocks until the cache fits its limits */
+- (void)trimLocked {
+    NSUInteger maxMemoryCost = self.maxMemoryCost;
+    while (_memoryCost > maxMemoryCost && _memoryRecentBlocks.count > 0) {
+        NSNumber * key = _memoryRecentBlocks.firstObject;
+        _memoryCost -= _memoryBlocks[key].length;
+        [_memoryBlocks removeObjectForKey:key];
+        [_memoryRecentBlocks removeObjectAtIndex:0];
+    }
+    unsigned long long maxDiskSize = self.maxDiskSize;
+    while (_diskSize > maxDiskSize && _diskRecentBlocks.count > 0) {
+        [self removeDiskBlockLocked:_diskRecentBlocks.firstObject];
+    }
+}
+
+- (NSError *)closedError {
+    return [NSError errorWithDomain:OSSClientErrorDomain
+                               code:OSSClientErrorCodeTaskCancelled
+                           userInfo:@{OSSErrorMessageTOKEN: @"The reader is closed!"}];
+}
+
+@end
@@ -0,0 +1,57 @@
+//
+//  OSSPartInfoJournal.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class OSSPartInfo;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An append-only binary journal of the parts finished by a multipart upload.
+
+ Each finished part appends one checksummed record (partNum, ETag, CRC64, size),
+ so persisting a part costs the same whatever the number of parts already uploaded.
+ A torn record left by a crash is dropped when the journal is read. Once parts
+ reported more than once make up most of the file, it is compacted to one record per part.
+ */
+@interface OSSPartInfoJournal : NSObject
+
+@property (nonatomic, copy, readonly) NSString *filePath;
+
+- (instancetype)initWithFilePath:(NSString *)filePath;
+
+/**
+ The latest record of every part, keyed by the part number string. The values have
+ the same layout as -[OSSPartInfo entityToDictionary].
+ */
+- (NSMutableDictionary<NSString *, NSDictionary *> *)partInfos;
+
+/**
+ Appends the record of a finished part. It's thread safe.
+ */
+- (BOOL)appendPartInfo:(OSSPartInfo *)partInfo error:(NSError **)error;
+
+/**
+ Replaces the journal by a journal holding the given part infos, e.g. to import the
+ plist written by former versions.
+ */
+- (BOOL)resetWithPartInfos:(NSDictionary<NSString *, NSDictionary *> *)partInfos error:(NSError **)error;
+
+/**
+ Rewrites the journal with one record per part.
+ */
+- (BOOL)compact:(NSError **)error;
+
+/**
+ Closes the file descriptor used for appending.
+ */
+- (void)close;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,218 @@
+//
+//  OSSPartInfoJournal.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSPartInfoJournal.h"
+#import "OSSDefine.h"
+#import "OSSModel.h"
+#import "OSSUtil.h"
+#import "OSSLog.h"
+#import <libkern/OSByteOrder.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const char oss_journal_magic[8] = {'O', 'S', 'S', 'P', 'J', 'N', 'L', '1'};
+// compaction is not worth it for small journals
+static const NSUInteger oss_journal_compaction_threshold = 128;
+
+/*
+ record layout, little endian:
+ uint32 payload length | int32 partNum | uint64 crc64 | int64 size | ETag (utf8) | uint64 crc64 of the payload
+ */
+static const size_t oss_journal_record_fixed_length = sizeof(int32_t) + sizeof(uint64_t) + sizeof(int64_t);
+
+@implementation OSSPartInfoJournal {
+    NSMutableDictionary<NSString *, NSDictionary *> *_partInfos;
+    NSUInteger _recordCount;
+    int _fd;
+}
+
+- (instancetype)initWithFilePath:(NSString *)filePath {
+    if (self = [super init]) {
+        _filePath = [filePath copy];
+        _fd = -1;
+        _partInfos = [NSMutableDictionary dictionary];
+        [self load];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self close];
+}
+
+- (NSMutableDictionary<NSString *, NSDictionary *> *)partInfos {
+    @synchronized(self) {
+        return [_partInfos mutableCopy];
+    }
+}
+
+- (BOOL)appendPartInfo:(OSSPartInfo *)partInfo error:(NSError **)error {
+    NSData *record = [OSSPartInfoJournal recordWithPartInfo:partInfo];
+    @synchronized(self) {
+        if (_fd < 0) {
+            _fd = open(_filePath.fileSystemRepresentation, O_WRONLY | O_APPEND | O_CREAT, 0644);
+            if (_fd < 0) {
+                return [self failWithErrno:errno error:error];
+            }
+            if (lseek(_fd, 0, SEEK_END) == 0 && ![self writeBytes:oss_journal_magic length:sizeof(oss_journal_magic) error:error]) {
+                return NO;
+            }
+        }
+        if (![self writeBytes:record.bytes length:record.length error:error]) {
+            return NO;
+        }
+        _recordCount++;
+        _partInfos[[NSString stringWithFormat:@"%zi", (NSInteger)partInfo.partNum]] = [partInfo entityToDictionary];
+
+        if (_recordCount >= oss_journal_compaction_threshold && _recordCount >= 2 * _partInfos.count) {
+            [self compactLocked:nil];
+        }
+    }
+    return YES;
+}
+
+- (BOOL)resetWithPartInfos:(NSDictionary<NSString *, NSDictionary *> *)partInfos error:(NSError **)error {
+    @synchronized(self) {
+        _partInfos = [partInfos mutableCopy] ?: [NSMutableDictionary dictionary];
+        return [self compactLocked:error];
+    }
+}
+
+- (BOOL)compact:(NSError **)error {
+    @synchronized(self) {
+        return [self compactLocked:error];
+    }
+}
+
+- (void)close {
+    @synchronized(self) {
+        if (_fd >= 0) {
+            close(_fd);
+            _fd = -1;
+        }
+    }
+}
+
+#pragma mark - Private Methods
+
+- (void)load {
+    NSData *data = [NSData dataWithContentsOfFile:_filePath options:NSDataReadingMappedIfSafe error:nil];
+    if (data.length == 0) {
+        return;
+    }
+    const uint8_t *bytes = data.bytes;
+    size_t length = data.length;
+    if (length < sizeof(oss_journal_magic) || memcmp(bytes, oss_journal_magic, sizeof(oss_journal_magic)) != 0) {
+        OSSLogError(@"unrecognized part info journal: %@", _filePath);
+        [self compactLocked:nil];
+        return;
+    }
+
+    size_t offset = sizeof(oss_journal_magic);
+    while (offset + sizeof(uint32_t) <= length) {
+        uint32_t payloadLength = OSReadLittleInt32(bytes, offset);
+        size_t remain = length - offset - sizeof(uint32_t);
+        if (remain < sizeof(uint64_t)
+            || payloadLength < oss_journal_record_fixed_length
+            || payloadLength > remain - sizeof(uint64_t)) {
+            break;
+        }
+        const uint8_t *payload = bytes + offset + sizeof(uint32_t);
+        uint64_t checksum = OSReadLittleInt64(payload, payloadLength);
+        if (checksum != [OSSUtil crc64ecma:0 buffer:(void *)payload length:payloadLength]) {
+            break;
+        }
+
+        int32_t partNum = (int32_t)OSReadLittleInt32(payload, 0);
+        uint64_t crc64 = OSReadLittleInt64(payload, sizeof(int32_t));
+        int64_t size = (int64_t)OSReadLittleInt64(payload, sizeof(int32_t) + sizeof(uint64_t));
+        NSString *eTag = [[NSString alloc] initWithBytes:payload + oss_journal_record_fixed_length
+                                                  length:payloadLength - oss_journal_record_fixed_length
+                                                encoding:NSUTF8StringEncoding];
+        OSSPartInfo *partInfo = [OSSPartInfo partInfoWithPartNum:partNum eTag:eTag size:size crc64:crc64];
+        _partInfos[[NSString stringWithFormat:@"%zi", (NSInteger)partNum]] = [partInfo entityToDictionary];
+        _recordCount++;
+        offset += sizeof(uint32_t) + payloadLength + sizeof(uint64_t);
+    }
+
+    if (offset != length) {
+        // a torn tail would corrupt the records appended after it
+        OSSLogDebug(@"drop the torn tail of part info journal: %@", _filePath);
+        [self compactLocked:nil];
+    } else if (_recordCount >= oss_journal_compaction_threshold && _recordCount >= 2 * _partInfos.count) {
+        [self compactLocked:nil];
+    }
+}
+
+- (BOOL)compactLocked:(NSError **)error {
+    if (_fd >= 0) {
+        close(_fd);
+        _fd = -1;
+    }
+    NSMutableData *data = [NSMutableData dataWithBytes:oss_journal_magic length:sizeof(oss_journal_magic)];
+    NSArray<NSString *> *keys = [_partInfos.allKeys sortedArrayUsingComparator:^NSComparisonResult(NSString *key1, NSString *key2) {
+        return [@(key1.integerValue) compare:@(key2.integerValue)];
+    }];
+    for (NSString *key in keys) {
+        NSDictionary *dict = _partInfos[key];
+        OSSPartInfo *partInfo = [OSSPartInfo partInfoWithPartNum:[dict[@"partNum"] intValue]
+                                                            eTag:dict[@"eTag"]
+                                                            size:[dict[@"size"] longLongValue]
+                                                           crc64:[dict[@"crc64"] unsignedLongLongValue]];
+        [data appendData:[OSSPartInfoJournal recordWithPartInfo:partInfo]];
+    }
+    if (![data writeToFile:_filePath options:NSDataWritingAtomic error:error]) {
+        OSSLogError(@"compact part info journal failed: %@", _filePath);
+        return NO;
+    }
+    _recordCount = keys.count;
+    return YES;
+}
+
+- (BOOL)writeBytes:(const void *)bytes length:(size_t)length error:(NSError **)error {
+    const uint8_t *cursor = bytes;
+    while (length > 0) {
+        ssize_t written = write(_fd, cursor, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return [self failWithErrno:errno error:error];
+        }
+        cursor += written;
+        length -= written;
+    }
+    return YES;
+}
+
+- (BOOL)failWithErrno:(int)code error:(NSError **)error {
+    OSSLogError(@"write part info journal failed: %s", strerror(code));
+    if (error) {
+        *error = [NSError errorWithDomain:OSSClientErrorDomain
+                                     code:OSSClientErrorCodeFileCantWrite
+                                 userInfo:@{OSSErrorMessageTOKEN: [NSString stringWithFormat:@"write part info journal failed: %s", strerror(code)]}];
+    }
+    return NO;
+}
+
++ (NSData *)recordWithPartInfo:(OSSPartInfo *)partInfo {
+    NSData *eTagData = [partInfo.eTag ?: @"" dataUsingEncoding:NSUTF8StringEncoding];
+    uint32_t payloadLength = (uint32_t)(oss_journal_record_fixed_length + eTagData.length);
+    NSMutableData *record = [NSMutableData dataWithLength:sizeof(uint32_t) + payloadLength + sizeof(uint64_t)];
+    uint8_t *bytes = record.mutableBytes;
+    OSWriteLittleInt32(bytes, 0, payloadLength);
+
+    uint8_t *payload = bytes + sizeof(uint32_t);
+    OSWriteLittleInt32(payload, 0, (uint32_t)partInfo.partNum);
+    OSWriteLittleInt64(payload, sizeof(int32_t), partInfo.crc64);
+    OSWriteLittleInt64(payload, sizeof(int32_t) + sizeof(uint64_t), (uint64_t)partInfo.size);
+    memcpy(payload + oss_journal_record_fixed_length, eTagData.bytes, eTagData.length);
+    OSWriteLittleInt64(payload, payloadLength, [OSSUtil crc64ecma:0 buffer:payload length:payloadLength]);
+    return record;
+}
+
+@end
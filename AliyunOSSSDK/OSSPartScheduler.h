@@ -0,0 +1,90 @@
+//
+//  OSSPartScheduler.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Decides how many parts of a multipart upload are in flight and how large the next parts are.
+
+ By default the window is fixed. When `adaptsConcurrency` is set, the window is adjusted
+ once per round, i.e. once as many parts as the window have finished (AIMD):
+ - it grows by one while the round throughput keeps growing,
+ - it shrinks to 3/4 when the parts take more than twice their best time per byte without
+   the throughput growing, as more parts in flight only queue up on the link,
+ - it is halved when a part fails.
+
+ When `adaptsPartSize` is set, the parts not started yet are sized so that a part takes
+ about `targetPartDuration` at the throughput measured per part.
+
+ The properties must be set before the first slot is taken.
+ */
+@interface OSSPartScheduler : NSObject
+
+@property (nonatomic, assign) BOOL adaptsConcurrency;
+
+/**
+ Bounds of the window when it adapts. Default is 1 and the initial concurrency.
+ */
+@property (nonatomic, assign) NSUInteger minConcurrency;
+@property (nonatomic, assign) NSUInteger maxConcurrency;
+
+@property (nonatomic, assign) BOOL adaptsPartSize;
+
+/**
+ Bounds of the part size when it adapts. Default is 100KB and 4MB.
+ */
+@property (nonatomic, assign) NSUInteger minPartSize;
+@property (nonatomic, assign) NSUInteger maxPartSize;
+
+/**
+ The time a part should take when its size adapts, in seconds. Default is 2.
+ */
+@property (nonatomic, assign) NSTimeInterval targetPartDuration;
+
+/**
+ The current window.
+ */
+@property (nonatomic, assign, readonly) NSUInteger concurrency;
+
+/**
+ The bytes per second of the last round, 0 before the first round finishes.
+ */
+@property (nonatomic, assign, readonly) double throughput;
+
+- (instancetype)initWithConcurrency:(NSUInteger)concurrency partSize:(NSUInteger)partSize;
+
+/**
+ Blocks until a part can be started.
+ */
+- (void)acquireSlot;
+
+/**
+ Takes a slot if a part can be started now, without blocking.
+ */
+- (BOOL)tryAcquireSlot;
+
+/**
+ Gives back the slot of a part, whether it was sent or not.
+ */
+- (void)releaseSlot;
+
+/**
+ Records a part sent, with the absolute times (CFAbsoluteTime) it started and finished at.
+ */
+- (void)recordPartWithLength:(int64_t)length startTime:(CFAbsoluteTime)startTime endTime:(CFAbsoluteTime)endTime succeeded:(BOOL)succeeded;
+
+/**
+ The size of the next part, the last part takes the rest of the file. When the size adapts,
+ it's never under the size which still fits the rest of the file in the parts left.
+ */
+- (NSUInteger)partSizeForRemainingLength:(unsigned long long)remainingLength remainingPartCount:(NSUInteger)remainingPartCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
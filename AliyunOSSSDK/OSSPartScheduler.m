@@ -0,0 +1,162 @@
+//
+//  OSSPartScheduler.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSPartScheduler.h"
+#import "OSSLog.h"
+
+static NSUInteger const oss_part_size_alignment = 4 * 1024;
+static double const oss_part_throughput_weight = 0.3;
+
+@implementation OSSPartScheduler {
+    NSCondition * _condition;
+    NSUInteger _runningCount;
+    NSUInteger _partSize;
+
+    /* bytes per second of a single part, smoothed */
+    double _partThroughput;
+    double _minSecondsPerByte;
+
+    NSUInteger _roundPartCount;
+    int64_t _roundLength;
+    double _roundSecondsPerByte;
+    CFAbsoluteTime _roundStartTime;
+    CFAbsoluteTime _roundEndTime;
+}
+
+- (instancetype)initWithConcurrency:(NSUInteger)concurrency partSize:(NSUInteger)partSize {
+    if (self = [super init]) {
+        _condition = [NSCondition new];
+        _concurrency = MAX(concurrency, 1);
+        _minConcurrency = 1;
+        _maxConcurrency = _concurrency;
+        _partSize = partSize;
+        _minPartSize = 100 * 1024;
+        _maxPartSize = 4 * 1024 * 1024;
+        _targetPartDuration = 2;
+    }
+    return self;
+}
+
+- (void)acquireSlot {
+    [_condition lock];
+    while (_runningCount >= _concurrency) {
+        [_condition wait];
+    }
+    _runningCount++;
+    [_condition unlock];
+}
+
+- (BOOL)tryAcquireSlot {
+    [_condition lock];
+    BOOL acquired = _runningCount < _concurrency;
+    if (acquired) {
+        _runningCount++;
+    }
+    [_condition unlock];
+    return acquired;
+}
+
+- (void)releaseSlot {
+    [_condition lock];
+    if (_runningCount > 0) {
+        _runningCount--;
+    }
+    [_condition broadcast];
+    [_condition unlock];
+}
+
+- (void)recordPartWithLength:(int64_t)length startTime:(CFAbsoluteTime)startTime endTime:(CFAbsoluteTime)endTime succeeded:(BOOL)succeeded {
+    [_condition lock];
+    if (!succeeded) {
+        if (_adaptsConcurrency) {
+            [self setConcurrencyLocked:_concurrency / 2];
+        }
+        [self resetRoundLocked];
+    } else if (length > 0 && endTime > startTime) {
+        NSTimeInterval duration = endTime - startTime;
+        double partThroughput = length / duration;
+        _partThroughput = _partThroughput > 0 ? (1 - oss_part_throughput_weight) * _partThroughput + oss_part_throughput_weight * partThroughput : partThroughput;
+
+        double secondsPerByte = duration / length;
+        if (_minSecondsPerByte == 0 || secondsPerByte < _minSecondsPerByte) {
+            _minSecondsPerByte = secondsPerByte;
+        }
+
+        if (_roundPartCount == 0 || startTime < _roundStartTime) {
+            _roundStartTime = startTime;
+        }
+        _roundEndTime = MAX(_roundEndTime, endTime);
+        _roundPartCount++;
+        _roundLength += length;
+        _roundSecondsPerByte += secondsPerByte;
+
+        if (_roundPartCount >= _concurrency) {
+            [self finishRoundLocked];
+        }
+    }
+    [_condition broadcast];
+    [_condition unlock];
+}
+
+- (NSUInteger)partSizeForRemainingLength:(unsigned long long)remainingLength remainingPartCount:(NSUInteger)remainingPartCount {
+    if (remainingPartCount <= 1) {
+        return (NSUInteger)remainingLength;
+    }
+    unsigned long long partSize = _partSize;
+    if (_adaptsPartSize) {
+        [_condition lock];
+        if (_partThroughput > 0) {
+            partSize = (unsigned long long)(_partThroughput * _targetPartDuration);
+        }
+        [_condition unlock];
+        partSize = MIN(MAX(partSize, _minPartSize), MAX(_maxPartSize, _minPartSize));
+        partSize -= partSize % oss_part_size_alignment;
+
+        // the rest of the file must still fit in the parts left
+        unsigned long long leastPartSize = (remainingLength + remainingPartCount - 1) / remainingPartCount;
+        partSize = MAX(partSize, leastPartSize);
+    }
+    return (NSUInteger)MIN(partSize, remainingLength);
+}
+
+# pragma mark - Private Methods
+
+- (void)finishRoundLocked {
+    double roundThroughput = _roundLength / MAX(_roundEndTime - _roundStartTime, 0.001);
+    double meanSecondsPerByte = _roundSecondsPerByte / _roundPartCount;
+    double lastThroughput = _throughput;
+    _throughput = roundThroughput;
+    [self resetRoundLocked];
+
+    if (!_adaptsConcurrency) {
+        return;
+    }
+    if (lastThroughput == 0 || roundThroughput > lastThroughput * 1.05) {
+        [self setConcurrencyLocked:_concurrency + 1];
+    } else if (meanSecondsPerByte > _minSecondsPerByte * 2) {
+        [self setConcurrencyLocked:(_concurrency * 3) / 4];
+    }
+}
+
+- (void)resetRoundLocked {
+    _roundPartCount = 0;
+    _roundLength = 0;
+    _roundSecondsPerByte = 0;
+    _roundStartTime = 0;
+    _roundEndTime = 0;
+}
+
+- (void)setConcurrencyLocked:(NSUInteger)concurrency {
+    NSUInteger minConcurrency = MAX(_minConcurrency, 1);
+    NSUInteger bounded = MIN(MAX(concurrency, minConcurrency), MAX(_maxConcurrency, minConcurrency));
+    if (bounded != _concurrency) {
+        OSSLogVerbose(@"part concurrency %lu -> %lu, throughput: %.0f B/s", (unsigned long)_concurrency, (unsigned long)bounded, _throughput);
+        _concurrency = bounded;
+    }
+}
+
+@end
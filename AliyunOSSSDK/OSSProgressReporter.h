@@ -0,0 +1,68 @@
+//
+//  OSSProgressReporter.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "OSSModel.h"
+
+@class OSSExecutor;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Coalesces progress updates before handing them to the user's progress block.
+
+ Updates from every part of a transfer can be fed into the same reporter. They are
+ accumulated and delivered at most once per `minimumInterval` and once at least
+ `minimumBytes` were transferred since the last delivery. The update which completes
+ the transfer is always delivered. While a delivery is waiting on the executor, newer
+ updates are merged into it instead of being queued.
+ */
+@interface OSSProgressReporter : NSObject
+
+/**
+ Minimum interval in seconds between two deliveries. Default is 0.
+ */
+@property (nonatomic, assign) NSTimeInterval minimumInterval;
+
+/**
+ Minimum number of bytes transferred between two deliveries. Default is 0.
+ */
+@property (nonatomic, assign) int64_t minimumBytes;
+
+/**
+ @param progress the user's progress block, it receives the bytes accumulated since its last call
+ @param executor the executor on which progress is delivered, nil delivers on the reporting thread
+ */
+- (instancetype)initWithProgress:(OSSNetworkingUploadProgressBlock)progress executor:(nullable OSSExecutor *)executor;
+
+/**
+ Creates a reporter configured from the progress settings of the request.
+ */
++ (nullable instancetype)reporterWithRequest:(OSSRequest *)request progress:(nullable OSSNetworkingUploadProgressBlock)progress;
+
+/**
+ Returns YES if the request asks for coalesced progress.
+ */
++ (BOOL)isProgressThrottledForRequest:(OSSRequest *)request;
+
+/**
+ Records a progress update.
+
+ @param bytes bytes transferred since the previous update
+ @param totalBytes total bytes transferred so far
+ @param totalBytesExpected total bytes of the transfer
+ */
+- (void)reportBytes:(int64_t)bytes totalBytes:(int64_t)totalBytes totalBytesExpected:(int64_t)totalBytesExpected;
+
+/**
+ Delivers the pending update, if any, regardless of the interval and byte thresholds.
+ */
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,104 @@
+//
+//  OSSProgressReporter.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSProgressReporter.h"
+#import "OSSExecutor.h"
+
+@implementation OSSProgressReporter {
+    OSSNetworkingUploadProgressBlock _progress;
+    OSSExecutor * _executor;
+
+    int64_t _pendingBytes;
+    int64_t _totalBytes;
+    int64_t _totalBytesExpected;
+    int64_t _deliveredTotalBytes;
+    CFAbsoluteTime _lastDeliveryTime;
+    BOOL _hasDelivered;
+    BOOL _isDeliveryScheduled;
+}
+
+- (instancetype)initWithProgress:(OSSNetworkingUploadProgressBlock)progress executor:(OSSExecutor *)executor {
+    if (self = [super init]) {
+        _progress = [progress copy];
+        _executor = executor ?: [OSSExecutor immediateExecutor];
+    }
+    return self;
+}
+
++ (instancetype)reporterWithRequest:(OSSRequest *)request progress:(OSSNetworkingUploadProgressBlock)progress {
+    if (!progress) {
+        return nil;
+    }
+    OSSProgressReporter * reporter = [[OSSProgressReporter alloc] initWithProgress:progress executor:request.progressReportExecutor];
+    reporter.minimumInterval = request.progressReportInterval;
+    reporter.minimumBytes = request.progressReportGranularity;
+    return reporter;
+}
+
++ (BOOL)isProgressThrottledForRequest:(OSSRequest *)request {
+    return request.progressReportInterval > 0 || request.progressReportGranularity > 0 || request.progressReportExecutor != nil;
+}
+
+- (void)reportBytes:(int64_t)bytes totalBytes:(int64_t)totalBytes totalBytesExpected:(int64_t)totalBytesExpected {
+    BOOL shouldSchedule = NO;
+    @synchronized(self) {
+        _pendingBytes += bytes;
+        // parts finish out of order, never report the progress backwards
+        _totalBytes = MAX(_totalBytes, totalBytes);
+        _totalBytesExpected = totalBytesExpected;
+
+        if (!_isDeliveryScheduled) {
+            BOOL isFinished = _totalBytesExpected > 0 && _totalBytes >= _totalBytesExpected;
+            BOOL isIntervalReached = CFAbsoluteTimeGetCurrent() - _lastDeliveryTime >= _minimumInterval;
+            BOOL isGranularityReached = _totalBytes - _deliveredTotalBytes >= _minimumBytes;
+            if (isFinished || !_hasDelivered || (isIntervalReached && isGranularityReached)) {
+                _isDeliveryScheduled = YES;
+                shouldSchedule = YES;
+            }
+        }
+    }
+    if (shouldSchedule) {
+        [self scheduleDelivery];
+    }
+}
+
+- (void)flush {
+    BOOL shouldSchedule = NO;
+    @synchronized(self) {
+        if (!_isDeliveryScheduled && (_totalBytes != _deliveredTotalBytes || _pendingBytes != 0)) {
+            _isDeliveryScheduled = YES;
+            shouldSchedule = YES;
+        }
+    }
+    if (shouldSchedule) {
+        [self scheduleDelivery];
+    }
+}
+
+- (void)scheduleDelivery {
+    [_executor execute:^{
+        int64_t bytes, totalBytes, totalBytesExpected;
+        BOOL isDuplicated;
+        @synchronized(self) {
+            bytes = _pendingBytes;
+            totalBytes = _totalBytes;
+            totalBytesExpected = _totalBytesExpected;
+            isDuplicated = _hasDelivered && bytes == 0 && totalBytes == _deliveredTotalBytes;
+
+            _pendingBytes = 0;
+            _deliveredTotalBytes = totalBytes;
+            _lastDeliveryTime = CFAbsoluteTimeGetCurrent();
+            _hasDelivered = YES;
+            _isDeliveryScheduled = NO;
+        }
+        if (!isDuplicated) {
+            _progress(bytes, totalBytes, totalBytesExpected);
+        }
+    }];
+}
+
+@end
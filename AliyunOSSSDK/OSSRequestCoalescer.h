@@ -0,0 +1,45 @@
+//
+//  OSSRequestCoalescer.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "OSSModel.h"
+
+@class OSSNetworkingRequestDelegate;
+@class OSSTask;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Sends identical reads requested at the same time once, e.g. the thumbnail many views of a screen
+ ask for at once.
+
+ The first caller of a key starts a flight of its own request delegate, the callers coming while it's
+ in flight wait for it too and every one of them gets its outcome, the same result object, and its
+ download progress. A caller is cancelled with its own request: its task fails right away, and the
+ flight is only cancelled once no caller waits for it any more.
+ */
+@interface OSSRequestCoalescer : NSObject
+
+/**
+ The flights in progress.
+ */
+@property (nonatomic, assign, readonly) NSUInteger flightCount;
+
+/**
+ @param key what makes two reads identical, e.g. the method, the object, the range and the processing
+ @param caller the request delegate of the caller, whose cancellation cancels its wait
+ @param downloadProgress the progress of the caller, optional
+ @param startFlight sends the read on the delegate of a new flight, it's only called by the first caller
+ */
+- (OSSTask *)taskForKey:(id<NSCopying>)key
+                 caller:(OSSNetworkingRequestDelegate *)caller
+       downloadProgress:(nullable OSSNetworkingDownloadProgressBlock)downloadProgress
+            startFlight:(OSSTask * (^)(OSSNetworkingRequestDelegate * flightDelegate))startFlight;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,177 @@
+//
+//  OSSRequestCoalescer.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSRequestCoalescer.h"
+#import "OSSNetworking.h"
+#import "OSSDefine.h"
+#import "OSSBolts.h"
+#import "OSSLog.h"
+
+@interface OSSCoalescedWaiter : NSObject
+
+@property (nonatomic, strong) OSSNetworkingRequestDelegate * caller;
+@property (nonatomic, copy) OSSNetworkingDownloadProgressBlock downloadProgress;
+@property (nonatomic, strong) OSSTaskCompletionSource * completionSource;
+
+@end
+
+@implementation OSSCoalescedWaiter
+@end
+
+@interface OSSCoalescedFlight : NSObject
+
+@property (nonatomic, copy) id<NSCopying> key;
+@property (nonatomic, strong) OSSNetworkingRequestDelegate * delegate;
+/* the callers not cancelled yet, guarded by the coalescer */
+@property (nonatomic, strong) NSMutableArray<OSSCoalescedWaiter *> * waiters;
+
+@end
+
+@implementation OSSCoalescedFlight
+@end
+
+@implementation OSSRequestCoalescer {
+    NSMutableDictionary<id<NSCopying>, OSSCoalescedFlight *> * _flights;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _flights = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (NSUInteger)flightCount {
+    @synchronized(self) {
+        return _flights.count;
+    }
+}
+
+- (OSSTask *)taskForKey:(id<NSCopying>)key
+                 caller:(OSSNetworkingRequestDelegate *)caller
+       downloadProgress:(OSSNetworkingDownloadProgressBlock)downloadProgress
+            startFlight:(OSSTask * (^)(OSSNetworkingRequestDelegate * flightDelegate))startFlight {
+    OSSCoalescedWaiter * waiter = [OSSCoalescedWaiter new];
+    waiter.caller = caller;
+    waiter.downloadProgress = downloadProgress;
+    waiter.completionSource = [OSSTaskCompletionSource taskCompletionSource];
+
+    OSSCoalescedFlight * flight = nil;
+    BOOL isNewFlight = NO;
+    @synchronized(self) {
+        flight = _flights[key];
+        if (!flight) {
+            flight = [OSSCoalescedFlight new];
+            flight.key = key;
+            flight.delegate = [OSSNetworkingRequestDelegate new];
+            flight.delegate.priority = caller.priority;
+            flight.waiters = [NSMutableArray array];
+            _flights[key] = flight;
+            isNewFlight = YES;
+        } else {
+            OSSLogDebug(@"a read joins the one in flight for %@", key);
+        }
+        [flight.waiters addObject:waiter];
+    }
+
+    // the caller's delegate is never sent, cancelling it only ends its wait
+    __weak OSSRequestCoalescer * weakSelf = self;
+    __weak OSSCoalescedWaiter * weakWaiter = waiter;
+    __weak OSSCoalescedFlight * weakFlight = flight;
+    caller.cancellationHandler = ^{
+        [weakSelf cancelWaiter:weakWaiter ofFlight:weakFlight];
+    };
+    if (caller.isRequestCancelled) {
+        [self cancelWaiter:waiter ofFlight:flight];
+    }
+
+    if (isNewFlight) {
+        flight.delegate.downloadProgress = ^(int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite) {
+            [weakSelf flight:weakFlight didWriteBytes:bytesWritten totalBytes:totalBytesWritten totalBytesExpected:totalBytesExpectedToWrite];
+        };
+        [startFlight(flight.delegate) continueWithBlock:^id(OSSTask *flightTask) {
+            [self didFinishFlight:flight task:flightTask];
+            return nil;
+        }];
+    }
+    return waiter.completionSource.task;
+}
+
+# pragma mark - Private Methods
+
+- (void)flight:(OSSCoalescedFlight *)flight didWriteBytes:(int64_t)bytes totalBytes:(int64_t)totalBytes totalBytesExpected:(int64_t)totalBytesExpected {
+    NSMutableArray<OSSNetworkingDownloadProgressBlock> * progresses = [NSMutableArray array];
+    @synchronized(self) {
+        for (OSSCoalescedWaiter * waiter in flight.waiters) {
+            if (waiter.downloadProgress) {
+                [progresses addObject:waiter.downloadProgress];
+            }
+        }
+    }
+    for (OSSNetworkingDownloadProgressBlock progress in progresses) {
+        progress(bytes, totalBytes, totalBytesExpected);
+    }
+}
+
+- (void)didFinishFlight:(OSSCoalescedFlight *)flight task:(OSSTask *)task {
+    NSArray<OSSCoalescedWaiter *> * waiters = nil;
+    @synchronized(self) {
+        if (_flights[flight.key] == flight) {
+            [_flights removeObjectForKey:flight.key];
+        }
+        waiters = [flight.waiters copy];
+        [flight.waiters removeAllObjects];
+    }
+
+    for (OSSCoalescedWaiter * waiter in waiters) {
+        waiter.caller.cancellationHandler = nil;
+        if (task.error) {
+            [waiter.completionSource trySetError:task.error];
+        } else if (task.exception) {
+            [waiter.completionSource trySetException:task.exception];
+        } else if (task.cancelled) {
+            [waiter.completionSource trySetCancelled];
+        } else {
+            [waiter.completionSource trySetResult:task.result];
+        }
+    }
+}
+
+- (void)cancelWaiter:(OSSCoalescedWaiter *)waiter ofFlight:(OSSCoalescedFlight *)flight {
+    if (!waiter || !flight) {
+        return;
+    }
+    BOOL cancelsFlight = NO;
+    @synchronized(self) {
+        if (![flight.waiters containsObject:waiter]) {
+            return;
+        }
+        [flight.waiters removeObject:waiter];
+        // the next identical read starts a new flight instead of joining the cancelled one
+        if (flight.waiters.count == 0) {
+            cancelsFlight = YES;
+            if (_flights[flight.key] == flight) {
+                [_flights removeObjectForKey:flight.key];
+            }
+        }
+    }
+
+    waiter.caller.cancellationHandler = nil;
+    [waiter.completionSource trySetError:[self cancelError]];
+    if (cancelsFlight) {
+        OSSLogDebug(@"no read waits for the one in flight for %@ any more", flight.key);
+        [flight.delegate cancel];
+    }
+}
+
+- (NSError *)cancelError {
+    return [NSError errorWithDomain:OSSClientErrorDomain
+                               code:OSSClientErrorCodeTaskCancelled
+                           userInfo:@{OSSErrorMessageTOKEN: @"This task has been cancelled!"}];
+}
+
+@end
@@ -16,5 +16,20 @@
 #import "OSSModel.h"
 #import "OSSUtil.h"
 #import "OSSLog.h"
+#import "OSSInputStreamHelper.h"
+#import "OSSProgressReporter.h"
+#import "OSSPartInfoJournal.h"
+#import "OSSXMLResponseParser.h"
+#import "OSSBucketListIterator.h"
+#import "OSSPartScheduler.h"
+#import "OSSObjectAppender.h"
+#import "OSSTransferScheduler.h"
+#import "OSSRequestCoalescer.h"
+#import "OSSObjectCache.h"
+#import "OSSCacheIndex.h"
+#import "OSSFileDigestCache.h"
+#import "OSSMemoryGovernor.h"
+#import "OSSObjectReader.h"
+#import "OSSImagePipeline.h"
 
 #import "OSSBolts.h"
@@ -0,0 +1,52 @@
+//
+//  OSSStreamingBody.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "OSSModel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ An upload body read once from an input stream or a producer block, without its whole length
+ being known or held in memory. The crc64 of the bytes is computed as they're read.
+
+ It's either read in parts with readDataOfMaxLength:error:, or handed to NSURLSession as a
+ body stream, which is filled by a thread of its own.
+ */
+@interface OSSStreamingBody : NSObject
+
+@property (nonatomic, assign, readonly) uint64_t crc64;
+@property (nonatomic, assign, readonly) int64_t length;
+@property (nonatomic, assign, readonly) BOOL isAtEnd;
+
+/**
+ YES once the body stream is handed out, the body can't be sent again.
+ */
+@property (nonatomic, assign, readonly) BOOL isBodyStreamTaken;
+
+/**
+ Called on the pumping thread once the body stream is filled, with the read or write error if any.
+ */
+@property (nonatomic, copy, nullable) void (^completion)(NSError * _Nullable error);
+
+- (instancetype)initWithInputStream:(NSInputStream *)inputStream;
+- (instancetype)initWithProducer:(OSSUploadDataProducerBlock)producer;
+
+/**
+ Blocks until maxLength bytes are read or the body is over. The data is shorter than maxLength
+ only at the end of the body. Returns nil on error.
+ */
+- (nullable NSData *)readDataOfMaxLength:(NSUInteger)maxLength error:(NSError **)error;
+
+/**
+ Returns the stream NSURLSession reads the body from, nil if it was already taken.
+ */
+- (nullable NSInputStream *)takeBodyStream;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,165 @@
+//
+//  OSSStreamingBody.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSStreamingBody.h"
+#import "OSSDefine.h"
+#import "OSSUtil.h"
+#import "OSSLog.h"
+
+static NSUInteger const oss_streaming_chunk_size = 64 * 1024;
+
+@implementation OSSStreamingBody {
+    NSInputStream * _inputStream;
+    OSSUploadDataProducerBlock _producer;
+
+    /* the rest of the last chunk produced, when it was larger than asked for */
+    NSData * _pendingData;
+    NSUInteger _pendingOffset;
+}
+
+- (instancetype)initWithInputStream:(NSInputStream *)inputStream {
+    if (self = [super init]) {
+        _inputStream = inputStream;
+    }
+    return self;
+}
+
+- (instancetype)initWithProducer:(OSSUploadDataProducerBlock)producer {
+    if (self = [super init]) {
+        _producer = [producer copy];
+    }
+    return self;
+}
+
+- (NSData *)readDataOfMaxLength:(NSUInteger)maxLength error:(NSError **)error {
+    NSMutableData * data = [NSMutableData dataWithCapacity:MIN(maxLength, 4 * 1024 * 1024)];
+    while (data.length < maxLength && !_isAtEnd) {
+        BOOL succeeded = _producer ? [self produceIntoData:data maxLength:maxLength - data.length error:error]
+                                   : [self readIntoData:data maxLength:maxLength - data.length error:error];
+        if (!succeeded) {
+            return nil;
+        }
+    }
+
+    if (data.length) {
+        _crc64 = [OSSUtil crc64ecma:_crc64 buffer:(void *)data.bytes length:data.length];
+        _length += data.length;
+    }
+    return data;
+}
+
+- (NSInputStream *)takeBodyStream {
+    @synchronized(self) {
+        if (_isBodyStreamTaken) {
+            return nil;
+        }
+        _isBodyStreamTaken = YES;
+    }
+
+    CFReadStreamRef readStream = NULL;
+    CFWriteStreamRef writeStream = NULL;
+    CFStreamCreateBoundPair(kCFAllocatorDefault, &readStream, &writeStream, oss_streaming_chunk_size);
+    NSInputStream * bodyStream = CFBridgingRelease(readStream);
+    NSOutputStream * outputStream = CFBridgingRelease(writeStream);
+
+    NSThread * pumpThread = [[NSThread alloc] initWithTarget:self selector:@selector(pumpToStream:) object:outputStream];
+    pumpThread.name = @"com.aliyun.oss.streaming-body";
+    [pumpThread start];
+    return bodyStream;
+}
+
+# pragma mark - Private Methods
+
+- (void)pumpToStream:(NSOutputStream *)outputStream {
+    @autoreleasepool {
+        [outputStream open];
+        NSError * error = nil;
+        while (!error && !_isAtEnd) {
+            @autoreleasepool {
+                NSData * data = [self readDataOfMaxLength:oss_streaming_chunk_size error:&error];
+                const uint8_t * bytes = data.bytes;
+                NSUInteger remain = data.length;
+                while (remain > 0) {
+                    // blocks while the session hasn't read the previous bytes, fails once it closed the stream
+                    NSInteger written = [outputStream write:bytes maxLength:remain];
+                    if (written <= 0) {
+                        error = outputStream.streamError ?: [self errorWithMessage:@"The upload body stream is closed before its end!"];
+                        break;
+                    }
+                    bytes += written;
+                    remain -= written;
+                }
+            }
+        }
+        [outputStream close];
+
+        if (error) {
+            OSSLogError(@"streaming body error after %lld bytes: %@", _length, error);
+        }
+        if (self.completion) {
+            self.completion(error);
+        }
+    }
+}
+
+- (BOOL)produceIntoData:(NSMutableData *)data maxLength:(NSUInteger)maxLength error:(NSError **)error {
+    if (_pendingOffset >= _pendingData.length) {
+        NSError * producerError = nil;
+        _pendingData = _producer(&producerError);
+        _pendingOffset = 0;
+        if (producerError) {
+            if (error) {
+                *error = producerError;
+            }
+            return NO;
+        }
+        if (!_pendingData.length) {
+            _pendingData = nil;
+            _isAtEnd = YES;
+            return YES;
+        }
+    }
+
+    NSUInteger length = MIN(maxLength, _pendingData.length - _pendingOffset);
+    [data appendBytes:(const uint8_t *)_pendingData.bytes + _pendingOffset length:length];
+    _pendingOffset += length;
+    return YES;
+}
+
+- (BOOL)readIntoData:(NSMutableData *)data maxLength:(NSUInteger)maxLength error:(NSError **)error {
+    if (_inputStream.streamStatus == NSStreamStatusNotOpen) {
+        [_inputStream open];
+    }
+
+    NSUInteger offset = data.length;
+    NSUInteger length = MIN(maxLength, oss_streaming_chunk_size);
+    [data setLength:offset + length];
+    // blocks until bytes are available, the stream isn't scheduled in a run loop
+    NSInteger readLength = [_inputStream read:(uint8_t *)data.mutableBytes + offset maxLength:length];
+    [data setLength:offset + MAX(readLength, 0)];
+
+    if (readLength < 0) {
+        if (error) {
+            *error = _inputStream.streamError ?: [self errorWithMessage:@"Can not read the upload stream!"];
+        }
+        [_inputStream close];
+        return NO;
+    }
+    if (readLength == 0) {
+        _isAtEnd = YES;
+        [_inputStream close];
+    }
+    return YES;
+}
+
+- (NSError *)errorWithMessage:(NSString *)message {
+    return [NSError errorWithDomain:OSSClientErrorDomain
+                               code:OSSClientErrorCodeNotKnown
+                           userInfo:@{OSSErrorMessageTOKEN: message}];
+}
+
+@end
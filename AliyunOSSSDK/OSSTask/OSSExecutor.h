@@ -51,6 +51,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (instancetype)executorWithOperationQueue:(NSOperationQueue *)queue;
 
+/*!
+ Returns a new executor that runs at most `width` continuations at a time on the global queue of the given QoS class.
+ The continuations are kept in one FIFO shared by the running workers, so a blocked continuation only holds its own
+ worker, and no NSOperation is allocated for them. Unlike a plain concurrent dispatch queue, a continuation
+ blocked in a wait never makes GCD start more than `width` threads for this executor.
+ @param width The max count of continuations running at the same time, at least 1.
+ @param qos The QoS class of the threads, e.g. `QOS_CLASS_UTILITY`.
+ */
++ (instancetype)executorWithWidth:(NSUInteger)width qualityOfService:(qos_class_t)qos;
+
 /*!
  Runs the given block using this executor's particular strategy.
  @param block The block to execute.
@@ -37,6 +37,81 @@ __attribute__((noinline)) static size_t remaining_stack_size(size_t *restrict to
     return (*totalSize) - (endStack - frameAddr);
 }
 
+/*!
+ The shared FIFO of a fixed-width executor. A worker is started on the target queue when a block is added while
+ fewer than `width` are running, and each worker runs blocks until the FIFO is empty.
+ */
+@interface OSSFixedWidthQueue : NSObject
+
+- (instancetype)initWithWidth:(NSUInteger)width qualityOfService:(qos_class_t)qos;
+- (void)addBlock:(dispatch_block_t)block;
+
+@end
+
+@implementation OSSFixedWidthQueue {
+    pthread_mutex_t _lock;
+    NSMutableArray<dispatch_block_t> *_blocks;
+    NSUInteger _width;
+    NSUInteger _workerCount;
+    dispatch_queue_t _targetQueue;
+}
+
+- (instancetype)initWithWidth:(NSUInteger)width qualityOfService:(qos_class_t)qos {
+    self = [super init];
+    if (!self) return self;
+
+    pthread_mutex_init(&_lock, NULL);
+    _blocks = [NSMutableArray array];
+    _width = MAX(width, 1);
+    _targetQueue = dispatch_get_global_queue(qos, 0);
+
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (void)addBlock:(dispatch_block_t)block {
+    BOOL startsWorker = NO;
+    pthread_mutex_lock(&_lock);
+    [_blocks addObject:block];
+    if (_workerCount < _width) {
+        _workerCount++;
+        startsWorker = YES;
+    }
+    pthread_mutex_unlock(&_lock);
+
+    if (startsWorker) {
+        dispatch_async(_targetQueue, ^{
+            [self runBlocks];
+        });
+    }
+}
+
+- (void)runBlocks {
+    while (YES) {
+        dispatch_block_t block = nil;
+        pthread_mutex_lock(&_lock);
+        block = _blocks.firstObject;
+        if (block) {
+            [_blocks removeObjectAtIndex:0];
+        } else {
+            _workerCount--;
+        }
+        pthread_mutex_unlock(&_lock);
+
+        if (!block) {
+            return;
+        }
+        @autoreleasepool {
+            block();
+        }
+    }
+}
+
+@end
+
 @interface OSSExecutor ()
 
 @property (nonatomic, copy) void(^block)(void(^block)(void));
@@ -114,6 +189,13 @@ __attribute__((noinline)) static size_t remaining_stack_size(size_t *restrict to
     }];
 }
 
++ (instancetype)executorWithWidth:(NSUInteger)width qualityOfService:(qos_class_t)qos {
+    OSSFixedWidthQueue *queue = [[OSSFixedWidthQueue alloc] initWithWidth:width qualityOfService:qos];
+    return [self executorWithBlock:^void(void(^block)(void)) {
+        [queue addBlock:block];
+    }];
+}
+
 #pragma mark - Initializer
 
 - (instancetype)initWithBlock:(void(^)(void(^block)(void)))block {
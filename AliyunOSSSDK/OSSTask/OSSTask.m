@@ -12,6 +12,8 @@
 #import "OSSLog.h"
 
 #import <libkern/OSAtomic.h>
+#import <pthread.h>
+#import <stdatomic.h>
 
 #import "OSSBolts.h"
 
@@ -33,15 +35,21 @@ NSString *const OSSTaskMultipleExceptionsUserInfoKey = @"exceptions";
     id _result;
     NSError *_error;
     NSException *_exception;
-}
+    BOOL _cancelled;
+    BOOL _faulted;
+
+    /* set last, with release ordering, so the fields above are read without the lock once it's seen */
+    atomic_bool _completed;
 
-@property (nonatomic, assign, readwrite, getter=isCancelled) BOOL cancelled;
-@property (nonatomic, assign, readwrite, getter=isFaulted) BOOL faulted;
-@property (nonatomic, assign, readwrite, getter=isCompleted) BOOL completed;
+    pthread_mutex_t _lock;
+    pthread_cond_t _condition;
+    NSUInteger _waiterCount;
 
-@property (nonatomic, strong) NSObject *lock;
-@property (nonatomic, strong) NSCondition *condition;
-@property (nonatomic, strong) NSMutableArray *callbacks;
+    /* most tasks have one continuation, it's kept inline and the array only holds the following ones */
+    OSSExecutor *_continuationExecutor;
+    dispatch_block_t _continuationBlock;
+    NSMutableArray *_moreContinuations;
+}
 
 @end
 
@@ -53,23 +61,23 @@ NSString *const OSSTaskMultipleExceptionsUserInfoKey = @"exceptions";
     self = [super init];
     if (!self) return self;
 
-    _lock = [[NSObject alloc] init];
-    _condition = [[NSCondition alloc] init];
-    _callbacks = [NSMutableArray array];
+    pthread_mutex_init(&_lock, NULL);
+    pthread_cond_init(&_condition, NULL);
 
     return self;
 }
 
 - (instancetype)initWithResult:(id)result {
-    self = [super init];
-    if (self) {
-        [self trySetResult:result];
-    }
+    self = [self init];
+    if (!self) return self;
+
+    [self trySetResult:result];
+
     return self;
 }
 
 - (instancetype)initWithError:(NSError *)error {
-    self = [super init];
+    self = [self init];
     if (!self) return self;
 
     [self trySetError:error];
@@ -78,7 +86,7 @@ NSString *const OSSTaskMultipleExceptionsUserInfoKey = @"exceptions";
 }
 
 - (instancetype)initWithException:(NSException *)exception {
-    self = [super init];
+    self = [self init];
     if (!self) return self;
 
     [self trySetException:exception];
@@ -87,7 +95,7 @@ NSString *const OSSTaskMultipleExceptionsUserInfoKey = @"exceptions";
 }
 
 - (instancetype)initCancelled {
-    self = [super init];
+    self = [self init];
     if (!self) return self;
 
     [self trySetCancelled];
@@ -95,6 +103,11 @@ NSString *const OSSTaskMultipleExceptionsUserInfoKey = @"exceptions";
     return self;
 }
 
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+    pthread_cond_destroy(&_condition);
+}
+
 #pragma mark - Task Class methods
 
 + (instancetype)taskWithResult:(_Nullable id)result {
@@ -277,102 +290,87 @@ NSString *const OSSTaskMultipleExceptionsUserInfoKey = @"exceptions";
 
 #pragma mark - Custom Setters/Getters
 
+/* the state never changes once completed, nor is it read before, so no lock is taken */
+
 - (nullable id)result {
-    @synchronized(self.lock) {
-        return _result;
-    }
+    return self.completed ? _result : nil;
 }
 
-- (BOOL)trySetResult:(nullable id)result {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        _result = result;
-        [self runContinuations];
-        return YES;
-    }
+- (nullable NSError *)error {
+    return self.completed ? _error : nil;
 }
 
-- (nullable NSError *)error {
-    @synchronized(self.lock) {
-        return _error;
-    }
+- (nullable NSException *)exception {
+    return self.completed ? _exception : nil;
 }
 
-- (BOOL)trySetError:(NSError *)error {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.faulted = YES;
-        _error = error;
-        [self runContinuations];
-        return YES;
-    }
+- (BOOL)isCancelled {
+    return self.completed && _cancelled;
 }
 
-- (nullable NSException *)exception {
-    @synchronized(self.lock) {
-        return _exception;
-    }
+- (BOOL)isFaulted {
+    return self.completed && _faulted;
 }
 
-- (BOOL)trySetException:(NSException *)exception {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.faulted = YES;
-        _exception = exception;
-        [self runContinuations];
-        return YES;
-    }
+- (BOOL)isCompleted {
+    return atomic_load_explicit(&_completed, memory_order_acquire);
 }
 
-- (BOOL)isCancelled {
-    @synchronized(self.lock) {
-        return _cancelled;
-    }
+- (BOOL)trySetResult:(nullable id)result {
+    return [self completeWithResult:result error:nil exception:nil cancelled:NO];
 }
 
-- (BOOL)isFaulted {
-    @synchronized(self.lock) {
-        return _faulted;
-    }
+- (BOOL)trySetError:(NSError *)error {
+    return [self completeWithResult:nil error:error exception:nil cancelled:NO];
+}
+
+- (BOOL)trySetException:(NSException *)exception {
+    return [self completeWithResult:nil error:nil exception:exception cancelled:NO];
 }
 
 - (BOOL)trySetCancelled {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.cancelled = YES;
-        [self runContinuations];
-        return YES;
-    }
+    return [self completeWithResult:nil error:nil exception:nil cancelled:YES];
 }
 
-- (BOOL)isCompleted {
-    @synchronized(self.lock) {
-        return _completed;
+- (BOOL)completeWithResult:(nullable id)result
+                     error:(nullable NSError *)error
+                 exception:(nullable NSException *)exception
+                 cancelled:(BOOL)cancelled {
+    if (self.completed) {
+        return NO;
     }
-}
 
-- (void)runContinuations {
-    @synchronized(self.lock) {
-        [self.condition lock];
-        [self.condition broadcast];
-        [self.condition unlock];
-        for (void (^callback)(void) in self.callbacks) {
-            callback();
-        }
-        [self.callbacks removeAllObjects];
+    pthread_mutex_lock(&_lock);
+    if (atomic_load_explicit(&_completed, memory_order_relaxed)) {
+        pthread_mutex_unlock(&_lock);
+        return NO;
+    }
+    _result = result;
+    _error = error;
+    _exception = exception;
+    _cancelled = cancelled;
+    _faulted = (error != nil || exception != nil);
+    atomic_store_explicit(&_completed, YES, memory_order_release);
+
+    OSSExecutor *executor = _continuationExecutor;
+    dispatch_block_t block = _continuationBlock;
+    NSArray *moreContinuations = _moreContinuations;
+    _continuationExecutor = nil;
+    _continuationBlock = nil;
+    _moreContinuations = nil;
+    if (_waiterCount > 0) {
+        pthread_cond_broadcast(&_condition);
+    }
+    pthread_mutex_unlock(&_lock);
+
+    // the continuations added from now on see the task completed and run at once
+    if (block) {
+        [executor execute:block];
+    }
+    for (NSUInteger i = 0; i + 1 < moreContinuations.count; i += 2) {
+        [(OSSExecutor *)moreContinuations[i] execute:moreContinuations[i + 1]];
     }
+    return YES;
 }
 
 #pragma mark - Chaining methods
@@ -384,12 +382,13 @@ NSString *const OSSTaskMultipleExceptionsUserInfoKey = @"exceptions";
 - (OSSTask *)continueWithExecutor:(OSSExecutor *)executor
                            block:(OSSContinuationBlock)block
                cancellationToken:(nullable OSSCancellationToken *)cancellationToken {
-    OSSTaskCompletionSource *tcs = [OSSTaskCompletionSource taskCompletionSource];
+    // the task is completed directly, no completion source is needed for it
+    OSSTask *continuationTask = [[OSSTask alloc] init];
 
     // Capture all of the state that needs to used when the continuation is complete.
     dispatch_block_t executionBlock = ^{
         if (cancellationToken.cancellationRequested) {
-            [tcs cancel];
+            [continuationTask trySetCancelled];
             return;
         }
 
@@ -397,54 +396,67 @@ NSString *const OSSTaskMultipleExceptionsUserInfoKey = @"exceptions";
         @try {
             result = block(self);
         } @catch (NSException *exception) {
-            tcs.exception = exception;
+            [continuationTask trySetException:exception];
             OSSLogError(@"exception name: %@",[exception name]);
             OSSLogError(@"exception reason: %@",[exception reason]);
             return;
         }
 
         if ([result isKindOfClass:[OSSTask class]]) {
-
-            id (^setupWithTask) (OSSTask *) = ^id(OSSTask *task) {
-                if (cancellationToken.cancellationRequested || task.cancelled) {
-                    [tcs cancel];
-                } else if (task.exception) {
-                    tcs.exception = task.exception;
-                } else if (task.error) {
-                    tcs.error = task.error;
-                } else {
-                    tcs.result = task.result;
-                }
-                return nil;
-            };
-
             OSSTask *resultTask = (OSSTask *)result;
-
             if (resultTask.completed) {
-                setupWithTask(resultTask);
+                [continuationTask completeWithTask:resultTask cancellationToken:cancellationToken];
             } else {
-                [resultTask continueWithBlock:setupWithTask];
+                [resultTask continueWithBlock:^id(OSSTask *task) {
+                    [continuationTask completeWithTask:task cancellationToken:cancellationToken];
+                    return nil;
+                }];
             }
-
         } else {
-            tcs.result = result;
+            [continuationTask trySetResult:result];
         }
     };
 
+    // a completed task runs the continuation at once, without taking the lock
+    if (self.completed) {
+        [executor execute:executionBlock];
+        return continuationTask;
+    }
+
     BOOL completed;
-    @synchronized(self.lock) {
-        completed = self.completed;
-        if (!completed) {
-            [self.callbacks addObject:[^{
-                [executor execute:executionBlock];
-            } copy]];
+    pthread_mutex_lock(&_lock);
+    completed = atomic_load_explicit(&_completed, memory_order_relaxed);
+    if (!completed) {
+        if (!_continuationBlock) {
+            _continuationExecutor = executor;
+            _continuationBlock = executionBlock;
+        } else {
+            if (!_moreContinuations) {
+                _moreContinuations = [NSMutableArray array];
+            }
+            [_moreContinuations addObject:executor];
+            [_moreContinuations addObject:executionBlock];
         }
     }
+    pthread_mutex_unlock(&_lock);
     if (completed) {
         [executor execute:executionBlock];
     }
 
-    return tcs.task;
+    return continuationTask;
+}
+
+/* completes the task as the task returned by its continuation */
+- (void)completeWithTask:(OSSTask *)task cancellationToken:(nullable OSSCancellationToken *)cancellationToken {
+    if (cancellationToken.cancellationRequested || task.cancelled) {
+        [self trySetCancelled];
+    } else if (task.exception) {
+        [self trySetException:task.exception];
+    } else if (task.error) {
+        [self trySetError:task.error];
+    } else {
+        [self trySetResult:task.result];
+    }
 }
 
 - (OSSTask *)continueWithBlock:(OSSContinuationBlock)block {
@@ -495,33 +507,26 @@ NSString *const OSSTaskMultipleExceptionsUserInfoKey = @"exceptions";
         [self warnOperationOnMainThread];
     }
 
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return;
-        }
-        [self.condition lock];
+    if (self.completed) {
+        return;
     }
-    while (!self.completed) {
-        [self.condition wait];
+    pthread_mutex_lock(&_lock);
+    _waiterCount++;
+    while (!atomic_load_explicit(&_completed, memory_order_relaxed)) {
+        pthread_cond_wait(&_condition, &_lock);
     }
-    [self.condition unlock];
+    _waiterCount--;
+    pthread_mutex_unlock(&_lock);
 }
 
 #pragma mark - NSObject
 
 - (NSString *)description {
     // Acquire the data from the locked properties
-    BOOL completed;
-    BOOL cancelled;
-    BOOL faulted;
-    NSString *resultDescription = nil;
-
-    @synchronized(self.lock) {
-        completed = self.completed;
-        cancelled = self.cancelled;
-        faulted = self.faulted;
-        resultDescription = completed ? [NSString stringWithFormat:@" result = %@", self.result] : @"";
-    }
+    BOOL completed = self.completed;
+    BOOL cancelled = self.cancelled;
+    BOOL faulted = self.faulted;
+    NSString *resultDescription = completed ? [NSString stringWithFormat:@" result = %@", self.result] : @"";
 
     // Description string includes status information and, if available, the
     // result since in some ways this is what a promise actually "is".
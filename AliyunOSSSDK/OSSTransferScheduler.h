@@ -0,0 +1,68 @@
+//
+//  OSSTransferScheduler.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "OSSModel.h"
+
+@class OSSNetworkingRequestDelegate;
+@class OSSTask;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Decides when the requests of a client are sent, so that its transfers share the link by priority
+ instead of competing for it.
+
+ A request waits until it fits the budgets: maxRequestCount requests in flight, maxInFlightBytes
+ bytes being uploaded, and maxBandwidth bytes per second. The waiting requests are sent by
+ priority, then in the order they were scheduled. A request is always sent when nothing else is
+ in flight, however large it is.
+
+ The bandwidth cap is applied when requests are sent, not on their bytes: a request is sent while
+ the bytes sent in the last second are under the cap, and the bytes it transfers are owed before
+ the next one. The bytes downloaded are counted once the response is received.
+
+ While the network is lost, the bulk requests wait, the others are sent and fail or wait for the network
+ as usual. They're all sent as soon as the network is back.
+ */
+@interface OSSTransferScheduler : NSObject
+
+/**
+ Max requests in flight, 0 for no limit.
+ */
+@property (atomic, assign) NSUInteger maxRequestCount;
+
+/**
+ Max request bytes in flight, 0 for no limit.
+ */
+@property (atomic, assign) int64_t maxInFlightBytes;
+
+/**
+ Max bytes per second uploaded and downloaded, 0 for no limit.
+ */
+@property (atomic, assign) int64_t maxBandwidth;
+
+/**
+ The requests in flight and waiting.
+ */
+@property (atomic, assign, readonly) NSUInteger runningCount;
+@property (atomic, assign, readonly) NSUInteger waitingCount;
+
+/**
+ The priority the request is sent with, its own unless it's OSSRequestPriorityDefault.
+ */
++ (OSSRequestPriority)priorityOfRequest:(OSSNetworkingRequestDelegate *)request;
+
+/**
+ Calls the send block once the request's turn comes, and returns a task completing as the sent one.
+ A request cancelled while it waits fails with the cancel error without being sent.
+ */
+- (OSSTask *)scheduleRequest:(OSSNetworkingRequestDelegate *)request send:(OSSTask * (^)(void))send;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,287 @@
+//
+//  OSSTransferScheduler.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSTransferScheduler.h"
+#import "OSSNetworking.h"
+#import "OSSDefine.h"
+#import "OSSBolts.h"
+#import "OSSLog.h"
+#import "OSSReachabilityManager.h"
+
+@interface OSSScheduledTransfer : NSObject
+
+@property (nonatomic, strong) OSSNetworkingRequestDelegate * request;
+@property (nonatomic, copy) OSSTask * (^send)(void);
+@property (nonatomic, strong) OSSTaskCompletionSource * completionSource;
+@property (nonatomic, assign) OSSRequestPriority priority;
+@property (nonatomic, assign) int64_t bytes;
+
+@end
+
+@implementation OSSScheduledTransfer
+@end
+
+@implementation OSSTransferScheduler {
+    /* the waiting transfers, one queue per priority from bulk to interactive */
+    NSArray<NSMutableArray<OSSScheduledTransfer *> *> * _queues;
+    NSUInteger _runningCount;
+    int64_t _inFlightBytes;
+
+    /* the bytes which may be sent now, negative while the last transfers are still owed */
+    double _bandwidthTokens;
+    CFAbsoluteTime _lastRefillTime;
+    BOOL _isRefillScheduled;
+
+    BOOL _isOffline;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _queues = @[[NSMutableArray new], [NSMutableArray new], [NSMutableArray new]];
+        OSSReachabilityManager * reachabilityManager = [OSSReachabilityManager shareInstance];
+        _isOffline = !reachabilityManager.isReachable;
+        // the changes of the device, and the ones posted to this scheduler only, e.g. by the tests
+        for (id object in @[reachabilityManager, self]) {
+            [[NSNotificationCenter defaultCenter] addObserver:self
+                                                     selector:@selector(reachabilityDidChange:)
+                                                         name:OSSReachabilityChangedNotification
+                                                       object:object];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
++ (OSSRequestPriority)priorityOfRequest:(OSSNetworkingRequestDelegate *)request {
+    if (request.priority != OSSRequestPriorityDefault) {
+        return request.priority;
+    }
+    switch (request.operType) {
+        case OSSOperationTypeGetObject:
+        case OSSOperationTypeHeadObject:
+            return OSSRequestPriorityInteractive;
+        case OSSOperationTypeUploadPart:
+            return OSSRequestPriorityBulk;
+        default:
+            return OSSRequestPriorityNormal;
+    }
+}
+
+- (NSUInteger)runningCount {
+    @synchronized(self) {
+        return _runningCount;
+    }
+}
+
+- (NSUInteger)waitingCount {
+    @synchronized(self) {
+        NSUInteger count = 0;
+        for (NSArray * queue in _queues) {
+            count += queue.count;
+        }
+        return count;
+    }
+}
+
+- (OSSTask *)scheduleRequest:(OSSNetworkingRequestDelegate *)request send:(OSSTask * (^)(void))send {
+    OSSScheduledTransfer * transfer = [OSSScheduledTransfer new];
+    transfer.request = request;
+    transfer.send = send;
+    transfer.completionSource = [OSSTaskCompletionSource taskCompletionSource];
+    transfer.priority = [OSSTransferScheduler priorityOfRequest:request];
+    transfer.bytes = [self requestBytesOfRequest:request];
+
+    __weak OSSTransferScheduler * weakSelf = self;
+    __weak OSSScheduledTransfer * weakTransfer = transfer;
+    request.cancellationHandler = ^{
+        [weakSelf cancelTransfer:weakTransfer];
+    };
+    @synchronized(self) {
+        [[self queueOfPriority:transfer.priority] addObject:transfer];
+    }
+    if (request.isRequestCancelled) {
+        [self cancelTransfer:transfer];
+    }
+
+    [self sendTransfers];
+    return transfer.completionSource.task;
+}
+
+# pragma mark - Private Methods
+
+- (void)reachabilityDidChange:(NSNotification *)notification {
+    OSSNetworkStatus status = [notification.userInfo[OSSReachabilityStatusKey] integerValue];
+    @synchronized(self) {
+        _isOffline = status == OSSNetworkStatusNotReachable;
+    }
+    if (status != OSSNetworkStatusNotReachable) {
+        [self sendTransfers];
+    }
+}
+
+- (NSMutableArray<OSSScheduledTransfer *> *)queueOfPriority:(OSSRequestPriority)priority {
+    NSUInteger index = MIN(MAX(priority, OSSRequestPriorityBulk), OSSRequestPriorityInteractive) - OSSRequestPriorityBulk;
+    return _queues[index];
+}
+
+- (void)sendTransfers {
+    NSMutableArray<OSSScheduledTransfer *> * admitted = [NSMutableArray array];
+    @synchronized(self) {
+        [self refillBandwidthTokensLocked];
+        while (YES) {
+            OSSScheduledTransfer * transfer = nil;
+            for (NSMutableArray * queue in _queues.reverseObjectEnumerator) {
+                transfer = queue.firstObject;
+                if (transfer) {
+                    break;
+                }
+            }
+            // the first transfer of the highest priority goes first, nothing overtakes it
+            if (!transfer || ![self canSendTransferLocked:transfer]) {
+                break;
+            }
+
+            [[self queueOfPriority:transfer.priority] removeObjectAtIndex:0];
+            _runningCount++;
+            _inFlightBytes += transfer.bytes;
+            if (self.maxBandwidth > 0) {
+                _bandwidthTokens -= transfer.bytes;
+            }
+            [admitted addObject:transfer];
+        }
+    }
+
+    for (OSSScheduledTransfer * transfer in admitted) {
+        [self startTransfer:transfer];
+    }
+}
+
+- (BOOL)canSendTransferLocked:(OSSScheduledTransfer *)transfer {
+    if (_isOffline && transfer.priority <= OSSRequestPriorityBulk) {
+        return NO;
+    }
+    NSUInteger maxRequestCount = self.maxRequestCount;
+    if (maxRequestCount > 0 && _runningCount >= maxRequestCount) {
+        return NO;
+    }
+    int64_t maxInFlightBytes = self.maxInFlightBytes;
+    if (maxInFlightBytes > 0 && _runningCount > 0 && _inFlightBytes + transfer.bytes > maxInFlightBytes) {
+        return NO;
+    }
+    int64_t maxBandwidth = self.maxBandwidth;
+    if (maxBandwidth > 0 && _bandwidthTokens <= 0) {
+        if (!_isRefillScheduled) {
+            // try again once what's owed is paid back
+            _isRefillScheduled = YES;
+            NSTimeInterval delay = MAX(-_bandwidthTokens / maxBandwidth, 0.01);
+            __weak OSSTransferScheduler * weakSelf = self;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                OSSTransferScheduler * strongSelf = weakSelf;
+                if (strongSelf) {
+                    @synchronized(strongSelf) {
+                        strongSelf->_isRefillScheduled = NO;
+                    }
+                    [strongSelf sendTransfers];
+                }
+            });
+        }
+        return NO;
+    }
+    return YES;
+}
+
+- (void)refillBandwidthTokensLocked {
+    int64_t maxBandwidth = self.maxBandwidth;
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    if (maxBandwidth <= 0) {
+        _bandwidthTokens = 0;
+    } else if (_lastRefillTime == 0) {
+        _bandwidthTokens = maxBandwidth;
+    } else {
+        // at most a second of bandwidth is saved up
+        _bandwidthTokens = MIN(_bandwidthTokens + (now - _lastRefillTime) * maxBandwidth, maxBandwidth);
+    }
+    _lastRefillTime = maxBandwidth > 0 ? now : 0;
+}
+
+- (void)startTransfer:(OSSScheduledTransfer *)transfer {
+    OSSNetworkingRequestDelegate * request = transfer.request;
+    // from now on, cancelling it cancels its session task
+    request.cancellationHandler = nil;
+    OSSTask * task = request.isRequestCancelled ? [OSSTask taskWithError:[self cancelError]] : transfer.send();
+
+    [task continueWithBlock:^id(OSSTask * sentTask) {
+        int64_t responseBytes = [self responseBytesOfRequest:request task:sentTask];
+        @synchronized(self) {
+            self->_runningCount--;
+            self->_inFlightBytes -= transfer.bytes;
+            if (self.maxBandwidth > 0) {
+                self->_bandwidthTokens -= responseBytes;
+            }
+        }
+
+        if (sentTask.error) {
+            [transfer.completionSource trySetError:sentTask.error];
+        } else if (sentTask.exception) {
+            [transfer.completionSource trySetException:sentTask.exception];
+        } else if (sentTask.cancelled) {
+            [transfer.completionSource trySetCancelled];
+        } else {
+            [transfer.completionSource trySetResult:sentTask.result];
+        }
+        [self sendTransfers];
+        return nil;
+    }];
+}
+
+- (void)cancelTransfer:(OSSScheduledTransfer *)transfer {
+    if (!transfer) {
+        return;
+    }
+    BOOL wasWaiting = NO;
+    @synchronized(self) {
+        NSMutableArray * queue = [self queueOfPriority:transfer.priority];
+        wasWaiting = [queue containsObject:transfer];
+        [queue removeObject:transfer];
+    }
+    if (wasWaiting) {
+        OSSLogDebug(@"a waiting request is cancelled");
+        transfer.request.cancellationHandler = nil;
+        [transfer.completionSource trySetError:[self cancelError]];
+    }
+}
+
+- (int64_t)requestBytesOfRequest:(OSSNetworkingRequestDelegate *)request {
+    if (request.uploadingData) {
+        return request.uploadingData.length;
+    }
+    if (request.uploadingFileURL) {
+        NSDictionary * attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:request.uploadingFileURL.path error:nil];
+        return [attributes[NSFileSize] longLongValue];
+    }
+    // the length of a streaming body isn't known before it's sent
+    return 0;
+}
+
+- (int64_t)responseBytesOfRequest:(OSSNetworkingRequestDelegate *)request task:(OSSTask *)task {
+    if (![task.result isKindOfClass:[OSSResult class]] || ![request.allNeededMessage.httpMethod isEqualToString:@"GET"]) {
+        return 0;
+    }
+    OSSResult * result = task.result;
+    return [result.httpResponseHeaderFields[@"Content-Length"] longLongValue];
+}
+
+- (NSError *)cancelError {
+    return [NSError errorWithDomain:OSSClientErrorDomain
+                               code:OSSClientErrorCodeTaskCancelled
+                           userInfo:@{OSSErrorMessageTOKEN: @"This task has been cancelled!"}];
+}
+
+@end
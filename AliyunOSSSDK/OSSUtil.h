@@ -16,7 +16,10 @@
 + (NSString *)calBase64Sha1WithData:(NSString *)data withSecret:(NSString *)key;
 + (NSString *)calBase64WithData:(uint8_t *)data;
 + (NSString *)encodeURL:(NSString *)url;
+/* appends the encodeURL: form of url without creating it */
++ (void)appendEncodedURL:(NSString *)url toString:(NSMutableString *)string;
 + (NSData *)constructHttpBodyFromPartInfos:(NSArray *)partInfos;
++ (NSData *)constructHttpBodyForDeleteMultipleObjects:(NSArray<NSString *> *)keys quiet:(BOOL)quiet;
 + (NSData *)constructHttpBodyForCreateBucketWithLocation:(NSString *)location __attribute__((deprecated("deprecated!")));
 + (BOOL)validateBucketName:(NSString *)bucketName;
 + (BOOL)validateObjectKey:(NSString *)objectKey;
@@ -42,6 +45,17 @@
 
 + (uint64_t)crc64ecma:(uint64_t)crc1 buffer:(void *)buffer length:(size_t)len;
 
+/**
+ * @brief: crc64 by the portable lookup table, crc64ecma:buffer:length: uses
+ * carry-less multiply instead when the cpu supports it.
+ */
++ (uint64_t)crc64ecmaByTable:(uint64_t)crc1 buffer:(void *)buffer length:(size_t)len;
+
+/**
+ * @brief: whether crc64ecma:buffer:length: runs on PMULL/PCLMULQDQ
+ */
++ (BOOL)isCrc64HardwareAccelerated;
+
 /**
  * @brief: combine crc1 and crc2
  */
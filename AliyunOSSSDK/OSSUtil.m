@@ -15,9 +15,12 @@
 #import "OSSHttpdns.h"
 #import "OSSIPv6Adapter.h"
 #import "OSSReachability.h"
+#import "OSSReachabilityManager.h"
 #import <CoreTelephony/CTCarrier.h>
 #import <CoreTelephony/CTTelephonyNetworkInfo.h>
 #import "aos_crc64.h"
+#import "OSSXMLDictionary.h"
+#import "OSSInputStreamHelper.h"
 
 NSString * const ALIYUN_HOST_SUFFIX = @".aliyuncs.com";
 NSString * const ALIYUN_OSS_TEST_ENDPOINT = @".aliyun-inc.com";
@@ -25,11 +28,46 @@ int32_t const CHUNK_SIZE = 8 * 1024;
 
 @implementation OSSUtil
 
+// the keyed HMAC state of a secret is computed once and copied for each signature. The states are
+// keyed by a digest of their secret, so the cache doesn't keep the secrets themselves
+static const NSUInteger oss_hmac_context_cache_limit = 8;
+
 + (NSString *)calBase64Sha1WithData:(NSString *)data withSecret:(NSString *)key {
-    NSData *secretData = [key dataUsingEncoding:NSUTF8StringEncoding];
+    static NSMutableDictionary<NSData *, NSData *> *hmacContextCache = nil;
+    // the oldest use first, it's the one evicted
+    static NSMutableArray<NSData *> *hmacContextOrder = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        hmacContextCache = [NSMutableDictionary dictionary];
+        hmacContextOrder = [NSMutableArray array];
+    });
+
+    CCHmacContext context;
+    NSData *secretData = [(key ?: @"") dataUsingEncoding:NSUTF8StringEncoding];
+    uint8_t secretDigest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(secretData.bytes, (CC_LONG)secretData.length, secretDigest);
+    NSData *cacheKey = [NSData dataWithBytes:secretDigest length:sizeof(secretDigest)];
+    @synchronized(hmacContextCache) {
+        NSData *cachedContext = hmacContextCache[cacheKey];
+        if (cachedContext) {
+            memcpy(&context, cachedContext.bytes, sizeof(context));
+            [hmacContextOrder removeObject:cacheKey];
+        } else {
+            CCHmacInit(&context, kCCHmacAlgSHA1, [secretData bytes], [secretData length]);
+            if (hmacContextOrder.count >= oss_hmac_context_cache_limit) {
+                [hmacContextCache removeObjectForKey:hmacContextOrder.firstObject];
+                [hmacContextOrder removeObjectAtIndex:0];
+            }
+            hmacContextCache[cacheKey] = [NSData dataWithBytes:&context length:sizeof(context)];
+        }
+        [hmacContextOrder addObject:cacheKey];
+    }
+
     NSData *clearTextData = [data dataUsingEncoding:NSUTF8StringEncoding];
-    uint8_t input[20];
-    CCHmac(kCCHmacAlgSHA1, [secretData bytes], [secretData length], [clearTextData bytes], [clearTextData length], input);
+    uint8_t input[CC_SHA1_DIGEST_LENGTH];
+    CCHmacUpdate(&context, [clearTextData bytes], [clearTextData length]);
+    CCHmacFinal(&context, input);
+    memset(&context, 0, sizeof(context));
 
     return [self calBase64WithData:input];
 }
@@ -67,46 +105,106 @@ int32_t const CHUNK_SIZE = 8 * 1024;
     return result;
 }
 
-+ (NSString *)encodeURL:(NSString *)url {
-    //保持和android处理方式一致，添加+ -> %20，* -> %2A，%7E -> ~, "%2F" -> /
-    NSMutableString *output = [NSMutableString string];
-    const unsigned char *source = (const unsigned char *)[url UTF8String];
-    NSUInteger sourceLen = strlen((const char *)source);
-    for (int i = 0; i < sourceLen; ++i) {
-        const unsigned char thisChar = source[i];
-        if (thisChar == ' ') {
-            [output appendString:@"%20"];
-        } else if (thisChar == '*') {
-            [output appendString:@"%2A"];
-        } else if (thisChar == '.' || thisChar == '-' || thisChar == '_' || thisChar == '~' ||
-                   (thisChar >= 'a' && thisChar <= 'z') ||
-                   (thisChar >= 'A' && thisChar <= 'Z') ||
-                   (thisChar >= '0' && thisChar <= '9')) {
-            [output appendFormat:@"%c", thisChar];
+//保持和android处理方式一致: ' ' -> %20, '*' -> %2A, '/' 和 '~' 不编码
+//不要用系统urlencode 的方式，很多特殊字符都没有转化；
+//详见：https://stackoverflow.com/questions/8088473/how-do-i-url-encode-a-string
+static BOOL oss_urlUnescapedBytes[256];
+static const char oss_urlHexDigits[] = "0123456789ABCDEF";
+
+/* escapes the bytes into buffer, which has room for 3 bytes per byte and the NUL, and returns the length written */
+static size_t oss_encodeURLBytes(const unsigned char *source, size_t length, char *buffer) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        const char *unescaped = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.-_~/";
+        for (const char *c = unescaped; *c; c++) {
+            oss_urlUnescapedBytes[(unsigned char)*c] = YES;
+        }
+    });
+
+    char *output = buffer;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = source[i];
+        if (oss_urlUnescapedBytes[c]) {
+            *output++ = (char)c;
         } else {
-            [output appendFormat:@"%%%02X", thisChar];
+            *output++ = '%';
+            *output++ = oss_urlHexDigits[c >> 4];
+            *output++ = oss_urlHexDigits[c & 0x0F];
         }
     }
-    NSString *encodeUrl = [output stringByReplacingOccurrencesOfString:@"%2F" withString:@"/"];
-    encodeUrl = [encodeUrl stringByReplacingOccurrencesOfString:@"%7E" withString:@"~"];
-    return encodeUrl;
+    *output = '\0';
+    return output - buffer;
+}
 
-    
-//  不要用系统urlencode 的方式，很多特殊字符都没有转化；
-//  详见：https://stackoverflow.com/questions/8088473/how-do-i-url-encode-a-string
+/* calls the block with the escaped bytes of the string, in a stack buffer for the usual keys */
+static void oss_withEncodedURL(NSString *url, void (^block)(const char *encoded, size_t encodedLength, size_t sourceLength)) {
+    const char *source = url.UTF8String;
+    size_t length = source ? strlen(source) : 0;
+    char stackBuffer[1024];
+    char *buffer = length * 3 < sizeof(stackBuffer) ? stackBuffer : malloc(length * 3 + 1);
+    size_t encodedLength = oss_encodeURLBytes((const unsigned char *)source, length, buffer);
+    block(buffer, encodedLength, length);
+    if (buffer != stackBuffer) {
+        free(buffer);
+    }
+}
+
++ (NSString *)encodeURL:(NSString *)url {
+    __block NSString *encodeUrl = nil;
+    oss_withEncodedURL(url, ^(const char *encoded, size_t encodedLength, size_t sourceLength) {
+        // nothing escaped, the string is its own encoding
+        encodeUrl = encodedLength == sourceLength ? [url copy] : [[NSString alloc] initWithBytes:encoded length:encodedLength encoding:NSASCIIStringEncoding];
+    });
+    return encodeUrl ?: @"";
+}
+
++ (void)appendEncodedURL:(NSString *)url toString:(NSMutableString *)string {
+    oss_withEncodedURL(url, ^(const char *encoded, size_t encodedLength, size_t sourceLength) {
+        CFStringAppendCString((__bridge CFMutableStringRef)string, encoded, kCFStringEncodingASCII);
+    });
+}
+
+static void oss_appendLiteral(NSMutableData *data, const char *literal) {
+    [data appendBytes:literal length:strlen(literal)];
+}
 
+/* the decimal digits of value, without going through a format string */
+static void oss_appendUnsignedInteger(NSMutableData *data, unsigned long long value) {
+    char digits[20];
+    char *start = digits + sizeof(digits);
+    do {
+        *--start = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    [data appendBytes:start length:digits + sizeof(digits) - start];
 }
 
 + (NSData *)constructHttpBodyFromPartInfos:(NSArray *)partInfos {
-    NSMutableString * body = [NSMutableString stringWithString:@"<CompleteMultipartUpload>\n"];
-    [partInfos enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
+    // written straight as UTF-8 bytes, a part takes less than 96 of them
+    NSMutableData * body = [NSMutableData dataWithCapacity:64 + partInfos.count * 96];
+    oss_appendLiteral(body, "<CompleteMultipartUpload>\n");
+    for (id obj in partInfos) {
         if ([obj isKindOfClass:[OSSPartInfo class]]) {
             OSSPartInfo * thePart = obj;
-            [body appendFormat:@"<Part>\n<PartNumber>%d</PartNumber>\n<ETag>%@</ETag>\n</Part>\n", thePart.partNum, thePart.eTag];
+            const char * eTag = thePart.eTag.UTF8String ?: "(null)";
+            oss_appendLiteral(body, "<Part>\n<PartNumber>");
+            oss_appendUnsignedInteger(body, (uint32_t)thePart.partNum);
+            oss_appendLiteral(body, "</PartNumber>\n<ETag>");
+            oss_appendLiteral(body, eTag);
+            oss_appendLiteral(body, "</ETag>\n</Part>\n");
         }
-    }];
-    [body appendString:@"</CompleteMultipartUpload>\n"];
-    OSSLogVerbose(@"constucted complete multipart upload body:\n%@", body);
+    }
+    oss_appendLiteral(body, "</CompleteMultipartUpload>\n");
+    OSSLogVerbose(@"constucted complete multipart upload body:\n%@", [[NSString alloc] initWithData:body encoding:NSUTF8StringEncoding]);
+    return body;
+}
+
++ (NSData *)constructHttpBodyForDeleteMultipleObjects:(NSArray<NSString *> *)keys quiet:(BOOL)quiet {
+    NSMutableString * body = [NSMutableString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Delete>\n<Quiet>%@</Quiet>\n", quiet ? @"true" : @"false"];
+    for (NSString * key in keys) {
+        [body appendFormat:@"<Object><Key>%@</Key></Object>\n", [key oss_XMLEncodedString]];
+    }
+    [body appendString:@"</Delete>\n"];
     return [body dataUsingEncoding:NSUTF8StringEncoding];
 }
 
@@ -166,7 +264,41 @@ int32_t const CHUNK_SIZE = 8 * 1024;
     return ip ? [[OSSIPv6Adapter getInstance] handleIpv4Address:ip] : host;
 }
 
+// the system proxy state only changes with the network, so it's probed again after a network change or once it gets old
+static const NSTimeInterval oss_proxy_state_max_age = 30;
+static BOOL oss_proxy_state_cached = NO;
+static BOOL oss_proxy_state_value = NO;
+static CFAbsoluteTime oss_proxy_state_time = 0;
+
 + (BOOL)isNetworkDelegateState {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        [OSSReachabilityManager shareInstance];
+        [[NSNotificationCenter defaultCenter] addObserverForName:OSSReachabilityChangedNotification
+                                                          object:nil
+                                                           queue:nil
+                                                      usingBlock:^(NSNotification * _Nonnull note) {
+                                                          @synchronized([OSSUtil class]) {
+                                                              oss_proxy_state_cached = NO;
+                                                          }
+                                                      }];
+    });
+
+    @synchronized([OSSUtil class]) {
+        if (oss_proxy_state_cached && CFAbsoluteTimeGetCurrent() - oss_proxy_state_time < oss_proxy_state_max_age) {
+            return oss_proxy_state_value;
+        }
+    }
+    BOOL isDelegateState = [self probeNetworkDelegateState];
+    @synchronized([OSSUtil class]) {
+        oss_proxy_state_value = isDelegateState;
+        oss_proxy_state_time = CFAbsoluteTimeGetCurrent();
+        oss_proxy_state_cached = YES;
+    }
+    return isDelegateState;
+}
+
++ (BOOL)probeNetworkDelegateState {
     NSURL* URL = [[NSURL alloc] initWithString:@"https://m.aliyun.com"];
     NSDictionary *proxySettings = CFBridgingRelease(CFNetworkCopySystemProxySettings());
     NSArray *proxies = nil;
@@ -207,15 +339,9 @@ int32_t const CHUNK_SIZE = 8 * 1024;
     }
     CC_MD5_CTX md5;
     CC_MD5_Init(&md5);
-    for (int i = 0; i < data.length; i += CHUNK_SIZE) {
-        NSData *subdata = nil;
-        if (i <= ((long)data.length - CHUNK_SIZE)) {
-            subdata = [data subdataWithRange:NSMakeRange(i, CHUNK_SIZE)];
-            CC_MD5_Update(&md5, [subdata bytes], (CC_LONG)[subdata length]);
-        } else {
-            subdata = [data subdataWithRange:NSMakeRange(i, data.length - i)];
-            CC_MD5_Update(&md5, [subdata bytes], (CC_LONG)[subdata length]);
-        }
+    const uint8_t *bytes = data.bytes;
+    for (NSUInteger i = 0; i < data.length; i += CHUNK_SIZE) {
+        CC_MD5_Update(&md5, bytes + i, (CC_LONG)MIN(CHUNK_SIZE, data.length - i));
     }
     unsigned char digestResult[CC_MD5_DIGEST_LENGTH * sizeof(unsigned char)];
     CC_MD5_Final(digestResult, &md5);
@@ -223,25 +349,13 @@ int32_t const CHUNK_SIZE = 8 * 1024;
 }
 
 + (NSData *)fileMD5:(NSString*)path {
-    NSFileHandle *handle = [NSFileHandle fileHandleForReadingAtPath:path];
-    if(handle == nil) {
+    if (![[NSFileManager defaultManager] isReadableFileAtPath:path]) {
         return nil;
     }
-    CC_MD5_CTX md5;
-    CC_MD5_Init(&md5);
-    BOOL done = NO;
-    while(!done) {
-        @autoreleasepool{
-            NSData* fileData = [handle readDataOfLength: CHUNK_SIZE];
-            CC_MD5_Update(&md5, [fileData bytes], (CC_LONG)[fileData length]);
-            if([fileData length] == 0) {
-                done = YES;
-            }
-        }
-    }
-    unsigned char digestResult[CC_MD5_DIGEST_LENGTH * sizeof(unsigned char)];
-    CC_MD5_Final(digestResult, &md5);
-    return [NSData dataWithBytes:(const void *)digestResult length:CC_MD5_DIGEST_LENGTH * sizeof(unsigned char)];
+    OSSInputStreamHelper *helper = [[OSSInputStreamHelper alloc] initWithFileAtPath:path];
+    helper.digestTypes = OSSDigestTypeMD5;
+    [helper syncReadBuffers];
+    return helper.md5;
 }
 
 + (NSString *)convertMd5Bytes2String:(unsigned char *)md5Bytes {
@@ -274,21 +388,21 @@ int32_t const CHUNK_SIZE = 8 * 1024;
 
 + (BOOL)isSubresource:(NSString *)param {
     /****************************************************************
-    * define a constant array to contain all specified subresource */
-    static NSArray * OSSSubResourceARRAY = nil;
+    * define a constant set to contain all specified subresource */
+    static NSSet * OSSSubResourceSET = nil;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
-        OSSSubResourceARRAY = @[
+        OSSSubResourceSET = [NSSet setWithArray:@[
             @"acl", @"uploads", @"location", @"cors", @"logging", @"website", @"referer", @"lifecycle", @"delete", @"append",
             @"tagging", @"objectMeta", @"uploadId", @"partNumber", @"security-token", @"position", @"img", @"style",
             @"styleName", @"replication", @"replicationProgress", @"replicationLocation", @"cname", @"bucketInfo", @"comp",
             @"qos", @"live", @"status", @"vod", @"startTime", @"endTime", @"symlink", @"x-oss-process", @"response-content-type",
             @"response-content-language", @"response-expires", @"response-cache-control", @"response-content-disposition", @"response-content-encoding"
-            ];
+            ]];
     });
     /****************************************************************/
 
-    return [OSSSubResourceARRAY containsObject:param];
+    return [OSSSubResourceSET containsObject:param];
 }
 
 + (NSString *)populateSubresourceStringFromParameter:(NSDictionary *)parameters {
@@ -1098,6 +1212,16 @@ int32_t const CHUNK_SIZE = 8 * 1024;
     return aos_crc64(crc1, buffer, len);
 }
 
++ (uint64_t)crc64ecmaByTable:(uint64_t)crc1 buffer:(void *)buffer length:(size_t)len
+{
+    return aos_crc64_table(crc1, buffer, len);
+}
+
++ (BOOL)isCrc64HardwareAccelerated
+{
+    return aos_crc64_accelerated() != 0;
+}
+
 + (uint64_t)crc64ForCombineCRC1:(uint64_t)crc1 CRC2:(uint64_t)crc2 length:(size_t)len2
 {
     return aos_crc64_combine(crc1, crc2, len2);
@@ -1141,41 +1265,13 @@ int32_t const CHUNK_SIZE = 8 * 1024;
 
 + (NSString *)sha1WithFilePath:(NSString *)filePath
 {
-    NSFileHandle *handle = [NSFileHandle fileHandleForReadingAtPath:filePath];
-    if(!handle) {
+    if (![[NSFileManager defaultManager] isReadableFileAtPath:filePath]) {
         return nil;
     }
-    CC_SHA1_CTX sha1;
-    CC_SHA1_Init(&sha1);
-    BOOL done = NO;
-    unsigned char *digest = NULL;
-    
-    while(!done) {
-        @autoreleasepool{
-            NSData* fileData = [handle readDataOfLength: CHUNK_SIZE];
-            if(fileData.length == 0) {
-                done = YES;
-                break;
-            }
-            // Malloc a buffer to hold hash.
-            digest = malloc(CC_SHA1_DIGEST_LENGTH * sizeof(unsigned char));
-            memset(digest, 0x0, CC_SHA1_DIGEST_LENGTH);
-
-            CC_SHA1_Update(&sha1, fileData.bytes, (CC_LONG)[fileData length]);
-        }
-    }
-    
-    // Malloc a buffer to hold hash.
-    digest = malloc(CC_SHA1_DIGEST_LENGTH * sizeof(unsigned char));
-    memset(digest, 0x0, CC_SHA1_DIGEST_LENGTH);
-    CC_SHA1_Final(digest, &sha1);
-    
-    NSString *result = [self sha1WithDigest:digest];
-    if (digest) {
-        free(digest);
-    }
-    
-    return result;
+    OSSInputStreamHelper *helper = [[OSSInputStreamHelper alloc] initWithFileAtPath:filePath];
+    helper.digestTypes = OSSDigestTypeSHA1;
+    [helper syncReadBuffers];
+    return helper.sha1String;
 }
 
 + (NSData *)constructHttpBodyForTriggerCallback:(NSString *)callbackParams callbackVaribles:(NSString *)callbackVaribles
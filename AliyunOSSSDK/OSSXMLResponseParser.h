@@ -0,0 +1,50 @@
+//
+//  OSSXMLResponseParser.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "OSSModel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Streaming parsers of the XML response bodies.
+
+ The body is fed chunk by chunk while it's being received, and the result object is
+ filled directly, without collecting the body or building a generic dictionary tree first.
+ The list entries (Contents, CommonPrefixes, Part) have the same layout as the ones
+ NSDictionary (OSSXMLDictionary) produced, so the results are unchanged.
+ */
+@interface OSSXMLResponseParser : NSObject
+
+/**
+ The result being filled, e.g. an OSSGetBucketResult for ListBucketResult bodies.
+ */
+@property (nonatomic, strong, readonly) OSSResult * result;
+
+/**
+ Returns nil if the operation has no streaming parser.
+ */
++ (nullable instancetype)parserForOperationType:(OSSOperationType)operationType;
+
+/**
+ Returns NO once the body is malformed, the data fed afterwards is ignored.
+ */
+- (BOOL)feedData:(NSData *)data;
+
+/**
+ Returns NO if the body fed is not a complete document. The fields parsed so far are kept in the result.
+ */
+- (BOOL)finish;
+
+/**
+ Parses an error body into the dictionary of its fields (Code, Message, RequestId, HostId...).
+ */
++ (nullable NSDictionary *)errorDictionaryWithData:(NSData *)data;
+
+@end
+
+NS_ASSUME_NONNULL_END
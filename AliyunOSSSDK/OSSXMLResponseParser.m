@@ -0,0 +1,401 @@
+//
+//  OSSXMLResponseParser.m
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#import "OSSXMLResponseParser.h"
+#import "OSSDefine.h"
+#import "OSSLog.h"
+#import "oss_xml_stream.h"
+
+typedef struct {
+    const char * name;
+    __unsafe_unretained NSString * key;
+} OSSXMLKnownKey;
+
+/* the element names found in every entry, so that no key string is allocated for them */
+static const OSSXMLKnownKey oss_known_keys[] = {
+    {"Key", OSSKeyXMLTOKEN},
+    {"LastModified", OSSLastModifiedXMLTOKEN},
+    {"ETag", OSSETagXMLTOKEN},
+    {"Type", OSSTypeXMLTOKEN},
+    {"Size", OSSSizeXMLTOKEN},
+    {"StorageClass", OSSStorageClassXMLTOKEN},
+    {"Owner", OSSOwnerXMLTOKEN},
+    {"ID", OSSIDXMLTOKEN},
+    {"DisplayName", OSSDisplayNameXMLTOKEN},
+    {"Prefix", OSSPrefixXMLTOKEN},
+    {"PartNumber", OSSPartNumberXMLTOKEN},
+    {"Contents", OSSContentsXMLTOKEN},
+    {"CommonPrefixes", OSSCommonPrefixesXMLTOKEN},
+    {"Part", OSSPartXMLTOKEN},
+    {"Deleted", @"Deleted"},
+    {"Code", @"Code"},
+    {"Message", @"Message"},
+    {"RequestId", @"RequestId"},
+    {"HostId", @"HostId"},
+};
+
+static NSString * OSSXMLKeyForName(const char * name, size_t length) {
+    for (size_t i = 0; i < sizeof(oss_known_keys) / sizeof(oss_known_keys[0]); i++) {
+        const char * known = oss_known_keys[i].name;
+        if (strlen(known) == length && memcmp(known, name, length) == 0) {
+            return oss_known_keys[i].key;
+        }
+    }
+    return [[NSString alloc] initWithBytes:name length:length encoding:NSUTF8StringEncoding];
+}
+
+static NSString * OSSXMLValueForText(const char * text, size_t length) {
+    return [[NSString alloc] initWithBytes:text length:length encoding:NSUTF8StringEncoding];
+}
+
+/* same merging as OSSXMLDictionary: a repeated element turns into an array */
+static void OSSXMLSetValue(NSMutableDictionary * dict, NSString * key, id value) {
+    id existing = dict[key];
+    if ([existing isKindOfClass:[NSMutableArray class]]) {
+        [existing addObject:value];
+    } else if (existing) {
+        dict[key] = [NSMutableArray arrayWithObjects:existing, value, nil];
+    } else {
+        dict[key] = value;
+    }
+}
+
+static void oss_xml_on_start(void * ctx, const char * name, size_t name_len, int depth);
+static void oss_xml_on_end(void * ctx, const char * name, size_t name_len, const char * text, size_t text_len, int depth);
+
+@interface OSSXMLResponseParser ()
+@property (nonatomic, strong, readwrite) OSSResult * result;
+
+/* a leaf right under the root element */
+- (void)didParseField:(NSString *)name value:(NSString *)value;
+
+/* a child of the root element collected into a dictionary, e.g. one Contents */
+- (void)didParseItem:(NSDictionary *)item name:(NSString *)name;
+- (BOOL)isItemElement:(NSString *)name;
+- (void)didFinish;
+@end
+
+@interface OSSListBucketXMLParser : OSSXMLResponseParser
+@end
+
+@interface OSSListPartsXMLParser : OSSXMLResponseParser
+@end
+
+@interface OSSDeleteResultXMLParser : OSSXMLResponseParser
+@end
+
+@interface OSSErrorXMLParser : OSSXMLResponseParser
+@property (nonatomic, strong, readonly) NSMutableDictionary * fields;
+@end
+
+@implementation OSSXMLResponseParser {
+    oss_xml_stream_t * _stream;
+    BOOL _failed;
+
+    /* the item being collected: its dictionary first, then the nested elements having children */
+    NSString * _itemName;
+    NSMutableArray<NSMutableDictionary *> * _containers;
+    NSMutableArray<NSString *> * _containerKeys;
+
+    /* the innermost open element, which is a leaf unless a child starts */
+    NSString * _pendingKey;
+    int _pendingDepth;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        oss_xml_stream_handler_t handler = {oss_xml_on_start, oss_xml_on_end};
+        _stream = oss_xml_stream_create(&handler, (__bridge void *)self);
+        _failed = (_stream == NULL);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    oss_xml_stream_free(_stream);
+}
+
++ (instancetype)parserForOperationType:(OSSOperationType)operationType {
+    switch (operationType) {
+        case OSSOperationTypeGetBucket:
+            return [OSSListBucketXMLParser new];
+        case OSSOperationTypeListMultipart:
+            return [OSSListPartsXMLParser new];
+        case OSSOperationTypeDeleteMultipleObjects:
+            return [OSSDeleteResultXMLParser new];
+        default:
+            return nil;
+    }
+}
+
++ (NSDictionary *)errorDictionaryWithData:(NSData *)data {
+    if (data.length == 0) {
+        return nil;
+    }
+    OSSErrorXMLParser * parser = [OSSErrorXMLParser new];
+    [parser feedData:data];
+    if (![parser finish]) {
+        OSSLogDebug(@"error body is not a complete xml document");
+    }
+    return parser.fields.count ? parser.fields : nil;
+}
+
+- (BOOL)feedData:(NSData *)data {
+    if (_failed) {
+        return NO;
+    }
+    __block BOOL failed = NO;
+    oss_xml_stream_t * stream = _stream;
+    [data enumerateByteRangesUsingBlock:^(const void * bytes, NSRange byteRange, BOOL * stop) {
+        if (oss_xml_stream_feed(stream, bytes, byteRange.length) != 0) {
+            failed = YES;
+            *stop = YES;
+        }
+    }];
+    if (failed) {
+        OSSLogError(@"malformed xml in the response body");
+        _failed = YES;
+    }
+    return !_failed;
+}
+
+- (BOOL)finish {
+    BOOL succeed = !_failed && oss_xml_stream_finish(_stream) == 0;
+    [self didFinish];
+    return succeed;
+}
+
+- (void)didParseField:(NSString *)name value:(NSString *)value {
+}
+
+- (void)didParseItem:(NSDictionary *)item name:(NSString *)name {
+}
+
+- (BOOL)isItemElement:(NSString *)name {
+    return NO;
+}
+
+- (void)didFinish {
+}
+
+# pragma mark - Private Methods
+
+- (void)startElement:(const char *)name length:(size_t)length depth:(int)depth {
+    if (depth == 2) {
+        NSString * key = OSSXMLKeyForName(name, length);
+        if ([self isItemElement:key]) {
+            _itemName = key;
+            _containers = [NSMutableArray arrayWithObject:[NSMutableDictionary new]];
+            _containerKeys = [NSMutableArray new];
+            _pendingKey = nil;
+        }
+    } else if (depth > 2 && _itemName) {
+        if (_pendingKey) {
+            /* the pending element has children */
+            [_containers addObject:[NSMutableDictionary new]];
+            [_containerKeys addObject:_pendingKey];
+        }
+        _pendingKey = OSSXMLKeyForName(name, length);
+        _pendingDepth = depth;
+    }
+}
+
+- (void)endElement:(const char *)name length:(size_t)length text:(const char *)text textLength:(size_t)textLength depth:(int)depth {
+    if (_itemName) {
+        if (depth == 2) {
+            NSDictionary * item = _containers.firstObject;
+            if (item.count) {
+                [self didParseItem:item name:_itemName];
+            }
+            _itemName = nil;
+            _containers = nil;
+            _containerKeys = nil;
+            _pendingKey = nil;
+        } else if (_pendingKey && _pendingDepth == depth) {
+            NSString * value = textLength ? OSSXMLValueForText(text, textLength) : nil;
+            if (value) {
+                OSSXMLSetValue(_containers.lastObject, _pendingKey, value);
+            }
+            _pendingKey = nil;
+        } else if (_containerKeys.count) {
+            NSMutableDictionary * container = _containers.lastObject;
+            NSString * key = _containerKeys.lastObject;
+            [_containers removeLastObject];
+            [_containerKeys removeLastObject];
+            /* empty nodes are stripped like OSSXMLDictionary does */
+            if (container.count) {
+                OSSXMLSetValue(_containers.lastObject, key, container);
+            }
+        }
+    } else if (depth == 2 && textLength) {
+        NSString * value = OSSXMLValueForText(text, textLength);
+        if (value) {
+            [self didParseField:OSSXMLKeyForName(name, length) value:value];
+        }
+    }
+}
+
+@end
+
+static void oss_xml_on_start(void * ctx, const char * name, size_t name_len, int depth) {
+    [(__bridge OSSXMLResponseParser *)ctx startElement:name length:name_len depth:depth];
+}
+
+static void oss_xml_on_end(void * ctx, const char * name, size_t name_len, const char * text, size_t text_len, int depth) {
+    [(__bridge OSSXMLResponseParser *)ctx endElement:name length:name_len text:text textLength:text_len depth:depth];
+}
+
+#pragma mark - ListBucketResult
+
+@implementation OSSListBucketXMLParser {
+    NSMutableArray * _contents;
+    NSMutableArray * _commonPrefixes;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.result = [OSSGetBucketResult new];
+    }
+    return self;
+}
+
+- (BOOL)isItemElement:(NSString *)name {
+    return [name isEqualToString:OSSContentsXMLTOKEN] || [name isEqualToString:OSSCommonPrefixesXMLTOKEN];
+}
+
+- (void)didParseField:(NSString *)name value:(NSString *)value {
+    OSSGetBucketResult * result = (OSSGetBucketResult *)self.result;
+    if ([name isEqualToString:OSSNameXMLTOKEN]) {
+        result.bucketName = value;
+    } else if ([name isEqualToString:OSSPrefixXMLTOKEN]) {
+        result.prefix = value;
+    } else if ([name isEqualToString:OSSMarkerXMLTOKEN]) {
+        result.marker = value;
+    } else if ([name isEqualToString:OSSNextMarkerXMLTOKEN]) {
+        result.nextMarker = value;
+    } else if ([name isEqualToString:OSSMaxKeysXMLTOKEN]) {
+        result.maxKeys = (int32_t)[value integerValue];
+    } else if ([name isEqualToString:OSSDelimiterXMLTOKEN]) {
+        result.delimiter = value;
+    } else if ([name isEqualToString:OSSIsTruncatedXMLTOKEN]) {
+        result.isTruncated = [value boolValue];
+    }
+}
+
+- (void)didParseItem:(NSDictionary *)item name:(NSString *)name {
+    if ([name isEqualToString:OSSContentsXMLTOKEN]) {
+        if (!_contents) {
+            _contents = [NSMutableArray new];
+        }
+        [_contents addObject:item];
+    } else {
+        if (!_commonPrefixes) {
+            _commonPrefixes = [NSMutableArray new];
+        }
+        NSString * prefix = [item objectForKey:OSSPrefixXMLTOKEN];
+        if ([prefix isKindOfClass:[NSString class]]) {
+            [_commonPrefixes addObject:prefix];
+        }
+    }
+}
+
+- (void)didFinish {
+    OSSGetBucketResult * result = (OSSGetBucketResult *)self.result;
+    result.contents = _contents;
+    result.commentPrefixes = _commonPrefixes;
+}
+
+@end
+
+#pragma mark - ListPartsResult
+
+@implementation OSSListPartsXMLParser {
+    NSMutableArray * _parts;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.result = [OSSListPartsResult new];
+    }
+    return self;
+}
+
+- (BOOL)isItemElement:(NSString *)name {
+    return [name isEqualToString:OSSPartXMLTOKEN];
+}
+
+- (void)didParseField:(NSString *)name value:(NSString *)value {
+    OSSListPartsResult * result = (OSSListPartsResult *)self.result;
+    if ([name isEqualToString:OSSNextPartNumberMarkerXMLTOKEN]) {
+        result.nextPartNumberMarker = [value intValue];
+    } else if ([name isEqualToString:OSSMaxPartsXMLTOKEN]) {
+        result.maxParts = [value intValue];
+    } else if ([name isEqualToString:OSSIsTruncatedXMLTOKEN]) {
+        result.isTruncated = [value boolValue];
+    }
+}
+
+- (void)didParseItem:(NSDictionary *)item name:(NSString *)name {
+    if (!_parts) {
+        _parts = [NSMutableArray new];
+    }
+    [_parts addObject:item];
+}
+
+- (void)didFinish {
+    ((OSSListPartsResult *)self.result).parts = _parts;
+}
+
+@end
+
+#pragma mark - DeleteResult
+
+@implementation OSSDeleteResultXMLParser {
+    NSMutableArray<NSString *> * _deletedObjects;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.result = [OSSDeleteMultipleObjectsResult new];
+        _deletedObjects = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (BOOL)isItemElement:(NSString *)name {
+    return [name isEqualToString:@"Deleted"];
+}
+
+- (void)didParseItem:(NSDictionary *)item name:(NSString *)name {
+    NSString * key = [item objectForKey:OSSKeyXMLTOKEN];
+    if ([key isKindOfClass:[NSString class]]) {
+        [_deletedObjects addObject:key];
+    }
+}
+
+- (void)didFinish {
+    ((OSSDeleteMultipleObjectsResult *)self.result).deletedObjects = _deletedObjects;
+}
+
+@end
+
+#pragma mark - Error
+
+@implementation OSSErrorXMLParser
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _fields = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (void)didParseField:(NSString *)name value:(NSString *)value {
+    OSSXMLSetValue(_fields, name, value);
+}
+
+@end
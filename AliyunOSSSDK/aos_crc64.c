@@ -201,7 +201,7 @@ static inline uint64_t crc64_big(uint64_t crc, void *buf, size_t len)
    at compile time if it can, and get rid of the unused code and table.  If the
    endianess can be changed at run time, then this code will handle that as
    well, initializing and using two tables, if called upon to do so. */
-uint64_t aos_crc64(uint64_t crc, void *buf, size_t len)
+uint64_t aos_crc64_table(uint64_t crc, void *buf, size_t len)
 {
     uint64_t n = 1;
 
@@ -209,6 +209,230 @@ uint64_t aos_crc64(uint64_t crc, void *buf, size_t len)
                          crc64_big(crc, buf, len);
 }
 
+/* Carry-less multiply folding, see "Fast CRC Computation for Generic
+   Polynomials Using PCLMULQDQ Instruction" (Intel, 2009).  Only little-endian
+   targets are handled, the data is consumed in the bit-reflected order of the
+   table code above.
+
+   The message is kept in four 128-bit lanes.  A lane X = H * x^64 + L (H is the
+   first eight bytes) is folded forward over n bits with
+       X * x^n = H * x^(n+64) + L * x^n == H * K1 + L * K2  (mod P),
+   where K1 = x^(n+64-1) mod P and K2 = x^(n-1) mod P.  The "- 1" compensates
+   for the one bit shift of a carry-less multiply of bit-reflected values.  The
+   folded 128 bits are finally run through the table code, which also handles
+   the unaligned tail, so no Barrett reduction is needed. */
+#if defined(__x86_64__) || defined(__i386__)
+#  include <cpuid.h>
+#  include <emmintrin.h>
+#  include <wmmintrin.h>
+#  define CRC64_FOLD_X86
+#elif defined(__aarch64__)
+#  include <arm_neon.h>
+#  if defined(__linux__)
+#    include <sys/auxv.h>
+#    include <asm/hwcap.h>
+#  endif
+#  define CRC64_FOLD_ARM
+#endif
+
+#if defined(CRC64_FOLD_X86) || defined(CRC64_FOLD_ARM)
+
+/* fold constants, as bit-reflected 64-bit values: {K1, K2} */
+static uint64_t crc64_fold_512[2];
+static uint64_t crc64_fold_128[2];
+static int crc64_fold_available;
+
+/* Return x^n mod P in the bit-reflected representation of the table code. */
+static uint64_t crc64_xpow_mod(unsigned n)
+{
+    uint64_t r = (uint64_t)1 << 63;     /* x^0 */
+
+    while (n--)
+        r = r & 1 ? (r >> 1) ^ POLY : r >> 1;
+    return r;
+}
+
+static int crc64_fold_supported(void)
+{
+#if defined(CRC64_FOLD_X86)
+    unsigned eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+    return (ecx & bit_PCLMUL) && (edx & bit_SSE2);
+#elif defined(__APPLE__)
+    return 1;                           /* every arm64 Apple core has PMULL */
+#elif defined(__linux__) && defined(HWCAP_PMULL)
+    return (getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+#else
+    return 0;
+#endif
+}
+
+static void crc64_fold_init(void)
+{
+    crc64_fold_512[0] = crc64_xpow_mod(512 + 64 - 1);
+    crc64_fold_512[1] = crc64_xpow_mod(512 - 1);
+    crc64_fold_128[0] = crc64_xpow_mod(128 + 64 - 1);
+    crc64_fold_128[1] = crc64_xpow_mod(128 - 1);
+    crc64_fold_available = crc64_fold_supported();
+}
+
+#if defined(CRC64_FOLD_X86)
+
+typedef __m128i crc64_lane;
+
+__attribute__((target("pclmul,sse2")))
+static inline crc64_lane crc64_lane_load(const unsigned char *p)
+{
+    return _mm_loadu_si128((const __m128i *)p);
+}
+
+__attribute__((target("pclmul,sse2")))
+static inline crc64_lane crc64_lane_fold(crc64_lane x, crc64_lane k, crc64_lane next)
+{
+    crc64_lane lo = _mm_clmulepi64_si128(x, k, 0x00);
+    crc64_lane hi = _mm_clmulepi64_si128(x, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(lo, hi), next);
+}
+
+__attribute__((target("pclmul,sse2")))
+static inline crc64_lane crc64_lane_xor(crc64_lane a, crc64_lane b)
+{
+    return _mm_xor_si128(a, b);
+}
+
+__attribute__((target("pclmul,sse2")))
+static inline crc64_lane crc64_lane_make(uint64_t lo, uint64_t hi)
+{
+    return _mm_set_epi64x((long long)hi, (long long)lo);
+}
+
+__attribute__((target("pclmul,sse2")))
+static inline void crc64_lane_store(unsigned char *p, crc64_lane x)
+{
+    _mm_storeu_si128((__m128i *)p, x);
+}
+
+#define CRC64_FOLD_TARGET __attribute__((target("pclmul,sse2")))
+
+#else /* CRC64_FOLD_ARM */
+
+typedef uint64x2_t crc64_lane;
+
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES)
+#  define CRC64_FOLD_TARGET
+#elif defined(__clang__)
+#  define CRC64_FOLD_TARGET __attribute__((target("aes")))
+#else
+#  define CRC64_FOLD_TARGET __attribute__((target("+crypto")))
+#endif
+
+CRC64_FOLD_TARGET
+static inline crc64_lane crc64_lane_load(const unsigned char *p)
+{
+    return vreinterpretq_u64_u8(vld1q_u8(p));
+}
+
+CRC64_FOLD_TARGET
+static inline crc64_lane crc64_lane_fold(crc64_lane x, crc64_lane k, crc64_lane next)
+{
+    crc64_lane lo = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(x, 0),
+                                                     (poly64_t)vgetq_lane_u64(k, 0)));
+    crc64_lane hi = vreinterpretq_u64_p128(vmull_high_p64(vreinterpretq_p64_u64(x),
+                                                          vreinterpretq_p64_u64(k)));
+    return veorq_u64(veorq_u64(lo, hi), next);
+}
+
+CRC64_FOLD_TARGET
+static inline crc64_lane crc64_lane_xor(crc64_lane a, crc64_lane b)
+{
+    return veorq_u64(a, b);
+}
+
+CRC64_FOLD_TARGET
+static inline crc64_lane crc64_lane_make(uint64_t lo, uint64_t hi)
+{
+    return vcombine_u64(vcreate_u64(lo), vcreate_u64(hi));
+}
+
+CRC64_FOLD_TARGET
+static inline void crc64_lane_store(unsigned char *p, crc64_lane x)
+{
+    vst1q_u8(p, vreinterpretq_u8_u64(x));
+}
+
+#endif
+
+/* Calculate a CRC-64 with carry-less multiply, len must be at least 64. */
+CRC64_FOLD_TARGET
+static uint64_t crc64_fold(uint64_t crc, const unsigned char *next, size_t len)
+{
+    crc64_lane k512 = crc64_lane_make(crc64_fold_512[0], crc64_fold_512[1]);
+    crc64_lane k128 = crc64_lane_make(crc64_fold_128[0], crc64_fold_128[1]);
+    crc64_lane x0, x1, x2, x3;
+    unsigned char folded[16];
+
+    /* the pre-conditioned crc is added to the first eight bytes */
+    x0 = crc64_lane_xor(crc64_lane_load(next), crc64_lane_make(~crc, 0));
+    x1 = crc64_lane_load(next + 16);
+    x2 = crc64_lane_load(next + 32);
+    x3 = crc64_lane_load(next + 48);
+    next += 64;
+    len -= 64;
+
+    while (len >= 64) {
+        x0 = crc64_lane_fold(x0, k512, crc64_lane_load(next));
+        x1 = crc64_lane_fold(x1, k512, crc64_lane_load(next + 16));
+        x2 = crc64_lane_fold(x2, k512, crc64_lane_load(next + 32));
+        x3 = crc64_lane_fold(x3, k512, crc64_lane_load(next + 48));
+        next += 64;
+        len -= 64;
+    }
+
+    x0 = crc64_lane_fold(x0, k128, x1);
+    x0 = crc64_lane_fold(x0, k128, x2);
+    x0 = crc64_lane_fold(x0, k128, x3);
+    while (len >= 16) {
+        x0 = crc64_lane_fold(x0, k128, crc64_lane_load(next));
+        next += 16;
+        len -= 16;
+    }
+
+    /* x0 is now a 16 byte message with the same crc as everything before */
+    crc64_lane_store(folded, x0);
+    crc = crc64_little(~(uint64_t)0, folded, sizeof(folded));
+    return crc64_little(crc, (void *)next, len);
+}
+
+#endif
+
+/* Return the CRC-64 of buf[0..len-1] with initial crc.  Uses carry-less
+   multiply (PCLMULQDQ on x86, PMULL on arm64) when the cpu supports it, and
+   the table code otherwise. */
+uint64_t aos_crc64(uint64_t crc, void *buf, size_t len)
+{
+#if defined(CRC64_FOLD_X86) || defined(CRC64_FOLD_ARM)
+    if (len >= 64) {
+        ONCE(crc64_fold_init);
+        if (crc64_fold_available)
+            return crc64_fold(crc, buf, len);
+    }
+#endif
+    return aos_crc64_table(crc, buf, len);
+}
+
+/* Return non-zero if aos_crc64() uses the carry-less multiply kernel. */
+int aos_crc64_accelerated(void)
+{
+#if defined(CRC64_FOLD_X86) || defined(CRC64_FOLD_ARM)
+    ONCE(crc64_fold_init);
+    return crc64_fold_available;
+#else
+    return 0;
+#endif
+}
+
 #define GF2_DIM 64      /* dimension of GF(2) vectors (length of CRC) */
 
 static uint64_t gf2_matrix_times(uint64_t *mat, uint64_t vec)
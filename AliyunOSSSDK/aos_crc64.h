@@ -6,6 +6,8 @@
 #include <stddef.h>
 
 uint64_t aos_crc64(uint64_t crc, void *buf, size_t len);
+uint64_t aos_crc64_table(uint64_t crc, void *buf, size_t len);
+int aos_crc64_accelerated(void);
 uint64_t aos_crc64_combine(uint64_t crc1, uint64_t crc2, uintmax_t len2);
 
 #endif
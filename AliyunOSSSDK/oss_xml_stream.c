@@ -0,0 +1,450 @@
+//
+//  oss_xml_stream.c
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#include "oss_xml_stream.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    OSS_XML_TEXT,
+    OSS_XML_LT,
+    OSS_XML_START_NAME,
+    OSS_XML_ATTRS,
+    OSS_XML_ATTR_VALUE,
+    OSS_XML_EMPTY_CLOSE,
+    OSS_XML_END_NAME,
+    OSS_XML_END_TRAIL,
+    OSS_XML_PI,
+    OSS_XML_BANG,
+    OSS_XML_COMMENT,
+    OSS_XML_CDATA,
+    OSS_XML_DECL,
+    OSS_XML_ENTITY,
+    OSS_XML_ERROR
+} oss_xml_state_t;
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+} oss_xml_buf_t;
+
+struct oss_xml_stream_s {
+    oss_xml_stream_handler_t handler;
+    void *ctx;
+    oss_xml_state_t state;
+
+    char quote;
+    /* the dashes of "-->", the brackets of "]]>" or the '?' of "?>" seen so far */
+    int marker;
+    int seen_root;
+
+    oss_xml_buf_t name;
+    oss_xml_buf_t text;
+    oss_xml_buf_t token;
+
+    /* names of the open elements, each one terminated by '\0' */
+    oss_xml_buf_t stack;
+    size_t *offsets;
+    int depth;
+    int offsets_cap;
+};
+
+static int oss_xml_buf_append(oss_xml_buf_t *buf, const char *data, size_t len)
+{
+    if (buf->len + len > buf->cap) {
+        size_t cap = buf->cap ? buf->cap : 64;
+        while (cap < buf->len + len) {
+            cap *= 2;
+        }
+        char *data_new = realloc(buf->data, cap);
+        if (!data_new) {
+            return -1;
+        }
+        buf->data = data_new;
+        buf->cap = cap;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    return 0;
+}
+
+static int oss_xml_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static int oss_xml_push(oss_xml_stream_t *stream)
+{
+    if (stream->depth == stream->offsets_cap) {
+        int cap = stream->offsets_cap ? stream->offsets_cap * 2 : 16;
+        size_t *offsets = realloc(stream->offsets, cap * sizeof(size_t));
+        if (!offsets) {
+            return -1;
+        }
+        stream->offsets = offsets;
+        stream->offsets_cap = cap;
+    }
+    stream->offsets[stream->depth++] = stream->stack.len;
+    if (oss_xml_buf_append(&stream->stack, stream->name.data, stream->name.len) != 0
+        || oss_xml_buf_append(&stream->stack, "", 1) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int oss_xml_start_element(oss_xml_stream_t *stream)
+{
+    if (stream->name.len == 0 || (stream->depth == 0 && stream->seen_root)) {
+        return -1;
+    }
+    if (oss_xml_push(stream) != 0) {
+        return -1;
+    }
+    stream->seen_root = 1;
+    stream->text.len = 0;
+    if (stream->handler.start_element) {
+        stream->handler.start_element(stream->ctx, stream->name.data, stream->name.len, stream->depth);
+    }
+    return 0;
+}
+
+static int oss_xml_end_element(oss_xml_stream_t *stream)
+{
+    if (stream->depth == 0) {
+        return -1;
+    }
+    size_t offset = stream->offsets[stream->depth - 1];
+    const char *open_name = stream->stack.data + offset;
+    size_t open_len = stream->stack.len - offset - 1;
+    if (open_len != stream->name.len || memcmp(open_name, stream->name.data, open_len) != 0) {
+        return -1;
+    }
+
+    const char *text = stream->text.data;
+    size_t text_len = stream->text.len;
+    while (text_len && oss_xml_is_space(*text)) {
+        text++;
+        text_len--;
+    }
+    while (text_len && oss_xml_is_space(text[text_len - 1])) {
+        text_len--;
+    }
+    if (stream->handler.end_element) {
+        stream->handler.end_element(stream->ctx, open_name, open_len, text_len ? text : "", text_len, stream->depth);
+    }
+    stream->depth--;
+    stream->stack.len = offset;
+    stream->text.len = 0;
+    return 0;
+}
+
+static int oss_xml_append_utf8(oss_xml_buf_t *buf, unsigned long cp)
+{
+    char out[4];
+    size_t len;
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        len = 1;
+    } else if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        len = 2;
+    } else if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        len = 3;
+    } else if (cp < 0x110000) {
+        out[0] = (char)(0xF0 | (cp >> 18));
+        out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = (char)(0x80 | (cp & 0x3F));
+        len = 4;
+    } else {
+        return -1;
+    }
+    return oss_xml_buf_append(buf, out, len);
+}
+
+static int oss_xml_decode_entity(oss_xml_stream_t *stream)
+{
+    const char *e = stream->token.data;
+    size_t len = stream->token.len;
+    char c;
+
+    if (len == 3 && memcmp(e, "amp", 3) == 0) {
+        c = '&';
+    } else if (len == 2 && memcmp(e, "lt", 2) == 0) {
+        c = '<';
+    } else if (len == 2 && memcmp(e, "gt", 2) == 0) {
+        c = '>';
+    } else if (len == 4 && memcmp(e, "quot", 4) == 0) {
+        c = '"';
+    } else if (len == 4 && memcmp(e, "apos", 4) == 0) {
+        c = '\'';
+    } else if (len >= 2 && e[0] == '#') {
+        char digits[16];
+        int hex = (e[1] == 'x' || e[1] == 'X');
+        size_t start = hex ? 2 : 1;
+        if (len - start == 0 || len - start >= sizeof(digits)) {
+            return -1;
+        }
+        memcpy(digits, e + start, len - start);
+        digits[len - start] = '\0';
+        char *end = NULL;
+        unsigned long cp = strtoul(digits, &end, hex ? 16 : 10);
+        if (*end != '\0') {
+            return -1;
+        }
+        return oss_xml_append_utf8(&stream->text, cp);
+    } else {
+        return -1;
+    }
+    return oss_xml_buf_append(&stream->text, &c, 1);
+}
+
+oss_xml_stream_t *oss_xml_stream_create(const oss_xml_stream_handler_t *handler, void *ctx)
+{
+    oss_xml_stream_t *stream = calloc(1, sizeof(oss_xml_stream_t));
+    if (!stream) {
+        return NULL;
+    }
+    stream->handler = *handler;
+    stream->ctx = ctx;
+    stream->state = OSS_XML_TEXT;
+    return stream;
+}
+
+void oss_xml_stream_reset(oss_xml_stream_t *stream)
+{
+    stream->state = OSS_XML_TEXT;
+    stream->marker = 0;
+    stream->seen_root = 0;
+    stream->depth = 0;
+    stream->name.len = 0;
+    stream->text.len = 0;
+    stream->token.len = 0;
+    stream->stack.len = 0;
+}
+
+void oss_xml_stream_free(oss_xml_stream_t *stream)
+{
+    if (!stream) {
+        return;
+    }
+    free(stream->name.data);
+    free(stream->text.data);
+    free(stream->token.data);
+    free(stream->stack.data);
+    free(stream->offsets);
+    free(stream);
+}
+
+int oss_xml_stream_finish(oss_xml_stream_t *stream)
+{
+    if (stream->state == OSS_XML_ERROR || !stream->seen_root || stream->depth != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int oss_xml_stream_feed(oss_xml_stream_t *stream, const char *data, size_t len)
+{
+    size_t i = 0;
+    int rc = 0;
+
+    while (i < len && rc == 0) {
+        char c = data[i];
+
+        switch (stream->state) {
+            case OSS_XML_TEXT: {
+                /* consume the run of plain characters at once */
+                size_t run = i;
+                while (run < len && data[run] != '<' && data[run] != '&') {
+                    run++;
+                }
+                if (run > i && stream->depth > 0) {
+                    rc = oss_xml_buf_append(&stream->text, data + i, run - i);
+                }
+                i = run;
+                if (i < len) {
+                    if (data[i] == '<') {
+                        stream->state = OSS_XML_LT;
+                    } else {
+                        stream->token.len = 0;
+                        stream->state = OSS_XML_ENTITY;
+                    }
+                    i++;
+                }
+                continue;
+            }
+
+            case OSS_XML_LT:
+                stream->name.len = 0;
+                if (c == '/') {
+                    stream->state = OSS_XML_END_NAME;
+                } else if (c == '?') {
+                    stream->marker = 0;
+                    stream->state = OSS_XML_PI;
+                } else if (c == '!') {
+                    stream->token.len = 0;
+                    stream->state = OSS_XML_BANG;
+                } else if (oss_xml_is_space(c) || c == '>') {
+                    rc = -1;
+                } else {
+                    rc = oss_xml_buf_append(&stream->name, &c, 1);
+                    stream->state = OSS_XML_START_NAME;
+                }
+                break;
+
+            case OSS_XML_START_NAME:
+                if (c == '>') {
+                    rc = oss_xml_start_element(stream);
+                    stream->state = OSS_XML_TEXT;
+                } else if (c == '/') {
+                    stream->state = OSS_XML_EMPTY_CLOSE;
+                } else if (oss_xml_is_space(c)) {
+                    stream->state = OSS_XML_ATTRS;
+                } else {
+                    rc = oss_xml_buf_append(&stream->name, &c, 1);
+                }
+                break;
+
+            case OSS_XML_ATTRS:
+                if (c == '>') {
+                    rc = oss_xml_start_element(stream);
+                    stream->state = OSS_XML_TEXT;
+                } else if (c == '/') {
+                    stream->state = OSS_XML_EMPTY_CLOSE;
+                } else if (c == '"' || c == '\'') {
+                    stream->quote = c;
+                    stream->state = OSS_XML_ATTR_VALUE;
+                }
+                break;
+
+            case OSS_XML_ATTR_VALUE:
+                if (c == stream->quote) {
+                    stream->state = OSS_XML_ATTRS;
+                }
+                break;
+
+            case OSS_XML_EMPTY_CLOSE:
+                if (c != '>') {
+                    rc = -1;
+                    break;
+                }
+                rc = oss_xml_start_element(stream);
+                if (rc == 0) {
+                    rc = oss_xml_end_element(stream);
+                }
+                stream->state = OSS_XML_TEXT;
+                break;
+
+            case OSS_XML_END_NAME:
+                if (c == '>') {
+                    rc = oss_xml_end_element(stream);
+                    stream->state = OSS_XML_TEXT;
+                } else if (oss_xml_is_space(c)) {
+                    stream->state = OSS_XML_END_TRAIL;
+                } else {
+                    rc = oss_xml_buf_append(&stream->name, &c, 1);
+                }
+                break;
+
+            case OSS_XML_END_TRAIL:
+                if (c == '>') {
+                    rc = oss_xml_end_element(stream);
+                    stream->state = OSS_XML_TEXT;
+                } else if (!oss_xml_is_space(c)) {
+                    rc = -1;
+                }
+                break;
+
+            case OSS_XML_PI:
+                if (c == '>' && stream->marker) {
+                    stream->state = OSS_XML_TEXT;
+                }
+                stream->marker = (c == '?');
+                break;
+
+            case OSS_XML_BANG:
+                rc = oss_xml_buf_append(&stream->token, &c, 1);
+                if (stream->token.len == 2 && memcmp(stream->token.data, "--", 2) == 0) {
+                    stream->marker = 0;
+                    stream->state = OSS_XML_COMMENT;
+                } else if (stream->token.len == 7 && memcmp(stream->token.data, "[CDATA[", 7) == 0) {
+                    stream->marker = 0;
+                    stream->state = OSS_XML_CDATA;
+                } else if (c == '>') {
+                    stream->state = OSS_XML_TEXT;
+                } else if (stream->token.len >= 7
+                           || (stream->token.data[0] != '-' && stream->token.data[0] != '[')) {
+                    stream->state = OSS_XML_DECL;
+                }
+                break;
+
+            case OSS_XML_COMMENT:
+                if (c == '>' && stream->marker >= 2) {
+                    stream->state = OSS_XML_TEXT;
+                }
+                stream->marker = (c == '-') ? stream->marker + 1 : 0;
+                break;
+
+            case OSS_XML_CDATA:
+                if (c == ']') {
+                    stream->marker++;
+                } else if (c == '>' && stream->marker >= 2) {
+                    /* the brackets before "]]>" belong to the data */
+                    for (int k = 2; k < stream->marker && rc == 0; k++) {
+                        rc = oss_xml_buf_append(&stream->text, "]", 1);
+                    }
+                    stream->marker = 0;
+                    stream->state = OSS_XML_TEXT;
+                } else {
+                    for (int k = 0; k < stream->marker && rc == 0; k++) {
+                        rc = oss_xml_buf_append(&stream->text, "]", 1);
+                    }
+                    stream->marker = 0;
+                    if (rc == 0) {
+                        rc = oss_xml_buf_append(&stream->text, &c, 1);
+                    }
+                }
+                break;
+
+            case OSS_XML_DECL:
+                if (c == '>') {
+                    stream->state = OSS_XML_TEXT;
+                }
+                break;
+
+            case OSS_XML_ENTITY:
+                if (c == ';') {
+                    if (stream->depth > 0) {
+                        rc = oss_xml_decode_entity(stream);
+                    }
+                    stream->state = OSS_XML_TEXT;
+                } else if (stream->token.len >= 12) {
+                    rc = -1;
+                } else {
+                    rc = oss_xml_buf_append(&stream->token, &c, 1);
+                }
+                break;
+
+            case OSS_XML_ERROR:
+                return -1;
+        }
+        i++;
+    }
+
+    if (rc != 0) {
+        stream->state = OSS_XML_ERROR;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+//
+//  oss_xml_stream.h
+//  AliyunOSSSDK
+//
+//  Copyright © 2018年 阿里云. All rights reserved.
+//
+
+#ifndef OSS_XML_STREAM_H
+#define OSS_XML_STREAM_H
+
+#include <stddef.h>
+
+/*
+ A minimal push parser for the XML bodies returned by OSS. The body can be fed in chunks
+ of any size as it arrives, and only the element being parsed is buffered.
+
+ Attributes, comments, processing instructions and DOCTYPE are skipped. Entities and
+ CDATA sections are decoded into the character data.
+ */
+
+typedef struct oss_xml_stream_s oss_xml_stream_t;
+
+typedef struct {
+    /* depth is 1 for the root element */
+    void (*start_element)(void *ctx, const char *name, size_t name_len, int depth);
+
+    /* text is the whitespace trimmed character data since the last tag, i.e. the value of a leaf element */
+    void (*end_element)(void *ctx, const char *name, size_t name_len, const char *text, size_t text_len, int depth);
+} oss_xml_stream_handler_t;
+
+oss_xml_stream_t *oss_xml_stream_create(const oss_xml_stream_handler_t *handler, void *ctx);
+
+/* returns 0 on success, -1 once the document is malformed */
+int oss_xml_stream_feed(oss_xml_stream_t *stream, const char *data, size_t len);
+
+/* returns 0 if a complete document has been fed, -1 otherwise */
+int oss_xml_stream_finish(oss_xml_stream_t *stream);
+
+void oss_xml_stream_reset(oss_xml_stream_t *stream);
+
+void oss_xml_stream_free(oss_xml_stream_t *stream);
+
+#endif
@@ -164,6 +164,57 @@ id<OSSCredentialProvider> credential, authCredential;
     XCTAssertEqual(204, abortResult.httpResponseCode);
 }
 
+- (void)testListPartsPages
+{
+    OSSInitMultipartUploadRequest * init = [OSSInitMultipartUploadRequest new];
+    init.bucketName = OSS_BUCKET_PRIVATE;
+    init.objectKey = OSS_MULTIPART_UPLOADKEY;
+    OSSTask * task = [client multipartUploadInit:init];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    NSString * uploadId = ((OSSInitMultipartUploadResult *)task.result).uploadId;
+
+    for (int i = 1; i <= 3; i++) {
+        OSSUploadPartRequest * uploadPart = [OSSUploadPartRequest new];
+        uploadPart.bucketName = OSS_BUCKET_PRIVATE;
+        uploadPart.objectkey = OSS_MULTIPART_UPLOADKEY;
+        uploadPart.uploadId = uploadId;
+        uploadPart.partNumber = i;
+        uploadPart.uploadPartData = [@"part" dataUsingEncoding:NSUTF8StringEncoding];
+        task = [client uploadPart:uploadPart];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+    }
+
+    OSSListPartsRequest * listParts = [OSSListPartsRequest new];
+    listParts.bucketName = OSS_BUCKET_PRIVATE;
+    listParts.objectKey = OSS_MULTIPART_UPLOADKEY;
+    listParts.uploadId = uploadId;
+    listParts.maxParts = 2;
+    task = [client listParts:listParts];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    OSSListPartsResult * result = task.result;
+    XCTAssertTrue(result.isTruncated);
+    XCTAssertEqual(2, result.nextPartNumberMarker);
+    XCTAssertEqual(2, result.parts.count);
+
+    listParts.partNumberMarker = result.nextPartNumberMarker;
+    task = [client listParts:listParts];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    result = task.result;
+    XCTAssertFalse(result.isTruncated);
+    XCTAssertEqual(1, result.parts.count);
+    XCTAssertEqualObjects(@"3", result.parts.firstObject[OSSPartNumberXMLTOKEN]);
+
+    OSSAbortMultipartUploadRequest * abort = [OSSAbortMultipartUploadRequest new];
+    abort.bucketName = OSS_BUCKET_PRIVATE;
+    abort.objectKey = OSS_MULTIPART_UPLOADKEY;
+    abort.uploadId = uploadId;
+    [[client abortMultipartUpload:abort] waitUntilFinished];
+}
+
 - (void)testAccessViaHttpProxy {
     OSSClientConfiguration * conf = [OSSClientConfiguration new];
     
@@ -241,6 +292,51 @@ id<OSSCredentialProvider> credential, authCredential;
     
 }
 
+- (void)testRequestMetrics {
+    OSSClientConfiguration * conf = [OSSClientConfiguration new];
+
+    __block OSSRequestMetrics * handledMetrics = nil;
+    conf.requestMetricsHandler = ^(OSSRequestMetrics * metrics) {
+        NSLog(@"metrics: %@", metrics);
+        handledMetrics = metrics;
+    };
+
+    OSSClient * metricsClient = [[OSSClient alloc] initWithEndpoint:OSS_ENDPOINT
+                                                credentialProvider:client.credentialProvider
+                                               clientConfiguration:conf];
+
+    OSSHeadObjectRequest * request = [OSSHeadObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = @"file1m";
+
+    OSSTask * task = [metricsClient headObject:request];
+
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSHeadObjectResult * result = task.result;
+        XCTAssertNotNil(result.metrics);
+        XCTAssertEqual(result.metrics, handledMetrics);
+        XCTAssertEqual(200, result.metrics.httpResponseCode);
+        XCTAssertEqualObjects(@"HEAD", result.metrics.httpMethod);
+        XCTAssertEqualObjects(result.requestId, result.metrics.requestId);
+        XCTAssertEqual(0u, result.metrics.retryCount);
+        XCTAssertTrue(result.metrics.totalDuration >= result.metrics.queueDuration);
+        XCTAssertNil(result.metrics.error);
+        return nil;
+    }] waitUntilFinished];
+
+    OSSHeadObjectRequest * missingRequest = [OSSHeadObjectRequest new];
+    missingRequest.bucketName = OSS_BUCKET_PRIVATE;
+    missingRequest.objectKey = @"not_exist_ttt";
+
+    [[[metricsClient headObject:missingRequest] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNotNil(task.error);
+        XCTAssertEqual(404, handledMetrics.httpResponseCode);
+        XCTAssertEqualObjects(task.error, handledMetrics.error);
+        return nil;
+    }] waitUntilFinished];
+}
+
 - (void)testMultiClientInstance {
     OSSClientConfiguration * conf = [OSSClientConfiguration new];
     conf.maxRetryCount = 3;
@@ -316,6 +412,44 @@ id<OSSCredentialProvider> credential, authCredential;
     }] waitUntilFinished];
 }
 
+- (void)testSharedSessionClients {
+    OSSClientConfiguration * conf = [OSSClientConfiguration new];
+    conf.enableSessionSharing = YES;
+    conf.maxConnectionsPerHost = 8;
+    conf.maxConcurrentRequestCount = 8;
+    conf.multipathServiceType = OSSMultipathServiceTypeHandover;
+
+    OSSClient * client1 = [[OSSClient alloc] initWithEndpoint:OSS_ENDPOINT
+                                           credentialProvider:credential
+                                          clientConfiguration:conf];
+    OSSClient * client2 = [[OSSClient alloc] initWithEndpoint:OSS_ENDPOINT
+                                           credentialProvider:credential
+                                          clientConfiguration:conf];
+    XCTAssertEqual(client1.networking, client2.networking);
+    XCTAssertEqual(8, client1.networking.dataSession.configuration.HTTPMaximumConnectionsPerHost);
+
+    conf.maxConnectionsPerHost = 4;
+    OSSClient * client3 = [[OSSClient alloc] initWithEndpoint:OSS_ENDPOINT
+                                           credentialProvider:credential
+                                          clientConfiguration:conf];
+    XCTAssertNotEqual(client1.networking, client3.networking);
+
+    OSSHeadObjectRequest * request = [OSSHeadObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = @"file1m";
+    [[[client1 headObject:request] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+    request = [OSSHeadObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = @"file1m";
+    [[[client2 headObject:request] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+}
+
 - (void)testClientInitWithNoneSchemeEndpoint {
     OSSClientConfiguration * conf = [OSSClientConfiguration new];
     conf.maxRetryCount = 3;
@@ -385,6 +519,87 @@ id<OSSCredentialProvider> credential, authCredential;
     }] waitUntilFinished];
 }
 
+- (void)testMultipartUpload_backgroundPartTransfer {
+    OSSMultipartUploadRequest * multipartUploadRequest = [OSSMultipartUploadRequest new];
+    multipartUploadRequest.bucketName = OSS_BUCKET_PRIVATE;
+    multipartUploadRequest.objectKey = OSS_MULTIPART_UPLOADKEY;
+    multipartUploadRequest.contentType = @"application/octet-stream";
+    multipartUploadRequest.partSize = 256 * 1024;
+    multipartUploadRequest.backgroundPartTransfer = YES;
+    multipartUploadRequest.uploadingFileURL = [[NSBundle mainBundle] URLForResource:@"wangwang" withExtension:@"zip"];
+    OSSTask * multipartTask = [client multipartUpload:multipartUploadRequest];
+    
+    [[multipartTask continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+    
+    BOOL isEqual = [self isFileOnOSSBucket:OSS_BUCKET_PRIVATE objectKey:OSS_MULTIPART_UPLOADKEY equalsToLocalFile:[multipartUploadRequest.uploadingFileURL path]];
+    XCTAssertTrue(isEqual);
+    NSString * slicesDir = [NSTemporaryDirectory() stringByAppendingPathComponent:@"com.aliyun.oss.slices"];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:[slicesDir stringByAppendingPathComponent:multipartUploadRequest.uploadId]]);
+    // the client has no background session to hand the events of
+    XCTAssertFalse([client handleEventsForBackgroundURLSession:@"com.aliyun.oss.backgroundsession" completionHandler:^{}]);
+}
+
+- (void)testMultipartUpload_moreUploadsThanOperationThreads {
+    // the client's operation queue runs 3 operations, the uploads mustn't hold them while their parts are sent
+    NSMutableArray<OSSTask *> * tasks = [NSMutableArray array];
+    NSMutableArray<OSSMultipartUploadRequest *> * requests = [NSMutableArray array];
+    for (int i = 0; i < 6; i++) {
+        OSSMultipartUploadRequest * request = [OSSMultipartUploadRequest new];
+        request.bucketName = OSS_BUCKET_PRIVATE;
+        request.objectKey = [NSString stringWithFormat:@"%@-%d", OSS_MULTIPART_UPLOADKEY, i];
+        request.contentType = @"application/octet-stream";
+        request.partSize = 100 * 1024;
+        request.uploadingFileURL = [[NSBundle mainBundle] URLForResource:@"wangwang" withExtension:@"zip"];
+        [requests addObject:request];
+        [tasks addObject:[client multipartUpload:request]];
+    }
+    
+    OSSTask * allTask = [OSSTask taskForCompletionOfAllTasks:tasks];
+    [allTask waitUntilFinished];
+    XCTAssertNil(allTask.error);
+    for (OSSMultipartUploadRequest * request in requests) {
+        BOOL isEqual = [self isFileOnOSSBucket:OSS_BUCKET_PRIVATE objectKey:request.objectKey equalsToLocalFile:[request.uploadingFileURL path]];
+        XCTAssertTrue(isEqual);
+    }
+}
+
+- (void)testStreamingMultipartUpload {
+    NSURL * fileURL = [[NSBundle mainBundle] URLForResource:@"wangwang" withExtension:@"zip"];
+    NSData * fileData = [NSData dataWithContentsOfURL:fileURL];
+    __block NSUInteger offset = 0;
+    
+    OSSStreamingMultipartUploadRequest * request = [OSSStreamingMultipartUploadRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = OSS_MULTIPART_UPLOADKEY;
+    request.partSize = 100 * 1024;
+    request.crcFlag = OSSRequestCRCOpen;
+    // chunks not aligned with the parts, as a recorder would produce them
+    request.uploadingDataProducer = ^NSData *(NSError **error) {
+        NSUInteger length = MIN(30 * 1024 + 7, fileData.length - offset);
+        NSData * chunk = [fileData subdataWithRange:NSMakeRange(offset, length)];
+        offset += length;
+        return chunk;
+    };
+    OSSTask * task = [client streamingMultipartUpload:request];
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+    
+    BOOL isEqual = [self isFileOnOSSBucket:OSS_BUCKET_PRIVATE objectKey:OSS_MULTIPART_UPLOADKEY equalsToLocalFile:[fileURL path]];
+    XCTAssertTrue(isEqual);
+    
+    request = [OSSStreamingMultipartUploadRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = OSS_MULTIPART_UPLOADKEY;
+    task = [client streamingMultipartUpload:request];
+    [task waitUntilFinished];
+    XCTAssertEqual(OSSClientErrorCodeInvalidArgument, task.error.code);
+}
+
 - (void)testMultipartUpload_cancel {
     OSSMultipartUploadRequest * multipartUploadRequest = [OSSMultipartUploadRequest new];
     multipartUploadRequest.bucketName = OSS_BUCKET_PRIVATE;
@@ -1148,12 +1363,10 @@ id<OSSCredentialProvider> credential, authCredential;
 - (void)testHttpdns {
     NSString * host1 = @"oss-ap-southeast-1.aliyuncs.com";
     NSString * host2 = @"oss-us-east-1.aliyuncs.com";
+    // hosts resolved by a former run are loaded from the disk cache and returned right away,
+    // otherwise the first calls only start resolving them
     NSString * ip1 = [[OSSHttpdns sharedInstance] asynGetIpByHost:host1];
-    ip1 = [[OSSHttpdns sharedInstance] asynGetIpByHost:host1];
-    XCTAssertNil(ip1);
-    
     NSString * ip2 = [[OSSHttpdns sharedInstance] asynGetIpByHost:host2];
-    XCTAssertNil(ip2);
     
     sleep(3);
     
@@ -1163,6 +1376,39 @@ id<OSSCredentialProvider> credential, authCredential;
     XCTAssertNotNil(ip2);
 }
 
+- (void)testHttpdnsBatchResolveAndFailedIp {
+    NSString * host1 = @"oss-cn-beijing.aliyuncs.com";
+    NSString * host2 = @"oss-cn-shenzhen.aliyuncs.com";
+    [[OSSHttpdns sharedInstance] preResolveHosts:@[host1, host2]];
+    
+    sleep(3);
+    
+    NSString * ip1 = [[OSSHttpdns sharedInstance] asynGetIpByHost:host1];
+    NSString * ip2 = [[OSSHttpdns sharedInstance] asynGetIpByHost:host2];
+    XCTAssertNotNil(ip1);
+    XCTAssertNotNil(ip2);
+    
+    // the ips not measured yet are tried first, each one of the host is measured before comparing them
+    NSMutableSet<NSString *> * measuredIps = [NSMutableSet set];
+    NSString * ip = nil;
+    while ((ip = [[OSSHttpdns sharedInstance] asynGetIpByHost:host1]) && ![measuredIps containsObject:ip]) {
+        [[OSSHttpdns sharedInstance] reportConnectRTT:0.5 forHost:host1 address:ip];
+        [measuredIps addObject:ip];
+    }
+    XCTAssertTrue([measuredIps containsObject:ip1]);
+    
+    // an ip which failed to connect is avoided while the host has other ips
+    [[OSSHttpdns sharedInstance] reportConnectFailureForHost:host1 address:ip1];
+    NSString * ipAfterFailure = [[OSSHttpdns sharedInstance] asynGetIpByHost:host1];
+    XCTAssertNotNil(ipAfterFailure);
+    if (measuredIps.count > 1) {
+        XCTAssertNotEqualObjects(ipAfterFailure, ip1);
+    }
+    // and the fastest of the measured ips is used
+    [[OSSHttpdns sharedInstance] reportConnectRTT:0.01 forHost:host1 address:ipAfterFailure];
+    XCTAssertEqualObjects([[OSSHttpdns sharedInstance] asynGetIpByHost:host1], ipAfterFailure);
+}
+
 - (void)testDetemineMimeTypeFunction {
     NSString * filePath1 = @"/a/b/c/d/aaa.txt";
     NSString * uploadName1 = @"aaa";
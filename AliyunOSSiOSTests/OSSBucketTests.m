@@ -101,6 +101,54 @@
     }] waitUntilFinished];
 }
 
+- (NSUInteger)countObjectsWithIterator:(OSSBucketListIterator *)iterator
+{
+    NSUInteger count = 0;
+    while (YES) {
+        OSSTask *task = [iterator nextPage];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        OSSGetBucketResult *page = task.result;
+        if (task.error || !page) {
+            break;
+        }
+        count += page.contents.count;
+    }
+    return count;
+}
+
+- (void)testAPI_bucketListIterator
+{
+    OSSGetBucketRequest *request = [OSSGetBucketRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.maxKeys = 1000;
+    OSSTask *task = [_client getBucket:request];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    NSUInteger expectedCount = [(OSSGetBucketResult *)task.result contents].count;
+
+    request = [OSSGetBucketRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.maxKeys = 2;
+    OSSBucketListIterator *iterator = [_client bucketListIteratorWithRequest:request];
+    iterator.maxPrefetchPages = 3;
+    XCTAssertEqual(expectedCount, [self countObjectsWithIterator:iterator]);
+
+    request = [OSSGetBucketRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.maxKeys = 2;
+    request.delimiter = @"/";
+    iterator = [_client bucketListIteratorWithRequest:request];
+    iterator.expandCommonPrefixes = YES;
+    XCTAssertEqual(expectedCount, [self countObjectsWithIterator:iterator]);
+
+    iterator = [_client bucketListIteratorWithRequest:request];
+    [iterator cancel];
+    task = [iterator nextPage];
+    [task waitUntilFinished];
+    XCTAssertEqual(OSSClientErrorCodeTaskCancelled, task.error.code);
+}
+
 - (void)testAPI_getBucketACL
 {
     OSSGetBucketACLRequest * request = [OSSGetBucketACLRequest new];
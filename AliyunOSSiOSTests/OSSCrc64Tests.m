@@ -202,6 +202,28 @@
     }] waitUntilFinished];
 }
 
+- (void)test_objectReaderWithCrc64Check
+{
+    NSString * objectKey = _fileNames[3];
+    NSString * filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:objectKey];
+    NSData * expected = [NSData dataWithContentsOfFile:filePath];
+    OSSPutObjectRequest * put = [OSSPutObjectRequest new];
+    put.bucketName = OSS_BUCKET_PRIVATE;
+    put.objectKey = objectKey;
+    put.uploadingFileURL = [NSURL fileURLWithPath:filePath];
+    OSSTask * task = [_client putObject:put];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    
+    // the blocks are ranges of the object, they're read even though the client checks the crc64
+    OSSObjectReader * reader = [_client objectReaderWithBucketName:OSS_BUCKET_PRIVATE objectKey:objectKey directory:nil];
+    reader.blockSize = 100 * 1024;
+    task = [reader readDataAtOffset:1000 length:250 * 1024];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(task.result, [expected subdataWithRange:NSMakeRange(1000, 250 * 1024)]);
+    [reader close];
+}
 
 - (void)testMultipartUpload_normal {
     NSString * objectkey = @"mul-wangwang.zip";
@@ -284,6 +306,109 @@
     
 }
 
+- (void)test_fusedDigestOfData
+{
+    NSString *filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file1m"];
+    NSData *data = [NSData dataWithContentsOfFile:filePath];
+    
+    OSSInputStreamHelper *helper = [[OSSInputStreamHelper alloc] initWithData:data];
+    helper.digestTypes = OSSDigestTypeCRC64 | OSSDigestTypeMD5 | OSSDigestTypeSHA1;
+    [helper syncReadBuffers];
+    
+    XCTAssertEqual(helper.crc64, [OSSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length]);
+    XCTAssertEqualObjects(helper.base64Md5, [OSSUtil base64Md5ForData:data]);
+    XCTAssertEqualObjects(helper.sha1String, [OSSUtil sha1WithData:data]);
+}
+
+- (void)test_asyncDigestOfFile
+{
+    NSString *filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file5m"];
+    
+    OSSInputStreamHelper *syncHelper = [[OSSInputStreamHelper alloc] initWithFileAtPath:filePath];
+    [syncHelper syncReadBuffers];
+    
+    OSSInputStreamHelper *asyncHelper = [[OSSInputStreamHelper alloc] initWithFileAtPath:filePath];
+    asyncHelper.digestTypes = OSSDigestTypeCRC64 | OSSDigestTypeMD5;
+    [asyncHelper asyncReadBuffers];
+    XCTAssertEqual(asyncHelper.crc64, syncHelper.crc64);
+    XCTAssertEqualObjects(asyncHelper.base64Md5, [OSSUtil base64Md5ForFilePath:filePath]);
+}
+
+- (void)test_concurrentDigestOfFile
+{
+    // 10MB is digested on several cores, the crc64 in slices combined afterwards
+    NSString *filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file10m"];
+    NSData *data = [NSData dataWithContentsOfFile:filePath];
+
+    OSSInputStreamHelper *helper = [[OSSInputStreamHelper alloc] initWithFileAtPath:filePath];
+    helper.digestTypes = OSSDigestTypeCRC64 | OSSDigestTypeMD5 | OSSDigestTypeSHA1;
+    [helper syncReadBuffers];
+
+    XCTAssertEqual(helper.crc64, [OSSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length]);
+    XCTAssertEqualObjects(helper.base64Md5, [OSSUtil base64Md5ForData:data]);
+    XCTAssertEqualObjects(helper.sha1String, [OSSUtil sha1WithData:data]);
+    XCTAssertEqualObjects([OSSUtil fileMD5String:filePath], [OSSUtil dataMD5String:data]);
+    XCTAssertEqualObjects([OSSUtil sha1WithFilePath:filePath], [OSSUtil sha1WithData:data]);
+    XCTAssertNil([OSSUtil sha1WithFilePath:[filePath stringByAppendingString:@"_missing"]]);
+}
+
+- (void)test_crc64KnownVectors
+{
+    // CRC-64/XZ check value
+    const char *check = "123456789";
+    XCTAssertEqual([OSSUtil crc64ecma:0 buffer:(void *)check length:strlen(check)], 0x995DC9BBDF1939FAULL);
+    XCTAssertEqual([OSSUtil crc64ecmaByTable:0 buffer:(void *)check length:strlen(check)], 0x995DC9BBDF1939FAULL);
+    XCTAssertEqual([OSSUtil crc64ecma:0 buffer:(void *)check length:0], 0ULL);
+    
+    NSMutableData *zeros = [NSMutableData dataWithLength:4096];
+    XCTAssertEqual([OSSUtil crc64ecma:0 buffer:zeros.mutableBytes length:zeros.length],
+                   [OSSUtil crc64ecmaByTable:0 buffer:zeros.mutableBytes length:zeros.length]);
+}
+
+- (void)test_crc64AcceleratedMatchesTable
+{
+    NSLog(@"crc64 hardware accelerated: %d", [OSSUtil isCrc64HardwareAccelerated]);
+    NSUInteger capacity = 64 * 1024 + 64;
+    NSMutableData *data = [NSMutableData dataWithLength:capacity];
+    uint8_t *bytes = data.mutableBytes;
+    for (NSUInteger i = 0; i < capacity; i++) {
+        bytes[i] = (uint8_t)(i * 31 + (i >> 7));
+    }
+    
+    // every length around the 16/64 byte fold boundaries and every misalignment
+    for (NSUInteger offset = 0; offset < 16; offset++) {
+        for (NSUInteger length = 0; length <= 600; length++) {
+            uint64_t initial = offset * 0x9E3779B97F4A7C15ULL;
+            uint64_t expected = [OSSUtil crc64ecmaByTable:initial buffer:bytes + offset length:length];
+            uint64_t actual = [OSSUtil crc64ecma:initial buffer:bytes + offset length:length];
+            XCTAssertEqual(actual, expected, @"offset: %lu, length: %lu", (unsigned long)offset, (unsigned long)length);
+        }
+    }
+    
+    uint64_t expected = [OSSUtil crc64ecmaByTable:0 buffer:bytes length:capacity];
+    XCTAssertEqual([OSSUtil crc64ecma:0 buffer:bytes length:capacity], expected);
+    
+    // chunked updates and combine must agree with the one shot value
+    uint64_t chunked = 0;
+    for (NSUInteger offset = 0; offset < capacity; offset += 1000) {
+        chunked = [OSSUtil crc64ecma:chunked buffer:bytes + offset length:MIN(1000, capacity - offset)];
+    }
+    XCTAssertEqual(chunked, expected);
+    
+    uint64_t crc1 = [OSSUtil crc64ecma:0 buffer:bytes length:40000];
+    uint64_t crc2 = [OSSUtil crc64ecma:0 buffer:bytes + 40000 length:capacity - 40000];
+    XCTAssertEqual([OSSUtil crc64ForCombineCRC1:crc1 CRC2:crc2 length:capacity - 40000], expected);
+}
+
+- (void)test_crc64PerformanceOf4MB
+{
+    NSMutableData *data = [NSMutableData dataWithLength:4 * 1024 * 1024];
+    arc4random_buf(data.mutableBytes, data.length);
+    [self measureBlock:^{
+        [OSSUtil crc64ecma:0 buffer:data.mutableBytes length:data.length];
+    }];
+}
+
 - (NSString *)getRecordFilePath:(OSSResumableUploadRequest *)resumableUpload {
     NSString *recordPathMd5 = [OSSUtil fileMD5String:[resumableUpload.uploadingFileURL path]];
     NSData *data = [[NSString stringWithFormat:@"%@%@%@%lu",recordPathMd5, resumableUpload.bucketName, resumableUpload.objectKey, resumableUpload.partSize] dataUsingEncoding:NSUTF8StringEncoding];
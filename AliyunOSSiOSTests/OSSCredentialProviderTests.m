@@ -84,6 +84,51 @@
     [self headObjectWithBackgroundSessionIdentifier:@"com.aliyun.testcases.federationprovider.identifier" provider:provider];
 }
 
+- (void)testForFederationCredentialProviderRefreshAhead
+{
+    __block NSInteger fetchCount = 0;
+    OSSFederationCredentialProvider *provider = [[OSSFederationCredentialProvider alloc] initWithFederationTokenGetter:^OSSFederationToken *{
+        @synchronized(self) {
+            fetchCount++;
+        }
+        [NSThread sleepForTimeInterval:0.5];
+        OSSFederationToken *token = [OSSFederationToken new];
+        token.tAccessKey = _token.tAccessKey;
+        token.tSecretKey = _token.tSecretKey;
+        token.tToken = _token.tToken;
+        token.expirationTimeInMilliSecond = ([[NSDate oss_clockSkewFixedDate] timeIntervalSince1970] + 3600) * 1000;
+        return token;
+    }];
+
+    // the callers asking at once share one fetch
+    NSMutableArray<OSSTask *> *tasks = [NSMutableArray array];
+    for (int i = 0; i < 10; i++) {
+        [tasks addObject:[provider getTokenAsync]];
+    }
+    [[OSSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+    XCTAssertEqual(1, fetchCount);
+    for (OSSTask *task in tasks) {
+        XCTAssertEqual(provider.cachedToken, task.result);
+    }
+
+    // a token in its refresh window is still returned at once, while the new one is got in the background
+    OSSFederationToken *expiringToken = [OSSFederationToken new];
+    expiringToken.tAccessKey = _token.tAccessKey;
+    expiringToken.tSecretKey = _token.tSecretKey;
+    expiringToken.tToken = _token.tToken;
+    expiringToken.expirationTimeInMilliSecond = ([[NSDate oss_clockSkewFixedDate] timeIntervalSince1970] + 5 * 60 + 30) * 1000;
+    provider.cachedToken = expiringToken;
+
+    NSError *error = nil;
+    XCTAssertEqual(expiringToken, [provider getToken:&error]);
+    XCTAssertNil(error);
+    [NSThread sleepForTimeInterval:1];
+    XCTAssertEqual(2, fetchCount);
+    XCTAssertNotEqual(expiringToken, provider.cachedToken);
+
+    [self headObjectWithBackgroundSessionIdentifier:@"com.aliyun.testcases.federationproviderrefreshahead.identifier" provider:provider];
+}
+
 - (void)testGetStsTokenCredentialProvider
 {
     OSSStsTokenCredentialProvider *provider = [[OSSStsTokenCredentialProvider alloc] initWithAccessKeyId:_token.tAccessKey secretKeyId:_token.tSecretKey securityToken:_token.tToken];
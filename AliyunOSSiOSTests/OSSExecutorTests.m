@@ -56,6 +56,62 @@
     [task waitUntilFinished];
 }
 
+- (void)testExecuteWithFixedWidth {
+    OSSExecutor *executor = [OSSExecutor executorWithWidth:3 qualityOfService:QOS_CLASS_UTILITY];
+    __block NSInteger runningCount = 0;
+    __block NSInteger maxRunningCount = 0;
+    NSObject *lock = [NSObject new];
+
+    NSMutableArray<OSSTask *> *tasks = [NSMutableArray array];
+    for (int i = 0; i < 30; i++) {
+        [tasks addObject:[[OSSTask taskWithResult:nil] continueWithExecutor:executor withBlock:^id(OSSTask *_) {
+            @synchronized(lock) {
+                runningCount++;
+                maxRunningCount = MAX(maxRunningCount, runningCount);
+            }
+            XCTAssertEqual(QOS_CLASS_UTILITY, qos_class_self());
+            [NSThread sleepForTimeInterval:0.01];
+            @synchronized(lock) {
+                runningCount--;
+            }
+            return @(i);
+        }]];
+    }
+    [[OSSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+
+    XCTAssertEqual(3, maxRunningCount);
+    for (int i = 0; i < 30; i++) {
+        XCTAssertEqualObjects(@(i), tasks[i].result);
+    }
+}
+
+- (void)measureThroughputOfExecutor:(OSSExecutor *)executor {
+    // 100 chains of 100 continuations, as many requests of a few steps each would make
+    [self measureBlock:^{
+        NSMutableArray<OSSTask *> *tasks = [NSMutableArray array];
+        for (int i = 0; i < 100; i++) {
+            OSSTask *task = [OSSTask taskWithResult:nil];
+            for (int j = 0; j < 100; j++) {
+                task = [task continueWithExecutor:executor withBlock:^id(OSSTask *previousTask) {
+                    return nil;
+                }];
+            }
+            [tasks addObject:task];
+        }
+        [[OSSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+    }];
+}
+
+- (void)testPerformanceForFixedWidthExecutor {
+    [self measureThroughputOfExecutor:[OSSExecutor executorWithWidth:4 qualityOfService:QOS_CLASS_DEFAULT]];
+}
+
+- (void)testPerformanceForOperationQueueExecutor {
+    NSOperationQueue *queue = [NSOperationQueue new];
+    queue.maxConcurrentOperationCount = 4;
+    [self measureThroughputOfExecutor:[OSSExecutor executorWithOperationQueue:queue]];
+}
+
 - (void)testMainThreadExecutor {
     OSSExecutor *executor = [OSSExecutor mainThreadExecutor];
     
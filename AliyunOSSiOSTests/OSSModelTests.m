@@ -9,11 +9,68 @@
 #import <XCTest/XCTest.h>
 #import <AliyunOSSiOS/OSSModel.h>
 #import <AliyunOSSiOS/OSSUtil.h>
+#import <AliyunOSSiOS/OSSProgressReporter.h>
+#import <AliyunOSSiOS/OSSBolts.h>
+#import <AliyunOSSiOS/OSSPartInfoJournal.h>
+#import <AliyunOSSiOS/OSSNetworking.h>
+#import <AliyunOSSiOS/OSSPartScheduler.h>
+#import <AliyunOSSiOS/OSSTransferScheduler.h>
+#import <AliyunOSSiOS/OSSRequestCoalescer.h>
+#import <AliyunOSSiOS/OSSLog.h>
+#import <AliyunOSSiOS/OSSObjectCache.h>
+#import <AliyunOSSiOS/OSSCacheIndex.h>
+#import <AliyunOSSiOS/OSSMemoryGovernor.h>
+#import <AliyunOSSiOS/OSSContentCompressor.h>
+#import <AliyunOSSiOS/OSSEndpointSelector.h>
+#import <AliyunOSSiOS/OSSReachabilityManager.h>
 
 @interface OSSModelTests : XCTestCase
 
 @end
 
+/* a session task which is never sent, it only records its cancels */
+@interface OSSStubSessionTask : NSURLSessionDataTask
+@property (atomic, assign) int cancelCount;
+@end
+@implementation OSSStubSessionTask
+
+- (NSUInteger)taskIdentifier {
+    return (NSUInteger)(uintptr_t)self;
+}
+
+- (NSURLRequest *)originalRequest {
+    return nil;
+}
+
+- (NSURLResponse *)response {
+    return nil;
+}
+
+- (void)cancel {
+    self.cancelCount++;
+}
+
+@end
+
+/* counts the sends of its request, which fail here unless the request is cancelled */
+@interface OSSSendCountingInterceptor : NSObject <OSSRequestInterceptor>
+@property (nonatomic, weak) OSSNetworkingRequestDelegate *request;
+@property (atomic, assign) int sendCount;
+@end
+@implementation OSSSendCountingInterceptor
+
+- (OSSTask *)interceptRequestMessage:(OSSAllRequestNeededMessage *)request {
+    self.sendCount++;
+    if (self.request.isRequestCancelled) {
+        return [OSSTask taskWithResult:nil];
+    }
+    return [OSSTask taskWithError:[NSError errorWithDomain:OSSClientErrorDomain
+                                                      code:OSSClientErrorCodeNetworkError
+                                                  userInfo:nil]];
+}
+
+@end
+
 @implementation OSSModelTests
 
 - (void)setUp {
@@ -36,6 +93,38 @@
     XCTAssertEqualObjects(urlString,urlString1);
 }
 
+- (void)testForCategoryForNSDate
+{
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:784111777];
+    XCTAssertEqualObjects([date oss_asStringValue], @"Sun, 06 Nov 1994 08:49:37 GMT");
+    XCTAssertEqualObjects([NSDate oss_dateFromString:@"Sun, 06 Nov 1994 08:49:37 GMT"], date);
+    XCTAssertEqualObjects([NSDate oss_dateFromISO8601String:@"1994-11-06T08:49:37Z"], date);
+    XCTAssertEqualObjects([NSDate oss_dateFromISO8601String:@"1994-11-06T16:49:37+08:00"], date);
+    XCTAssertNil([NSDate oss_dateFromString:@"not a date"]);
+
+    // the formatted string must match what NSDateFormatter produced before
+    NSDateFormatter *dateFormatter = [NSDateFormatter new];
+    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
+    dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+    dateFormatter.dateFormat = @"EEE, dd MMM yyyy HH:mm:ss z";
+    for (int i = 0; i < 100; i++) {
+        NSDate *randomDate = [NSDate dateWithTimeIntervalSince1970:arc4random()];
+        NSString *dateString = [randomDate oss_asStringValue];
+        XCTAssertEqualObjects(dateString, [dateFormatter stringFromDate:randomDate]);
+        XCTAssertEqualObjects([NSDate oss_dateFromString:dateString], [dateFormatter dateFromString:dateString]);
+    }
+}
+
+- (void)testPerformanceForCategoryForNSDate
+{
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            NSString *dateString = [[NSDate oss_clockSkewFixedDate] oss_asStringValue];
+            [NSDate oss_dateFromString:dateString];
+        }
+    }];
+}
+
 - (void)testForOSSSyncMutableDictionary
 {
     OSSSyncMutableDictionary *syncMutableDict = [[OSSSyncMutableDictionary alloc] init];
@@ -44,4 +133,839 @@
     XCTAssertNotNil(syncMutableDict.allKeys);
 }
 
+- (void)testForOSSShardedMutableDictionary
+{
+    OSSShardedMutableDictionary *shardedDict = [[OSSShardedMutableDictionary alloc] init];
+    dispatch_apply(1000, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        [shardedDict setObject:@(i) forKey:@(i)];
+    });
+    XCTAssertEqual(shardedDict.allKeys.count, 1000);
+    XCTAssertEqualObjects([shardedDict objectForKey:@(512)], @(512));
+    XCTAssertNil([shardedDict objectForKey:nil]);
+
+    dispatch_apply(500, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        [shardedDict removeObjectForKey:@(i * 2)];
+    });
+    XCTAssertEqual(shardedDict.allKeys.count, 500);
+    XCTAssertNil([shardedDict objectForKey:@(512)]);
+    XCTAssertEqualObjects([shardedDict objectForKey:@(511)], @(511));
+
+    // it's what the public sessionDelagateManager, an OSSSyncMutableDictionary, holds
+    OSSNetworking *networking = [[OSSNetworking alloc] initWithConfiguration:[OSSNetworkingConfiguration new]];
+    XCTAssertTrue([networking.sessionDelagateManager isKindOfClass:[OSSShardedMutableDictionary class]]);
+}
+
+// simulates the networking callbacks of 32 concurrent tasks, each looking up its delegate per data chunk
+- (void)lookupDelegatesConcurrentlyWithDictionary:(id)dictionary
+{
+    const size_t taskCount = 32;
+    const size_t chunksPerTask = 20000;
+    for (size_t i = 0; i < taskCount; i++) {
+        [dictionary setObject:[NSObject new] forKey:@(i)];
+    }
+    dispatch_apply(taskCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        for (size_t chunk = 0; chunk < chunksPerTask; chunk++) {
+            if ([dictionary objectForKey:@(i)] == nil) {
+                XCTFail(@"delegate of task %zu lost", i);
+            }
+        }
+    });
+}
+
+- (void)testForOSSProgressReporterCoalescing
+{
+    NSMutableArray<NSNumber *> *totals = [NSMutableArray array];
+    __block int64_t reportedBytes = 0;
+    OSSProgressReporter *reporter = [[OSSProgressReporter alloc] initWithProgress:^(int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend) {
+        reportedBytes += bytesSent;
+        [totals addObject:@(totalBytesSent)];
+    } executor:nil];
+    reporter.minimumBytes = 1000;
+
+    int64_t total = 0;
+    for (int i = 0; i < 100; i++) {
+        total += 100;
+        [reporter reportBytes:100 totalBytes:total totalBytesExpected:10000];
+    }
+    // the first update, one every 1000 bytes, and the final one
+    XCTAssertEqual(totals.count, 11);
+    XCTAssertEqualObjects(totals.lastObject, @(10000));
+    XCTAssertEqual(reportedBytes, 10000);
+
+    [reporter flush];
+    XCTAssertEqual(totals.count, 11);
+}
+
+- (void)testForOSSProgressReporterOnExecutor
+{
+    dispatch_queue_t queue = dispatch_queue_create("com.aliyun.oss.progresstest", DISPATCH_QUEUE_SERIAL);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"progress finished"];
+    __block int64_t lastTotal = 0;
+    __block int64_t reportedBytes = 0;
+    __block NSUInteger callCount = 0;
+    OSSProgressReporter *reporter = [[OSSProgressReporter alloc] initWithProgress:^(int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend) {
+        XCTAssertGreaterThanOrEqual(totalBytesSent, lastTotal);
+        lastTotal = totalBytesSent;
+        reportedBytes += bytesSent;
+        callCount++;
+        if (totalBytesSent == totalBytesExpectedToSend) {
+            [expectation fulfill];
+        }
+    } executor:[OSSExecutor executorWithDispatchQueue:queue]];
+    reporter.minimumInterval = 0.05;
+
+    // 32 parts reporting concurrently
+    __block int64_t total = 0;
+    NSObject *lock = [NSObject new];
+    dispatch_apply(32, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t part) {
+        for (int i = 0; i < 1000; i++) {
+            @synchronized(lock) {
+                total += 10;
+                [reporter reportBytes:10 totalBytes:total totalBytesExpected:320000];
+            }
+        }
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    dispatch_sync(queue, ^{});
+    XCTAssertEqual(reportedBytes, 320000);
+    XCTAssertLessThan(callCount, 1000);
+}
+
+- (void)testForOSSPartInfoJournal
+{
+    NSString *journalPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    OSSPartInfoJournal *journal = [[OSSPartInfoJournal alloc] initWithFilePath:journalPath];
+    for (int32_t i = 1; i <= 100; i++) {
+        OSSPartInfo *partInfo = [OSSPartInfo partInfoWithPartNum:i eTag:[NSString stringWithFormat:@"etag-%d", i] size:i * 100 crc64:UINT64_MAX - i];
+        XCTAssertTrue([journal appendPartInfo:partInfo error:nil]);
+    }
+    // a part uploaded again overrides its former record
+    XCTAssertTrue([journal appendPartInfo:[OSSPartInfo partInfoWithPartNum:7 eTag:@"etag-retry" size:700 crc64:7] error:nil]);
+    [journal close];
+
+    // a torn record written by a crash is dropped
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingAtPath:journalPath];
+    [fileHandle seekToEndOfFile];
+    [fileHandle writeData:[@"torn" dataUsingEncoding:NSUTF8StringEncoding]];
+    [fileHandle closeFile];
+
+    OSSPartInfoJournal *resumedJournal = [[OSSPartInfoJournal alloc] initWithFilePath:journalPath];
+    NSDictionary *partInfos = [resumedJournal partInfos];
+    XCTAssertEqual(partInfos.count, 100);
+    XCTAssertEqualObjects(partInfos[@"1"][@"eTag"], @"etag-1");
+    XCTAssertEqualObjects(partInfos[@"7"][@"eTag"], @"etag-retry");
+    XCTAssertEqual([partInfos[@"100"][@"size"] longLongValue], 10000);
+    XCTAssertEqual([partInfos[@"100"][@"crc64"] unsignedLongLongValue], UINT64_MAX - 100);
+
+    XCTAssertTrue([resumedJournal appendPartInfo:[OSSPartInfo partInfoWithPartNum:101 eTag:@"etag-101" size:1 crc64:1] error:nil]);
+    [resumedJournal close];
+    XCTAssertEqual([[[OSSPartInfoJournal alloc] initWithFilePath:journalPath] partInfos].count, 101);
+    [[NSFileManager defaultManager] removeItemAtPath:journalPath error:nil];
+}
+
+- (void)testForOSSPartInfoJournalCompaction
+{
+    NSString *journalPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    OSSPartInfoJournal *journal = [[OSSPartInfoJournal alloc] initWithFilePath:journalPath];
+    OSSPartInfo *partInfo = [OSSPartInfo partInfoWithPartNum:1 eTag:@"etag" size:100 crc64:1];
+    XCTAssertTrue([journal appendPartInfo:partInfo error:nil]);
+    unsigned long long singleRecordSize = [[[NSFileManager defaultManager] attributesOfItemAtPath:journalPath error:nil] fileSize];
+    for (int i = 0; i < 1000; i++) {
+        XCTAssertTrue([journal appendPartInfo:partInfo error:nil]);
+    }
+    [journal close];
+    unsigned long long journalSize = [[[NSFileManager defaultManager] attributesOfItemAtPath:journalPath error:nil] fileSize];
+    XCTAssertLessThan(journalSize, singleRecordSize * 200);
+    XCTAssertEqual([[[OSSPartInfoJournal alloc] initWithFilePath:journalPath] partInfos].count, 1);
+    [[NSFileManager defaultManager] removeItemAtPath:journalPath error:nil];
+}
+
+- (void)testForOSSJitteredRetryPolicy
+{
+    OSSJitteredRetryPolicy *policy = [OSSJitteredRetryPolicy policyWithMaxRetryCount:3];
+    OSSNetworkingRequestDelegate *delegate = [OSSNetworkingRequestDelegate new];
+    delegate.operType = OSSOperationTypeGetObject;
+    NSURL *url = [NSURL URLWithString:@"https://oss-cn-hangzhou.aliyuncs.com"];
+
+    NSError *timeout = [NSError errorWithDomain:OSSClientErrorDomain
+                                           code:OSSClientErrorCodeNetworkError
+                                       userInfo:@{@"OriginErrorCode": [@(NSURLErrorTimedOut) stringValue]}];
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:delegate response:nil error:timeout], OSSNetworkingRetryTypeShouldRetry);
+    XCTAssertEqual(policy.availableRetryTokens, policy.retryTokenCapacity - policy.timeoutRetryCost);
+    XCTAssertEqual([policy shouldRetry:3 requestDelegate:delegate response:nil error:timeout], OSSNetworkingRetryTypeShouldNotRetry);
+
+    // decorrelated jitter stays within [baseDelay, maxDelay]
+    for (uint32_t i = 0; i < 50; i++) {
+        NSTimeInterval interval = [policy timeIntervalForRetry:i requestDelegate:delegate response:nil retryType:OSSNetworkingRetryTypeShouldRetry];
+        XCTAssertGreaterThanOrEqual(interval, policy.baseDelay);
+        XCTAssertLessThanOrEqual(interval, policy.maxDelay);
+    }
+
+    // the first retries of the requests which failed together are spread out
+    NSMutableSet<NSNumber *> *firstIntervals = [NSMutableSet set];
+    for (int i = 0; i < 20; i++) {
+        OSSNetworkingRequestDelegate *freshDelegate = [OSSNetworkingRequestDelegate new];
+        NSTimeInterval interval = [policy timeIntervalForRetry:0 requestDelegate:freshDelegate response:nil retryType:OSSNetworkingRetryTypeShouldRetry];
+        XCTAssertGreaterThanOrEqual(interval, policy.baseDelay);
+        XCTAssertLessThanOrEqual(interval, MIN(policy.baseDelay * 3, policy.maxDelay));
+        [firstIntervals addObject:@(interval)];
+    }
+    XCTAssertGreaterThan(firstIntervals.count, 10);
+
+    // 503 honors Retry-After, a too long one isn't waited for
+    NSHTTPURLResponse *throttled = [[NSHTTPURLResponse alloc] initWithURL:url statusCode:503 HTTPVersion:@"HTTP/1.1" headerFields:@{@"Retry-After": @"3"}];
+    NSError *serverError = [NSError errorWithDomain:OSSServerErrorDomain code:-503 userInfo:nil];
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:delegate response:throttled error:serverError], OSSNetworkingRetryTypeShouldRetry);
+    XCTAssertGreaterThanOrEqual([policy timeIntervalForRetry:0 requestDelegate:delegate response:throttled retryType:OSSNetworkingRetryTypeShouldRetry], 3);
+    NSHTTPURLResponse *tooLong = [[NSHTTPURLResponse alloc] initWithURL:url statusCode:429 HTTPVersion:@"HTTP/1.1" headerFields:@{@"Retry-After": @"3600"}];
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:delegate response:tooLong error:serverError], OSSNetworkingRetryTypeShouldNotRetry);
+
+    // appends without a position and completes are only retried when nothing was sent
+    OSSNetworkingRequestDelegate *append = [OSSNetworkingRequestDelegate new];
+    append.operType = OSSOperationTypeAppendObject;
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:append response:nil error:timeout], OSSNetworkingRetryTypeShouldNotRetry);
+    NSError *cannotConnect = [NSError errorWithDomain:OSSClientErrorDomain
+                                                 code:OSSClientErrorCodeNetworkError
+                                             userInfo:@{@"OriginErrorCode": [@(NSURLErrorCannotConnectToHost) stringValue]}];
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:append response:nil error:cannotConnect], OSSNetworkingRetryTypeShouldRetry);
+    OSSNetworkingRequestDelegate *complete = [OSSNetworkingRequestDelegate new];
+    complete.operType = OSSOperationTypeCompleteMultipartUpload;
+    NSHTTPURLResponse *internalError = [[NSHTTPURLResponse alloc] initWithURL:url statusCode:500 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:complete response:internalError error:serverError], OSSNetworkingRetryTypeShouldNotRetry);
+}
+
+- (void)testForOSSJitteredRetryPolicyTokenBucket
+{
+    OSSJitteredRetryPolicy *policy = [OSSJitteredRetryPolicy policyWithMaxRetryCount:3];
+    policy.retryTokenCapacity = 10;
+    OSSNetworkingRequestDelegate *delegate = [OSSNetworkingRequestDelegate new];
+    delegate.operType = OSSOperationTypeHeadObject;
+    NSError *error = [NSError errorWithDomain:OSSClientErrorDomain code:OSSClientErrorCodeNetworkError userInfo:nil];
+
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:delegate response:nil error:error], OSSNetworkingRetryTypeShouldRetry);
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:delegate response:nil error:error], OSSNetworkingRetryTypeShouldRetry);
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:delegate response:nil error:error], OSSNetworkingRetryTypeShouldNotRetry);
+    XCTAssertEqual(policy.availableRetryTokens, 0);
+
+    for (int i = 0; i < 5; i++) {
+        [policy requestDidSucceed:delegate];
+    }
+    XCTAssertEqual([policy shouldRetry:0 requestDelegate:delegate response:nil error:error], OSSNetworkingRetryTypeShouldRetry);
+}
+
+- (void)testForOSSPartSchedulerConcurrency
+{
+    OSSPartScheduler *scheduler = [[OSSPartScheduler alloc] initWithConcurrency:2 partSize:1024 * 1024];
+    scheduler.adaptsConcurrency = YES;
+    scheduler.maxConcurrency = 6;
+    int64_t length = 1024 * 1024;
+
+    // one round is as many parts as the window, the window grows while the throughput does
+    for (int i = 0; i < 2; i++) {
+        [scheduler recordPartWithLength:length startTime:0 endTime:1 succeeded:YES];
+    }
+    XCTAssertEqual(scheduler.concurrency, 3);
+    XCTAssertEqualWithAccuracy(scheduler.throughput, 2 * length, 1);
+    for (int i = 0; i < 3; i++) {
+        [scheduler recordPartWithLength:length startTime:1 endTime:2 succeeded:YES];
+    }
+    XCTAssertEqual(scheduler.concurrency, 4);
+
+    // the parts slow down without the throughput growing
+    for (int i = 0; i < 4; i++) {
+        [scheduler recordPartWithLength:length startTime:2 endTime:4.5 succeeded:YES];
+    }
+    XCTAssertEqual(scheduler.concurrency, 3);
+
+    [scheduler recordPartWithLength:length startTime:5 endTime:6 succeeded:NO];
+    XCTAssertEqual(scheduler.concurrency, 1);
+    [scheduler recordPartWithLength:length startTime:6 endTime:7 succeeded:NO];
+    XCTAssertEqual(scheduler.concurrency, 1);
+}
+
+- (void)testForOSSPartSchedulerPartSize
+{
+    NSUInteger MB = 1024 * 1024;
+    OSSPartScheduler *fixed = [[OSSPartScheduler alloc] initWithConcurrency:5 partSize:256 * 1024];
+    XCTAssertEqual([fixed partSizeForRemainingLength:MB remainingPartCount:3], 256 * 1024);
+    XCTAssertEqual([fixed partSizeForRemainingLength:MB remainingPartCount:1], MB);
+    XCTAssertEqual(fixed.maxConcurrency, 5);
+
+    OSSPartScheduler *scheduler = [[OSSPartScheduler alloc] initWithConcurrency:5 partSize:256 * 1024];
+    scheduler.adaptsPartSize = YES;
+    XCTAssertEqual([scheduler partSizeForRemainingLength:100 * MB remainingPartCount:1000], 256 * 1024);
+    [scheduler recordPartWithLength:MB startTime:0 endTime:1 succeeded:YES];
+    XCTAssertEqual([scheduler partSizeForRemainingLength:100 * MB remainingPartCount:100], 2 * MB);
+    XCTAssertEqual([scheduler partSizeForRemainingLength:MB remainingPartCount:100], MB);
+    // the rest still has to fit in the parts left
+    XCTAssertEqual([scheduler partSizeForRemainingLength:100 * MB remainingPartCount:10], 10 * MB);
+
+    [scheduler recordPartWithLength:100 * MB startTime:1 endTime:2 succeeded:YES];
+    XCTAssertEqual([scheduler partSizeForRemainingLength:100 * MB remainingPartCount:100], 4 * MB);
+    for (int i = 0; i < 30; i++) {
+        [scheduler recordPartWithLength:10 * 1024 startTime:2 + i * 10 endTime:12 + i * 10 succeeded:YES];
+    }
+    // a slow link gets the smallest parts
+    XCTAssertEqual([scheduler partSizeForRemainingLength:100 * MB remainingPartCount:10000], 100 * 1024);
+}
+
+- (void)testForOSSTransferScheduler
+{
+    OSSTransferScheduler *scheduler = [OSSTransferScheduler new];
+    scheduler.maxRequestCount = 1;
+    NSMutableArray<NSString *> *sentOrder = [NSMutableArray array];
+    OSSTaskCompletionSource *firstSource = [OSSTaskCompletionSource taskCompletionSource];
+    
+    OSSNetworkingRequestDelegate *first = [OSSNetworkingRequestDelegate new];
+    first.operType = OSSOperationTypeUploadPart;
+    XCTAssertEqual([OSSTransferScheduler priorityOfRequest:first], OSSRequestPriorityBulk);
+    [scheduler scheduleRequest:first send:^OSSTask *{
+        @synchronized(sentOrder) {
+            [sentOrder addObject:@"first"];
+        }
+        return firstSource.task;
+    }];
+    
+    OSSNetworkingRequestDelegate *bulk = [OSSNetworkingRequestDelegate new];
+    bulk.operType = OSSOperationTypeUploadPart;
+    OSSTask *bulkTask = [scheduler scheduleRequest:bulk send:^OSSTask *{
+        @synchronized(sentOrder) {
+            [sentOrder addObject:@"bulk"];
+        }
+        return [OSSTask taskWithResult:@"bulk"];
+    }];
+    OSSNetworkingRequestDelegate *cancelled = [OSSNetworkingRequestDelegate new];
+    OSSTask *cancelledTask = [scheduler scheduleRequest:cancelled send:^OSSTask *{
+        @synchronized(sentOrder) {
+            [sentOrder addObject:@"cancelled"];
+        }
+        return [OSSTask taskWithResult:nil];
+    }];
+    OSSNetworkingRequestDelegate *interactive = [OSSNetworkingRequestDelegate new];
+    interactive.operType = OSSOperationTypeGetObject;
+    OSSTask *interactiveTask = [scheduler scheduleRequest:interactive send:^OSSTask *{
+        @synchronized(sentOrder) {
+            [sentOrder addObject:@"interactive"];
+        }
+        return [OSSTask taskWithResult:@"interactive"];
+    }];
+    XCTAssertEqual(scheduler.runningCount, 1);
+    XCTAssertEqual(scheduler.waitingCount, 3);
+    
+    // a request cancelled while it waits fails without being sent
+    [cancelled cancel];
+    XCTAssertEqual(cancelledTask.error.code, OSSClientErrorCodeTaskCancelled);
+    XCTAssertEqual(scheduler.waitingCount, 2);
+    
+    [firstSource setResult:@"first"];
+    [bulkTask waitUntilFinished];
+    [interactiveTask waitUntilFinished];
+    XCTAssertEqualObjects(bulkTask.result, @"bulk");
+    XCTAssertEqualObjects(interactiveTask.result, @"interactive");
+    NSArray *expectedOrder = @[@"first", @"interactive", @"bulk"];
+    XCTAssertEqualObjects(sentOrder, expectedOrder);
+    XCTAssertEqual(scheduler.runningCount, 0);
+}
+
+- (void)testForOSSTransferScheduler_pausesBulkWhileOffline
+{
+    OSSTransferScheduler *scheduler = [OSSTransferScheduler new];
+    [self postNetworkStatus:OSSNetworkStatusNotReachable previousStatus:OSSNetworkStatusReachableViaWiFi toObject:scheduler];
+
+    OSSNetworkingRequestDelegate *bulk = [OSSNetworkingRequestDelegate new];
+    bulk.operType = OSSOperationTypeUploadPart;
+    OSSTask *bulkTask = [scheduler scheduleRequest:bulk send:^OSSTask *{
+        return [OSSTask taskWithResult:@"bulk"];
+    }];
+    OSSNetworkingRequestDelegate *interactive = [OSSNetworkingRequestDelegate new];
+    interactive.operType = OSSOperationTypeGetObject;
+    OSSTask *interactiveTask = [scheduler scheduleRequest:interactive send:^OSSTask *{
+        return [OSSTask taskWithResult:@"interactive"];
+    }];
+    [interactiveTask waitUntilFinished];
+    XCTAssertEqualObjects(interactiveTask.result, @"interactive");
+    // nothing is in flight, the bulk request still waits for the network
+    XCTAssertFalse(bulkTask.completed);
+    XCTAssertEqual(scheduler.waitingCount, 1);
+
+    [self postNetworkStatus:OSSNetworkStatusReachableViaWWAN previousStatus:OSSNetworkStatusNotReachable toObject:scheduler];
+    [bulkTask waitUntilFinished];
+    XCTAssertEqualObjects(bulkTask.result, @"bulk");
+    XCTAssertEqual(scheduler.waitingCount, 0);
+}
+
+- (void)testForOSSNetworking_resendsRequestInterruptedByNetworkChange
+{
+    OSSNetworking *networking = [[OSSNetworking alloc] initWithConfiguration:[OSSNetworkingConfiguration new]];
+    OSSStubSessionTask *sessionTask = [self stubSessionTask];
+    OSSSendCountingInterceptor *interceptor = [OSSSendCountingInterceptor new];
+    OSSNetworkingRequestDelegate *request = [self requestOnNetworking:networking sessionTask:sessionTask interceptor:interceptor];
+    request.currentRetryCount = 1;
+    XCTestExpectation *completed = [self expectationWithDescription:@"request completed"];
+    __block NSError *completionError = nil;
+    request.completionHandler = ^(id responseObject, NSError *error) {
+        completionError = error;
+        [completed fulfill];
+    };
+
+    [self postNetworkStatus:OSSNetworkStatusNotReachable previousStatus:OSSNetworkStatusReachableViaWiFi toObject:networking];
+    XCTAssertEqual(sessionTask.cancelCount, 1);
+    XCTAssertTrue(request.isInterruptedByNetworkChange);
+
+    // offline the cancelled request is parked, neither failed nor sent
+    [self completeSessionTask:sessionTask onNetworking:networking];
+    XCTAssertFalse(request.isInterruptedByNetworkChange);
+    XCTAssertNotNil(request.cancellationHandler);
+    XCTAssertEqual(interceptor.sendCount, 0);
+
+    [self postNetworkStatus:OSSNetworkStatusReachableViaWWAN previousStatus:OSSNetworkStatusNotReachable toObject:networking];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(interceptor.sendCount, 1);
+    XCTAssertEqual(completionError.code, OSSClientErrorCodeNetworkError);
+    XCTAssertNil(request.cancellationHandler);
+    // the interrupted attempt doesn't count as a retry
+    XCTAssertEqual(request.currentRetryCount, 1);
+}
+
+- (void)testForOSSNetworking_resendsParkedRequestAfterResourceTimeout
+{
+    OSSNetworkingConfiguration *configuration = [OSSNetworkingConfiguration new];
+    configuration.timeoutIntervalForResource = 0.5;
+    OSSNetworking *networking = [[OSSNetworking alloc] initWithConfiguration:configuration];
+    OSSStubSessionTask *sessionTask = [self stubSessionTask];
+    OSSSendCountingInterceptor *interceptor = [OSSSendCountingInterceptor new];
+    OSSNetworkingRequestDelegate *request = [self requestOnNetworking:networking sessionTask:sessionTask interceptor:interceptor];
+    XCTestExpectation *completed = [self expectationWithDescription:@"request completed"];
+    __block NSError *completionError = nil;
+    request.completionHandler = ^(id responseObject, NSError *error) {
+        completionError = error;
+        [completed fulfill];
+    };
+
+    [self postNetworkStatus:OSSNetworkStatusNotReachable previousStatus:OSSNetworkStatusReachableViaWiFi toObject:networking];
+    [self completeSessionTask:sessionTask onNetworking:networking];
+    XCTAssertEqual(interceptor.sendCount, 0);
+
+    // still offline, it's sent once the resource timeout is over and fails like a request without network
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(interceptor.sendCount, 1);
+    XCTAssertEqual(completionError.code, OSSClientErrorCodeNetworkError);
+    XCTAssertEqual(request.currentRetryCount, 0);
+
+    // the network coming back later doesn't send it again
+    [self postNetworkStatus:OSSNetworkStatusReachableViaWiFi previousStatus:OSSNetworkStatusNotReachable toObject:networking];
+    XCTAssertEqual(interceptor.sendCount, 1);
+}
+
+- (void)testForOSSNetworking_cancelsParkedRequest
+{
+    OSSNetworking *networking = [[OSSNetworking alloc] initWithConfiguration:[OSSNetworkingConfiguration new]];
+    OSSStubSessionTask *sessionTask = [self stubSessionTask];
+    OSSSendCountingInterceptor *interceptor = [OSSSendCountingInterceptor new];
+    OSSNetworkingRequestDelegate *request = [self requestOnNetworking:networking sessionTask:sessionTask interceptor:interceptor];
+    XCTestExpectation *completed = [self expectationWithDescription:@"request completed"];
+    __block NSError *completionError = nil;
+    request.completionHandler = ^(id responseObject, NSError *error) {
+        completionError = error;
+        [completed fulfill];
+    };
+
+    [self postNetworkStatus:OSSNetworkStatusNotReachable previousStatus:OSSNetworkStatusReachableViaWiFi toObject:networking];
+    [self completeSessionTask:sessionTask onNetworking:networking];
+    XCTAssertNotNil(request.cancellationHandler);
+
+    [request cancel];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqualObjects(completionError.domain, OSSClientErrorDomain);
+    XCTAssertEqual(completionError.code, OSSClientErrorCodeTaskCancelled);
+    XCTAssertNil(request.cancellationHandler);
+
+    // a cancelled request isn't sent when the network is back
+    [self postNetworkStatus:OSSNetworkStatusReachableViaWiFi previousStatus:OSSNetworkStatusNotReachable toObject:networking];
+    XCTAssertEqual(interceptor.sendCount, 1);
+}
+
+- (void)testForOSSRequestCoalescer
+{
+    OSSRequestCoalescer *coalescer = [OSSRequestCoalescer new];
+    OSSTaskCompletionSource *flightSource = [OSSTaskCompletionSource taskCompletionSource];
+    __block OSSNetworkingRequestDelegate *flightDelegate = nil;
+    __block int startCount = 0;
+    OSSTask * (^startFlight)(OSSNetworkingRequestDelegate *) = ^OSSTask *(OSSNetworkingRequestDelegate *delegate) {
+        startCount++;
+        flightDelegate = delegate;
+        return flightSource.task;
+    };
+    
+    __block int64_t firstProgress = 0;
+    __block int64_t secondProgress = 0;
+    OSSNetworkingRequestDelegate *first = [OSSNetworkingRequestDelegate new];
+    OSSTask *firstTask = [coalescer taskForKey:@"GET thumbnail" caller:first downloadProgress:^(int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite) {
+        firstProgress = totalBytesWritten;
+    } startFlight:startFlight];
+    OSSNetworkingRequestDelegate *second = [OSSNetworkingRequestDelegate new];
+    OSSTask *secondTask = [coalescer taskForKey:@"GET thumbnail" caller:second downloadProgress:^(int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite) {
+        secondProgress = totalBytesWritten;
+    } startFlight:startFlight];
+    OSSNetworkingRequestDelegate *cancelled = [OSSNetworkingRequestDelegate new];
+    OSSTask *cancelledTask = [coalescer taskForKey:@"GET thumbnail" caller:cancelled downloadProgress:nil startFlight:startFlight];
+    XCTAssertEqual(startCount, 1);
+    XCTAssertEqual(coalescer.flightCount, 1);
+    
+    // one caller cancelled doesn't cancel the flight of the others
+    [cancelled cancel];
+    XCTAssertEqual(cancelledTask.error.code, OSSClientErrorCodeTaskCancelled);
+    XCTAssertFalse(flightDelegate.isRequestCancelled);
+    
+    flightDelegate.downloadProgress(10, 10, 20);
+    XCTAssertEqual(firstProgress, 10);
+    XCTAssertEqual(secondProgress, 10);
+    [flightSource setResult:@"thumbnail"];
+    [firstTask waitUntilFinished];
+    [secondTask waitUntilFinished];
+    XCTAssertEqualObjects(firstTask.result, @"thumbnail");
+    XCTAssertEqualObjects(secondTask.result, @"thumbnail");
+    XCTAssertEqual(coalescer.flightCount, 0);
+    
+    // the flight is cancelled once no caller waits for it
+    OSSTaskCompletionSource *lonelySource = [OSSTaskCompletionSource taskCompletionSource];
+    OSSNetworkingRequestDelegate *lonely = [OSSNetworkingRequestDelegate new];
+    OSSTask *lonelyTask = [coalescer taskForKey:@"HEAD thumbnail" caller:lonely downloadProgress:nil startFlight:^OSSTask *(OSSNetworkingRequestDelegate *delegate) {
+        flightDelegate = delegate;
+        return lonelySource.task;
+    }];
+    [lonely cancel];
+    XCTAssertEqual(lonelyTask.error.code, OSSClientErrorCodeTaskCancelled);
+    XCTAssertTrue(flightDelegate.isRequestCancelled);
+    XCTAssertEqual(coalescer.flightCount, 0);
+    [lonelySource setError:[NSError errorWithDomain:OSSClientErrorDomain code:OSSClientErrorCodeTaskCancelled userInfo:nil]];
+}
+
+- (void)testForOSSMemoryGovernor
+{
+    OSSMemoryGovernor *governor = [OSSMemoryGovernor new];
+    governor.maxBytes = 100;
+    governor.pressureDuration = 0.5;
+    
+    // the first reservation is always granted, the next ones only under the ceiling
+    XCTAssertTrue([governor reserveBytes:150 orRetryWithBlock:^{}]);
+    XCTestExpectation *retried = [self expectationWithDescription:@"retried once bytes are released"];
+    XCTAssertFalse([governor reserveBytes:10 orRetryWithBlock:^{
+        [retried fulfill];
+    }]);
+    [governor releaseBytes:150];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertEqual(governor.heldBytes, 0);
+    
+    [governor holdBytes:20];
+    XCTAssertTrue([governor reserveBytes:60 orRetryWithBlock:^{}]);
+    XCTAssertEqual(governor.heldBytes, 80);
+    [governor releaseBytes:60];
+    
+    // the ceiling drops to a quarter under pressure, and the observers release their caches
+    XCTestExpectation *released = [self expectationWithDescription:@"observer called"];
+    NSObject *observer = [NSObject new];
+    [governor addPressureObserver:observer handler:^{
+        [released fulfill];
+    }];
+    [governor handleMemoryPressure];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertTrue(governor.isUnderPressure);
+    XCTAssertFalse([governor reserveBytes:10 orRetryWithBlock:^{}]);
+    
+    [NSThread sleepForTimeInterval:0.6];
+    XCTAssertFalse(governor.isUnderPressure);
+    XCTAssertTrue([governor reserveBytes:10 orRetryWithBlock:^{}]);
+    [governor removePressureObserver:observer];
+    [governor releaseBytes:30];
+    XCTAssertEqual(governor.heldBytes, 0);
+}
+
+- (void)testForOSSContentCompressor
+{
+    NSMutableString *logs = [NSMutableString string];
+    for (int i = 0; i < 5000; i++) {
+        [logs appendFormat:@"{\"level\":\"info\",\"seq\":%d,\"message\":\"request finished\"}\n", i];
+    }
+    NSData *data = [logs dataUsingEncoding:NSUTF8StringEncoding];
+
+    for (NSNumber *compression in @[@(OSSContentCompressionGzip), @(OSSContentCompressionDeflate)]) {
+        NSError *error = nil;
+        NSData *compressed = [OSSContentCompressor compressData:data compression:compression.integerValue error:&error];
+        XCTAssertNil(error);
+        XCTAssertLessThan(compressed.length * 5, data.length);
+        XCTAssertEqualObjects(data, [OSSContentCompressor decompressData:compressed error:&error]);
+
+        // the body produced in small pieces is compressed into one stream
+        __block NSUInteger offset = 0;
+        OSSUploadDataProducerBlock producer = [OSSContentCompressor producerCompressingProducer:^NSData *(NSError **producerError) {
+            NSUInteger length = MIN(1000, data.length - offset);
+            NSData *chunk = [data subdataWithRange:NSMakeRange(offset, length)];
+            offset += length;
+            return chunk;
+        } compression:compression.integerValue];
+        NSMutableData *produced = [NSMutableData data];
+        NSData *piece = nil;
+        while ((piece = producer(&error)).length) {
+            [produced appendData:piece];
+        }
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(data, [OSSContentCompressor decompressData:produced error:&error]);
+
+        NSURL *fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"oss-compressor-source.log"]];
+        NSURL *compressedURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"oss-compressor-compressed.log"]];
+        [data writeToURL:fileURL atomically:YES];
+        XCTAssertTrue([OSSContentCompressor compressFileAtURL:fileURL toURL:compressedURL compression:compression.integerValue error:&error]);
+        XCTAssertEqualObjects(data, [OSSContentCompressor decompressData:[NSData dataWithContentsOfURL:compressedURL] error:&error]);
+        [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+        [[NSFileManager defaultManager] removeItemAtURL:compressedURL error:nil];
+    }
+
+    // parts compressed one by one are gzip members one after another
+    NSMutableData *members = [[OSSContentCompressor compressData:[data subdataWithRange:NSMakeRange(0, 1000)] compression:OSSContentCompressionGzip error:nil] mutableCopy];
+    [members appendData:[OSSContentCompressor compressData:[data subdataWithRange:NSMakeRange(1000, data.length - 1000)] compression:OSSContentCompressionGzip error:nil]];
+    XCTAssertEqualObjects(data, [OSSContentCompressor decompressData:members error:nil]);
+
+    NSError *error = nil;
+    XCTAssertNil([OSSContentCompressor decompressData:[members subdataWithRange:NSMakeRange(0, members.length - 4)] error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertNil([[OSSContentCompressor alloc] initWithCompression:OSSContentCompressionNone]);
+}
+
+- (void)testForOSSEndpointSelector
+{
+    // names without a host are never probed, only the reports move the scores
+    NSString *regional = @"regional";
+    NSString *accelerate = @"accelerate";
+    OSSEndpointSelector *selector = [[OSSEndpointSelector alloc] initWithEndpoints:@[regional, accelerate, regional]];
+    XCTAssertEqual(2, selector.endpoints.count);
+
+    // the client's endpoint is kept until another one is measured or it fails
+    XCTAssertEqualObjects(regional, [selector bestEndpoint]);
+    [selector reportSuccessForEndpoint:regional connectRTT:0.2];
+    XCTAssertEqualObjects(regional, [selector bestEndpoint]);
+    [selector reportSuccessForEndpoint:accelerate connectRTT:0.05];
+    XCTAssertEqualObjects(accelerate, [selector bestEndpoint]);
+
+    [selector reportConnectFailureForEndpoint:accelerate];
+    XCTAssertEqualObjects(regional, [selector bestEndpoint]);
+    XCTAssertTrue([selector hasHealthyEndpointOtherThan:accelerate]);
+    [selector reportConnectFailureForEndpoint:regional];
+    XCTAssertFalse([selector hasHealthyEndpointOtherThan:accelerate]);
+
+    // a success clears the failures of the endpoint
+    [selector reportSuccessForEndpoint:accelerate connectRTT:0];
+    XCTAssertEqualObjects(accelerate, [selector bestEndpoint]);
+}
+
+- (void)testForOSSObjectCache
+{
+    NSData *data = [@"0123456789" dataUsingEncoding:NSUTF8StringEncoding];
+    NSString *key = [OSSObjectCache keyWithScope:@"scope" bucketName:@"bucket" objectKey:@"key"];
+    NSString *otherKey = [OSSObjectCache keyWithScope:@"scope" bucketName:@"bucket" objectKey:@"other"];
+    NSString *thirdKey = [OSSObjectCache keyWithScope:@"scope" bucketName:@"bucket" objectKey:@"third"];
+    OSSObjectCache *cache = [OSSObjectCache new];
+    [cache storeHttpResponseHeaderFields:@{@"Etag": @"\"e1\"", @"Last-Modified": @"Fri, 24 Feb 2012 06:07:48 GMT"}
+                              objectMeta:@{@"Content-Type": @"text/plain"}
+                                    data:data
+                                  forKey:key];
+    OSSObjectCacheEntry *entry = [cache entryForKey:key];
+    XCTAssertEqualObjects(entry.eTag, @"\"e1\"");
+    XCTAssertEqualObjects(entry.lastModified, @"Fri, 24 Feb 2012 06:07:48 GMT");
+    XCTAssertTrue(entry.hasData);
+    XCTAssertEqualObjects([cache dataForKey:key], data);
+    // revalidated every time by default
+    XCTAssertFalse([cache isEntryFresh:entry]);
+    cache.timeToLive = 60;
+    XCTAssertTrue([cache isEntryFresh:entry]);
+
+    // a HEAD of the same version keeps the content, of another version drops it
+    [cache storeHttpResponseHeaderFields:@{@"Etag": @"\"e1\""} objectMeta:nil data:nil forKey:key];
+    XCTAssertEqualObjects([cache dataForKey:key], data);
+    [cache storeHttpResponseHeaderFields:@{@"Etag": @"\"e2\""} objectMeta:nil data:nil forKey:key];
+    XCTAssertFalse([cache entryForKey:key].hasData);
+    XCTAssertNil([cache dataForKey:key]);
+
+    // the least recently used entries go first
+    cache.maxEntryCount = 2;
+    [cache storeHttpResponseHeaderFields:@{} objectMeta:nil data:nil forKey:otherKey];
+    [cache entryForKey:key];
+    [cache storeHttpResponseHeaderFields:@{} objectMeta:nil data:nil forKey:thirdKey];
+    XCTAssertNotNil([cache entryForKey:key]);
+    XCTAssertNil([cache entryForKey:otherKey]);
+    [cache removeEntryForKey:key];
+    XCTAssertNil([cache entryForKey:key]);
+
+    // the entries outlive the cache of a directory
+    NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    OSSObjectCache *diskCache = [[OSSObjectCache alloc] initWithDirectory:directory];
+    [diskCache storeHttpResponseHeaderFields:@{@"Etag": @"\"e1\""} objectMeta:nil data:data forKey:key];
+    [NSThread sleepForTimeInterval:1.5];
+    OSSObjectCache *reopenedCache = [[OSSObjectCache alloc] initWithDirectory:directory];
+    XCTAssertEqualObjects([reopenedCache entryForKey:key].eTag, @"\"e1\"");
+    XCTAssertEqualObjects([reopenedCache dataForKey:key], data);
+    [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+}
+
+- (void)testForOSSObjectCacheScopes
+{
+    NSString *endpoint = @"https://oss-cn-hangzhou.aliyuncs.com";
+    id<OSSCredentialProvider> provider = [[OSSPlainTextAKSKPairCredentialProvider alloc] initWithPlainTextAccessKey:@"ak1" secretKey:@"sk1"];
+    id<OSSCredentialProvider> sameAccountProvider = [[OSSStsTokenCredentialProvider alloc] initWithAccessKeyId:@"ak1" secretKeyId:@"sk1" securityToken:@""];
+    id<OSSCredentialProvider> otherAccountProvider = [[OSSPlainTextAKSKPairCredentialProvider alloc] initWithPlainTextAccessKey:@"ak2" secretKey:@"sk2"];
+    OSSFederationCredentialProvider *federationProvider = [[OSSFederationCredentialProvider alloc] initWithFederationTokenGetter:^OSSFederationToken *{
+        return nil;
+    }];
+    OSSFederationCredentialProvider *otherFederationProvider = [[OSSFederationCredentialProvider alloc] initWithFederationTokenGetter:^OSSFederationToken *{
+        return nil;
+    }];
+
+    NSString *scope = [OSSObjectCache scopeWithEndpoint:endpoint credentialProvider:provider];
+    XCTAssertEqualObjects(scope, [OSSObjectCache scopeWithEndpoint:endpoint credentialProvider:sameAccountProvider]);
+    XCTAssertNotEqualObjects(scope, [OSSObjectCache scopeWithEndpoint:endpoint credentialProvider:otherAccountProvider]);
+    XCTAssertNotEqualObjects(scope, [OSSObjectCache scopeWithEndpoint:@"https://oss-cn-shanghai.aliyuncs.com" credentialProvider:provider]);
+    // the access key id doesn't show in the keys written to disk
+    XCTAssertEqual([scope rangeOfString:@"ak1"].location, NSNotFound);
+
+    // the accounts of token getters aren't known, each provider has its own entries
+    NSString *federationScope = [OSSObjectCache scopeWithEndpoint:endpoint credentialProvider:federationProvider];
+    XCTAssertEqualObjects(federationScope, [OSSObjectCache scopeWithEndpoint:endpoint credentialProvider:federationProvider]);
+    XCTAssertNotEqualObjects(federationScope, [OSSObjectCache scopeWithEndpoint:endpoint credentialProvider:otherFederationProvider]);
+
+    OSSObjectCache *cache = [OSSObjectCache new];
+    NSData *data = [@"0123456789" dataUsingEncoding:NSUTF8StringEncoding];
+    [cache storeHttpResponseHeaderFields:@{@"Etag": @"\"e1\""} objectMeta:nil data:data
+                                  forKey:[OSSObjectCache keyWithScope:scope bucketName:@"bucket" objectKey:@"key"]];
+    NSString *otherScope = [OSSObjectCache scopeWithEndpoint:endpoint credentialProvider:otherAccountProvider];
+    XCTAssertNil([cache entryForKey:[OSSObjectCache keyWithScope:otherScope bucketName:@"bucket" objectKey:@"key"]]);
+    XCTAssertNil([cache dataForKey:[OSSObjectCache keyWithScope:federationScope bucketName:@"bucket" objectKey:@"key"]]);
+    XCTAssertEqualObjects([cache dataForKey:[OSSObjectCache keyWithScope:scope bucketName:@"bucket" objectKey:@"key"]], data);
+}
+
+- (void)testForOSSCacheIndex
+{
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    OSSCacheIndex *index = [[OSSCacheIndex alloc] initWithFilePath:filePath queue:nil];
+    [index setItem:@{@"size": @1} forKey:@"a"];
+    [index setItem:@{@"size": @2} forKey:@"b"];
+    [index setItem:@{@"size": @3} forKey:@"c"];
+    XCTAssertEqualObjects(index.leastRecentlyUsedKey, @"a");
+
+    // a replaced item keeps its place, a used one moves last
+    [index setItem:@{@"size": @4} forKey:@"a"];
+    XCTAssertEqualObjects(index.leastRecentlyUsedKey, @"a");
+    [index touchKey:@"a"];
+    XCTAssertEqualObjects([index keys], (@[@"b", @"c", @"a"]));
+    [index removeItemForKey:@"c"];
+    XCTAssertEqual(index.count, 2);
+    XCTAssertNil([index itemForKey:@"c"]);
+
+    // the changes are written together, a second later
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:filePath]);
+    [NSThread sleepForTimeInterval:1.5];
+    OSSCacheIndex *reopenedIndex = [[OSSCacheIndex alloc] initWithFilePath:filePath queue:nil];
+    XCTAssertEqualObjects([reopenedIndex keys], (@[@"b", @"a"]));
+    XCTAssertEqualObjects([reopenedIndex itemForKey:@"a"], @{@"size": @4});
+
+    [reopenedIndex removeAllItems];
+    XCTAssertNil(reopenedIndex.leastRecentlyUsedKey);
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+}
+
+- (void)testForOSSDDFileLoggerBatchedWrites
+{
+    NSString *logsDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    OSSDDLogFileManagerDefault *logFileManager = [[OSSDDLogFileManagerDefault alloc] initWithLogsDirectory:logsDirectory];
+    OSSDDFileLogger *fileLogger = [[OSSDDFileLogger alloc] initWithLogFileManager:logFileManager];
+    fileLogger.logFlushInterval = 60;
+    [OSSDDLog addLogger:fileLogger];
+
+    OSSDDLogInfo(@"buffered info message");
+    NSString *logFilePath = logFileManager.sortedLogFilePaths.firstObject;
+    NSString *content = logFilePath ? [NSString stringWithContentsOfFile:logFilePath encoding:NSUTF8StringEncoding error:nil] : nil;
+    XCTAssertFalse([content containsString:@"buffered info message"]);
+
+    [OSSDDLog flushLog];
+    logFilePath = logFileManager.sortedLogFilePaths.firstObject;
+    content = [NSString stringWithContentsOfFile:logFilePath encoding:NSUTF8StringEncoding error:nil];
+    XCTAssertTrue([content containsString:@"buffered info message"]);
+
+    // errors are written through
+    OSSDDLogError(@"written error message");
+    content = [NSString stringWithContentsOfFile:logFilePath encoding:NSUTF8StringEncoding error:nil];
+    XCTAssertTrue([content containsString:@"written error message"]);
+
+    [OSSDDLog removeLogger:fileLogger];
+    [[NSFileManager defaultManager] removeItemAtPath:logsDirectory error:nil];
+}
+
+- (void)testPerformanceForOSSSyncMutableDictionaryLookup
+{
+    OSSSyncMutableDictionary *dictionary = [[OSSSyncMutableDictionary alloc] init];
+    [self measureBlock:^{
+        [self lookupDelegatesConcurrentlyWithDictionary:dictionary];
+    }];
+}
+
+- (void)testPerformanceForOSSShardedMutableDictionaryLookup
+{
+    OSSShardedMutableDictionary *dictionary = [[OSSShardedMutableDictionary alloc] init];
+    [self measureBlock:^{
+        [self lookupDelegatesConcurrentlyWithDictionary:dictionary];
+    }];
+}
+
+
+#pragma mark - utils
+
+/* posted to the object only, the schedulers and networkings shared by the other tests don't see it */
+- (void)postNetworkStatus:(OSSNetworkStatus)status previousStatus:(OSSNetworkStatus)previousStatus toObject:(id)object
+{
+    [[NSNotificationCenter defaultCenter] postNotificationName:OSSReachabilityChangedNotification
+                                                        object:object
+                                                      userInfo:@{OSSReachabilityPreviousStatusKey: @(previousStatus),
+                                                                 OSSReachabilityStatusKey: @(status)}];
+}
+
+- (OSSStubSessionTask *)stubSessionTask
+{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+    return [OSSStubSessionTask new];
+#pragma clang diagnostic pop
+}
+
+/* a get in flight on the stub session task */
+- (OSSNetworkingRequestDelegate *)requestOnNetworking:(OSSNetworking *)networking
+                                          sessionTask:(OSSStubSessionTask *)sessionTask
+                                          interceptor:(OSSSendCountingInterceptor *)interceptor
+{
+    OSSNetworkingRequestDelegate *request = [OSSNetworkingRequestDelegate new];
+    request.operType = OSSOperationTypeGetObject;
+    request.allNeededMessage = [[OSSAllRequestNeededMessage alloc] initWithEndpoint:@"https://oss-cn-hangzhou.aliyuncs.com"
+                                                                         httpMethod:@"GET"
+                                                                         bucketName:@"test-bucket"
+                                                                          objectKey:@"test-object"
+                                                                               type:nil
+                                                                                md5:nil
+                                                                              range:nil
+                                                                               date:nil
+                                                                       headerParams:nil
+                                                                             querys:nil
+                                                                               sha1:nil];
+    interceptor.request = request;
+    [request.interceptors addObject:interceptor];
+    request.currentSessionTask = sessionTask;
+    [networking.sessionDelagateManager setObject:request forKey:@(sessionTask.taskIdentifier)];
+    return request;
+}
+
+/* the callback of the session once the task is cancelled */
+- (void)completeSessionTask:(OSSStubSessionTask *)sessionTask onNetworking:(OSSNetworking *)networking
+{
+    [networking URLSession:networking.dataSession
+                      task:sessionTask
+      didCompleteWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+}
+
 @end
@@ -9,6 +9,8 @@
 #import <XCTest/XCTest.h>
 #import "OSSTestMacros.h"
 #import <AliyunOSSiOS/AliyunOSSiOS.h>
+#import <AliyunOSSiOS/OSSContentCompressor.h>
+#import <AliyunOSSiOS/OSSEndpointSelector.h>
 
 @interface OSSObjectTests : XCTestCase
 {
@@ -106,6 +108,42 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_putObjectFromInputStream
+{
+    NSString *filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:_fileNames[0]];
+    OSSPutObjectRequest * request = [OSSPutObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = _fileNames[0];
+    request.uploadingInputStream = [NSInputStream inputStreamWithFileAtPath:filePath];
+    request.crcFlag = OSSRequestCRCOpen;
+    
+    OSSTask * task = [_client putObject:request];
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSPutObjectResult * result = task.result;
+        XCTAssertEqualObjects(result.remoteCRC64ecma, result.localCRC64ecma);
+        return nil;
+    }] waitUntilFinished];
+    
+    NSData * fileData = [NSData dataWithContentsOfFile:filePath];
+    __block NSUInteger offset = 0;
+    request = [OSSPutObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = _fileNames[0];
+    request.uploadingDataProducer = ^NSData *(NSError **error) {
+        NSUInteger length = MIN(1000, fileData.length - offset);
+        NSData * chunk = [fileData subdataWithRange:NSMakeRange(offset, length)];
+        offset += length;
+        return chunk;
+    };
+    task = [_client putObject:request];
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+    XCTAssertEqual(offset, fileData.length);
+}
+
 - (void)testAPI_putObjectFromFile
 {
     for (NSUInteger pIdx = 0; pIdx < _fileNames.count; pIdx++)
@@ -138,6 +176,138 @@
     }
 }
 
+- (void)testAPI_putObjectSkippingUnchangedObject
+{
+    NSString *objectKey = _fileNames[0];
+    NSString *filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:objectKey];
+
+    OSSPutObjectRequest *request = [OSSPutObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = objectKey;
+    request.uploadingFileURL = [NSURL fileURLWithPath:filePath];
+    request.skipsUnchangedObject = YES;
+    OSSTask *task = [_client putObject:request];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+
+    // the object has the content of the file now, the second upload only heads it
+    request = [OSSPutObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = objectKey;
+    request.uploadingFileURL = [NSURL fileURLWithPath:filePath];
+    request.skipsUnchangedObject = YES;
+    task = [_client putObject:request];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertTrue(((OSSPutObjectResult *)task.result).isSkipped);
+
+    request = [OSSPutObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = objectKey;
+    request.uploadingData = [@"another content" dataUsingEncoding:NSUTF8StringEncoding];
+    request.skipsUnchangedObject = YES;
+    task = [_client putObject:request];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertFalse(((OSSPutObjectResult *)task.result).isSkipped);
+
+    // the digest of the file is cached for its size and modification date
+    OSSFileDigestCache *digestCache = [OSSFileDigestCache new];
+    NSString *crc64ecma = [digestCache crc64ecmaOfFileAtPath:filePath];
+    XCTAssertNotNil(crc64ecma);
+    uint64_t crc64 = [[NSMutableData dataWithContentsOfFile:filePath] oss_crc64];
+    XCTAssertEqualObjects([NSString stringWithFormat:@"%llu", crc64], crc64ecma);
+    XCTAssertEqualObjects([OSSUtil fileMD5String:filePath], [digestCache md5OfFileAtPath:filePath]);
+    XCTAssertNil([digestCache crc64ecmaOfFileAtPath:[filePath stringByAppendingString:@"-missing"]]);
+
+    // the other tests read the file's content back
+    request = [OSSPutObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = objectKey;
+    request.uploadingFileURL = [NSURL fileURLWithPath:filePath];
+    task = [_client putObject:request];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+}
+
+- (void)testAPI_headObjectWithEndpointFailover
+{
+    // nothing listens on the first endpoint, the requests fail over to the alternative one at once
+    OSSClientConfiguration *config = [OSSClientConfiguration new];
+    config.alternativeEndpoints = @[OSS_ENDPOINT];
+    OSSAuthCredentialProvider *authProv = [[OSSAuthCredentialProvider alloc] initWithAuthServerUrl:OSS_STSTOKEN_URL];
+    OSSClient *client = [[OSSClient alloc] initWithEndpoint:@"http://127.0.0.1:1"
+                                         credentialProvider:authProv
+                                        clientConfiguration:config];
+    XCTAssertEqual(2, client.endpointSelector.endpoints.count);
+
+    OSSHeadObjectRequest *request = [OSSHeadObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = _fileNames[0];
+    NSDate *startDate = [NSDate date];
+    OSSTask *task = [client headObject:request];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertLessThan(-[startDate timeIntervalSinceNow], 5);
+    XCTAssertEqualObjects(OSS_ENDPOINT, [client.endpointSelector bestEndpoint]);
+}
+
+- (void)testAPI_putObjectWithCompression
+{
+    NSMutableString *logs = [NSMutableString string];
+    for (int i = 0; i < 20000; i++) {
+        [logs appendFormat:@"{\"level\":\"info\",\"seq\":%d,\"message\":\"request finished\"}\n", i];
+    }
+    NSData *data = [logs dataUsingEncoding:NSUTF8StringEncoding];
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"compressed-upload.log"];
+    [data writeToFile:filePath atomically:YES];
+
+    NSString *objectKey = @"putObject-compressed.log";
+    for (int source = 0; source < 3; source++) {
+        OSSPutObjectRequest *request = [OSSPutObjectRequest new];
+        request.bucketName = OSS_BUCKET_PRIVATE;
+        request.objectKey = objectKey;
+        request.crcFlag = OSSRequestCRCOpen;
+        request.contentCompression = OSSContentCompressionGzip;
+        if (source == 0) {
+            request.uploadingData = data;
+        } else if (source == 1) {
+            request.uploadingFileURL = [NSURL fileURLWithPath:filePath];
+        } else {
+            request.uploadingInputStream = [NSInputStream inputStreamWithFileAtPath:filePath];
+        }
+        __block int64_t totalSent = 0;
+        request.uploadProgress = ^(int64_t bytesSent, int64_t totalByteSent, int64_t totalBytesExpectedToSend) {
+            totalSent = totalByteSent;
+        };
+
+        OSSTask *task = [_client putObject:request];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        OSSPutObjectResult *result = task.result;
+        XCTAssertEqualObjects(result.remoteCRC64ecma, result.localCRC64ecma);
+        XCTAssertLessThan(totalSent * 5, (int64_t)data.length);
+
+        OSSHeadObjectRequest *head = [OSSHeadObjectRequest new];
+        head.bucketName = OSS_BUCKET_PRIVATE;
+        head.objectKey = objectKey;
+        task = [_client headObject:head];
+        [task waitUntilFinished];
+        XCTAssertEqualObjects(((OSSHeadObjectResult *)task.result).httpResponseHeaderFields[@"Content-Encoding"], @"gzip");
+
+        // the object is decoded as it's downloaded, its crc64 is the one of the encoded bytes and isn't checked
+        OSSGetObjectRequest *get = [OSSGetObjectRequest new];
+        get.bucketName = OSS_BUCKET_PRIVATE;
+        get.objectKey = objectKey;
+        get.crcFlag = OSSRequestCRCOpen;
+        task = [_client getObject:get];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        XCTAssertEqualObjects(data, ((OSSGetObjectResult *)task.result).downloadedData);
+    }
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+}
+
 - (void)test_putObjectFromFileWithCRC
 {
     NSString *objectKey = @"putObject-wangwang.zip";
@@ -311,6 +481,7 @@
     XCTAssertNil(task.error);
 }
 
+#pragma mark - appendObject
 - (void)testA_appendObject
 {
     OSSDeleteObjectRequest * delete = [OSSDeleteObjectRequest new];
@@ -360,6 +531,40 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_objectAppender
+{
+    OSSDeleteObjectRequest * delete = [OSSDeleteObjectRequest new];
+    delete.bucketName = OSS_BUCKET_PRIVATE;
+    delete.objectKey = @"appender";
+    [[_client deleteObject:delete] waitUntilFinished];
+    
+    OSSObjectAppender * appender = [_client objectAppenderWithBucketName:OSS_BUCKET_PRIVATE objectKey:@"appender" position:0 crc64ecma:nil];
+    appender.flushSize = 10 * 1024;
+    appender.maxBufferedSize = 20 * 1024;
+    appender.contentType = @"text/plain";
+    NSMutableData * expected = [NSMutableData data];
+    for (int i = 0; i < 1000; i++) {
+        NSData * line = [[NSString stringWithFormat:@"%04d telemetry line\n", i] dataUsingEncoding:NSUTF8StringEncoding];
+        [expected appendData:line];
+        NSError * error = nil;
+        XCTAssertTrue([appender appendData:line error:&error]);
+        XCTAssertNil(error);
+    }
+    OSSTask * task = [appender close];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(appender.nextPosition, (int64_t)expected.length);
+    XCTAssertEqualObjects(((OSSAppendObjectResult *)task.result).remoteCRC64ecma, appender.crc64ecma);
+    XCTAssertFalse([appender appendData:expected error:nil]);
+    
+    OSSGetObjectRequest * get = [OSSGetObjectRequest new];
+    get.bucketName = OSS_BUCKET_PRIVATE;
+    get.objectKey = @"appender";
+    task = [_client getObject:get];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(((OSSGetObjectResult *)task.result).downloadedData, expected);
+}
+
 #pragma mark - getObject
 - (void)testAPI_getObject
 {
@@ -377,6 +582,47 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_objectReader
+{
+    NSString * filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file1m"];
+    NSData * expected = [NSData dataWithContentsOfFile:filePath];
+    NSString * directory = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"objectReader"];
+    [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+
+    OSSObjectReader * reader = [_client objectReaderWithBucketName:OSS_BUCKET_PRIVATE objectKey:@"file1m" directory:directory];
+    reader.blockSize = 100 * 1024;
+    reader.maxMemoryCost = 300 * 1024;
+    NSMutableData * content = [NSMutableData data];
+    NSError * error = nil;
+    NSData * data = nil;
+    while ((data = [reader readDataOfLength:70 * 1024 error:&error]).length > 0) {
+        [content appendData:data];
+    }
+    XCTAssertNil(error);
+    XCTAssertEqual(reader.contentLength, (int64_t)expected.length);
+    XCTAssertEqualObjects(content, expected);
+
+    // seeking back reads the blocks evicted from memory from disk
+    OSSTask * task = [reader readDataAtOffset:1000 length:250 * 1024];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(task.result, [expected subdataWithRange:NSMakeRange(1000, 250 * 1024)]);
+
+    [reader close];
+    task = [reader readDataAtOffset:0 length:1];
+    [task waitUntilFinished];
+    XCTAssertEqual(task.error.code, OSSClientErrorCodeTaskCancelled);
+
+    // a new reader finds the blocks left on disk
+    reader = [_client objectReaderWithBucketName:OSS_BUCKET_PRIVATE objectKey:@"file1m" directory:directory];
+    reader.blockSize = 100 * 1024;
+    task = [reader readDataAtOffset:expected.length - 10 length:100];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(task.result, [expected subdataWithRange:NSMakeRange(expected.length - 10, 10)]);
+    [reader close];
+    [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+}
+
 - (void)testAPI_getImage
 {
     OSSGetObjectRequest * request = [OSSGetObjectRequest new];
@@ -396,6 +642,45 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_imagePipeline
+{
+    NSString * directory = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"imagePipeline"];
+    [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+    NSString * process = [OSSImagePipeline resizeProcessWithPixelWidth:100 height:100];
+
+    OSSImagePipeline * pipeline = [_client imagePipelineWithBucketName:OSS_BUCKET_PRIVATE directory:directory];
+    pipeline.imageScale = 2;
+    XCTAssertNil([pipeline cachedImageForObjectKey:OSS_IMAGE_KEY xOssProcess:process]);
+    [pipeline prefetchImagesForObjectKeys:@[OSS_IMAGE_KEY] xOssProcess:process];
+    // the load shares the download and the decode of the prefetch
+    OSSTask * task = [pipeline imageForObjectKey:OSS_IMAGE_KEY xOssProcess:process];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    OSSImage * image = task.result;
+    XCTAssertNotNil(image);
+    XCTAssertLessThanOrEqual(image.size.width, 50);
+    XCTAssertLessThanOrEqual(image.size.height, 50);
+    XCTAssertEqual([pipeline cachedImageForObjectKey:OSS_IMAGE_KEY xOssProcess:process], image);
+
+    // a new pipeline decodes the variant left on disk, once the index of its object cache is written
+    [NSThread sleepForTimeInterval:1.5];
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:[directory stringByAppendingPathComponent:@"index.plist"]]);
+    pipeline = [_client imagePipelineWithBucketName:OSS_BUCKET_PRIVATE directory:directory];
+    task = [pipeline imageForObjectKey:OSS_IMAGE_KEY xOssProcess:process];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertNotNil(task.result);
+
+    // a cancelled prefetch fails without being cached
+    [pipeline prefetchImagesForObjectKeys:@[OSS_IMAGE_KEY] xOssProcess:nil];
+    [pipeline cancelPrefetchingForObjectKeys:@[OSS_IMAGE_KEY] xOssProcess:nil];
+    XCTAssertNil([pipeline cachedImageForObjectKey:OSS_IMAGE_KEY xOssProcess:nil]);
+
+    [pipeline removeAllImages];
+    XCTAssertNil([pipeline cachedImageForObjectKey:OSS_IMAGE_KEY xOssProcess:process]);
+    [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+}
+
 - (void)testAPI_getObjectWithRecieveDataBlock
 {
     OSSGetObjectRequest * request = [OSSGetObjectRequest new];
@@ -442,6 +727,92 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_getObjectIntoBuffer
+{
+    NSMutableData * buffer = [NSMutableData dataWithBytes:"stale" length:5];
+    OSSGetObjectRequest * request = [OSSGetObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = _fileNames[0];
+    request.downloadBuffer = buffer;
+
+    OSSTask * task = [_client getObject:request];
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSGetObjectResult * result = task.result;
+        XCTAssertTrue(result.downloadedData == buffer);
+        XCTAssertEqual(buffer.length, [result.httpResponseHeaderFields[@"Content-Length"] integerValue]);
+        return nil;
+    }] waitUntilFinished];
+
+    OSSGetObjectRequest * cappedRequest = [OSSGetObjectRequest new];
+    cappedRequest.bucketName = OSS_BUCKET_PRIVATE;
+    cappedRequest.objectKey = _fileNames[0];
+    cappedRequest.maxDownloadedDataLength = 10;
+
+    [[[_client getObject:cappedRequest] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNotNil(task.error);
+        XCTAssertEqual(OSSClientErrorCodeInvalidArgument, task.error.code);
+        return nil;
+    }] waitUntilFinished];
+}
+
+- (void)testAPI_getObjectWithObjectCache
+{
+    OSSClientConfiguration * conf = [OSSClientConfiguration new];
+    conf.objectCache = [OSSObjectCache new];
+    OSSClient * cacheClient = [[OSSClient alloc] initWithEndpoint:OSS_ENDPOINT
+                                              credentialProvider:_client.credentialProvider
+                                             clientConfiguration:conf];
+
+    __block NSData * downloadedData = nil;
+    OSSGetObjectRequest * request = [OSSGetObjectRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = _fileNames[0];
+    [[[cacheClient getObject:request] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSGetObjectResult * result = task.result;
+        XCTAssertEqual(200, result.httpResponseCode);
+        downloadedData = result.downloadedData;
+        return nil;
+    }] waitUntilFinished];
+
+    // not downloaded again while it's unchanged
+    OSSGetObjectRequest * secondRequest = [OSSGetObjectRequest new];
+    secondRequest.bucketName = OSS_BUCKET_PRIVATE;
+    secondRequest.objectKey = _fileNames[0];
+    [[[cacheClient getObject:secondRequest] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSGetObjectResult * result = task.result;
+        XCTAssertEqual(304, result.httpResponseCode);
+        XCTAssertEqualObjects(downloadedData, result.downloadedData);
+        return nil;
+    }] waitUntilFinished];
+
+    // served without asking OSS while it's fresh
+    conf.objectCache.timeToLive = 60;
+    OSSHeadObjectRequest * headRequest = [OSSHeadObjectRequest new];
+    headRequest.bucketName = OSS_BUCKET_PRIVATE;
+    headRequest.objectKey = _fileNames[0];
+    [[[cacheClient headObject:headRequest] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSHeadObjectResult * result = task.result;
+        XCTAssertNil(result.requestId);
+        XCTAssertNotNil(result.objectMeta[@"Etag"]);
+        return nil;
+    }] waitUntilFinished];
+
+    // a client of another endpoint sharing the cache asks OSS
+    OSSClient * otherClient = [[OSSClient alloc] initWithEndpoint:@"https://oss-cn-shenzhen.aliyuncs.com"
+                                              credentialProvider:_client.credentialProvider
+                                             clientConfiguration:conf];
+    [[[otherClient headObject:headRequest] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSHeadObjectResult * result = task.result;
+        XCTAssertNotNil(result.requestId);
+        return nil;
+    }] waitUntilFinished];
+}
+
 - (void)testAPI_getObjectWithRange
 {
     OSSGetObjectRequest * request = [OSSGetObjectRequest new];
@@ -600,6 +971,27 @@
     XCTAssertNotNil(error);
 }
 
+- (void)testAPI_headMultipleObjects
+{
+    OSSHeadMultipleObjectsRequest * request = [OSSHeadMultipleObjectsRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.keys = [_fileNames arrayByAddingObject:@"wrong-key"];
+    request.concurrentRequestCount = 2;
+
+    OSSTask * task = [_client headMultipleObjects:request];
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSHeadMultipleObjectsResult * result = task.result;
+        XCTAssertEqual(_fileNames.count, result.headObjectResults.count);
+        for (NSString * key in _fileNames) {
+            XCTAssertNotNil(result.headObjectResults[key].httpResponseHeaderFields[@"Content-Length"]);
+        }
+        XCTAssertEqualObjects(@[@"wrong-key"], result.missingObjects);
+        XCTAssertEqual(0, result.failedObjects.count);
+        return nil;
+    }] waitUntilFinished];
+}
+
 - (void)testAPI_copyAndDeleteObject
 {
     OSSHeadObjectRequest * head = [OSSHeadObjectRequest new];
@@ -635,6 +1027,182 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_multipartCopy
+{
+    __block int64_t copiedBytes = 0;
+    OSSMultipartCopyRequest * copy = [OSSMultipartCopyRequest new];
+    copy.bucketName = OSS_BUCKET_PRIVATE;
+    copy.objectKey = @"file10m_multipartCopyTo";
+    copy.sourceBucketName = OSS_BUCKET_PRIVATE;
+    copy.sourceObjectKey = @"file10m";
+    copy.partSize = 1024 * 1024;
+    copy.copyProgress = ^(int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend) {
+        copiedBytes = totalBytesSent;
+    };
+    OSSTask * task = [_client multipartCopy:copy];
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSMultipartCopyResult * result = task.result;
+        XCTAssertEqual(200, result.httpResponseCode);
+        XCTAssertNotNil(result.eTag);
+        return nil;
+    }] waitUntilFinished];
+
+    OSSHeadObjectRequest * head = [OSSHeadObjectRequest new];
+    head.bucketName = OSS_BUCKET_PRIVATE;
+    head.objectKey = @"file10m";
+    OSSTask * headSourceTask = [_client headObject:head];
+    head = [OSSHeadObjectRequest new];
+    head.bucketName = OSS_BUCKET_PRIVATE;
+    head.objectKey = @"file10m_multipartCopyTo";
+    OSSTask * headCopyTask = [_client headObject:head];
+    [[OSSTask taskForCompletionOfAllTasks:@[headSourceTask, headCopyTask]] waitUntilFinished];
+    NSDictionary * sourceMeta = ((OSSHeadObjectResult *)headSourceTask.result).objectMeta;
+    NSDictionary * copyMeta = ((OSSHeadObjectResult *)headCopyTask.result).objectMeta;
+    XCTAssertEqualObjects(sourceMeta[@"Content-Length"], copyMeta[@"Content-Length"]);
+    XCTAssertEqualObjects(sourceMeta[@"x-oss-hash-crc64ecma"], copyMeta[@"x-oss-hash-crc64ecma"]);
+    XCTAssertEqual([sourceMeta[@"Content-Length"] longLongValue], copiedBytes);
+
+    OSSDeleteObjectRequest * delete = [OSSDeleteObjectRequest new];
+    delete.bucketName = OSS_BUCKET_PRIVATE;
+    delete.objectKey = @"file10m_multipartCopyTo";
+    [[_client deleteObject:delete] waitUntilFinished];
+}
+
+- (void)testAPI_bulkUpload
+{
+    NSString * documentDirectory = [NSString oss_documentDirectory];
+    NSArray<NSString *> * fileNames = @[@"file1k", @"file100k", @"file10m"];
+    NSMutableArray<NSURL *> * fileURLs = [NSMutableArray array];
+    int64_t totalSize = 0;
+    for (NSString * fileName in fileNames) {
+        NSString * filePath = [documentDirectory stringByAppendingPathComponent:fileName];
+        [fileURLs addObject:[NSURL fileURLWithPath:filePath]];
+        totalSize += [[[NSFileManager defaultManager] attributesOfItemAtPath:filePath error:nil] fileSize];
+    }
+
+    __block int64_t uploadedBytes = 0;
+    OSSBulkUploadRequest * request = [OSSBulkUploadRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.fileURLs = fileURLs;
+    request.objectKeyPrefix = @"bulk/";
+    request.multipartThreshold = 1024 * 1024;
+    request.recordDirectoryPath = documentDirectory;
+    request.uploadProgress = ^(int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend) {
+        uploadedBytes = totalBytesSent;
+    };
+    OSSTask * task = [_client bulkUpload:request];
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSBulkUploadResult * result = task.result;
+        XCTAssertEqual(fileNames.count, result.uploadedObjects.count);
+        XCTAssertEqual(0, result.skippedObjects.count);
+        XCTAssertEqual(0, result.failedObjects.count);
+        return nil;
+    }] waitUntilFinished];
+    XCTAssertEqual(totalSize, uploadedBytes);
+
+    OSSHeadMultipleObjectsRequest * head = [OSSHeadMultipleObjectsRequest new];
+    head.bucketName = OSS_BUCKET_PRIVATE;
+    NSMutableArray<NSString *> * keys = [NSMutableArray array];
+    for (NSString * fileName in fileNames) {
+        [keys addObject:[@"bulk/" stringByAppendingString:fileName]];
+    }
+    head.keys = keys;
+    [[[_client headMultipleObjects:head] continueWithBlock:^id(OSSTask *task) {
+        OSSHeadMultipleObjectsResult * result = task.result;
+        XCTAssertEqual(fileNames.count, result.headObjectResults.count);
+        return nil;
+    }] waitUntilFinished];
+
+    OSSDeleteMultipleObjectsRequest * delete = [OSSDeleteMultipleObjectsRequest new];
+    delete.bucketName = OSS_BUCKET_PRIVATE;
+    delete.keys = keys;
+    [[_client deleteMultipleObjects:delete] waitUntilFinished];
+}
+
+- (void)testAPI_concurrentBulkUploads
+{
+    // more bulk uploads than threads of the operation executor, each with a multipart file
+    NSURL * fileURL = [NSURL fileURLWithPath:[[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file10m"]];
+    NSMutableArray<NSString *> * keys = [NSMutableArray array];
+    for (int i = 0; i < 4; i++) {
+        OSSBulkUploadRequest * request = [OSSBulkUploadRequest new];
+        request.bucketName = OSS_BUCKET_PRIVATE;
+        request.fileURLs = @[fileURL];
+        request.objectKeyPrefix = [NSString stringWithFormat:@"bulk%d/", i];
+        request.multipartThreshold = 1024 * 1024;
+        XCTestExpectation * finished = [self expectationWithDescription:request.objectKeyPrefix];
+        [[_client bulkUpload:request] continueWithBlock:^id(OSSTask *task) {
+            XCTAssertNil(task.error);
+            XCTAssertEqual(1, ((OSSBulkUploadResult *)task.result).uploadedObjects.count);
+            [finished fulfill];
+            return nil;
+        }];
+        [keys addObject:[request.objectKeyPrefix stringByAppendingString:@"file10m"]];
+    }
+    [self waitForExpectationsWithTimeout:300 handler:nil];
+
+    OSSDeleteMultipleObjectsRequest * delete = [OSSDeleteMultipleObjectsRequest new];
+    delete.bucketName = OSS_BUCKET_PRIVATE;
+    delete.keys = keys;
+    [[_client deleteMultipleObjects:delete] waitUntilFinished];
+}
+
+- (void)testAPI_deleteMultipleObjects
+{
+    NSMutableArray * keys = [NSMutableArray array];
+    for (int i = 0; i < 3; i++) {
+        NSString * key = [NSString stringWithFormat:@"batch_delete_%d&<>", i];
+        OSSPutObjectRequest * put = [OSSPutObjectRequest new];
+        put.bucketName = OSS_BUCKET_PRIVATE;
+        put.objectKey = key;
+        put.uploadingData = [key dataUsingEncoding:NSUTF8StringEncoding];
+        [[[_client putObject:put] continueWithBlock:^id(OSSTask *task) {
+            XCTAssertNil(task.error);
+            return nil;
+        }] waitUntilFinished];
+        [keys addObject:key];
+    }
+    
+    OSSDeleteMultipleObjectsRequest * delete = [OSSDeleteMultipleObjectsRequest new];
+    delete.bucketName = OSS_BUCKET_PRIVATE;
+    delete.keys = keys;
+    OSSTask * task = [_client deleteMultipleObjects:delete];
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSDeleteMultipleObjectsResult * result = task.result;
+        XCTAssertEqual(200, result.httpResponseCode);
+        XCTAssertEqualObjects([NSSet setWithArray:keys], [NSSet setWithArray:result.deletedObjects]);
+        XCTAssertEqual(0, result.failedObjects.count);
+        return nil;
+    }] waitUntilFinished];
+    
+    // more than one batch, in quiet mode
+    NSMutableArray * missingKeys = [NSMutableArray array];
+    for (int i = 0; i < 2500; i++) {
+        [missingKeys addObject:[NSString stringWithFormat:@"batch_delete_missing_%d", i]];
+    }
+    delete = [OSSDeleteMultipleObjectsRequest new];
+    delete.bucketName = OSS_BUCKET_PRIVATE;
+    delete.keys = missingKeys;
+    delete.quiet = YES;
+    task = [_client deleteMultipleObjects:delete];
+    [[task continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        OSSDeleteMultipleObjectsResult * result = task.result;
+        XCTAssertEqual(0, result.deletedObjects.count);
+        XCTAssertEqual(0, result.failedObjects.count);
+        return nil;
+    }] waitUntilFinished];
+    
+    delete = [OSSDeleteMultipleObjectsRequest new];
+    delete.bucketName = OSS_BUCKET_PRIVATE;
+    task = [_client deleteMultipleObjects:delete];
+    [task waitUntilFinished];
+    XCTAssertEqual(OSSClientErrorCodeInvalidArgument, task.error.code);
+}
+
 #pragma mark - retry operations
 - (void)testAPI_PutObjectWithErrorRetry
 {
@@ -1155,6 +1723,30 @@
     XCTAssertNil(tk.error);
 }
 
+- (void)testAPI_presignConstrainURLs
+{
+    NSArray * keys = @[@"file1k", @"file10k", @"file100k"];
+    OSSTask * tk = [_client presignConstrainURLsWithBucketName:OSS_BUCKET_PRIVATE
+                                                withObjectKeys:keys
+                                        withExpirationInterval:30 * 60
+                                                withParameters:nil];
+    XCTAssertNil(tk.error);
+    NSArray<NSString *> * urls = tk.result;
+    XCTAssertEqual(keys.count, urls.count);
+
+    for (NSUInteger i = 0; i < keys.count; i++) {
+        XCTAssertTrue([urls[i] containsString:[NSString stringWithFormat:@"/%@?", keys[i]]]);
+        OSSTaskCompletionSource * tcs = [OSSTaskCompletionSource taskCompletionSource];
+        NSURLSessionDataTask * dataTask = [[NSURLSession sharedSession] dataTaskWithURL:[NSURL URLWithString:urls[i]]
+                                                                       completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+                                                                           [tcs setResult:response];
+                                                                       }];
+        [dataTask resume];
+        [tcs.task waitUntilFinished];
+        XCTAssertEqual(200, ((NSHTTPURLResponse *)tcs.task.result).statusCode);
+    }
+}
+
 - (void)testAPI_presignPublicURL
 {
     OSSTask * task = [_client presignPublicURLWithBucketName:OSS_BUCKET_PUBLIC withObjectKey:@"file1m"];
@@ -1178,6 +1770,108 @@
     XCTAssertNil(task.error);
 }
 
+#pragma mark - parallelDownload
+
+- (void)testAPI_parallelDownload {
+    NSString * filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file5m"];
+    OSSPutObjectRequest * put = [OSSPutObjectRequest new];
+    put.bucketName = OSS_BUCKET_PRIVATE;
+    put.objectKey = @"file5m";
+    put.uploadingFileURL = [NSURL fileURLWithPath:filePath];
+    [[[_client putObject:put] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+    
+    NSString * downloadPath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file5m_parallel"];
+    OSSParallelDownloadRequest * request = [OSSParallelDownloadRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = @"file5m";
+    request.downloadToFileURL = [NSURL fileURLWithPath:downloadPath];
+    request.partSize = 512 * 1024;
+    request.concurrentPartCount = 3;
+    request.crcFlag = OSSRequestCRCOpen;
+    __block int64_t lastTotalBytesWritten = 0;
+    request.downloadProgress = ^(int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite) {
+        XCTAssertTrue(totalBytesWritten > lastTotalBytesWritten);
+        lastTotalBytesWritten = totalBytesWritten;
+    };
+    
+    [[[_client parallelDownload:request] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+    
+    XCTAssertEqual(lastTotalBytesWritten, 1024 * 1024 * 5);
+    XCTAssertEqualObjects([OSSUtil fileMD5String:downloadPath], [OSSUtil fileMD5String:filePath]);
+    [[NSFileManager defaultManager] removeItemAtPath:downloadPath error:nil];
+}
+
+- (void)testAPI_parallelDownloadWithoutFileURL {
+    OSSParallelDownloadRequest * request = [OSSParallelDownloadRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = @"file5m";
+    
+    [[[_client parallelDownload:request] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNotNil(task.error);
+        XCTAssertEqual(task.error.code, OSSClientErrorCodeInvalidArgument);
+        return nil;
+    }] waitUntilFinished];
+}
+
+- (void)testAPI_resumableDownloadAfterCancel {
+    NSString * filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file10m"];
+    OSSPutObjectRequest * put = [OSSPutObjectRequest new];
+    put.bucketName = OSS_BUCKET_PRIVATE;
+    put.objectKey = @"file10m";
+    put.uploadingFileURL = [NSURL fileURLWithPath:filePath];
+    [[[_client putObject:put] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+    
+    NSString * downloadPath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file10m_resumable"];
+    NSString * cachesDir = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject];
+    OSSResumableDownloadRequest * request = [OSSResumableDownloadRequest new];
+    request.bucketName = OSS_BUCKET_PRIVATE;
+    request.objectKey = @"file10m";
+    request.downloadToFileURL = [NSURL fileURLWithPath:downloadPath];
+    request.recordDirectoryPath = cachesDir;
+    request.crcFlag = OSSRequestCRCOpen;
+    __weak typeof(request) weakRequest = request;
+    request.downloadProgress = ^(int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite) {
+        if (totalBytesWritten > totalBytesExpectedToWrite / 2) {
+            [weakRequest cancel];
+        }
+    };
+    [[[_client resumableDownload:request] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertEqual(task.error.code, OSSClientErrorCodeTaskCancelled);
+        return nil;
+    }] waitUntilFinished];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:downloadPath]);
+    
+    OSSResumableDownloadRequest * resumeRequest = [OSSResumableDownloadRequest new];
+    resumeRequest.bucketName = OSS_BUCKET_PRIVATE;
+    resumeRequest.objectKey = @"file10m";
+    resumeRequest.downloadToFileURL = [NSURL fileURLWithPath:downloadPath];
+    resumeRequest.recordDirectoryPath = cachesDir;
+    resumeRequest.crcFlag = OSSRequestCRCOpen;
+    __block BOOL isFirstProgress = YES;
+    resumeRequest.downloadProgress = ^(int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite) {
+        if (isFirstProgress) {
+            XCTAssertGreaterThan(totalBytesWritten, totalBytesExpectedToWrite / 3);
+            isFirstProgress = NO;
+        }
+    };
+    [[[_client resumableDownload:resumeRequest] continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+    
+    XCTAssertEqualObjects([OSSUtil fileMD5String:downloadPath], [OSSUtil fileMD5String:filePath]);
+    [[NSFileManager defaultManager] removeItemAtPath:downloadPath error:nil];
+}
+
 #pragma mark - utils
 
 - (BOOL)checkMd5WithBucketName:(nonnull NSString *)bucketName objectKey:(nonnull NSString *)objectKey localFilePath:(nonnull NSString *)filePath
@@ -1329,4 +2023,64 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_multipartUploadWithConcurrentPartCount {
+    OSSMultipartUploadRequest * multipartUploadRequest = [OSSMultipartUploadRequest new];
+    multipartUploadRequest.bucketName = OSS_BUCKET_PRIVATE;
+    multipartUploadRequest.objectKey = OSS_MULTIPART_UPLOADKEY;
+    multipartUploadRequest.contentType = @"application/octet-stream";
+    multipartUploadRequest.partSize = 256 * 1024;
+    multipartUploadRequest.concurrentPartCount = 2;
+    NSString * filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:@"file10m"];
+    multipartUploadRequest.uploadingFileURL = [NSURL fileURLWithPath:filePath];
+    __block int64_t lastTotalBytesSent = 0;
+    multipartUploadRequest.uploadProgress = ^(int64_t bytesSent, int64_t totalByteSent, int64_t totalBytesExpectedToSend) {
+        XCTAssertTrue(totalByteSent > lastTotalBytesSent);
+        lastTotalBytesSent = totalByteSent;
+    };
+    OSSTask * multipartTask = [_client multipartUpload:multipartUploadRequest];
+    
+    [[multipartTask continueWithBlock:^id(OSSTask *task) {
+        XCTAssertNil(task.error);
+        return nil;
+    }] waitUntilFinished];
+    
+    XCTAssertEqual(lastTotalBytesSent, 1024 * 1024 * 10);
+    BOOL isEqual = [self checkMd5WithBucketName:OSS_BUCKET_PRIVATE
+                                      objectKey:OSS_MULTIPART_UPLOADKEY
+                                  localFilePath:filePath];
+    XCTAssertTrue(isEqual);
+}
+
+- (void)testAPI_concurrentMultipartUploadsFromTwoClients {
+    OSSClient *otherClient = [[OSSClient alloc] initWithEndpoint:OSS_ENDPOINT credentialProvider:_client.credentialProvider];
+    NSArray<OSSClient *> *clients = @[_client, otherClient];
+    NSArray<NSString *> *fileNames = @[@"file5m", @"file10m"];
+    NSMutableArray<OSSTask *> *tasks = [NSMutableArray array];
+    NSMutableArray<NSMutableArray<NSNumber *> *> *progressTotals = [NSMutableArray array];
+    
+    for (NSUInteger i = 0; i < clients.count; i++) {
+        OSSMultipartUploadRequest * multipartUploadRequest = [OSSMultipartUploadRequest new];
+        multipartUploadRequest.bucketName = OSS_BUCKET_PRIVATE;
+        multipartUploadRequest.objectKey = [NSString stringWithFormat:@"%@-%lu", OSS_MULTIPART_UPLOADKEY, (unsigned long)i];
+        multipartUploadRequest.partSize = 256 * 1024;
+        NSString * filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:fileNames[i]];
+        multipartUploadRequest.uploadingFileURL = [NSURL fileURLWithPath:filePath];
+        NSMutableArray<NSNumber *> *totals = [NSMutableArray array];
+        [progressTotals addObject:totals];
+        multipartUploadRequest.uploadProgress = ^(int64_t bytesSent, int64_t totalByteSent, int64_t totalBytesExpectedToSend) {
+            [totals addObject:@(totalByteSent)];
+        };
+        [tasks addObject:[clients[i] multipartUpload:multipartUploadRequest]];
+    }
+    [[OSSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+    
+    for (NSUInteger i = 0; i < tasks.count; i++) {
+        XCTAssertNil(tasks[i].error);
+        NSString * filePath = [[NSString oss_documentDirectory] stringByAppendingPathComponent:fileNames[i]];
+        unsigned long long fileSize = [[[NSFileManager defaultManager] attributesOfItemAtPath:filePath error:nil] fileSize];
+        // each upload counts only its own bytes
+        XCTAssertEqual([progressTotals[i].lastObject unsignedLongLongValue], fileSize);
+    }
+}
+
 @end
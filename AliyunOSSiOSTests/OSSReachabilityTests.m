@@ -8,6 +8,8 @@
 
 #import <XCTest/XCTest.h>
 #import <AliyunOSSiOS/OSSReachability.h>
+#import <AliyunOSSiOS/OSSReachabilityManager.h>
+#import <AliyunOSSiOS/OSSUtil.h>
 
 @interface OSSReachabilityTests : XCTestCase
 
@@ -36,4 +38,18 @@
     [reachability connectionRequired];
 }
 
+- (void)testProxyStateIsCachedUntilNetworkChanges
+{
+    BOOL isDelegateState = [OSSUtil isNetworkDelegateState];
+    // the probe only runs again after a network change
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            XCTAssertEqual([OSSUtil isNetworkDelegateState], isDelegateState);
+        }
+    }];
+
+    [[NSNotificationCenter defaultCenter] postNotificationName:OSSReachabilityChangedNotification object:nil];
+    XCTAssertEqual([OSSUtil isNetworkDelegateState], isDelegateState);
+}
+
 @end
@@ -7,6 +7,11 @@
 //
 
 #import <XCTest/XCTest.h>
+#import <AliyunOSSiOS/OSSModel.h>
+#import <AliyunOSSiOS/OSSClient.h>
+#import <AliyunOSSiOS/OSSNetworking.h>
+#import <AliyunOSSiOS/OSSUtil.h>
+#import <AliyunOSSiOS/OSSBolts.h>
 
 @interface OSSSignTests : XCTestCase
 
@@ -29,6 +34,125 @@
     // Use XCTAssert and related functions to verify your tests produce the correct results.
 }
 
+- (OSSAllRequestNeededMessage *)signingMessage {
+    OSSAllRequestNeededMessage *message = [[OSSAllRequestNeededMessage alloc] initWithEndpoint:@"https://oss-cn-hangzhou.aliyuncs.com"
+                                                                                    httpMethod:@"PUT"
+                                                                                    bucketName:@"oss-example"
+                                                                                     objectKey:@"nelson"
+                                                                                          type:@"text/html"
+                                                                                           md5:@"c8fdb181845a4ca6b8fec737b3581d76"
+                                                                                         range:nil
+                                                                                          date:@"Thu, 17 Nov 2005 18:49:58 GMT"
+                                                                                  headerParams:[@{@"x-oss-meta-author": @"foo@bar.com",
+                                                                                                  @"x-oss-magic": @"abracadabra",
+                                                                                                  @"Content-Length": @"4"} mutableCopy]
+                                                                                        querys:[@{@"uploadId": @"abc",
+                                                                                                  @"acl": @"",
+                                                                                                  @"partNumber": @"1",
+                                                                                                  @"max-keys": @"100"} mutableCopy]
+                                                                                          sha1:nil];
+    return message;
+}
+
+- (void)testSignerStringToSign {
+    __block NSString *signedContent = nil;
+    OSSCustomSignerCredentialProvider *provider = [[OSSCustomSignerCredentialProvider alloc] initWithImplementedSigner:^NSString *(NSString *contentToSign, NSError *__autoreleasing *error) {
+        signedContent = contentToSign;
+        return @"OSS ak:signature";
+    }];
+    OSSSignerInterceptor *signer = [[OSSSignerInterceptor alloc] initWithCredentialProvider:provider];
+    OSSAllRequestNeededMessage *message = [self signingMessage];
+    XCTAssertNil([signer interceptRequestMessage:message].error);
+
+    // headers without the x-oss- prefix and queries which aren't subresources are not signed
+    NSString *expected = @"PUT\nc8fdb181845a4ca6b8fec737b3581d76\ntext/html\nThu, 17 Nov 2005 18:49:58 GMT\n"
+                         @"x-oss-magic:abracadabra\nx-oss-meta-author:foo@bar.com\n"
+                         @"/oss-example/nelson?acl&partNumber=1&uploadId=abc";
+    XCTAssertEqualObjects(signedContent, expected);
+    XCTAssertEqualObjects(message.headerParams[@"Authorization"], @"OSS ak:signature");
+}
+
+- (void)testHmacSha1WithCachedSecret {
+    NSString *content = @"PUT\nc8fdb181845a4ca6b8fec737b3581d76\ntext/html\nThu, 17 Nov 2005 18:49:58 GMT\nx-oss-magic:abracadabra\nx-oss-meta-author:foo@bar.com\n/oss-example/nelson";
+    NSString *secret = @"OtxrzxIsfpFjA7SwPzILwy8Bw21TLhquhboDYROV";
+    // the second round uses the cached key schedule and must give the same signature
+    for (int i = 0; i < 2; i++) {
+        XCTAssertEqualObjects([OSSUtil calBase64Sha1WithData:content withSecret:secret], @"dZpCvvKgxiFw6wvMHHj5g3W6STM=");
+        XCTAssertEqualObjects([OSSUtil calBase64Sha1WithData:@"GET\n\n\nThu, 17 Nov 2005 18:49:58 GMT\n/bucket/object?acl&partNumber=1&uploadId=abc" withSecret:secret], @"I3tlXGBo6QMBjxNTo6kV6W3xt6w=");
+        XCTAssertNotEqualObjects([OSSUtil calBase64Sha1WithData:content withSecret:@"another secret"], @"dZpCvvKgxiFw6wvMHHj5g3W6STM=");
+    }
+    
+    // more secrets than the cache holds, the ones evicted and the ones kept still sign the same
+    for (int i = 0; i < 20; i++) {
+        NSString *otherSecret = [NSString stringWithFormat:@"secret %d", i];
+        XCTAssertEqualObjects([OSSUtil calBase64Sha1WithData:content withSecret:otherSecret],
+                              [OSSUtil calBase64Sha1WithData:content withSecret:otherSecret]);
+        XCTAssertEqualObjects([OSSUtil calBase64Sha1WithData:content withSecret:secret], @"dZpCvvKgxiFw6wvMHHj5g3W6STM=");
+    }
+}
+
+- (void)testPerformanceForSigning {
+    // 10000 signatures per run, a run under 0.5s means more than 20k signed requests/sec
+    OSSStsTokenCredentialProvider *provider = [[OSSStsTokenCredentialProvider alloc] initWithAccessKeyId:@"ak"
+                                                                                              secretKeyId:@"OtxrzxIsfpFjA7SwPzILwy8Bw21TLhquhboDYROV"
+                                                                                            securityToken:@"token"];
+    OSSSignerInterceptor *signer = [[OSSSignerInterceptor alloc] initWithCredentialProvider:provider];
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            @autoreleasepool {
+                [signer interceptRequestMessage:[self signingMessage]];
+            }
+        }
+    }];
+}
+
+- (void)testPerformanceForURLEncoding {
+    // long keys of Chinese characters, spaces and symbols, each of them escaped into thousands of bytes
+    NSMutableString *key = [NSMutableString string];
+    for (int i = 0; i < 100; i++) {
+        [key appendFormat:@"图片/测试 文件_%d*(~).jpg/", i];
+    }
+    NSString *expected = [OSSUtil encodeURL:key];
+    XCTAssertTrue([expected hasPrefix:@"%E5%9B%BE%E7%89%87/%E6%B5%8B%E8%AF%95%20%E6%96%87%E4%BB%B6_0%2A%28~%29.jpg/"]);
+
+    NSMutableString *appended = [NSMutableString stringWithString:@"https://bucket.oss-cn-hangzhou.aliyuncs.com/"];
+    [OSSUtil appendEncodedURL:key toString:appended];
+    XCTAssertEqualObjects([@"https://bucket.oss-cn-hangzhou.aliyuncs.com/" stringByAppendingString:expected], appended);
+
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            @autoreleasepool {
+                [OSSUtil encodeURL:key];
+            }
+        }
+    }];
+}
+
+- (void)testPerformanceForBatchPresigning {
+    // 1000 image URLs per run, a run under 0.1s means more than 10k presigned URLs/sec
+    OSSStsTokenCredentialProvider *provider = [[OSSStsTokenCredentialProvider alloc] initWithAccessKeyId:@"ak"
+                                                                                              secretKeyId:@"OtxrzxIsfpFjA7SwPzILwy8Bw21TLhquhboDYROV"
+                                                                                            securityToken:@"token"];
+    OSSClient *client = [[OSSClient alloc] initWithEndpoint:@"https://oss-cn-hangzhou.aliyuncs.com" credentialProvider:provider];
+    NSMutableArray<NSString *> *keys = [NSMutableArray array];
+    for (int i = 0; i < 1000; i++) {
+        [keys addObject:[NSString stringWithFormat:@"feed/图片_%d.jpg", i]];
+    }
+    NSDictionary *parameters = @{@"x-oss-process": @"image/resize,w_200"};
+
+    OSSTask *task = [client presignConstrainURLsWithBucketName:@"bucket" withObjectKeys:keys withExpirationInterval:3600 withParameters:parameters];
+    [task waitUntilFinished];
+    NSArray<NSString *> *urls = task.result;
+    XCTAssertEqual(keys.count, urls.count);
+    XCTAssertTrue([urls.firstObject hasPrefix:@"https://bucket.oss-cn-hangzhou.aliyuncs.com/feed/%E5%9B%BE%E7%89%87_0.jpg?"]);
+    XCTAssertTrue([urls.firstObject containsString:@"x-oss-process=image/resize%2Cw_200"]);
+    XCTAssertTrue([urls.firstObject containsString:@"security-token=token"]);
+
+    [self measureBlock:^{
+        [[client presignConstrainURLsWithBucketName:@"bucket" withObjectKeys:keys withExpirationInterval:3600 withParameters:parameters] waitUntilFinished];
+    }];
+}
+
 - (void)testPerformanceExample {
     // This is an example of a performance test case.
     [self measureBlock:^{
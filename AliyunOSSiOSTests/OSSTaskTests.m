@@ -7,6 +7,7 @@
 //
 
 #import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
 
 #import <AliyunOSSiOS/AliyunOSSiOS.h>
 
@@ -783,4 +784,76 @@
     [self waitForExpectationsWithTimeout:10.0 handler:nil];
 }
 
+- (void)testContinuationsInOrderOnPendingTask {
+    OSSTaskCompletionSource *tcs = [OSSTaskCompletionSource taskCompletionSource];
+    NSMutableArray *order = [NSMutableArray array];
+    for (int i = 0; i < 3; i++) {
+        [tcs.task continueWithExecutor:[OSSExecutor immediateExecutor] withBlock:^id(OSSTask *t) {
+            [order addObject:@(i)];
+            return nil;
+        }];
+    }
+    XCTAssertNil(tcs.task.result);
+    XCTAssertFalse(tcs.task.completed);
+    tcs.result = @"foo";
+    XCTAssertEqualObjects((@[@0, @1, @2]), order);
+    XCTAssertEqualObjects(@"foo", tcs.task.result);
+}
+
+- (void)testAllocationsPerContinuation {
+    // the heap blocks a pending continuation keeps alive: its task and the captured blocks
+    const int count = 10000;
+    OSSTaskCompletionSource *tcs = [OSSTaskCompletionSource taskCompletionSource];
+    NSMutableArray<OSSTask *> *tasks = [NSMutableArray arrayWithCapacity:count];
+    malloc_statistics_t before, after;
+    malloc_zone_statistics(NULL, &before);
+    for (int i = 0; i < count; i++) {
+        [tasks addObject:[tcs.task continueWithExecutor:[OSSExecutor immediateExecutor] withBlock:^id(OSSTask *t) {
+            return nil;
+        }]];
+    }
+    malloc_zone_statistics(NULL, &after);
+    double allocations = (double)(after.blocks_in_use - before.blocks_in_use) / count;
+    double bytes = (double)(after.size_in_use - before.size_in_use) / count;
+    NSLog(@"allocations per continuation: %.2f, bytes: %.0f", allocations, bytes);
+    XCTAssertLessThan(allocations, 5);
+
+    tcs.result = nil;
+    XCTAssertTrue(tasks.lastObject.completed);
+}
+
+- (void)testPerformanceForContinuationsOfCompletedTask {
+    const int count = 100000;
+    OSSTask *task = [OSSTask taskWithResult:@"foo"];
+    [self measureBlock:^{
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < count; i++) {
+            @autoreleasepool {
+                [task continueWithExecutor:[OSSExecutor immediateExecutor] withBlock:^id(OSSTask *t) {
+                    return t.result;
+                }];
+            }
+        }
+        NSLog(@"ns per continuation of a completed task: %.0f", (CFAbsoluteTimeGetCurrent() - start) * 1e9 / count);
+    }];
+}
+
+- (void)testPerformanceForContinuationChains {
+    const int count = 100000;
+    [self measureBlock:^{
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        OSSTaskCompletionSource *tcs = [OSSTaskCompletionSource taskCompletionSource];
+        OSSTask *task = tcs.task;
+        for (int i = 0; i < count; i++) {
+            task = [task continueWithSuccessBlock:^id(OSSTask *t) {
+                return t.result;
+            }];
+        }
+        tcs.result = @"foo";
+        [task waitUntilFinished];
+        XCTAssertEqualObjects(@"foo", task.result);
+        NSLog(@"ns per chained continuation: %.0f", (CFAbsoluteTimeGetCurrent() - start) * 1e9 / count);
+    }];
+}
+
 @end
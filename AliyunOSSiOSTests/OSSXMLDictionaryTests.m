@@ -8,6 +8,8 @@
 
 #import <XCTest/XCTest.h>
 #import <AliyunOSSiOS/OSSXMLDictionary.h>
+#import <AliyunOSSiOS/OSSXMLResponseParser.h>
+#import <AliyunOSSiOS/OSSUtil.h>
 
 @interface OSSXMLDictionaryTests : XCTestCase
 
@@ -53,4 +55,97 @@
     XCTAssertNotNil(dict);
 }
 
+- (NSString *)listBucketXMLWithKeyCount:(int)count {
+    NSMutableString *xml = [NSMutableString stringWithString:@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<ListBucketResult>\n<Name>oss-test</Name><Prefix></Prefix><Marker></Marker><MaxKeys>1000</MaxKeys><Delimiter>/</Delimiter><IsTruncated>true</IsTruncated><NextMarker>k999</NextMarker>\n"];
+    for (int i = 0; i < count; i++) {
+        [xml appendFormat:@"<Contents>\n  <Key>dir/k%d &amp; &#x4E2D;</Key>\n  <LastModified>2018-01-01T00:00:00.000Z</LastModified>\n  <ETag>&quot;5B3C1A2E053D763E1B002CC607C5A0FE&quot;</ETag>\n  <Type>Normal</Type><Size>%d</Size><StorageClass>Standard</StorageClass>\n  <Owner><ID>100</ID><DisplayName>100</DisplayName></Owner>\n</Contents>\n", i, i];
+    }
+    [xml appendString:@"<CommonPrefixes><Prefix>a/</Prefix></CommonPrefixes><CommonPrefixes><Prefix>b/</Prefix></CommonPrefixes>\n</ListBucketResult>"];
+    return xml;
+}
+
+- (void)testForStreamingListBucketParser {
+    NSData *body = [[self listBucketXMLWithKeyCount:10] dataUsingEncoding:NSUTF8StringEncoding];
+    NSDictionary *dict = [NSDictionary oss_dictionaryWithXMLData:body];
+
+    for (NSUInteger chunk = 1; chunk < 64; chunk += 7) {
+        OSSXMLResponseParser *parser = [OSSXMLResponseParser parserForOperationType:OSSOperationTypeGetBucket];
+        for (NSUInteger offset = 0; offset < body.length; offset += chunk) {
+            XCTAssertTrue([parser feedData:[body subdataWithRange:NSMakeRange(offset, MIN(chunk, body.length - offset))]]);
+        }
+        XCTAssertTrue([parser finish]);
+
+        OSSGetBucketResult *result = (OSSGetBucketResult *)parser.result;
+        XCTAssertEqualObjects(result.bucketName, @"oss-test");
+        XCTAssertNil(result.prefix);
+        XCTAssertEqualObjects(result.delimiter, @"/");
+        XCTAssertEqualObjects(result.nextMarker, @"k999");
+        XCTAssertEqual(result.maxKeys, 1000);
+        XCTAssertTrue(result.isTruncated);
+        XCTAssertEqualObjects(result.contents, dict[@"Contents"]);
+        XCTAssertEqualObjects(result.contents[3][@"Key"], @"dir/k3 & 中");
+        XCTAssertEqualObjects((@[@"a/", @"b/"]), result.commentPrefixes);
+    }
+}
+
+- (void)testForStreamingListPartsAndErrorParser {
+    NSData *body = [@"<ListPartsResult><Bucket>b</Bucket><NextPartNumberMarker>2</NextPartNumberMarker><MaxParts>1000</MaxParts><IsTruncated>false</IsTruncated><Part><PartNumber>1</PartNumber><ETag>\"A\"</ETag><Size>102400</Size></Part><Part><PartNumber>2</PartNumber><ETag>\"B\"</ETag><Size>10</Size></Part></ListPartsResult>" dataUsingEncoding:NSUTF8StringEncoding];
+    OSSXMLResponseParser *parser = [OSSXMLResponseParser parserForOperationType:OSSOperationTypeListMultipart];
+    XCTAssertTrue([parser feedData:body]);
+    XCTAssertTrue([parser finish]);
+    OSSListPartsResult *result = (OSSListPartsResult *)parser.result;
+    XCTAssertEqual(result.nextPartNumberMarker, 2);
+    XCTAssertEqual(result.maxParts, 1000);
+    XCTAssertFalse(result.isTruncated);
+    XCTAssertEqualObjects(result.parts, [NSDictionary oss_dictionaryWithXMLData:body][@"Part"]);
+
+    NSData *errorBody = [@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Error>\n  <Code>NoSuchKey</Code>\n  <Message>The specified key does not exist.</Message>\n  <RequestId>5A0E</RequestId>\n  <HostId>b.oss-cn-hangzhou.aliyuncs.com</HostId>\n</Error>" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects([OSSXMLResponseParser errorDictionaryWithData:errorBody], [NSDictionary oss_dictionaryWithXMLData:errorBody]);
+
+    parser = [OSSXMLResponseParser parserForOperationType:OSSOperationTypeGetBucket];
+    XCTAssertFalse([parser feedData:[@"<ListBucketResult><Name>b</Nam>" dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertFalse([parser finish]);
+    XCTAssertNil([OSSXMLResponseParser parserForOperationType:OSSOperationTypePutObject]);
+
+    parser = [OSSXMLResponseParser parserForOperationType:OSSOperationTypeDeleteMultipleObjects];
+    XCTAssertTrue([parser feedData:[@"<DeleteResult><Deleted><Key>a &amp; b</Key></Deleted><Deleted><Key>c</Key></Deleted></DeleteResult>" dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertTrue([parser finish]);
+    XCTAssertEqualObjects(((OSSDeleteMultipleObjectsResult *)parser.result).deletedObjects, (@[@"a & b", @"c"]));
+}
+
+- (void)testPerformanceForCompleteMultipartUploadBody {
+    NSMutableArray *partInfos = [NSMutableArray array];
+    for (int32_t i = 1; i <= 10000; i++) {
+        [partInfos addObject:[OSSPartInfo partInfoWithPartNum:i eTag:@"\"3858F62230AC3C915F300C664312C11F\"" size:100 * 1024 crc64:0]];
+    }
+    NSString *body = [[NSString alloc] initWithData:[OSSUtil constructHttpBodyFromPartInfos:partInfos] encoding:NSUTF8StringEncoding];
+    XCTAssertTrue([body hasPrefix:@"<CompleteMultipartUpload>\n<Part>\n<PartNumber>1</PartNumber>\n<ETag>\"3858F62230AC3C915F300C664312C11F\"</ETag>\n</Part>\n"]);
+    XCTAssertTrue([body hasSuffix:@"<Part>\n<PartNumber>10000</PartNumber>\n<ETag>\"3858F62230AC3C915F300C664312C11F\"</ETag>\n</Part>\n</CompleteMultipartUpload>\n"]);
+    NSArray *parsedParts = [NSDictionary oss_dictionaryWithXMLData:[body dataUsingEncoding:NSUTF8StringEncoding]][@"Part"];
+    XCTAssertEqual(10000, parsedParts.count);
+    XCTAssertEqualObjects(@"512", parsedParts[511][@"PartNumber"]);
+
+    [self measureBlock:^{
+        [OSSUtil constructHttpBodyFromPartInfos:partInfos];
+    }];
+}
+
+- (void)testPerformanceForStreamingListBucketParser {
+    NSData *body = [[self listBucketXMLWithKeyCount:1000] dataUsingEncoding:NSUTF8StringEncoding];
+    [self measureBlock:^{
+        OSSXMLResponseParser *parser = [OSSXMLResponseParser parserForOperationType:OSSOperationTypeGetBucket];
+        for (NSUInteger offset = 0; offset < body.length; offset += 16384) {
+            [parser feedData:[body subdataWithRange:NSMakeRange(offset, MIN(16384, body.length - offset))]];
+        }
+        [parser finish];
+    }];
+}
+
+- (void)testPerformanceForXMLDictionaryListBucket {
+    NSData *body = [[self listBucketXMLWithKeyCount:1000] dataUsingEncoding:NSUTF8StringEncoding];
+    [self measureBlock:^{
+        [NSDictionary oss_dictionaryWithXMLData:body];
+    }];
+}
+
 @end
@@ -12,6 +12,30 @@
 
 @end
 
+@interface OSSClient (SequentialMultipartUploadTests)
+- (OSSTask *)uploadPart:(OSSUploadPartRequest *)uploadPart ofRequest:(OSSMultipartUploadRequest *)request;
+@end
+
+/* holds up the first parts longest, they'd finish last if nothing kept the parts in order */
+@interface OSSPartOrderRecordingClient : OSSClient
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *finishedPartNumbers;
+@end
+@implementation OSSPartOrderRecordingClient
+
+- (OSSTask *)uploadPart:(OSSUploadPartRequest *)uploadPart ofRequest:(OSSMultipartUploadRequest *)request {
+    int delay = MAX(0, 5 - uploadPart.partNumber) * 200;
+    return [[[OSSTask taskWithDelay:delay] continueWithBlock:^id(OSSTask *task) {
+        return [super uploadPart:uploadPart ofRequest:request];
+    }] continueWithBlock:^id(OSSTask *task) {
+        @synchronized(self) {
+            [self.finishedPartNumbers addObject:@(uploadPart.partNumber)];
+        }
+        return task;
+    }];
+}
+
+@end
+
 @implementation SequentialMultipartUploadTests
 
 - (void)setUp {
@@ -62,6 +86,49 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_sequentialMultipartUpload_readAhead {
+    OSSResumableUploadRequest *request = [OSSResumableUploadRequest new];
+    request.bucketName = OSS_BUCKET_PUBLIC;
+    request.objectKey = @"sequential-multipart-read-ahead";
+    request.uploadingFileURL = [[NSBundle mainBundle] URLForResource:@"wangwang" withExtension:@"zip"];
+    request.crcFlag = OSSRequestCRCOpen;
+    request.sequentialReadAheadPartCount = 3;
+    __block int64_t lastTotalBytesSent = 0;
+    request.uploadProgress = ^(int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend) {
+        XCTAssertGreaterThan(totalBytesSent, lastTotalBytesSent);
+        lastTotalBytesSent = totalBytesSent;
+    };
+    
+    // the crc64 of the object is only right if the parts were sent in order
+    OSSTask *task = [self.client sequentialMultipartUpload:request];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(lastTotalBytesSent, [[[NSFileManager defaultManager] attributesOfItemAtPath:request.uploadingFileURL.path error:nil] fileSize]);
+}
+
+- (void)testAPI_sequentialMultipartUpload_readAheadPartsFinishInOrder {
+    OSSPlainTextAKSKPairCredentialProvider *provider = [[OSSPlainTextAKSKPairCredentialProvider alloc] initWithPlainTextAccessKey:OSS_ACCESSKEY_ID secretKey:OSS_SECRETKEY_ID];
+    OSSPartOrderRecordingClient *client = [[OSSPartOrderRecordingClient alloc] initWithEndpoint:OSS_ENDPOINT
+                                                                              credentialProvider:provider];
+    client.finishedPartNumbers = [NSMutableArray array];
+    
+    OSSResumableUploadRequest *request = [OSSResumableUploadRequest new];
+    request.bucketName = OSS_BUCKET_PUBLIC;
+    request.objectKey = @"sequential-multipart-read-ahead";
+    request.uploadingFileURL = [[NSBundle mainBundle] URLForResource:@"wangwang" withExtension:@"zip"];
+    request.crcFlag = OSSRequestCRCOpen;
+    request.partSize = 1024 * 1024;
+    request.sequentialReadAheadPartCount = 3;
+    
+    OSSTask *task = [client sequentialMultipartUpload:request];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertGreaterThan(client.finishedPartNumbers.count, 4);
+    for (NSUInteger i = 0; i < client.finishedPartNumbers.count; i++) {
+        XCTAssertEqual(client.finishedPartNumbers[i].intValue, (int)i + 1);
+    }
+}
+
 - (void)testAPI_sequentialMultipartUpload_cancel_withoutDeleteRecord {
     OSSResumableUploadRequest *request = [OSSResumableUploadRequest new];
     request.bucketName = OSS_BUCKET_PUBLIC;
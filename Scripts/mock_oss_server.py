@@ -0,0 +1,345 @@
+#!/usr/bin/env python3
+# encoding: utf-8
+# 本地模拟 OSS 服务，用于 AliyunOSSBenchmarks 的性能测试，不校验签名，对象只保存在内存中。
+# 使用步骤：
+# 1.需要 python 3.7 以上，不依赖第三方模块
+# 2.启动服务 python3 mock_oss_server.py --port 8800 [--latency 50] [--bandwidth 10485760] [--crc]
+#   --latency   每个请求在响应前等待的毫秒数，模拟网络往返
+#   --bandwidth 所有连接共享的上行、下行带宽上限（字节/秒），0 表示不限速
+#   --crc       返回 x-oss-hash-crc64ecma，纯 python 计算，会拖慢大文件
+# 3.AliyunOSSBenchmarks 默认连接 http://127.0.0.1:8800，可以用环境变量 OSS_BENCHMARK_ENDPOINT 修改
+#
+# 支持的接口：PutObject、GetObject(Range)、HeadObject、DeleteObject、DeleteMultipleObjects、GetBucket，
+# InitiateMultipartUpload、UploadPart、CompleteMultipartUpload、ListParts、AbortMultipartUpload。
+# endpoint 是 IP 时 SDK 不把 bucket 放进 host，所以请求路径就是 object key，所有 bucket 共用一个命名空间。
+
+import argparse
+import hashlib
+import threading
+import time
+import uuid
+import xml.etree.ElementTree as ElementTree
+from email.utils import formatdate
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, unquote, urlsplit
+from xml.sax.saxutils import escape
+
+CHUNK_SIZE = 64 * 1024
+
+
+def _crc64_table():
+    table = []
+    for i in range(256):
+        crc = i
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xC96C5795D7870F42 if crc & 1 else crc >> 1
+        table.append(crc)
+    return table
+
+
+CRC64_TABLE = _crc64_table()
+
+
+def crc64ecma(data):
+    crc = 0xFFFFFFFFFFFFFFFF
+    for byte in data:
+        crc = CRC64_TABLE[(crc ^ byte) & 0xFF] ^ (crc >> 8)
+    return crc ^ 0xFFFFFFFFFFFFFFFF
+
+
+class Throttle(object):
+    """a token bucket shared by all the connections, holding at most a second of bandwidth"""
+
+    def __init__(self, bytes_per_second):
+        self.rate = bytes_per_second
+        self.tokens = bytes_per_second
+        self.last = time.monotonic()
+        self.lock = threading.Lock()
+
+    def consume(self, count):
+        if self.rate <= 0:
+            return
+        with self.lock:
+            now = time.monotonic()
+            self.tokens = min(self.tokens + (now - self.last) * self.rate, self.rate)
+            self.last = now
+            self.tokens -= count
+            delay = -self.tokens / self.rate if self.tokens < 0 else 0
+        if delay > 0:
+            time.sleep(delay)
+
+
+class Store(object):
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.objects = {}
+        self.uploads = {}
+
+
+class OSSObject(object):
+    def __init__(self, data, content_type, meta, with_crc):
+        self.data = data
+        self.content_type = content_type or 'application/octet-stream'
+        self.meta = meta
+        self.etag = '"%s"' % hashlib.md5(data).hexdigest().upper()
+        self.last_modified = formatdate(usegmt=True)
+        self.crc64 = str(crc64ecma(data)) if with_crc else None
+
+
+class MockOSSHandler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+    server_version = 'AliyunOSS'
+
+    def log_message(self, format, *args):
+        if self.server.verbose:
+            BaseHTTPRequestHandler.log_message(self, format, *args)
+
+    # ---- request parsing
+
+    def parse(self):
+        url = urlsplit(self.path)
+        self.key = unquote(url.path[1:])
+        self.query = {k: v[0] for k, v in parse_qs(url.query, keep_blank_values=True).items()}
+
+    def read_body(self):
+        throttle = self.server.upload_throttle
+        if self.headers.get('Transfer-Encoding', '').lower() == 'chunked':
+            chunks = []
+            while True:
+                size = int(self.rfile.readline().strip().split(b';')[0], 16)
+                if size == 0:
+                    self.rfile.readline()
+                    break
+                chunks.append(self.rfile.read(size))
+                self.rfile.readline()
+                throttle.consume(size)
+            return b''.join(chunks)
+
+        remaining = int(self.headers.get('Content-Length', 0))
+        chunks = []
+        while remaining > 0:
+            chunk = self.rfile.read(min(CHUNK_SIZE, remaining))
+            if not chunk:
+                break
+            chunks.append(chunk)
+            remaining -= len(chunk)
+            throttle.consume(len(chunk))
+        return b''.join(chunks)
+
+    # ---- responses
+
+    def respond(self, status, body=b'', headers=None, send_body=True):
+        time.sleep(self.server.latency)
+        self.send_response(status)
+        self.send_header('x-oss-request-id', uuid.uuid4().hex.upper()[:24])
+        self.send_header('Date', formatdate(usegmt=True))
+        self.send_header('Content-Length', str(len(body)))
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.end_headers()
+        if send_body:
+            throttle = self.server.download_throttle
+            for offset in range(0, len(body), CHUNK_SIZE):
+                chunk = body[offset:offset + CHUNK_SIZE]
+                throttle.consume(len(chunk))
+                self.wfile.write(chunk)
+
+    def respond_xml(self, status, xml):
+        body = ('<?xml version="1.0" encoding="UTF-8"?>\n' + xml).encode('utf-8')
+        self.respond(status, body, {'Content-Type': 'application/xml'})
+
+    def respond_error(self, status, code, message, send_body=True):
+        xml = '<Error><Code>%s</Code><Message>%s</Message><RequestId>mock</RequestId><HostId>127.0.0.1</HostId></Error>' % (code, message)
+        body = ('<?xml version="1.0" encoding="UTF-8"?>\n' + xml).encode('utf-8')
+        self.respond(status, body, {'Content-Type': 'application/xml'}, send_body)
+
+    def object_headers(self, obj):
+        headers = {
+            'Content-Type': obj.content_type,
+            'ETag': obj.etag,
+            'Last-Modified': obj.last_modified,
+            'x-oss-object-type': 'Normal',
+            'Accept-Ranges': 'bytes',
+        }
+        if obj.crc64:
+            headers['x-oss-hash-crc64ecma'] = obj.crc64
+        headers.update(obj.meta)
+        return headers
+
+    def store_object(self, data):
+        meta = {k: v for k, v in self.headers.items() if k.lower().startswith('x-oss-meta-')}
+        obj = OSSObject(data, self.headers.get('Content-Type'), meta, self.server.with_crc)
+        with self.server.store.lock:
+            self.server.store.objects[self.key] = obj
+        return obj
+
+    # ---- methods
+
+    def do_PUT(self):
+        self.parse()
+        data = self.read_body()
+        if 'partNumber' in self.query and 'uploadId' in self.query:
+            with self.server.store.lock:
+                upload = self.server.store.uploads.get(self.query['uploadId'])
+                if upload is None:
+                    return self.respond_error(404, 'NoSuchUpload', 'The specified upload does not exist.')
+                part = OSSObject(data, None, {}, self.server.with_crc)
+                upload['parts'][int(self.query['partNumber'])] = part
+            headers = {'ETag': part.etag}
+            if part.crc64:
+                headers['x-oss-hash-crc64ecma'] = part.crc64
+            return self.respond(200, headers=headers)
+
+        obj = self.store_object(data)
+        headers = {'ETag': obj.etag}
+        if obj.crc64:
+            headers['x-oss-hash-crc64ecma'] = obj.crc64
+        self.respond(200, headers=headers)
+
+    def do_POST(self):
+        self.parse()
+        data = self.read_body()
+        store = self.server.store
+        if 'uploads' in self.query:
+            upload_id = uuid.uuid4().hex.upper()
+            meta = {k: v for k, v in self.headers.items() if k.lower().startswith('x-oss-meta-')}
+            with store.lock:
+                store.uploads[upload_id] = {'key': self.key, 'parts': {}, 'meta': meta,
+                                            'content_type': self.headers.get('Content-Type')}
+            return self.respond_xml(200, '<InitiateMultipartUploadResult><Bucket>mock</Bucket><Key>%s</Key>'
+                                         '<UploadId>%s</UploadId></InitiateMultipartUploadResult>'
+                                    % (escape(self.key), upload_id))
+
+        if 'uploadId' in self.query:
+            with store.lock:
+                upload = store.uploads.pop(self.query['uploadId'], None)
+            if upload is None:
+                return self.respond_error(404, 'NoSuchUpload', 'The specified upload does not exist.')
+            numbers = [int(part.findtext('PartNumber')) for part in ElementTree.fromstring(data).iter('Part')]
+            if any(number not in upload['parts'] for number in numbers):
+                return self.respond_error(400, 'InvalidPart', 'One or more of the specified parts could not be found.')
+            obj = OSSObject(b''.join(upload['parts'][number].data for number in numbers),
+                            upload['content_type'], upload['meta'], self.server.with_crc)
+            with store.lock:
+                store.objects[self.key] = obj
+            headers = {'Content-Type': 'application/xml'}
+            if obj.crc64:
+                headers['x-oss-hash-crc64ecma'] = obj.crc64
+            body = ('<?xml version="1.0" encoding="UTF-8"?>\n<CompleteMultipartUploadResult><Location>%s</Location>'
+                    '<Bucket>mock</Bucket><Key>%s</Key><ETag>%s</ETag></CompleteMultipartUploadResult>'
+                    % (escape(self.key), escape(self.key), escape(obj.etag))).encode('utf-8')
+            return self.respond(200, body, headers)
+
+        if 'delete' in self.query:
+            keys = [element.findtext('Key') for element in ElementTree.fromstring(data).iter('Object')]
+            with store.lock:
+                for key in keys:
+                    store.objects.pop(key, None)
+            deleted = ''.join('<Deleted><Key>%s</Key></Deleted>' % escape(key) for key in keys)
+            return self.respond_xml(200, '<DeleteResult>%s</DeleteResult>' % deleted)
+
+        self.respond_error(400, 'InvalidArgument', 'Unsupported POST request.')
+
+    def do_GET(self):
+        self.get_or_head(send_body=True)
+
+    def do_HEAD(self):
+        self.get_or_head(send_body=False)
+
+    def get_or_head(self, send_body):
+        self.parse()
+        store = self.server.store
+        if 'uploadId' in self.query:
+            return self.list_parts()
+        if not self.key:
+            return self.list_objects()
+
+        with store.lock:
+            obj = store.objects.get(self.key)
+        if obj is None:
+            return self.respond_error(404, 'NoSuchKey', 'The specified key does not exist.', send_body)
+
+        headers = self.object_headers(obj)
+        byte_range = self.headers.get('Range')
+        if byte_range and byte_range.startswith('bytes='):
+            start, _, end = byte_range[len('bytes='):].partition('-')
+            size = len(obj.data)
+            if start == '':
+                start, end = max(size - int(end), 0), size - 1
+            else:
+                start, end = int(start), min(int(end) if end else size - 1, size - 1)
+            if start < size:
+                headers['Content-Range'] = 'bytes %d-%d/%d' % (start, end, size)
+                return self.respond(206, obj.data[start:end + 1], headers, send_body)
+        self.respond(200, obj.data, headers, send_body)
+
+    def list_parts(self):
+        with self.server.store.lock:
+            upload = self.server.store.uploads.get(self.query['uploadId'])
+            parts = sorted(upload['parts'].items()) if upload else None
+        if parts is None:
+            return self.respond_error(404, 'NoSuchUpload', 'The specified upload does not exist.')
+        marker = int(self.query.get('part-number-marker') or 0)
+        max_parts = int(self.query.get('max-parts') or 1000)
+        parts = [(number, part) for number, part in parts if number > marker]
+        page, truncated = parts[:max_parts], len(parts) > max_parts
+        xml = ''.join('<Part><PartNumber>%d</PartNumber><LastModified>%s</LastModified><ETag>%s</ETag><Size>%d</Size></Part>'
+                      % (number, part.last_modified, escape(part.etag), len(part.data)) for number, part in page)
+        next_marker = page[-1][0] if page else marker
+        self.respond_xml(200, '<ListPartsResult><Bucket>mock</Bucket><Key>%s</Key><UploadId>%s</UploadId>'
+                              '<PartNumberMarker>%d</PartNumberMarker><NextPartNumberMarker>%d</NextPartNumberMarker>'
+                              '<MaxParts>%d</MaxParts><IsTruncated>%s</IsTruncated>%s</ListPartsResult>'
+                         % (escape(self.key), self.query['uploadId'], marker, next_marker, max_parts,
+                            'true' if truncated else 'false', xml))
+
+    def list_objects(self):
+        prefix = self.query.get('prefix', '')
+        max_keys = int(self.query.get('max-keys') or 100)
+        marker = self.query.get('marker', '')
+        with self.server.store.lock:
+            keys = sorted(key for key in self.server.store.objects if key.startswith(prefix) and key > marker)
+            objects = [(key, self.server.store.objects[key]) for key in keys[:max_keys]]
+        truncated = len(keys) > max_keys
+        xml = ''.join('<Contents><Key>%s</Key><LastModified>%s</LastModified><ETag>%s</ETag><Type>Normal</Type>'
+                      '<Size>%d</Size><StorageClass>Standard</StorageClass></Contents>'
+                      % (escape(key), obj.last_modified, escape(obj.etag), len(obj.data)) for key, obj in objects)
+        next_marker = '<NextMarker>%s</NextMarker>' % escape(objects[-1][0]) if truncated else ''
+        self.respond_xml(200, '<ListBucketResult><Name>mock</Name><Prefix>%s</Prefix><Marker>%s</Marker>'
+                              '<MaxKeys>%d</MaxKeys><IsTruncated>%s</IsTruncated>%s%s</ListBucketResult>'
+                         % (escape(prefix), escape(marker), max_keys, 'true' if truncated else 'false', next_marker, xml))
+
+    def do_DELETE(self):
+        self.parse()
+        store = self.server.store
+        with store.lock:
+            if 'uploadId' in self.query:
+                store.uploads.pop(self.query['uploadId'], None)
+            else:
+                store.objects.pop(self.key, None)
+        self.respond(204)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='a local OSS mock for the SDK benchmarks')
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=8800)
+    parser.add_argument('--latency', type=float, default=0, help='milliseconds waited before each response')
+    parser.add_argument('--bandwidth', type=int, default=0, help='bytes per second in each direction, 0 for no limit')
+    parser.add_argument('--crc', action='store_true', help='return x-oss-hash-crc64ecma')
+    parser.add_argument('--verbose', action='store_true')
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer((args.host, args.port), MockOSSHandler)
+    server.daemon_threads = True
+    server.store = Store()
+    server.latency = args.latency / 1000.0
+    server.upload_throttle = Throttle(args.bandwidth)
+    server.download_throttle = Throttle(args.bandwidth)
+    server.with_crc = args.crc
+    server.verbose = args.verbose
+    print('mock OSS listening on http://%s:%d' % (args.host, args.port))
+    server.serve_forever()
+
+
+if __name__ == '__main__':
+    main()